@@ -24,3 +24,4 @@ make clean
 make
 cp -f cdecoder ../recorder/wav/
 cp -f sdecoder ../recorder/wav/
+cp -f bdecoder ../recorder/wav/
@@ -0,0 +1,400 @@
+/************************************************************************
+*
+*	FILENAME		:	bdecoder.c
+*
+*	DESCRIPTION		:	Main program for batch decoding of a directory
+*					of speech files on several threads
+*
+************************************************************************
+*
+*	USAGE			:	bdecoder [-j threads] directory
+*					(Executable_File [Option] Input1)
+*
+*	INPUT FILE(S)		:
+*
+*		INPUT1	:	- Description : directory containing the files
+*					  to decode
+*					- *.out : channel encoded serial stream
+*					  (see cdecoder.c), it is channel decoded
+*					  then speech decoded
+*					- *.cod : serial stream (see sdecoder.c),
+*					  it is speech decoded
+*
+*	OUTPUT FILE(S)	:
+*
+*		OUTPUT1	:	- Description : one synthesis file <name>.raw
+*					  for each input file, in the same directory
+*					- Format : binary file 16 bit-samples
+*
+*	COMMENTS		:	- Each thread owns its channel decoder and
+*					speech decoder contexts, files are taken
+*					from a shared list until it is empty.
+*					Output is bit-exact with the chain
+*					cdecoder + sdecoder.
+*					- Default threads number is the number of
+*					online processors
+*
+************************************************************************
+*
+*	INCLUDED FILES	:	channel.h
+*					source.h
+*					stdio.h
+*					stdlib.h
+*					string.h
+*					dirent.h
+*					pthread.h
+*					unistd.h
+*
+************************************************************************/
+
+/* LIBRARIES USED */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "source.h"
+#include "channel.h"
+
+/*-----------------*
+ * Constants       *
+ *-----------------*/
+
+#define L_frame     240
+#define serial_size 138
+#define prm_size    24
+#define max_threads 256
+
+/*-----------------*
+ * Shared job list *
+ *-----------------*/
+
+static char            *Directory;
+static char           **File_names;
+static int              Nber_files;
+static int              Next_file = 0;
+static int              Nber_errors = 0;
+static pthread_mutex_t  Jobs_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**************************************************************************
+*
+*	ROUTINE				:	Decode_Serial_Frame
+*
+*	DESCRIPTION			:	Speech decoding of one serial frame
+*							(BFI + 137 bits) and writing of the synthesis
+*
+**************************************************************************
+*
+*	USAGE				:	Decode_Serial_Frame(st,serial,file_pointer)
+*							(Routine_Name(context,input1,input2))
+*
+*	RETURNED VALUE		:	0 if process correct, -1 if write error
+*
+**************************************************************************/
+
+static int Decode_Serial_Frame(Decoder_State *st, Word16 serial[],
+			FILE *fout)
+{
+	Word16  synth[L_frame];		/* Synthesis              */
+	Word16  parm[prm_size];		/* Synthesis parameters   */
+
+	Bits2prm_Tetra(serial, parm);
+	Decod_Tetra(st, parm, synth);
+	Post_Process(synth, (Word16)L_frame);
+
+	if (fwrite(synth, sizeof(Word16), L_frame, fout) != L_frame)
+		return -1;
+
+	return 0;
+}
+
+/**************************************************************************
+*
+*	ROUTINE				:	Decode_Out_File
+*
+*	DESCRIPTION			:	Channel decoding then speech decoding of a
+*							channel encoded file (same processing as
+*							cdecoder followed by sdecoder, without
+*							frame stealing)
+*
+**************************************************************************
+*
+*	USAGE				:	Decode_Out_File(file_in,file_out)
+*							(Routine_Name(input1,input2))
+*
+*	RETURNED VALUE		:	number of speech frames, -1 if write error
+*
+**************************************************************************/
+
+static long Decode_Out_File(FILE *fin, FILE *fout)
+{
+	Channel_Decoder_State cdec;	/* Channel decoder context */
+	Decoder_State sdec;		/* Speech decoder context  */
+	Tetra_File tetra_file;		/* Input file blocks       */
+	short   first_pass = 1;
+	long    frames = 0;
+	Word16  bfi2;
+	Word16  Reordered_array[286];
+	Word16  Interleaved_coded_array[432];
+	Word16  Coded_array[432];
+	Word16  serial[serial_size];
+
+	memset(&tetra_file, 0, sizeof(tetra_file));
+	Init_Decod_Tetra(&sdec);
+
+	while (Read_Tetra_File(&tetra_file, fin, Interleaved_coded_array) != -1)
+	{
+		Desinterleaving_Speech(Interleaved_coded_array, Coded_array);
+
+		bfi2 = Channel_Decoding(&cdec, first_pass, 0, Coded_array,
+				Reordered_array);
+		first_pass = 0;
+
+/* 1st speech frame : its BFI is set when the channel frame is bad */
+		serial[0] = bfi2;
+		memcpy(serial + 1, Reordered_array, 137 * sizeof(Word16));
+		if (Decode_Serial_Frame(&sdec, serial, fout) != 0)
+			return -1;
+
+/* 2nd speech frame */
+		serial[0] = bfi2;
+		memcpy(serial + 1, Reordered_array + 137, 137 * sizeof(Word16));
+		if (Decode_Serial_Frame(&sdec, serial, fout) != 0)
+			return -1;
+
+		frames += 2;
+	}
+
+	return frames;
+}
+
+/**************************************************************************
+*
+*	ROUTINE				:	Decode_Cod_File
+*
+*	DESCRIPTION			:	Speech decoding of a serial stream file
+*							(same processing as sdecoder)
+*
+**************************************************************************
+*
+*	USAGE				:	Decode_Cod_File(file_in,file_out)
+*							(Routine_Name(input1,input2))
+*
+*	RETURNED VALUE		:	number of speech frames, -1 if write error
+*
+**************************************************************************/
+
+static long Decode_Cod_File(FILE *fin, FILE *fout)
+{
+	Decoder_State sdec;		/* Speech decoder context  */
+	long    frames = 0;
+	Word16  serial[serial_size];
+
+	Init_Decod_Tetra(&sdec);
+
+	while (fread(serial, sizeof(Word16), serial_size, fin) == serial_size)
+	{
+		if (Decode_Serial_Frame(&sdec, serial, fout) != 0)
+			return -1;
+		frames++;
+	}
+
+	return frames;
+}
+
+/**************************************************************************
+*
+*	ROUTINE				:	Decode_File
+*
+*	DESCRIPTION			:	Decode one file of the directory into
+*							<name>.raw
+*
+**************************************************************************
+*
+*	USAGE				:	Decode_File(name)
+*							(Routine_Name(input1))
+*
+*	RETURNED VALUE		:	0 if process correct, -1 if error
+*
+**************************************************************************/
+
+static int Decode_File(const char *name)
+{
+	char    path_in[4096], path_out[4096];
+	size_t  len = strlen(name);
+	FILE    *fin, *fout;
+	long    frames;
+
+	snprintf(path_in, sizeof(path_in), "%s/%s", Directory, name);
+	snprintf(path_out, sizeof(path_out), "%s/%.*s.raw", Directory,
+			(int)(len - 4), name);
+
+	if ((fin = fopen(path_in, "rb")) == NULL)
+	{
+		fprintf(stderr, "bdecoder: can't open %s\n", path_in);
+		return -1;
+	}
+
+	if ((fout = fopen(path_out, "wb")) == NULL)
+	{
+		fprintf(stderr, "bdecoder: can't open %s\n", path_out);
+		fclose(fin);
+		return -1;
+	}
+
+	if (strcmp(name + len - 4, ".out") == 0)
+		frames = Decode_Out_File(fin, fout);
+	else
+		frames = Decode_Cod_File(fin, fout);
+
+	fclose(fin);
+	if (fclose(fout) != 0) frames = -1;
+
+	if (frames < 0)
+	{
+		fprintf(stderr, "bdecoder: can't write to %s\n", path_out);
+		return -1;
+	}
+
+	fprintf(stderr, "* %s -> %.*s.raw (%ld Speech Frames)\n", name,
+			(int)(len - 4), name, frames);
+	return 0;
+}
+
+/**************************************************************************
+*
+*	ROUTINE				:	Worker
+*
+*	DESCRIPTION			:	Thread body, takes the next file of the list
+*							until all files are decoded
+*
+**************************************************************************/
+
+static void *Worker(void *arg)
+{
+	int     index;
+
+	(void)arg;
+
+	while (1)
+	{
+		pthread_mutex_lock(&Jobs_lock);
+		index = Next_file++;
+		pthread_mutex_unlock(&Jobs_lock);
+
+		if (index >= Nber_files) break;
+
+		if (Decode_File(File_names[index]) != 0)
+		{
+			pthread_mutex_lock(&Jobs_lock);
+			Nber_errors++;
+			pthread_mutex_unlock(&Jobs_lock);
+		}
+	}
+
+	return NULL;
+}
+
+static int Has_Extension(const char *name)
+{
+	size_t  len = strlen(name);
+
+	if (len <= 4) return 0;
+	return (strcmp(name + len - 4, ".out") == 0) ||
+		(strcmp(name + len - 4, ".cod") == 0);
+}
+
+static int Compare_Names(const void *a, const void *b)
+{
+	return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+int	main( int argc, char *argv[] )
+{
+	DIR     *dir;
+	struct dirent *entry;
+	pthread_t threads[max_threads];
+	long    Nber_threads;
+	int     capacity = 0;
+	int     i;
+
+	/* Parse arguments */
+	Nber_threads = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if ((argc == 4) && (strcmp(argv[1], "-j") == 0))
+	{
+		Nber_threads = atol(argv[2]);
+		argv += 2;
+		argc -= 2;
+	}
+
+	if ((argc != 2) || (Nber_threads < 1))
+	{
+		fputs("usage : bdecoder [-j threads] directory\n", stderr);
+		fputs("decodes every *.out (channel encoded) and *.cod (serial)\n", stderr);
+		fputs("file of directory into *.raw synthesis files\n", stderr);
+		exit( 1 );
+	}
+
+	if (Nber_threads > max_threads) Nber_threads = max_threads;
+
+	Directory = argv[1];
+
+	if ((dir = opendir(Directory)) == NULL)
+	{
+		fprintf(stderr, "bdecoder: can't open directory %s\n", Directory);
+		exit( 1 );
+	}
+
+	/* Build the sorted list of files to decode */
+	Nber_files = 0;
+	File_names = NULL;
+
+	while ((entry = readdir(dir)) != NULL)
+	{
+		if (!Has_Extension(entry->d_name)) continue;
+
+		if (Nber_files == capacity)
+		{
+			capacity = capacity ? 2 * capacity : 64;
+			File_names = realloc(File_names, capacity * sizeof(char *));
+			if (File_names == NULL)
+			{
+				fputs("bdecoder: out of memory\n", stderr);
+				exit( 1 );
+			}
+		}
+		File_names[Nber_files++] = strdup(entry->d_name);
+	}
+	closedir(dir);
+
+	qsort(File_names, Nber_files, sizeof(char *), Compare_Names);
+
+	if (Nber_threads > Nber_files) Nber_threads = Nber_files;
+
+	/* Decode files on all threads */
+	for (i = 0; i < Nber_threads - 1; i++)
+	{
+		if (pthread_create(&threads[i], NULL, Worker, NULL) != 0)
+		{
+			fputs("bdecoder: can't create thread\n", stderr);
+			Nber_threads = i + 1;
+			break;
+		}
+	}
+
+	/* The calling thread is the last worker */
+	Worker(NULL);
+
+	for (i = 0; i < Nber_threads - 1; i++)
+		pthread_join(threads[i], NULL);
+
+	fprintf(stderr, "%d files decoded, %d errors\n", Nber_files - Nber_errors,
+			Nber_errors);
+
+	for (i = 0; i < Nber_files; i++) free(File_names[i]);
+	free(File_names);
+
+	return (Nber_errors ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -26,8 +26,8 @@
 *
 **************************************************************************
 *
-*	USAGE				:	Channel_Encoding(first,flag,buffer_in, buffer_out)
-*						(Routine_Name(input1,input2,input3,output1))
+*	USAGE				:	Channel_Encoding(st,first,flag,buffer_in, buffer_out)
+*						(Routine_Name(context,input1,input2,input3,output1))
 *
 *	INPUT ARGUMENT(S)		:	
 *
@@ -49,7 +49,7 @@
 *
 **************************************************************************/
 
-void Channel_Encoding(short first_pass, Word16 Frame_Stealing, Word16 Input_Frame[], Word16 Output_Frame[])
+void Channel_Encoding(Channel_Coder_State *st, short first_pass, Word16 Frame_Stealing, Word16 Input_Frame[], Word16 Output_Frame[])
 
 {
 
@@ -62,7 +62,7 @@ Word16  i, Nber_Info_Bits;
 		else 
 			Nber_Info_Bits = N0 + N1 + N2 + Fs_SIZE_CRC; 
 			
-		if ( first_pass ) Init_Rcpc_Coding(Frame_Stealing,
+		if ( first_pass ) Init_Rcpc_Coding(st, Frame_Stealing,
 					Ordered_array);  
 		else {  /* Zero the (K - 1) last bits of Ordered_array */
 			for (i = 0; i < K - 1; i++)
@@ -87,10 +87,10 @@ Word16  i, Nber_Info_Bits;
 
 		if (!Frame_Stealing)
 /* Channel encoding of the 2 frames */
-			Rcpc_Coding(Frame_Stealing, Ordered_array, Output_Frame);
+			Rcpc_Coding(st, Frame_Stealing, Ordered_array, Output_Frame);
 		else
 /* Channel encoding of 2nd frame */
-			Rcpc_Coding(Frame_Stealing, Ordered_array,
+			Rcpc_Coding(st, Frame_Stealing, Ordered_array,
 					Output_Frame + 216);
 
 		return;
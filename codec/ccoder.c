@@ -38,6 +38,7 @@
 
 /* LIBRARIES USED */
 #include <stdlib.h>
+#include <string.h>
 #include "channel.h"
 
 #ifndef TRUE
@@ -62,6 +63,8 @@ int    main( int argc, char *argv[] )
 	Word16  Vocod_array[274];       /* Input Buffer : 2 vocoder frames */
 	Word16  Coded_array[432];
 	Word16  Interleaved_coded_array[432]; /* Output Buffer */
+	Channel_Coder_State coder;	/* Channel coder context */
+	Tetra_File tetra_file;		/* Output file blocks */
 
 	/* Parse arguments */
 	if ( argc != 3 )
@@ -84,6 +87,8 @@ int    main( int argc, char *argv[] )
 		exit( 1 );
 	}
 
+	memset(&tetra_file, 0, sizeof(tetra_file));
+
 	while( 1 )
 	{
 			      /* Skip over bfi bit */
@@ -109,7 +114,7 @@ int    main( int argc, char *argv[] )
 
 
 /* Channel Encoding */
-		Channel_Encoding(first_pass,FS_Flag,Vocod_array,Coded_array);
+		Channel_Encoding(&coder,first_pass,FS_Flag,Vocod_array,Coded_array);
 		first_pass = FALSE;
 
 /* Interleaving */
@@ -128,7 +133,7 @@ int    main( int argc, char *argv[] )
 		Loop_counter++;
 
 /* write Output_array (1 TETRA frame = 2 speech frames) to output file */
-		if (Write_Tetra_File (fout, Interleaved_coded_array) == -1)
+		if (Write_Tetra_File (&tetra_file, fout, Interleaved_coded_array) == -1)
 		  {
 		  puts ("chanlcod: cannot write to output file");
 		  break;
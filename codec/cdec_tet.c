@@ -24,8 +24,8 @@
 *
 **************************************************************************
 *
-*	USAGE				:	Channel_Decoding(first,flag,buffer_in, buffer_out)
-*						(Routine_Name(input1,input2,input3,output1))
+*	USAGE				:	Channel_Decoding(st,first,flag,buffer_in, buffer_out)
+*						(Routine_Name(context,input1,input2,input3,output1))
 *
 *	INPUT ARGUMENT(S)		:	
 *
@@ -45,20 +45,20 @@
 *
 **************************************************************************/
 
-Word16    Channel_Decoding(short first_pass, Word16 Frame_Stealing,
-			Word16 Input_Frame[], Word16 Output_Frame[])
+Word16    Channel_Decoding(Channel_Decoder_State *st, short first_pass,
+			Word16 Frame_Stealing, Word16 Input_Frame[], Word16 Output_Frame[])
 {
 Word16  Decoded_array[286];
 Word16  badframeindicator;
 
 /* Init for channel-decoder */
-	if ( first_pass ) Init_Rcpc_Decoding();
+	if ( first_pass ) Init_Rcpc_Decoding(st);
 
 /* Decoding */
 	if (!Frame_Stealing)
-		Rcpc_Decoding(Frame_Stealing, Input_Frame, Decoded_array);
+		Rcpc_Decoding(st, Frame_Stealing, Input_Frame, Decoded_array);
 	else
-		Rcpc_Decoding(Frame_Stealing, Input_Frame + 216, Decoded_array);
+		Rcpc_Decoding(st, Frame_Stealing, Input_Frame + 216, Decoded_array);
 	badframeindicator = Bfi(Frame_Stealing,Decoded_array);
 /* "Decoding" for non-protected class (class 0) */
 	Untransform_Class_0(Frame_Stealing,Decoded_array);
@@ -36,6 +36,7 @@
 
 /* LIBRARIES USED */
 #include <stdlib.h>
+#include <string.h>
 #include "channel.h"
 		       
 #ifndef TRUE
@@ -63,6 +64,8 @@ int	main( int argc, char *argv[] )
 	Word16  Reordered_array[286];   /* 2 frames vocoder + 8 + 4 */
 	Word16  Interleaved_coded_array[432]; /*time-slot length at 7.2 kb/s*/
 	Word16  Coded_array[432];
+	Channel_Decoder_State decoder;	/* Channel decoder context */
+	Tetra_File tetra_file;		/* Input file blocks */
 	
 	/* Parse arguments */
 	if ( argc != 3 )
@@ -88,10 +91,12 @@ int	main( int argc, char *argv[] )
 	}
 
 
+	memset(&tetra_file, 0, sizeof(tetra_file));
+
 	while( 1 )
 	{
 /* read Input_array (1 TETRA frame = 2 speech frames) from input file */
-		if (Read_Tetra_File (fin, Interleaved_coded_array) == -1)
+		if (Read_Tetra_File (&tetra_file, fin, Interleaved_coded_array) == -1)
 		  {
 		  fputs ("cdecoder: reached end of input_file",stderr);
 		  break;
@@ -117,7 +122,7 @@ in "Coded_array" */
 		if (bfi1) fprintf(stderr,"Frame Nb %ld was stolen\n",Loop_counter+1);
 
 /* Channel Decoding */
-		bfi2 = Channel_Decoding(first_pass,Frame_stealing,
+		bfi2 = Channel_Decoding(&decoder,first_pass,Frame_stealing,
 				Coded_array,Reordered_array);
 		first_pass = FALSE;
 		if ((Frame_stealing==0) && (bfi2==1)) bfi1=1;
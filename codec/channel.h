@@ -29,6 +29,52 @@ typedef int   Flag;
 #endif
 
 
+/************************************************************************
+*
+*	DESCRIPTION		:	CONTEXTS of the TETRA speech channel coder
+*						and speech channel decoder
+*
+*						Each coder/decoder instance owns its context,
+*						so several instances may run in the same process
+*
+************************************************************************/
+
+#ifndef CHANNEL_STATE_H
+#define CHANNEL_STATE_H
+
+#define	K				5 /* Constraint Length */
+#define	Decoding_delay		30 /* Decoding Delay */
+
+/* Description of the lattice (set by Init_Rcpc_Coding) */
+typedef struct {
+	Word16	Previous[(1 << (K - 1))][2];
+	Word16	T1[(1 << (K - 1))][2], T2[(1 << (K - 1))][2], T3[(1 << (K - 1))][2];
+	Word16	Msb_bit;
+	Word16	M_1;
+} Channel_Coder_State;
+
+/* Description of the lattice (set by Init_Rcpc_Decoding) and Viterbi memories */
+typedef struct {
+	Word16	Previous[(1 << (K - 1))][2];
+	Word16	Best_previous[(1 << (K - 1))][Decoding_delay];
+	Word16	T1[(1 << (K - 1))][2], T2[(1 << (K - 1))][2], T3[(1 << (K - 1))][2];
+	Word16	Score[(1 << (K - 1))];
+	Word16	Ex_score[(1 << (K - 1))];
+	Word16	Received[3];
+	Word16	Msb_bit;
+	Word16	M_1;
+} Channel_Decoder_State;
+
+/* TETRA format file (Read_Tetra_File/Write_Tetra_File) : to be zeroed */
+/* before the first call                                                */
+typedef struct {
+	short	initial;
+	short	block[690];
+} Tetra_File;
+
+#endif
+
+
 /************************************************************************
 *
 *	DESCRIPTION		:	FUNCTION PROTOTYPES for the TETRA
@@ -45,16 +91,18 @@ typedef int   Flag;
 Word16	Build_Crc(Word16 FS_Flag, Word16 Input_Frame[]);
 Word16	Build_Sensitivity_Classes(Word16 FS_Flag, Word16 Input_Frame[], 			Word16 Output_Frame[]);
 Word16	Combination(Word16 A, Word16 B);
-void		Channel_Encoding(short first_pass, Word16 Frame_Stealing,
-			Word16 Input_Frame[], Word16 Output_Frame[]);
-void		Init_Rcpc_Coding(Word16 FS_Flag, Word16 Input_Frame[]);
+void		Channel_Encoding(Channel_Coder_State *st, short first_pass,
+			Word16 Frame_Stealing, Word16 Input_Frame[],
+			Word16 Output_Frame[]);
+void		Init_Rcpc_Coding(Channel_Coder_State *st, Word16 FS_Flag,
+			Word16 Input_Frame[]);
 Word16	Interleaving_Signalling(Word16 Input_Frame[],
 			Word16 Output_frame[]);
 Word16	Interleaving_Speech(Word16 Input_Frame[], Word16 Output_frame[]);
-void		Rcpc_Coding(Word16 FS_Flag, Word16 Input_Frame[],
-			Word16 Output_Frame[]);
+void		Rcpc_Coding(Channel_Coder_State *st, Word16 FS_Flag,
+			Word16 Input_Frame[], Word16 Output_Frame[]);
 void		Transform_Class_0(Word16 FS_Flag, Word16 Input_Frame[]);
-short		Write_Tetra_File (FILE *fout, short *array);
+short		Write_Tetra_File (Tetra_File *tf, FILE *fout, short *array);
 
 #endif
 
@@ -72,17 +120,18 @@ short		Write_Tetra_File (FILE *fout, short *array);
 
 
 Word16	Bfi(Word16 FS_Flag, Word16 Input_Frame[]);
-Word16	Channel_Decoding(short first_pass, Word16 Frame_Stealing,
-			Word16 Input_Frame[], Word16 Output_Frame[]);
+Word16	Channel_Decoding(Channel_Decoder_State *st, short first_pass,
+			Word16 Frame_Stealing, Word16 Input_Frame[],
+			Word16 Output_Frame[]);
 Word16	Combination(Word16 A, Word16 B);
 Word16	Desinterleaving_Signalling(Word16 Input_Frame[],
 			Word16 Output_frame[]);
 Word16	Desinterleaving_Speech(Word16 Input_Frame[],
 			Word16 Output_frame[]);
-void		Init_Rcpc_Decoding(void);
-void		Rcpc_Decoding(Word16 FS_Flag, Word16 Input_Frame[],
-			Word16 Output_Frame[]);
-short		Read_Tetra_File (FILE *fin, short *array);
+void		Init_Rcpc_Decoding(Channel_Decoder_State *st);
+void		Rcpc_Decoding(Channel_Decoder_State *st, Word16 FS_Flag,
+			Word16 Input_Frame[], Word16 Output_Frame[]);
+short		Read_Tetra_File (Tetra_File *tf, FILE *fin, short *array);
 Word16	Unbuild_Sensitivity_Classes(Word16 FS_Flag, Word16 Input_Frame[],
 			Word16 Output_Frame[]);
 Word16	Untransform_Class_0(Word16 FS_Flag, Word16 Input_Frame[]);
@@ -105,8 +154,16 @@ Word16	Untransform_Class_0(Word16 FS_Flag, Word16 Input_Frame[]);
  *-----------------------*/
 
 
-extern Flag Overflow;
-extern Flag Carry;
+/* Overflow and Carry are set by the operators : one copy per thread */
+
+#if defined(__GNUC__)
+#define TETRA_TLS __thread
+#else
+#define TETRA_TLS _Thread_local
+#endif
+
+extern TETRA_TLS Flag Overflow;
+extern TETRA_TLS Flag Carry;
 
 #define MAX_32 (Word32)0x7fffffff
 #define MIN_32 (Word32)0x80000000
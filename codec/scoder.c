@@ -54,7 +54,7 @@ int main(int argc, char *argv[] )
 {
   Word16 frame;
 
-  extern Word16 *new_speech;		/* Pointer on new_speech. */
+  Coder_State coder;			/* Coder context.         */
 
   Word16 syn[L_frame];			/* Local synthesis.       */
   Word16 ana[ana_size];			/* Analysis parameters.   */
@@ -104,20 +104,20 @@ int main(int argc, char *argv[] )
 
   /* Initialization of the coder */
 
-  Init_Pre_Process();
-  Init_Coder_Tetra();
+  Init_Coder_Tetra(&coder);
+  Init_Pre_Process(&coder);
 
   /* Loop for each "L_frame" speech data. */
 
   frame =0;
-  while( fread(new_speech, sizeof(Word16), L_frame, f_speech) == L_frame)
+  while( fread(coder.new_speech, sizeof(Word16), L_frame, f_speech) == L_frame)
   {
     printf("frame=%d\n", ++frame);
 
-    Pre_Process(new_speech, (Word16)L_frame);	/* Pre processing of input 
+    Pre_Process(&coder, coder.new_speech, (Word16)L_frame);	/* Pre processing of input 
 											 speech */
 
-    Coder_Tetra(ana, syn);              /* Find speech parameters         */
+    Coder_Tetra(&coder, ana, syn);      /* Find speech parameters         */
 
     Post_Process(syn, (Word16)L_frame); /* Post processing of synthesis   */
 
@@ -12,9 +12,11 @@
 ************************************************************************
 *
 *	INCLUDED FILES	:	source.h
+*					string.h
 *
 ************************************************************************/
 
+#include <string.h>
 #include "source.h"
 
 /*--------------------------------------------------------*
@@ -50,47 +52,18 @@
 
 
 /*--------------------------------------------------------*
- *         Static memory allocation.                      *
+ *         Constant tables.                               *
+ *   Memories kept between frames are in Decoder_State    *
+ *   (see source.h).                                      *
  *--------------------------------------------------------*/
 
-        /* Excitation vector */
-
-static Word16 old_exc[L_frame+pit_max+L_inter];
-static Word16 *exc;
-
-        /* Spectral expansion factors */
-
-static Word16 F_gamma3[p];
-static Word16 F_gamma4[p];
-
-        /* Lsp (Line spectral pairs in the cosine domain) */
-
-static Word16 lspold[p]={
-              30000, 26000, 21000, 15000, 8000, 0,
-		  -8000,-15000,-21000,
-			-26000};
-static Word16 lspnew[p];
-
 	  /* Initial lsp values used after each time */
         /* a reset is executed */
 
-static Word16 lspold_init[p]={
+static const Word16 lspold_init[p]={
               30000, 26000, 21000, 15000, 8000, 0,
 		  -8000,-15000,-21000,-26000};
 
-        /* Filter's memory */
-
-static Word16 mem_syn[p];
-
-        /* Default parameters */
-
-static Word16 old_parm[parm_size], old_T0;
-
-       /* Global definition */
-
-Word16 last_ener_cod;
-Word16 last_ener_pit;
-
 
 /**************************************************************************
 *
@@ -100,7 +73,7 @@ Word16 last_ener_pit;
 *
 **************************************************************************
 *
-*	USAGE				:	Init_Decod_Tetra()
+*	USAGE				:	Init_Decod_Tetra(st)
 *
 *	INPUT ARGUMENT(S)		:	None
 *
@@ -110,43 +83,47 @@ Word16 last_ener_pit;
 *
 **************************************************************************/
 
-void Init_Decod_Tetra(void)
+void Init_Decod_Tetra(Decoder_State *st)
 {
   Word16 i;
 
-  old_T0 = 60;
+  /* Whole context to zero, as were the static memories */
+
+  memset(st, 0, sizeof(Decoder_State));
+
+  st->old_T0 = 60;
   for(i=0; i<23; i++)
-     old_parm[i] = 0;
+     st->old_parm[i] = 0;
 
   /* Initialize static pointer */
 
-  exc    = old_exc + pit_max + L_inter;
+  st->exc    = st->old_exc + pit_max + L_inter;
 
-  /* Initialize global variables */
+  /* Initialize energy quantizer memories */
 
-  last_ener_cod = 0;
-  last_ener_pit = 0;
+  st->last_ener_cod = 0;
+  st->last_ener_pit = 0;
   
   /* Static vectors to zero */
 
   for(i=0; i<pit_max + L_inter; i++)
-    old_exc[i] = 0;
+    st->old_exc[i] = 0;
 
   for(i=0; i<p; i++)
-    mem_syn[i] = 0;
+    st->mem_syn[i] = 0;
 
 
   /* Initialisation of lsp values for first */
   /* frame lsp interpolation */
 
   for(i=0; i<p; i++)
-    lspold[i] = lspold_init[i];
+    st->lspold[i] = lspold_init[i];
 
 
   /* Compute LPC spectral expansion factors */
 
-  Fac_Pond(gamma3, F_gamma3);
-  Fac_Pond(gamma4, F_gamma4);
+  Fac_Pond(gamma3, st->F_gamma3);
+  Fac_Pond(gamma4, st->F_gamma4);
 
  return;
 }
@@ -160,7 +137,7 @@ void Init_Decod_Tetra(void)
 *
 **************************************************************************
 *
-*	USAGE				:	Decod_Tetra(parm,synth)
+*	USAGE				:	Decod_Tetra(st,parm,synth)
 *							(Routine_Name(input1,output1))
 *
 *	INPUT ARGUMENT(S)		:	
@@ -177,7 +154,7 @@ void Init_Decod_Tetra(void)
 *
 **************************************************************************/
 
-void Decod_Tetra(Word16 parm[], Word16 synth[])
+void Decod_Tetra(Decoder_State *st, Word16 parm[], Word16 synth[])
 {
   /* LPC coefficients */
 
@@ -212,30 +189,30 @@ void Decod_Tetra(Word16 parm[], Word16 synth[])
 
   if(bfi == 0)
   {
-    D_Lsp334(&parm[0], lspnew, lspold);	/* lsp decoding   */
+    D_Lsp334(&parm[0], st->lspnew, st->lspold);	/* lsp decoding   */
 
     for(i=0; i< parm_size; i++)		/* keep parm[] as old_parm */
-      old_parm[i] = parm[i];
+      st->old_parm[i] = parm[i];
   }
   else
   {
     for(i=1; i<p; i++)
-      lspnew[i] = lspold[i];
+      st->lspnew[i] = st->lspold[i];
 
     for(i=0; i< parm_size; i++)		/* use old parm[] */
-      parm[i] = old_parm[i];
+      parm[i] = st->old_parm[i];
   }
 
   parm += 3;			/* Advance synthesis parameters pointer */
 
   /* Interpolation of LPC for the 4 subframes */
 
-  Int_Lpc4(lspold,   lspnew,   A_t);
+  Int_Lpc4(st->lspold,   st->lspnew,   A_t);
 
   /* update the LSPs for the next frame */
 
   for(i=0; i<p; i++)
-    lspold[i]   = lspnew[i];
+    st->lspold[i]   = st->lspnew[i];
 
 /*------------------------------------------------------------------------*
  *          Loop for every subframe in the analysis frame                 *
@@ -279,7 +256,7 @@ void Decod_Tetra(Word16 parm[], Word16 synth[])
       }
       else   /* bfi == 1 */
       {
-        T0 = old_T0;
+        T0 = st->old_T0;
         T0_frac = 0;
       }
 
@@ -319,7 +296,7 @@ void Decod_Tetra(Word16 parm[], Word16 synth[])
     * - Find the adaptive codebook vector.            *
     *-------------------------------------------------*/
 
-    Pred_Lt(&exc[i_subfr], T0, T0_frac, L_subfr);
+    Pred_Lt(&st->exc[i_subfr], T0, T0_frac, L_subfr);
 
    /*-----------------------------------------------------*
     * - Compute noise filter F[].                         *
@@ -327,8 +304,8 @@ void Decod_Tetra(Word16 parm[], Word16 synth[])
     * - Find the algebraic codeword.                      *
     *-----------------------------------------------------*/
 
-    Pond_Ai(A, F_gamma3, Ap3);
-    Pond_Ai(A, F_gamma4, Ap4);
+    Pond_Ai(A, st->F_gamma3, Ap3);
+    Pond_Ai(A, st->F_gamma4, Ap4);
 
     for (i = 0;   i <= p;      i++) F[i] = Ap3[i];
     for (i = pp1; i < L_subfr; i++) F[i] = 0;
@@ -356,7 +333,8 @@ void Decod_Tetra(Word16 parm[], Word16 synth[])
 
     index = *parm++;        /* index of energy VQ */
 
-    Dec_Ener(index,bfi,A,&exc[i_subfr],code, L_subfr, &gain_pit, &gain_code);
+    Dec_Ener(index,bfi,A,&st->exc[i_subfr],code, L_subfr, &gain_pit, &gain_code,
+             &st->last_ener_pit, &st->last_ener_cod);
 
    /*-------------------------------------------------------*
     * - Find the total excitation.                          *
@@ -369,12 +347,12 @@ void Decod_Tetra(Word16 parm[], Word16 synth[])
       /* exc[i]  in Q0   gain_pit in Q12               */
       /* code[i] in Q12  gain_cod in Q0                */
 
-      L_temp = L_mult0(exc[i+i_subfr], gain_pit);
+      L_temp = L_mult0(st->exc[i+i_subfr], gain_pit);
       L_temp = L_mac0(L_temp, code[i], gain_code);
-      exc[i+i_subfr] = L_shr_r(L_temp, (Word16)12);
+      st->exc[i+i_subfr] = L_shr_r(L_temp, (Word16)12);
     }
 
-    Syn_Filt(A, &exc[i_subfr], &synth[i_subfr], L_subfr, mem_syn, (Word16)1);
+    Syn_Filt(A, &st->exc[i_subfr], &synth[i_subfr], L_subfr, st->mem_syn, (Word16)1);
 
     A  += pp1;    /* interpolated LPC parameters for next subframe */
   }
@@ -385,9 +363,9 @@ void Decod_Tetra(Word16 parm[], Word16 synth[])
   *--------------------------------------------------*/
 
   for(i=0; i<pit_max+L_inter; i++)
-    old_exc[i] = old_exc[i+L_frame];
+    st->old_exc[i] = st->old_exc[i+L_frame];
 
-  old_T0 = T0;
+  st->old_T0 = T0;
 
   return;
 }
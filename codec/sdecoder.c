@@ -51,6 +51,7 @@ int main(int argc, char *argv[] )
   Word16 synth[L_frame];		/* Synthesis              */
   Word16 parm[prm_size];		/* Synthesis parameters   */
   Word16 serial[serial_size];		/* Serial stream          */
+  Decoder_State decoder;		/* Decoder context        */
   FILE   *f_syn, *f_serial;
 
 
@@ -87,7 +88,7 @@ int main(int argc, char *argv[] )
 
   /* Initialization of decoder  */
 
-  Init_Decod_Tetra();
+  Init_Decod_Tetra(&decoder);
 
   /* Loop for each "L_frame" speech data. */
 
@@ -99,7 +100,7 @@ int main(int argc, char *argv[] )
 
     Bits2prm_Tetra(serial, parm);	/* serial to parameters */
 
-    Decod_Tetra(parm, synth);		/* decoder */
+    Decod_Tetra(&decoder, parm, synth);	/* decoder */
 
     Post_Process(synth, (Word16)L_frame);	/* Post processing of synthesis  */
 
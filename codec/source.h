@@ -39,6 +39,57 @@ typedef int     Flag;
 #define TETRA_H
 
 
+/*-----------------------------------------------------------------------*
+ *  Coder and decoder contexts : memories kept from one frame to the     *
+ *  next. Each coder or decoder instance owns its context, so several    *
+ *  instances may run in the same process (and in different threads).    *
+ *                                                                       *
+ *  Dimensions (see scod_tet.c and sdec_tet.c) :                         *
+ *    L_total = 290  (L_frame + L_next + p)                              *
+ *    L_wsp   = 383  (L_frame + pit_max)                                 *
+ *    L_exc   = 398  (L_frame + pit_max + L_inter)                       *
+ *    L_zero  = 71   (L_subfr + pp1)                                     *
+ *-----------------------------------------------------------------------*/
+
+typedef struct {
+  Word16 old_speech[290];		/* Speech vector                    */
+  Word16 *speech, *p_window, *new_speech;
+  Word16 old_wsp[383];			/* Weighted speech vector           */
+  Word16 *wsp;
+  Word16 old_exc[398];			/* Excitation vector                */
+  Word16 *exc;
+  Word16 ai_zero[71];			/* All-zero vector                  */
+  Word16 *zero;
+  Word16 F_gamma1[10];			/* Spectral expansion factors       */
+  Word16 F_gamma2[10];
+  Word16 F_gamma3[10];
+  Word16 F_gamma4[10];
+  Word16 lspold[10];			/* Lsp in the cosine domain         */
+  Word16 lspnew[10];
+  Word16 lspnew_q[10], lspold_q[10];
+  Word16 mem_syn[10], mem_w0[10], mem_w[10];	/* Filters memories         */
+  Word16 rr[32][32];			/* Matrix rr[dim_rr][dim_rr]        */
+  Word16 last_ener_cod;			/* Energy quantizer memories        */
+  Word16 last_ener_pit;
+  Word16 old_A[11];			/* Last stable A(z) (Levin_32)      */
+  Word16 lsp_old_q[10];			/* Last ordered lsp_q (Clsp_334)    */
+  Word16 y_hi, y_lo, x0;		/* Pre_Process filter memories      */
+} Coder_State;
+
+typedef struct {
+  Word16 old_exc[398];			/* Excitation vector                */
+  Word16 *exc;
+  Word16 F_gamma3[10];			/* Spectral expansion factors       */
+  Word16 F_gamma4[10];
+  Word16 lspold[10];			/* Lsp in the cosine domain         */
+  Word16 lspnew[10];
+  Word16 mem_syn[10];			/* Filter's memory                  */
+  Word16 old_parm[23], old_T0;		/* Default parameters (bfi)         */
+  Word16 last_ener_cod;			/* Energy quantizer memories        */
+  Word16 last_ener_pit;
+} Decoder_State;
+
+
 /* Basic functions */
 
 Word32 add_sh(Word32 L_var, Word16 var1, Word16 shift);
@@ -78,7 +129,7 @@ void   Fac_Pond(Word16 gamma, Word16 fac[]);
 void   Get_Lsp_Pol(Word16 *lsp, Word32 *f);
 void   Int_Lpc4(Word16 lsp_old[], Word16 lsp_new[], Word16 a_4[]);
 void   Lag_Window(Word16 p, Word16 r_h[], Word16 r_l[]);
-void   Levin_32(Word16 Rh[], Word16 Rl[], Word16 A[]);
+void   Levin_32(Word16 Rh[], Word16 Rl[], Word16 A[], Word16 old_A[]);
 Word32 Lpc_Gain(Word16 a[]);
 void   Lsp_Az(Word16 lsp[], Word16 a[]);
 void   Pond_Ai(Word16 a[], Word16 fac[], Word16 a_exp[]);
@@ -88,17 +139,18 @@ void   Syn_Filt(Word16 a[], Word16 x[], Word16 y[], Word16 lg, Word16 mem[],
 
 /* Specific coder functions */
 
-void   Init_Coder_Tetra(void);
-void   Coder_Tetra(Word16 ana[], Word16 synth[]);
+void   Init_Coder_Tetra(Coder_State *st);
+void   Coder_Tetra(Coder_State *st, Word16 ana[], Word16 synth[]);
 void   Cal_Rr2(Word16 h[], Word16 *rr);
-void   Clsp_334(Word16 *lsp, Word16 *lsp_q, Word16 *indice);
+void   Clsp_334(Word16 *lsp, Word16 *lsp_q, Word16 *indice, Word16 *lsp_old);
 Word16 D4i60_16(Word16 dn[], Word16 f[], Word16 h[], Word16 rr[][32],
                 Word16 cod[], Word16 y[], Word16 *sign, Word16 *shift_code);
 Word16 Ener_Qua(Word16 A[], Word16 prd_lt[], Word16 code[], Word16 L_subfr,
-                Word16 *gain_pit, Word16 *gain_cod);
+                Word16 *gain_pit, Word16 *gain_cod, Word16 *last_ener_pit,
+                Word16 *last_ener_cod);
 Word16 G_Code(Word16 xn2[], Word16 y2[], Word16 L_subfr);
 Word16 G_Pitch(Word16 xn[], Word16 y1[], Word16 L_subfr);
-void   Init_Pre_Process(void);
+void   Init_Pre_Process(Coder_State *st);
 Word16 Lag_Max(Word16 signal[], Word16 sig_dec[], Word16 L_frame,
                Word16 lag_max, Word16 lag_min, Word16 *cor_max);
 Word16 Pitch_Fr(Word16 exc[], Word16 xn[], Word16 h[], Word16 L_subfr,
@@ -106,16 +158,17 @@ Word16 Pitch_Fr(Word16 exc[], Word16 xn[], Word16 h[], Word16 L_subfr,
 		    Word16 *pit_frac);
 Word16 Pitch_Ol_Dec(Word16 signal[], Word16 L_frame);
 void   Pred_Lt(Word16 exc[], Word16 T0, Word16 frac, Word16 L_subfr);
-void   Pre_Process(Word16 signal[], Word16 lg);
+void   Pre_Process(Coder_State *st, Word16 signal[], Word16 lg);
 void   Prm2bits_Tetra(Word16 prm[], Word16 bits[]);
 
 /* Specific decoder functions */
 
-void   Init_Decod_Tetra(void);
-void   Decod_Tetra(Word16 parm[], Word16 synth[]);
+void   Init_Decod_Tetra(Decoder_State *st);
+void   Decod_Tetra(Decoder_State *st, Word16 parm[], Word16 synth[]);
 void   Bits2prm_Tetra(Word16 bits[], Word16 prm[]);
 Word16 Dec_Ener(Word16 index, Word16 bfi, Word16 A[], Word16 prd_lt[],
-	    Word16 code[], Word16 L_subfr, Word16 *gain_pit, Word16 *gain_cod);
+	    Word16 code[], Word16 L_subfr, Word16 *gain_pit, Word16 *gain_cod,
+	    Word16 *last_ener_pit, Word16 *last_ener_cod);
 void   D_D4i60(Word16 index,Word16 sign,Word16 shift, Word16 F[], 
 	    Word16 cod[]);
 void   D_Lsp334(Word16 indice[], Word16 lsp[], Word16 old_lsp[]);
@@ -140,8 +193,17 @@ void   Post_Process(Word16 signal[], Word16 lg);
  *-----------------------*/
 
 
-extern Flag Overflow;
-extern Flag Carry;
+/* Overflow and Carry are set by the operators : one copy per thread so  */
+/* that coders and decoders running in parallel don't interfere         */
+
+#if defined(__GNUC__)
+#define TETRA_TLS __thread
+#else
+#define TETRA_TLS _Thread_local
+#endif
+
+extern TETRA_TLS Flag Overflow;
+extern TETRA_TLS Flag Carry;
 
 #define MAX_32 (Word32)0x7fffffff
 #define MIN_32 (Word32)0x80000000
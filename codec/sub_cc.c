@@ -274,18 +274,19 @@ Word16             i, temp1, temp2, temp3;
 *
 **************************************************************************
 *
-*	USAGE				:	Init_Rcpc_Coding(flag,buffer)
-*							(Routine_Name(arg1,arg2))
+*	USAGE				:	Init_Rcpc_Coding(st,flag,buffer)
+*							(Routine_Name(context,arg1,arg2))
 *
 *	ARGUMENT(S)			:
 *
 *		ARG1				:	- Description :	- (flag = 0) : standard mode
 *								- (flag  0) : frame stealing activated*						- Format : Word16**		ARG2				:	- Description : Frame to be encoded*							- Format : 286 * 16 bit-samples**	RETURNED VALUE		:	None**	COMMENTS			:	4 zeroes are concatenated to the input buffer*							to clear the encoder ***************************************************************************/
 
-void	Init_Rcpc_Coding(Word16 FS_Flag, Word16 Input_Frame[])
+void	Init_Rcpc_Coding(Channel_Coder_State *st, Word16 FS_Flag, Word16 Input_Frame[])
 {
 /* Variables */ 
 Word16             i, M;
+Word16             Nber_Info_Bits;
 Word16             Arrival_state;  /* index for Loop on the Lattice States */
 Word16             Starting_state;
 Word16             Msb;    /* Value used for computation of coded bit */
@@ -330,29 +331,29 @@ else {
 /* Number of states in the Viterbi Lattice : */
 M = shl( (Word16)1,(Word16)(K - 1) );
 /* Last State of the Viterbi Lattice */
-M_1 = sub( M,(Word16)1 ); 
+st->M_1 = sub( M,(Word16)1 ); 
 
-Msb_bit = shl( (Word16)1,(Word16)(K - 2) );
-Lsb_bits = Msb_bit - 1;
+st->Msb_bit = shl( (Word16)1,(Word16)(K - 2) );
+Lsb_bits = st->Msb_bit - 1;
 
 
 /* Description of the Lattice : Loop on Arrival_State */
-for (Arrival_state = 0; Arrival_state <= M_1; Arrival_state++) {
+for (Arrival_state = 0; Arrival_state <= st->M_1; Arrival_state++) {
 /* Computation of the MSB for the Arrival State */
-	Msb = Arrival_state & Msb_bit;
+	Msb = Arrival_state & st->Msb_bit;
 /* Computation of the (K - 1)MSBs for the Starting State */
 	Msbs_starting_state = Arrival_state & Lsb_bits;
 	
 /* Loop on Lsb, LSB of the Starting State */
 	for (Lsb = 0; Lsb <= 1; Lsb++) {
 		Starting_state = add( shl( Msbs_starting_state,(Word16)1 ),Lsb );
-		Previous[Arrival_state][Lsb] = Starting_state;
+		st->Previous[Arrival_state][Lsb] = Starting_state;
 /*   TRANSITION BITS T1, T2, T3   */
 		Involved_bits = add(shl( Msb,(Word16)1 ),Starting_state);
 
-		T1[Arrival_state][Lsb] = Combination( Involved_bits,(Word16)G1 );
-		T2[Arrival_state][Lsb] = Combination( Involved_bits,(Word16)G2 );
-		T3[Arrival_state][Lsb] = Combination( Involved_bits,(Word16)G3 );
+		st->T1[Arrival_state][Lsb] = Combination( Involved_bits,(Word16)G1 );
+		st->T2[Arrival_state][Lsb] = Combination( Involved_bits,(Word16)G2 );
+		st->T3[Arrival_state][Lsb] = Combination( Involved_bits,(Word16)G3 );
 	} /* End Loop on Lsb  */
 
 } /* End Loop on Arrival_state */
@@ -450,8 +451,8 @@ return(0);
 *
 **************************************************************************
 *
-*	USAGE				:	Rcpc_Coding(flag,buffer_in,buffer_out)
-*							(Routine_Name(input1,input2,output1))
+*	USAGE				:	Rcpc_Coding(st,flag,buffer_in,buffer_out)
+*							(Routine_Name(context,input1,input2,output1))
 *
 *	INPUT ARGUMENT(S)		:	
 *
@@ -474,7 +475,7 @@ return(0);
 *
 **************************************************************************/
 
-void	Rcpc_Coding(Word16 FS_Flag, Word16 Input_Frame[],
+void	Rcpc_Coding(Channel_Coder_State *st, Word16 FS_Flag, Word16 Input_Frame[],
 			Word16 Output_Frame[])
 {
 /* Variables */
@@ -508,7 +509,7 @@ Coder_state = 0;
 /* Init Number of Coded Bits */
 Nber_coded_bits = 0;  
 
-Msb_bit_div2 = shr( Msb_bit,(Word16)1 );
+Msb_bit_div2 = shr( st->Msb_bit,(Word16)1 );
 
 /*-------------------------------------------------------------------------*/
 /* Coding of Class 1 */
@@ -529,7 +530,7 @@ for (i = 0; i < Size_Class1; i++) {   /* Loop on class 1 */
 	if ((A1[Index_puncturing]) != 0)  
 		{
 #endif
-		Output_Frame[Size_Class0 + Nber_coded_bits] = (T1[Coder_state][Lsb] > 0) ? -127 : 127;
+		Output_Frame[Size_Class0 + Nber_coded_bits] = (st->T1[Coder_state][Lsb] > 0) ? -127 : 127;
 		Nber_coded_bits++;
 #ifdef DEBUG                
 		}
@@ -537,14 +538,14 @@ for (i = 0; i < Size_Class1; i++) {   /* Loop on class 1 */
 /* Second coded bit, if any, per info bit */
 	if ((A1[Index_puncturing + Period_pct]) != 0) 
 		{
-		Output_Frame[Size_Class0 + Nber_coded_bits] = (T2[Coder_state][Lsb] > 0) ? -127 : 127;
+		Output_Frame[Size_Class0 + Nber_coded_bits] = (st->T2[Coder_state][Lsb] > 0) ? -127 : 127;
 		Nber_coded_bits++;
 		}
 #ifdef DEBUG
 /* Third coded bit, if any, per info bit */
 	if ((A1[Index_puncturing + 2*Period_pct]) != 0) 
 		{
-		Output_Frame[Size_Class0 + Nber_coded_bits] = (T3[Coder_state][Lsb] > 0) ? -127 : 127;
+		Output_Frame[Size_Class0 + Nber_coded_bits] = (st->T3[Coder_state][Lsb] > 0) ? -127 : 127;
 		Nber_coded_bits++;
 		}
 #endif
@@ -573,7 +574,7 @@ for (i = 0; i < Size_Class2 + Size_Error_Control + (K - 1); i++) {   /* Loop on
 	if ((A2[Index_puncturing]) != 0)  
 		{
 #endif                
-		Output_Frame[Size_Class0 + Nber_coded_bits] = (T1[Coder_state][Lsb] > 0) ? -127 : 127;
+		Output_Frame[Size_Class0 + Nber_coded_bits] = (st->T1[Coder_state][Lsb] > 0) ? -127 : 127;
 		Nber_coded_bits++;
 #ifdef DEBUG        
 		}
@@ -584,7 +585,7 @@ for (i = 0; i < Size_Class2 + Size_Error_Control + (K - 1); i++) {   /* Loop on
 	if ((A2[Index_puncturing + Period_pct]) != 0) 
 		{
 #endif
-		Output_Frame[Size_Class0 + Nber_coded_bits] = (T2[Coder_state][Lsb] > 0) ? -127 : 127;
+		Output_Frame[Size_Class0 + Nber_coded_bits] = (st->T2[Coder_state][Lsb] > 0) ? -127 : 127;
 		Nber_coded_bits++;
 #ifdef DEBUG        
 		}
@@ -594,7 +595,7 @@ if (!FS_Flag) {
 	if ((A2[Index_puncturing + 2*Period_pct]) != 0) 
 /* Third coded bit, if any, per info bit */
 		{
-		Output_Frame[Size_Class0 + Nber_coded_bits] = (T3[Coder_state][Lsb] > 0) ? -127 : 127;
+		Output_Frame[Size_Class0 + Nber_coded_bits] = (st->T3[Coder_state][Lsb] > 0) ? -127 : 127;
 		Nber_coded_bits++;
 		}
 } /* If FS_Flag */
@@ -602,7 +603,7 @@ else {
 	if ((Fs_A2[Index_puncturing + 2*Period_pct]) != 0) 
 /* Third coded bit, if any, per info bit */
 		{
-		Output_Frame[Size_Class0 + Nber_coded_bits] = (T3[Coder_state][Lsb] > 0) ? -127 : 127;
+		Output_Frame[Size_Class0 + Nber_coded_bits] = (st->T3[Coder_state][Lsb] > 0) ? -127 : 127;
 		Nber_coded_bits++;
 		}
 }
@@ -671,8 +672,8 @@ for (i = 0; i < Size_Class0; i++) {
 *
 **************************************************************************
 *
-*	USAGE				:	Write_Tetra_File(file_pointer,buffer)
-*							(Routine_Name(input1,input2))
+*	USAGE				:	Write_Tetra_File(tf,file_pointer,buffer)
+*							(Routine_Name(context,input1,input2))
 *
 *	INPUT ARGUMENT(S)		:	
 *
@@ -688,10 +689,9 @@ for (i = 0; i < Size_Class0; i++) {
 *
 **************************************************************************/
 
-short           Write_Tetra_File (FILE *fout, short *array)
+short           Write_Tetra_File (Tetra_File *tf, FILE *fout, short *array)
 {
-	static short    initial = 0;
-	static short    block[690];    /* 960 if FFFF filling is included */
+	/* tf->block : 690 samples, 960 if FFFF filling is included */
 	short          *ptr_block;
 	short i;
 
@@ -701,10 +701,10 @@ short           Write_Tetra_File (FILE *fout, short *array)
                  
 
 	/* if first call to this routine, then set up output block */
-        if (initial == 0)
+        if (tf->initial == 0)
           {     
-                initial = 1;
-                ptr_block = block;
+                tf->initial = 1;
+                ptr_block = tf->block;
                 *ptr_block++ = 0x6b21;
 		for (i = 0; i < 114; i++)
 			*ptr_block++ = 0; 
@@ -739,34 +739,34 @@ short           Write_Tetra_File (FILE *fout, short *array)
                 
 /* Fill first valid block */
 
-		ptr_block = block+1;
+		ptr_block = tf->block+1;
 
 		for (i = 0; i < 114; i++)
 			 *ptr_block++ = *array++ & 0x00FF;
 
 /* Fill second valid block */
 
-		ptr_block = block + 161 - 45;
+		ptr_block = tf->block + 161 - 45;
 
 		for (i = 0; i < 114; i++)
 			 *ptr_block++ = *array++ & 0x00FF;
 
 /* Fill third valid block */
 
-		ptr_block = block + 321 - 45 - 45;
+		ptr_block = tf->block + 321 - 45 - 45;
 
 		for (i = 0; i < 114; i++)
 			 *ptr_block++ = *array++ & 0x00FF;
 
 /* Fill fourth valid block */
 
-		ptr_block = block + 481 - 45 - 45 - 45;
+		ptr_block = tf->block + 481 - 45 - 45 - 45;
 
 		for (i = 0; i < 90; i++)
 			 *ptr_block++ = *array++ & 0x00FF;
 
 /* Write out TETRA frame */
-		if (fwrite (block, sizeof (short), 690, fout) != 690)
+		if (fwrite (tf->block, sizeof (short), 690, fout) != 690)
 			return -1;
 
 return 0;
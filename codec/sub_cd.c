@@ -326,8 +326,8 @@ return(0);
 *
 **************************************************************************
 *
-*	USAGE				:	Init_Rcpc_Decoding()
-*							(Routine_Name)
+*	USAGE				:	Init_Rcpc_Decoding(st)
+*							(Routine_Name(context))
 *
 *	ARGUMENT(S)			:	None
 *
@@ -335,7 +335,7 @@ return(0);
 *
 **************************************************************************/
 
-void	Init_Rcpc_Decoding(void)
+void	Init_Rcpc_Decoding(Channel_Decoder_State *st)
 {
 /* Variables */
 Word16             M;
@@ -351,30 +351,30 @@ Word16             Involved_bits;
 /* Number of states in the Viterbi Lattice : */
 M = shl( (Word16)1,(Word16)(K - 1) );
 /* Last State of the Viterbi Lattice */
-M_1 = sub( M,(Word16)1 ); 
+st->M_1 = sub( M,(Word16)1 ); 
 
-Msb_bit = shl( (Word16)1,(Word16)(K - 2) );
-Lsb_bits = Msb_bit - 1;
+st->Msb_bit = shl( (Word16)1,(Word16)(K - 2) );
+Lsb_bits = st->Msb_bit - 1;
 
 
 /* Description of the Lattice : Loop on Arrival_State */
-for (Arrival_state = 0; Arrival_state <= M_1; Arrival_state++) {
+for (Arrival_state = 0; Arrival_state <= st->M_1; Arrival_state++) {
 /* Computation of the MSB for the Arrival State */
-	Msb = Arrival_state & Msb_bit;
+	Msb = Arrival_state & st->Msb_bit;
 /* Computation of the (K - 1)MSBs for the Starting State */
 	Msbs_starting_state = Arrival_state & Lsb_bits;
 	
 /* Loop on Lsb, LSB of the Starting State */
 	for (Lsb = 0; Lsb <= 1; Lsb++) {
 		Starting_state = add(shl( Msbs_starting_state,(Word16)1 ),Lsb);
-		Previous[Arrival_state][Lsb] = Starting_state;
+		st->Previous[Arrival_state][Lsb] = Starting_state;
 
 /*   TRANSITION BITS T1, T2, T3   */
 		Involved_bits = add( shl( Msb,(Word16)1 ),Starting_state );
 
-		T1[Arrival_state][Lsb] = Combination( Involved_bits,(Word16)G1 );
-		T2[Arrival_state][Lsb] = Combination( Involved_bits,(Word16)G2 );
-		T3[Arrival_state][Lsb] = Combination( Involved_bits,(Word16)G3 );
+		st->T1[Arrival_state][Lsb] = Combination( Involved_bits,(Word16)G1 );
+		st->T2[Arrival_state][Lsb] = Combination( Involved_bits,(Word16)G2 );
+		st->T3[Arrival_state][Lsb] = Combination( Involved_bits,(Word16)G3 );
 	} /* End Loop on Lsb  */
 
 } /* End Loop on Arrival_state */
@@ -390,8 +390,8 @@ for (Arrival_state = 0; Arrival_state <= M_1; Arrival_state++) {
 *
 **************************************************************************
 *
-*	USAGE				:	Rcpc_Decoding(flag,buffer_in,buffer_out)
-*							(Routine_Name(input1,input2,output1))
+*	USAGE				:	Rcpc_Decoding(st,flag,buffer_in,buffer_out)
+*							(Routine_Name(context,input1,input2,output1))
 *
 *	INPUT ARGUMENT(S)		:	
 *
@@ -420,7 +420,7 @@ for (Arrival_state = 0; Arrival_state <= M_1; Arrival_state++) {
 *
 **************************************************************************/
 
-void	Rcpc_Decoding(Word16 FS_Flag, Word16 Input_Frame[],
+void	Rcpc_Decoding(Channel_Decoder_State *st, Word16 FS_Flag, Word16 Input_Frame[],
 		Word16 Output_Frame[])
 {
 /* Variables */
@@ -475,9 +475,9 @@ Decoder_ready = 0; /* Decoder not ready yet (Step_bis < Decoding_delay) */
 
 /* Init of the scores (scores of the current Step) */
 /* Starting State 0 is favoured */
-Score[0] = 0;
-for (j = 1; j <= M_1; j++)
-	Score[j] = - 16000;   /* M states */
+st->Score[0] = 0;
+for (j = 1; j <= st->M_1; j++)
+	st->Score[j] = - 16000;   /* M states */
 
 
 /*-------------------------------------------------------------------------*/
@@ -493,35 +493,35 @@ for (index = 0; index < Size_Coded_Class1;) {   /* Loop on coded class 1 */
 	if ((A1[Index_puncturing]) != 0)
 			{
 #endif                        
-			Received[0] = negate( sub( shl( Input_Frame[Size_Class0 +
+			st->Received[0] = negate( sub( shl( Input_Frame[Size_Class0 +
 				index],(Word16)1 ),(Word16)1 ) );
 			index++;
 #ifdef DEBUG        
 			}
 	else
-			Received[0] = 0;
+			st->Received[0] = 0;
 #endif        
 
 	if ((A1[Index_puncturing + Period_pct]) != 0)
 			{
-			Received[1] = negate( sub( shl (Input_Frame[Size_Class0 +
+			st->Received[1] = negate( sub( shl (Input_Frame[Size_Class0 +
 				index],(Word16)1 ),(Word16)1 ) );
 			index++;
 			}
 	else
-			Received[1] = 0;
+			st->Received[1] = 0;
 
 	
 #ifdef DEBUG        
 	if ((A1[Index_puncturing + 2*Period_pct]) != 0)
 			{
-			Received[2] = negate( sub( shl (Input_Frame[Size_Class0 +
+			st->Received[2] = negate( sub( shl (Input_Frame[Size_Class0 +
 				index],(Word16)1 ),(Word16)1 ) );
 			index++;
 			}
 	else
 #endif                        
-			Received[2] = 0;
+			st->Received[2] = 0;
 
 	Index_puncturing++;
 	if (sub( Index_puncturing,(Word16)Period_pct ) == 0)
@@ -536,23 +536,23 @@ for (index = 0; index < Size_Coded_Class1;) {   /* Loop on coded class 1 */
 /*   Computation of the best predecessor of each state and determination
 of the best state */
 	Maximum = -32768;
-	for (j = 0; j <= M_1; j++)        
-		Ex_score[j] = Score[j];
+	for (j = 0; j <= st->M_1; j++)        
+		st->Ex_score[j] = st->Score[j];
 
 /* Loop on the states */
-	for (Arrival_state_sym = ((M_1 + 1)/2); Arrival_state_sym <= M_1; Arrival_state_sym++) {
+	for (Arrival_state_sym = ((st->M_1 + 1)/2); Arrival_state_sym <= st->M_1; Arrival_state_sym++) {
 
 		for (Lsb = 0; Lsb <= 1; Lsb++) {    /* Loop on LSB */
 /* For every state : Estimation of the best predecessor between
 the one of LSB=0 and the one of LSB=1 */ 
-			Essai = Ex_score[Previous[Arrival_state_sym][Lsb]];
+			Essai = st->Ex_score[st->Previous[Arrival_state_sym][Lsb]];
 /* Accumulation of the transition due to the received data */
-			Essai = add( Essai,(Word16)((T1[Arrival_state_sym][Lsb] >
-					0) ? Received[0] : negate(Received[0])) );
-			Essai = add( Essai,(Word16)((T2[Arrival_state_sym][Lsb] >
-					0) ? Received[1] : negate(Received[1])) ); 
-			Essai = add( Essai,(Word16)((T3[Arrival_state_sym][Lsb] >
-					0) ? Received[2] : negate(Received[2])) );
+			Essai = add( Essai,(Word16)((st->T1[Arrival_state_sym][Lsb] >
+					0) ? st->Received[0] : negate(st->Received[0])) );
+			Essai = add( Essai,(Word16)((st->T2[Arrival_state_sym][Lsb] >
+					0) ? st->Received[1] : negate(st->Received[1])) ); 
+			Essai = add( Essai,(Word16)((st->T3[Arrival_state_sym][Lsb] >
+					0) ? st->Received[2] : negate(st->Received[2])) );
 
 /*  Search of the best predecessor (predecessor with the highest score) */
 			if (Lsb == 0) {
@@ -569,9 +569,9 @@ the one of LSB=0 and the one of LSB=1 */
 		} /* Loop on Lsb */
 
 /* The score of the current state is the best among the two (Lsb=0,1) : */
-		Score[Arrival_state_sym] = Chosen_score;
-		Best_previous[Arrival_state_sym][Step] =
-			Previous[Arrival_state_sym][Chosen_lsb];
+		st->Score[Arrival_state_sym] = Chosen_score;
+		st->Best_previous[Arrival_state_sym][Step] =
+			st->Previous[Arrival_state_sym][Chosen_lsb];
 
 /*     Search of the best arrival state */
 		if (sub(Chosen_score,Maximum) > 0) {
@@ -579,19 +579,19 @@ the one of LSB=0 and the one of LSB=1 */
 			Maximum = Chosen_score;
 		}
 
-		Arrival_state = sub( Arrival_state_sym, (Word16)((M_1 + 1)/2) );
+		Arrival_state = sub( Arrival_state_sym, (Word16)((st->M_1 + 1)/2) );
 
 		for (Lsb = 0; Lsb <= 1; Lsb++) {    /* Loop on LSB */
 /* For every state : Estimation of the best predecessor between
 the one of LSB=0 and the one of LSB=1 */ 
-			Essai = Ex_score[Previous[Arrival_state][Lsb]];
+			Essai = st->Ex_score[st->Previous[Arrival_state][Lsb]];
 /* Accumulation of the transition due to the received data */
-			Essai = add( Essai,(Word16)((T1[Arrival_state][Lsb]
-					> 0) ? Received[0] : negate(Received[0])) );
-			Essai = add( Essai,(Word16)((T2[Arrival_state][Lsb]
-					> 0) ? Received[1] : negate(Received[1])) );
-			Essai = add( Essai,(Word16)((T3[Arrival_state][Lsb]
-					> 0) ? Received[2] : negate(Received[2])) );
+			Essai = add( Essai,(Word16)((st->T1[Arrival_state][Lsb]
+					> 0) ? st->Received[0] : negate(st->Received[0])) );
+			Essai = add( Essai,(Word16)((st->T2[Arrival_state][Lsb]
+					> 0) ? st->Received[1] : negate(st->Received[1])) );
+			Essai = add( Essai,(Word16)((st->T3[Arrival_state][Lsb]
+					> 0) ? st->Received[2] : negate(st->Received[2])) );
 
 /*  Search of the best predecessor (predecessor with the highest score) */
 			if (Lsb == 0) {
@@ -608,9 +608,9 @@ the one of LSB=0 and the one of LSB=1 */
 		} /* Loop on Lsb */
 
 /* The score of the current state is the best among the two (Lsb=0,1) : */
-		Score[Arrival_state] = Chosen_score;
-		Best_previous[Arrival_state][Step] =
-			Previous[Arrival_state][Chosen_lsb];
+		st->Score[Arrival_state] = Chosen_score;
+		st->Best_previous[Arrival_state][Step] =
+			st->Previous[Arrival_state][Chosen_lsb];
 
 /*     Search of the best arrival state */
 		if(sub(Chosen_score,Maximum) > 0) { 
@@ -622,8 +622,8 @@ the one of LSB=0 and the one of LSB=1 */
 
 
 /* To avoid overflow, substraction of the highest score */
-	for (j = 0; j <= M_1; j++)
-	      Score[j] = sub(Score[j],Maximum);
+	for (j = 0; j <= st->M_1; j++)
+	      st->Score[j] = sub(st->Score[j],Maximum);
 
 /* Check that the decoder is ready */
 	if (sub( Step,(Word16)(Decoding_delay - 1) ) == 0) Decoder_ready = 1;
@@ -633,7 +633,7 @@ the one of LSB=0 and the one of LSB=1 */
 			Pointer = Step;
 			for (j = 1; j <= Decoding_delay - 1; j++) {
 				Best =
-					Best_previous[Best][Pointer];
+					st->Best_previous[Best][Pointer];
 				Pointer--;
 				if (Pointer < 0)
 					Pointer = Decoding_delay - 1;
@@ -667,47 +667,47 @@ for (index = 0; index < Size_Coded_Class2; ) {   /* Loop on coded class 2 */
 	if ((A2[Index_puncturing]) != 0)
 			{
 #endif                        
-			Received[0] = negate( sub( shl( Input_Frame[Size_Class0 +
+			st->Received[0] = negate( sub( shl( Input_Frame[Size_Class0 +
 				Size_Coded_Class1 + index],(Word16)1 ),(Word16)1 ) );
 			index++;
 #ifdef DEBUG        
 			}
 	else
-			Received[0] = 0;
+			st->Received[0] = 0;
 #endif
 
 #ifdef DEBUG        
 	if ((A2[Index_puncturing + Period_pct]) != 0)
 			{
 #endif
-			Received[1] = negate( sub( shl( Input_Frame[Size_Class0 +
+			st->Received[1] = negate( sub( shl( Input_Frame[Size_Class0 +
 				Size_Coded_Class1 + index],(Word16)1 ),(Word16)1 ) );
 			index++;
 #ifdef DEBUG        
 			}
 	else
-			Received[1] = 0;
+			st->Received[1] = 0;
 #endif
 
 	if (!FS_Flag) {                
 		if ((A2[Index_puncturing + 2*Period_pct]) != 0)
 			{
-			Received[2] = negate( sub( shl( Input_Frame[Size_Class0 +
+			st->Received[2] = negate( sub( shl( Input_Frame[Size_Class0 +
 				Size_Coded_Class1 + index],(Word16)1 ),(Word16)1 ) );
 			index++;
 			}
 		else
-			Received[2] = 0;
+			st->Received[2] = 0;
 	}
 	else {
 		if ((Fs_A2[Index_puncturing + 2*Period_pct]) != 0)
 			{
-			Received[2] = negate( sub( shl( Input_Frame[Size_Class0 +
+			st->Received[2] = negate( sub( shl( Input_Frame[Size_Class0 +
 				Size_Coded_Class1 + index],(Word16)1 ),(Word16)1 ) );
 			index++;
 			}
 		else
-			Received[2] = 0;
+			st->Received[2] = 0;
 	}
 
 	Index_puncturing++;
@@ -722,24 +722,24 @@ for (index = 0; index < Size_Coded_Class2; ) {   /* Loop on coded class 2 */
 /*   Computation of the best predecessor of each state and determination
 of the best state */
 	Maximum = -32768;
-	for (j = 0; j <= M_1; j++)        
-		Ex_score[j] = Score[j];
+	for (j = 0; j <= st->M_1; j++)        
+		st->Ex_score[j] = st->Score[j];
 
 /* Loop on the states */
-	for (Arrival_state_sym = ((M_1 + 1)/2); Arrival_state_sym <= M_1; Arrival_state_sym++) {
+	for (Arrival_state_sym = ((st->M_1 + 1)/2); Arrival_state_sym <= st->M_1; Arrival_state_sym++) {
 
 /* Arrival_state_sym */
 		for (Lsb = 0; Lsb <= 1; Lsb++) {    /* Loop on LSB */
 /* For every state : Estimation of the best predecessor between
 the one of LSB=0 and the one of LSB=1 */ 
-			Essai = Ex_score[Previous[Arrival_state_sym][Lsb]];
+			Essai = st->Ex_score[st->Previous[Arrival_state_sym][Lsb]];
 /* Accumulation of the transition due to the received data */
-			Essai = add( Essai,(Word16)((T1[Arrival_state_sym][Lsb] >
-				0) ? Received[0] : negate(Received[0])) );
-			Essai = add( Essai,(Word16)((T2[Arrival_state_sym][Lsb] >
-				0) ? Received[1] : negate(Received[1])) ); 
-			Essai = add( Essai,(Word16)((T3[Arrival_state_sym][Lsb] >
-				0) ? Received[2] : negate(Received[2])) );
+			Essai = add( Essai,(Word16)((st->T1[Arrival_state_sym][Lsb] >
+				0) ? st->Received[0] : negate(st->Received[0])) );
+			Essai = add( Essai,(Word16)((st->T2[Arrival_state_sym][Lsb] >
+				0) ? st->Received[1] : negate(st->Received[1])) ); 
+			Essai = add( Essai,(Word16)((st->T3[Arrival_state_sym][Lsb] >
+				0) ? st->Received[2] : negate(st->Received[2])) );
 
 /*  Search of the best predecessor (predecessor with the highest score) */
 			if (Lsb == 0) {
@@ -757,9 +757,9 @@ the one of LSB=0 and the one of LSB=1 */
 		} /* Loop on Lsb */
 
 /* The score of the current state is the best among the two (Lsb=0,1) : */
-		Score[Arrival_state_sym] = Chosen_score;
-		Best_previous[Arrival_state_sym][Step] =
-			Previous[Arrival_state_sym][Chosen_lsb];
+		st->Score[Arrival_state_sym] = Chosen_score;
+		st->Best_previous[Arrival_state_sym][Step] =
+			st->Previous[Arrival_state_sym][Chosen_lsb];
 
 		if (sub(Chosen_score,Maximum) > 0) {
 			Best = Arrival_state_sym;
@@ -767,19 +767,19 @@ the one of LSB=0 and the one of LSB=1 */
 		}
 
 
-		Arrival_state = sub( Arrival_state_sym,(Word16)((M_1 + 1)/2) );
+		Arrival_state = sub( Arrival_state_sym,(Word16)((st->M_1 + 1)/2) );
 
 		for (Lsb = 0; Lsb <= 1; Lsb++) {    /* Loop on LSB */
 /* For every state : Estimation of the best predecessor between
 the one of LSB=0 and the one of LSB=1 */ 
-			Essai = Ex_score[Previous[Arrival_state][Lsb]];
+			Essai = st->Ex_score[st->Previous[Arrival_state][Lsb]];
 /* Accumulation of the transition due to the received data */
-			Essai = add( Essai,(Word16)((T1[Arrival_state][Lsb] > 0) ?
-				Received[0] : negate(Received[0])) );
-			Essai = add( Essai,(Word16)((T2[Arrival_state][Lsb] > 0) ?
-				Received[1] : negate(Received[1])) );
-			Essai = add( Essai,(Word16)((T3[Arrival_state][Lsb] > 0) ?
-				Received[2] : negate(Received[2])) );
+			Essai = add( Essai,(Word16)((st->T1[Arrival_state][Lsb] > 0) ?
+				st->Received[0] : negate(st->Received[0])) );
+			Essai = add( Essai,(Word16)((st->T2[Arrival_state][Lsb] > 0) ?
+				st->Received[1] : negate(st->Received[1])) );
+			Essai = add( Essai,(Word16)((st->T3[Arrival_state][Lsb] > 0) ?
+				st->Received[2] : negate(st->Received[2])) );
 
 /*  Search of the best predecessor (predecessor with the highest score) */
 			if (Lsb == 0) {
@@ -796,9 +796,9 @@ the one of LSB=0 and the one of LSB=1 */
 		} /* Loop on Lsb */
 
 /* The score of the current state is the best among the two (Lsb=0,1) : */
-		Score[Arrival_state] = Chosen_score;
-		Best_previous[Arrival_state][Step] =
-			Previous[Arrival_state][Chosen_lsb];
+		st->Score[Arrival_state] = Chosen_score;
+		st->Best_previous[Arrival_state][Step] =
+			st->Previous[Arrival_state][Chosen_lsb];
 
 /*     Search of the best arrival state */
 		if (sub(Chosen_score,Maximum) > 0) { 
@@ -808,8 +808,8 @@ the one of LSB=0 and the one of LSB=1 */
 	} /* Loop on the states */
 
 /* To avoid overflow, substraction of the highest score */
-	for (j = 0; j <= M_1; j++)
-		Score[j] = sub(Score[j],Maximum);
+	for (j = 0; j <= st->M_1; j++)
+		st->Score[j] = sub(st->Score[j],Maximum);
 
 /* Check that the decoder is ready */
 /*------------------------------------------------------------------------*/
@@ -830,7 +830,7 @@ the one of LSB=0 and the one of LSB=1 */
 				Output_Frame[Size_Class0 + Pointer_bis] =
 					extract_h(L_temp);
 				Best =
-					Best_previous[Best][Pointer];
+					st->Best_previous[Best][Pointer];
 				Nber_decoded_bits++;
 				Pointer_bis--;
 				Pointer--;
@@ -847,7 +847,7 @@ the one of LSB=0 and the one of LSB=1 */
 			Pointer = Step;
 			for (j = 1; j <= Decoding_delay - 1; j++) {
 				Best =
-					Best_previous[Best][Pointer];
+					st->Best_previous[Best][Pointer];
 				Pointer--;
 				if (Pointer < 0)
 					Pointer = Decoding_delay - 1;
@@ -876,8 +876,8 @@ the one of LSB=0 and the one of LSB=1 */
 *
 **************************************************************************
 *
-*	USAGE				:	Read_Tetra_File(file_pointer,buffer)
-*							(Routine_Name(input1,output1))
+*	USAGE				:	Read_Tetra_File(tf,file_pointer,buffer)
+*							(Routine_Name(context,input1,output1))
 *
 *	INPUT ARGUMENT(S)		:	
 *
@@ -895,10 +895,8 @@ the one of LSB=0 and the one of LSB=1 */
 *
 **************************************************************************/
 
-short           Read_Tetra_File (FILE *fin, short *array)
+short           Read_Tetra_File (Tetra_File *tf, FILE *fin, short *array)
 {
-	static short    initial = 0;
-	static short    block[690];
 	short          *ptr_block;
 	short i; 
 	short *start_of_array;
@@ -909,20 +907,20 @@ short           Read_Tetra_File (FILE *fin, short *array)
 	start_of_array = array; 
 
 	/* if first call to this routine, then skip past any header */
-	if (initial == 0)
+	if (tf->initial == 0)
 	  {     
-		while (*block != 0x6b21)
+		while (*tf->block != 0x6b21)
 		{
-		if (fread (block, sizeof (short), 1, fin) != 1)
+		if (fread (tf->block, sizeof (short), 1, fin) != 1)
 			return -1;
 		}
-		initial = 1;
-		if (fread (block+1, sizeof (short), 689, fin) != 689)
+		tf->initial = 1;
+		if (fread (tf->block+1, sizeof (short), 689, fin) != 689)
 			return -1;
 
 	  } else    /* Read in TETRA frame */
 	  {
-		if (fread (block, sizeof (short), 690, fin) != 690)
+		if (fread (tf->block, sizeof (short), 690, fin) != 690)
 			return -1;
 	  }          
 				
@@ -930,7 +928,7 @@ short           Read_Tetra_File (FILE *fin, short *array)
 
 /* Copy first valid block */
 
-		ptr_block = block+1;
+		ptr_block = tf->block+1;
 
 		for (i = 0; i < 114; i++)
 			*array++ = *ptr_block++;
@@ -938,21 +936,21 @@ short           Read_Tetra_File (FILE *fin, short *array)
 
 /* Copy second valid block */
 
-		ptr_block = block + 161 - 45;
+		ptr_block = tf->block + 161 - 45;
 
 		for (i = 0; i < 114; i++)
 			*array++ = *ptr_block++;
 
 /* Copy third valid block */
 
-		ptr_block = block + 321 - 45 - 45;
+		ptr_block = tf->block + 321 - 45 - 45;
 
 		for (i = 0; i < 114; i++)
 			*array++ = *ptr_block++;
 
 /* Copy fourth valid block */
 
-		ptr_block = block + 481 - 45 - 45 - 45;
+		ptr_block = tf->block + 481 - 45 - 45 - 45;
 
 		for (i = 0; i < 90; i++)
 			*array++ = *ptr_block++;
@@ -88,8 +88,6 @@ void Autocorr(Word16 x[], Word16 p, Word16 r_h[], Word16 r_l[])
   Word16 y[L_window];
   Word32 sum;
 
-  extern Flag Overflow;
-
   /* Windowing of signal */
 
   for(i=0; i<L_window; i++)
@@ -742,8 +740,8 @@ void Lag_Window(Word16 p, Word16 r_h[], Word16 r_l[])
 *
 **************************************************************************
 *
-*	USAGE				:	Levin_32(buffer_in1,buffer_in2,buffer_out)
-*							(Routine_Name(input1,input2,output1))
+*	USAGE				:	Levin_32(buffer_in1,buffer_in2,buffer_out,old_A)
+*							(Routine_Name(input1,input2,output1,arg1))
 *
 *	INPUT ARGUMENT(S)		:	
 *
@@ -758,6 +756,10 @@ void Lag_Window(Word16 p, Word16 r_h[], Word16 r_l[])
 *		OUTPUT1			:	- Description : LPC coefficients
 *							- Format : Word16 - Q12
 *
+*	ARG1				:	- Description : Last stable LPC coefficients, used
+*							  when the filter is unstable (coder context, updated)
+*							- Format : Word16 - Q12 - 11 values
+*
 *	RETURNED VALUE		:	None
 *
 *	COMMENTS			:	Algorithm :
@@ -817,11 +819,9 @@ void Lag_Window(Word16 p, Word16 r_h[], Word16 r_l[])
 *
 **************************************************************************/
 
-/* Last A(z) for case of unstable filter */
-
-static Word16 old_A[pp+1]={4096,0,0,0,0,0,0,0,0,0,0};
+/* Last A(z) for case of unstable filter is kept by the caller (old_A[]) */
 
-void Levin_32(Word16 Rh[], Word16 Rl[], Word16 A[])
+void Levin_32(Word16 Rh[], Word16 Rl[], Word16 A[], Word16 old_A[])
 {
  Word16 i, j;
  Word16 hi, lo;
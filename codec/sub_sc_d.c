@@ -230,8 +230,8 @@ void Cal_Rr2(Word16 h[], Word16 *rr)
 *
 **************************************************************************
 *
-*	USAGE				:	Clsp_334(buffer_in,buffer_out1,buffer_out2)
-*							(Routine_Name(input1,output1,output2))
+*	USAGE				:	Clsp_334(buffer_in,buffer_out1,buffer_out2,lsp_old)
+*							(Routine_Name(input1,output1,output2,arg1))
 *
 *	INPUT ARGUMENT(S)		:	
 *
@@ -247,22 +247,22 @@ void Cal_Rr2(Word16 h[], Word16 *rr)
 *								          codebook entries
 *							- Format : Word16
 *
+*		ARG1				:	- Description : Last quantized LSPs in order, used
+*							  when lsp_q[] are not (coder context, updated)
+*							- Format : Word16 - Q15
+*
 *	RETURNED VALUE		:	None
 *
 *
 **************************************************************************/
 
-void Clsp_334(Word16 *lsp, Word16 *lsp_q, Word16 *indice)
+void Clsp_334(Word16 *lsp, Word16 *lsp_q, Word16 *indice, Word16 *lsp_old)
 {
 
  Word16 i, j, ind, temp;
  Word16 *p_dico;
  Word32 min, dist;
 
- static Word16 lsp_old[10]={
-               30000, 26000, 21000, 15000, 8000, 0,
-	 	  -8000,-15000,-21000,-26000};
-
 
 /* Search dico1  lsp[0]-lsp[2] */
 
@@ -424,15 +424,17 @@ void Clsp_334(Word16 *lsp, Word16 *lsp_q, Word16 *indice)
 *		OUTPUT2			:	- Description : Quantized code gain
 *							- Format : Word16
 *
+*		ARG7, ARG8			:	- Description : Past quantized energies
+*							  (decoder context, updated)
+*							- Format : Word16
+*
 *	RETURNED VALUE		:	Index of energy quantizer
 *
 **************************************************************************/
 
-  extern Word16 last_ener_pit;
-  extern Word16 last_ener_cod;
-
 Word16 Dec_Ener(Word16 index, Word16 bfi, Word16 A[], Word16 prd_lt[],
-          Word16 code[], Word16 L_subfr, Word16 *gain_pit, Word16 *gain_cod)
+          Word16 code[], Word16 L_subfr, Word16 *gain_pit, Word16 *gain_cod,
+          Word16 *last_ener_pit, Word16 *last_ener_cod)
 {
 
   Word16  i, j;
@@ -524,11 +526,11 @@ Word16 Dec_Ener(Word16 index, Word16 bfi, Word16 A[], Word16 prd_lt[],
 
    if(bfi != 0)
    {
-     last_ener_pit = sub(last_ener_pit, (Word16)128);	/* -0.5 in Q8 */
-     if(last_ener_pit < 0) last_ener_pit = 0;
+     *last_ener_pit = sub(*last_ener_pit, (Word16)128);	/* -0.5 in Q8 */
+     if(*last_ener_pit < 0) *last_ener_pit = 0;
 
-     last_ener_cod = sub(last_ener_cod, (Word16)128);	/* -0.5 in Q8 */
-     if(last_ener_cod < 0) last_ener_cod = 0;
+     *last_ener_cod = sub(*last_ener_cod, (Word16)128);	/* -0.5 in Q8 */
+     if(*last_ener_cod < 0) *last_ener_cod = 0;
    }
    else
    {
@@ -539,8 +541,8 @@ Word16 Dec_Ener(Word16 index, Word16 bfi, Word16 A[], Word16 prd_lt[],
       *  if(pred_pit < 0.0) pred_pit = 0.0;                             *
       *-----------------------------------------------------------------*/
 
-     L_tmp = Load_sh(last_ener_pit, (Word16)8);	/* .5 last_ener_pit in Q9  */
-     L_tmp = add_sh(L_tmp,last_ener_cod, (Word16)7); /*+.25 last_ener_code 
+     L_tmp = Load_sh(*last_ener_pit, (Word16)8);	/* .5 last_ener_pit in Q9  */
+     L_tmp = add_sh(L_tmp,*last_ener_cod, (Word16)7); /*+.25 last_ener_code 
 											in Q9    */
      L_tmp = sub_sh(L_tmp, (Word16)768, (Word16)9); /* -3.0 in Q9          */
      if(L_tmp < 0) L_tmp = 0;
@@ -552,8 +554,8 @@ Word16 Dec_Ener(Word16 index, Word16 bfi, Word16 A[], Word16 prd_lt[],
       *  if(pred_cod < 0.0) pred_cod = 0.0;                             *
       *-----------------------------------------------------------------*/
 
-     L_tmp = Load_sh(last_ener_cod, (Word16)8);	/* .5 last_ener_cod in Q9  */
-     L_tmp = add_sh(L_tmp, last_ener_pit, (Word16)7); /*+.25 last_ener_pit 
+     L_tmp = Load_sh(*last_ener_cod, (Word16)8);	/* .5 last_ener_cod in Q9  */
+     L_tmp = add_sh(L_tmp, *last_ener_pit, (Word16)7); /*+.25 last_ener_pit 
 											in Q9    */
      L_tmp = sub_sh(L_tmp, (Word16)768, (Word16)9); /* -3.0 in Q9          */
      if(L_tmp < 0) L_tmp = 0;
@@ -564,14 +566,14 @@ Word16 Dec_Ener(Word16 index, Word16 bfi, Word16 A[], Word16 prd_lt[],
       *-----------------------------------------------------------------*/
 
      j = shl(index, (Word16)1);
-     last_ener_pit = add(t_qua_ener[j],   pred_pit);
-     last_ener_cod = add(t_qua_ener[j+1], pred_cod);
+     *last_ener_pit = add(t_qua_ener[j],   pred_pit);
+     *last_ener_cod = add(t_qua_ener[j+1], pred_cod);
 
      /* Limit energies ->for transmission errors */
 
-     if(sub(last_ener_pit, (Word16)6912)>0)last_ener_pit = 6912; 
+     if(sub(*last_ener_pit, (Word16)6912)>0)*last_ener_pit = 6912; 
 									/* 6912 = 27 in Q8 */
-     if(sub(last_ener_cod, (Word16)6400)>0)last_ener_cod = 6400; 
+     if(sub(*last_ener_cod, (Word16)6400)>0)*last_ener_cod = 6400; 
 									/* 6400 = 25 in Q8 */
   }
 
@@ -587,7 +589,7 @@ Word16 Dec_Ener(Word16 index, Word16 bfi, Word16 A[], Word16 prd_lt[],
    *                                                   *
    *---------------------------------------------------*/
 
-  L_tmp = Load_sh(last_ener_pit, (Word16)6);	 /* last_ener_pit/2 in Q15 */
+  L_tmp = Load_sh(*last_ener_pit, (Word16)6);	 /* last_ener_pit/2 in Q15 */
   L_tmp = sub_sh(L_tmp, ener_plt, (Word16)6);	 /* - ener_plt/2    in Q15 */
   L_tmp = add_sh(L_tmp, (Word16)12, (Word16)15); /* to have gain in Q12    */
   L_extract(L_tmp, &exp, &frac);
@@ -604,7 +606,7 @@ Word16 Dec_Ener(Word16 index, Word16 bfi, Word16 A[], Word16 prd_lt[],
    *                                                   *
    *---------------------------------------------------*/
 
-  L_tmp = Load_sh(last_ener_cod, (Word16)6);	/* last_ener_cod/2 in Q15 */
+  L_tmp = Load_sh(*last_ener_cod, (Word16)6);	/* last_ener_cod/2 in Q15 */
   L_tmp = sub_sh(L_tmp, ener_c, (Word16)6);	/* - ener_c/2      in Q15 */
   L_extract(L_tmp, &exp, &frac);
   L_tmp = pow2(exp, frac);
@@ -1257,15 +1259,17 @@ void D_Lsp334(Word16 indice[], Word16 lsp[], Word16 lsp_old[])
 *		ARG6				:	- Description : Quantized code gain
 *							- Format : Word16
 *
+*		ARG7, ARG8			:	- Description : Past quantized energies
+*							  (coder context, updated)
+*							- Format : Word16
+*
 *	RETURNED VALUE		:	Index of quantization
 *
 **************************************************************************/
 
-  extern Word16 last_ener_pit;
-  extern Word16 last_ener_cod;
-
 Word16 Ener_Qua(Word16 A[], Word16 prd_lt[], Word16 code[], Word16 L_subfr,
-                Word16 *gain_pit, Word16 *gain_cod)
+                Word16 *gain_pit, Word16 *gain_cod, Word16 *last_ener_pit,
+                Word16 *last_ener_cod)
 {
 
   Word16  i, j, index, tmp, *p;
@@ -1396,8 +1400,8 @@ Word16 Ener_Qua(Word16 A[], Word16 prd_lt[], Word16 code[], Word16 L_subfr,
    *  err_pit = ener_pit - pred_pit;                                 *
    *-----------------------------------------------------------------*/
 
-  L_tmp = Load_sh(last_ener_pit, (Word16)8); /* .5 last_ener_pit in Q9     */
-  L_tmp = add_sh(L_tmp, last_ener_cod, (Word16)7); /*+.25 last_ener_code 
+  L_tmp = Load_sh(*last_ener_pit, (Word16)8); /* .5 last_ener_pit in Q9     */
+  L_tmp = add_sh(L_tmp, *last_ener_cod, (Word16)7); /*+.25 last_ener_code 
 											in Q9    */
   L_tmp = sub_sh(L_tmp, (Word16)768, (Word16)9); /* -3.0 in Q9             */
   if(L_tmp < 0) L_tmp = 0;
@@ -1412,8 +1416,8 @@ Word16 Ener_Qua(Word16 A[], Word16 prd_lt[], Word16 code[], Word16 L_subfr,
    *  err_cod = ener_cod - pred_cod;                                 *
    *-----------------------------------------------------------------*/
 
-  L_tmp = Load_sh(last_ener_cod, (Word16)8); /* .5 last_ener_cod  in Q9    */
-  L_tmp = add_sh(L_tmp, last_ener_pit, (Word16)7); /*+.25 last_ener_pit
+  L_tmp = Load_sh(*last_ener_cod, (Word16)8); /* .5 last_ener_cod  in Q9    */
+  L_tmp = add_sh(L_tmp, *last_ener_pit, (Word16)7); /*+.25 last_ener_pit
 											in Q9    */
   L_tmp = sub_sh(L_tmp, (Word16)768, (Word16)9); /* -3.0 in Q9             */
   if(L_tmp < 0) L_tmp = 0;
@@ -1445,14 +1449,14 @@ Word16 Ener_Qua(Word16 A[], Word16 prd_lt[], Word16 code[], Word16 L_subfr,
   }
 
   j = shl(index, (Word16)1);
-  last_ener_pit = add(t_qua_ener[j],   pred_pit);
-  last_ener_cod = add(t_qua_ener[j+1], pred_cod);
+  *last_ener_pit = add(t_qua_ener[j],   pred_pit);
+  *last_ener_cod = add(t_qua_ener[j+1], pred_cod);
 
   /* Limit energies ->for transmission errors */
 
-  if(sub(last_ener_pit, (Word16)6912) > 0) last_ener_pit = 6912;
+  if(sub(*last_ener_pit, (Word16)6912) > 0) *last_ener_pit = 6912;
 									/* 6912 = 27 in Q8 */
-  if(sub(last_ener_cod, (Word16)6400) > 0) last_ener_cod = 6400;
+  if(sub(*last_ener_cod, (Word16)6400) > 0) *last_ener_cod = 6400;
 									/* 6400 = 25 in Q8 */
 
   /*---------------------------------------------------*
@@ -1466,7 +1470,7 @@ Word16 Ener_Qua(Word16 A[], Word16 prd_lt[], Word16 code[], Word16 L_subfr,
    *                                                   *
    *---------------------------------------------------*/
 
-  L_tmp = Load_sh(last_ener_pit, (Word16)6);	/* last_ener_pit/2 in Q15 */
+  L_tmp = Load_sh(*last_ener_pit, (Word16)6);	/* last_ener_pit/2 in Q15 */
   L_tmp = sub_sh(L_tmp, ener_plt, (Word16)6);	/* - ener_plt/2    in Q15 */
   L_tmp = add_sh(L_tmp, (Word16)12, (Word16)15); /* to have gain in Q12   */
   L_extract(L_tmp, &exp, &frac);
@@ -1484,7 +1488,7 @@ Word16 Ener_Qua(Word16 A[], Word16 prd_lt[], Word16 code[], Word16 L_subfr,
    *                                                   *
    *---------------------------------------------------*/
 
-  L_tmp = Load_sh(last_ener_cod, (Word16)6);	/* last_ener_cod/2 in Q15 */
+  L_tmp = Load_sh(*last_ener_cod, (Word16)6);	/* last_ener_cod/2 in Q15 */
   L_tmp = sub_sh(L_tmp, ener_c, (Word16)6);	/* - ener_c/2      in Q15 */
   L_extract(L_tmp, &exp, &frac);
   L_tmp = pow2(exp, frac);
@@ -2484,39 +2488,37 @@ void Pred_Lt(Word16 exc[], Word16 T0, Word16 frac, Word16 L_subfr)
 *
 **************************************************************************/
 
-/* Static values to be preserved between calls */
-
-static Word16 y_hi, y_lo, x0;
+/* Values preserved between calls are in the coder context (y_hi, y_lo, x0) */
 
-/* Initialization of static values */
+/* Initialization of preserved values */
 
-void Init_Pre_Process(void)
+void Init_Pre_Process(Coder_State *st)
 {
-  y_hi = 0;
-  y_lo = 0;
-  x0   = 0;
+  st->y_hi = 0;
+  st->y_lo = 0;
+  st->x0   = 0;
 }
 
 
 /* Offset compensation and divide by 2 */
 
-void Pre_Process(Word16 signal[], Word16 lg)
+void Pre_Process(Coder_State *st, Word16 signal[], Word16 lg)
 {
   Word16 i, x1;
   Word32 L_tmp;
 
   for(i=0; i<lg; i++)
   {
-     x1 = x0;
-     x0 = signal[i];
+     x1 = st->x0;
+     st->x0 = signal[i];
 
-     L_tmp     = Load_sh(x0, (Word16)15);
+     L_tmp     = Load_sh(st->x0, (Word16)15);
      L_tmp     = sub_sh(L_tmp, x1, (Word16)15);
-     L_tmp     = L_mac(L_tmp, y_hi, (Word16)32735);
-     L_tmp     = add_sh(L_tmp, mult(y_lo, (Word16)32735), (Word16)1);
+     L_tmp     = L_mac(L_tmp, st->y_hi, (Word16)32735);
+     L_tmp     = add_sh(L_tmp, mult(st->y_lo, (Word16)32735), (Word16)1);
      signal[i] = extract_h(L_tmp);
-     y_hi      = extract_h(L_tmp);
-     y_lo      = extract_l(sub_sh(L_shr( L_tmp,(Word16)1 ), y_hi, (Word16)15));
+     st->y_hi      = extract_h(L_tmp);
+     st->y_lo      = extract_l(sub_sh(L_shr( L_tmp,(Word16)1 ), st->y_hi, (Word16)15));
   }
   return;
 }
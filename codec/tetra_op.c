@@ -63,8 +63,8 @@ Word16 sature(Word32 L_var1);
  * Constants and Globals *
  *-----------------------*/
 
-Flag Overflow =0;
-Flag Carry =0;
+TETRA_TLS Flag Overflow =0;
+TETRA_TLS Flag Carry =0;
 
 
 /************************************************************************
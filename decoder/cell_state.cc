@@ -0,0 +1,207 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "tetra_dl.h"
+#include "utils.h"
+
+static const char CELL_STATE_MAGIC[8] = {'T', 'K', 'C', 'E', 'L', 'L', '0', '1'};
+static const int  HYPERFRAME_SLOTS    = 60 * 18 * 4;                            // TDMA time wraps every hyperframe
+
+/**
+ * @brief Wall clock time, TDMA time estimate must survive a restart
+ *
+ */
+
+static uint64_t wall_clock_ns()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Slot index in hyperframe from TDMA time
+ *
+ */
+
+static int slot_index(const tetra_time_t & time)
+{
+    return ((time.mn - 1) * 18 + (time.fn - 1)) * 4 + (time.tn - 1);
+}
+
+/**
+ * @brief Save cell state snapshot, the file is replaced atomically
+ *
+ * Nothing is saved until cell informations are acquired so a good
+ * snapshot is not overwritten by a decoder which never synchronized.
+ *
+ * @return true if saved
+ *
+ */
+
+bool tetra_dl::cell_state_save(const char * filename)
+{
+    if (!g_cell_informations_acquired)
+    {
+        return false;
+    }
+
+    cell_state_t state;
+    memset(&state, 0, sizeof(cell_state_t));
+
+    memcpy(state.magic, CELL_STATE_MAGIC, sizeof(state.magic));
+    state.record_size = sizeof(cell_state_t);
+    state.cell        = g_cell_infos;
+    state.time        = g_time;
+    state.time_ns     = wall_clock_ns();
+    memcpy(state.usage_marker_encryption_mode, usage_marker_encryption_mode, sizeof(state.usage_marker_encryption_mode));
+
+    std::string tmp_filename = std::string(filename) + ".tmp";
+
+    FILE * file = fopen(tmp_filename.c_str(), "wb");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    bool ok_flag = (fwrite(&state, sizeof(cell_state_t), 1, file) == 1);
+    ok_flag = (fclose(file) == 0) && ok_flag;
+
+    if (ok_flag)
+    {
+        ok_flag = (rename(tmp_filename.c_str(), filename) == 0);
+    }
+
+    return ok_flag;
+}
+
+/**
+ * @brief Load cell state snapshot for warm start
+ *
+ * Scrambling code, frequency and encryption modes are restored so
+ * normal bursts are decoded before the first SYNC is received. TDMA
+ * time is advanced by the time elapsed since the snapshot. All of this
+ * remains an assumption until checked by cell_state_validate().
+ *
+ * @return true if loaded
+ *
+ */
+
+bool tetra_dl::cell_state_load(const char * filename)
+{
+    FILE * file = fopen(filename, "rb");
+    if (file == NULL)                                                           // first start, nothing to load
+    {
+        return false;
+    }
+
+    cell_state_t state;
+    bool ok_flag = (fread(&state, sizeof(cell_state_t), 1, file) == 1);
+    fclose(file);
+
+    if (!ok_flag || (memcmp(state.magic, CELL_STATE_MAGIC, sizeof(state.magic)) != 0) || (state.record_size != sizeof(cell_state_t)))
+    {
+        log_printf(LOG_ERROR, "Invalid cell state file '%s', ignored\n", filename);
+        return false;
+    }
+
+    g_cell_infos = state.cell;
+    calculate_scrambling_code();
+
+    if ((g_cell_infos.scrambling_code != state.cell.scrambling_code) || (state.time.tn < 1) || (state.time.tn > 4) ||
+        (state.time.fn < 1) || (state.time.fn > 18) || (state.time.mn < 1) || (state.time.mn > 60))
+    {
+        log_printf(LOG_ERROR, "Inconsistent cell state file '%s', ignored\n", filename);
+        g_cell_infos.mcc                = 0;
+        g_cell_infos.mnc                = 0;
+        g_cell_infos.color_code         = 0;
+        g_cell_infos.scrambling_code    = 0;
+        g_cell_infos.downlink_frequency = 0;
+        g_cell_infos.uplink_frequency   = 0;
+        return false;
+    }
+
+    for (int idx = 0; idx < 64; idx++)
+    {
+        usage_marker_encryption_mode[idx] = state.usage_marker_encryption_mode[idx] & 0x03;
+    }
+
+    uint64_t now_ns = wall_clock_ns();
+    int slot = slot_index(state.time);
+
+    if (now_ns > state.time_ns)                                                 // TDMA slot is 85/6 ms
+    {
+        slot = (int)((slot + (now_ns - state.time_ns) * 6 / 85000000) % HYPERFRAME_SLOTS);
+    }
+
+    g_time.tn = slot % 4 + 1;
+    g_time.fn = (slot / 4) % 18 + 1;
+    g_time.mn = slot / (4 * 18) + 1;
+
+    g_cell_state         = state;
+    g_cell_state_pending = true;
+
+    log_printf(LOG_SYNC, "* warm start    : MCC/MNC = %3u/ %3u  ColorCode=%3u  Freq= %10.6f MHz  TN/FN/MN = %2u/%2u/%2u (estimated)\n",
+               g_cell_infos.mcc,
+               g_cell_infos.mnc,
+               g_cell_infos.color_code,
+               g_cell_infos.downlink_frequency / 1.0e6,
+               g_time.tn,
+               g_time.fn,
+               g_time.mn);
+
+    return true;
+}
+
+/**
+ * @brief Check loaded cell state against the first SYNC received
+ *
+ * If the cell changed, encryption modes and frequency of the old cell
+ * are forgotten. Cell informations and TDMA time were already updated
+ * from SYNC by the caller.
+ *
+ */
+
+void tetra_dl::cell_state_validate(const tetra_time_t & estimate)
+{
+    g_cell_state_pending = false;
+
+    if ((g_cell_infos.mcc == g_cell_state.cell.mcc) && (g_cell_infos.mnc == g_cell_state.cell.mnc) && (g_cell_infos.color_code == g_cell_state.cell.color_code))
+    {
+        int offset = (slot_index(g_time) - slot_index(estimate) + HYPERFRAME_SLOTS) % HYPERFRAME_SLOTS;
+        if (offset > HYPERFRAME_SLOTS / 2)                                      // shortest way around the hyperframe
+        {
+            offset -= HYPERFRAME_SLOTS;
+        }
+
+        log_printf(LOG_SYNC, "* warm start    : confirmed by SYNC, TDMA time estimate was %d slots off\n", offset);
+    }
+    else
+    {
+        log_printf(LOG_SYNC, "* warm start    : cell changed, MCC/MNC = %3u/ %3u  ColorCode=%3u  cell state discarded\n",
+                   g_cell_infos.mcc,
+                   g_cell_infos.mnc,
+                   g_cell_infos.color_code);
+
+        for (int idx = 0; idx < 64; idx++)
+        {
+            usage_marker_encryption_mode[idx] = 0;
+        }
+
+        g_cell_infos.downlink_frequency = 0;                                    // until next SYSINFO
+        g_cell_infos.uplink_frequency   = 0;
+    }
+}
@@ -26,10 +26,9 @@
 
 void tetra_dl::service_cmce(std::vector<uint8_t> pdu, mac_logical_channel_t mac_logical_channel)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - mac_channel = %s pdu = %s\n", "service_cmce", mac_logical_channel_name(mac_logical_channel).c_str(), vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - mac_channel = %s pdu = %s\n", "service_cmce", mac_logical_channel_name(mac_logical_channel).c_str(), vector_to_string(pdu, pdu.size()).c_str());
     }
 
     uint8_t pdu_type;
@@ -185,26 +184,26 @@ void tetra_dl::service_cmce(std::vector<uint8_t> pdu, mac_logical_channel_t mac_
 
     if (b_complete_print_flag)
     {
-        printf("service_cmce: TN/FN/MN = %2d/%2d/%2d  %-20s  len=%3lu  cid=%u  ssi=%8u  usage_marker=%2u, encr=%u\n",
-               g_time.tn,
-               g_time.fn,
-               g_time.mn,
-               txt.c_str(),
-               pdu.size(),
-               cid,
-               mac_address.ssi,
-               mac_address.usage_marker,
-               mac_address.encryption_mode
-            );
+        log_printf(LOG_CMCE, "service_cmce: TN/FN/MN = %2d/%2d/%2d  %-20s  len=%3lu  cid=%u  ssi=%8u  usage_marker=%2u, encr=%u\n",
+                   g_time.tn,
+                   g_time.fn,
+                   g_time.mn,
+                   txt.c_str(),
+                   pdu.size(),
+                   cid,
+                   mac_address.ssi,
+                   mac_address.usage_marker,
+                   mac_address.encryption_mode
+                );
     }
     else
     {
-        printf("ser_cmce_sds: TN/FN/MN = %2d/%2d/%2d  %-20s  len=%3lu \n",
-               g_time.tn,
-               g_time.fn,
-               g_time.mn,
-               txt.c_str(),
-               pdu.size());
+        log_printf(LOG_CMCE, "ser_cmce_sds: TN/FN/MN = %2d/%2d/%2d  %-20s  len=%3lu \n",
+                   g_time.tn,
+                   g_time.fn,
+                   g_time.mn,
+                   txt.c_str(),
+                   pdu.size());
     }
 }
 
@@ -213,31 +212,27 @@ void tetra_dl::service_cmce(std::vector<uint8_t> pdu, mac_logical_channel_t mac_
  *
  */
 
+static constexpr pdu_field_t CMCE_D_ALERT[] = {
+    pdu_value("call identifier", 14),
+    pdu_value("call timeout, setup phase", 3),
+    pdu_reserved(1),
+    pdu_value("simplex/duplex operation", 1),
+    pdu_value("call queued", 1)
+};
+
 void tetra_dl::cmce_parse_d_alert(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_alert", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_alert", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-ALERT");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    report_add("call identifier", get_value(pdu, pos, 14));
-    pos += 14;
-    
-    report_add("call timeout, setup phase", get_value(pdu, pos, 3));
-    pos += 3;
-
-    pos += 1;                                                                   // reserved
-
-    report_add("simplex/duplex operation", get_value(pdu, pos, 1));
-    pos += 1;
+    if (!report_start("CMCE", "D-ALERT"))
+    {
+        return;
+    }
 
-    report_add("call queued", get_value(pdu, pos, 1));
-    pos += 1;
+    pdu_parse<CMCE_D_ALERT, pdu_schema_size(CMCE_D_ALERT)>(pdu, 5, *this);      // after pdu type
 
     // TODO type2 / 3 elements
 
@@ -249,29 +244,26 @@ void tetra_dl::cmce_parse_d_alert(std::vector<uint8_t> pdu)
  *
  */
 
+static constexpr pdu_field_t CMCE_D_CALL_PROCEEDING[] = {
+    pdu_value("call identifier", 14),
+    pdu_value("call timeout, setup phase", 3),
+    pdu_value("hook method selection", 1),
+    pdu_value("simplex/duplex selection", 1)
+};
+
 void tetra_dl::cmce_parse_d_call_proceeding(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_call_proceeding", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_call_proceeding", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-ALERT");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    report_add("call identifier", get_value(pdu, pos, 14));
-    pos += 14;
-    
-    report_add("call timeout, setup phase", get_value(pdu, pos, 3));
-    pos += 3;
-
-    report_add("hook method selection", get_value(pdu, pos, 1));
-    pos += 1;
+    if (!report_start("CMCE", "D-ALERT"))
+    {
+        return;
+    }
 
-    report_add("simplex/duplex selection", get_value(pdu, pos, 1));
-    pos += 1;
+    pdu_parse<CMCE_D_CALL_PROCEEDING, pdu_schema_size(CMCE_D_CALL_PROCEEDING)>(pdu, 5, *this); // after pdu type
 
     // TODO type2 / 3 elements
 
@@ -283,79 +275,35 @@ void tetra_dl::cmce_parse_d_call_proceeding(std::vector<uint8_t> pdu)
  *
  */
 
+static constexpr pdu_field_t CMCE_D_CALL_RESTORE[] = {
+    pdu_value("call identifier", 14),
+    pdu_value("transmission grant", 2),
+    pdu_value("transmission request permission", 1),
+    pdu_value("reset call time-out timer T310", 1),
+    pdu_option(),
+    pdu_type2("new call identifier", 14),
+    pdu_type2("call time-out", 4),
+    pdu_type2("call status", 3),
+    pdu_type2("modify", 9),
+    pdu_type2("notification indicator", 6)
+};
+
 void tetra_dl::cmce_parse_d_call_restore(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_call_restore", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_call_restore", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-CALL RESTORE");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    report_add("call identifier", get_value(pdu, pos, 14));
-    pos += 14;
-
-    report_add("transmission grant", get_value(pdu, pos, 2));
-    pos += 2;
-
-    report_add("transmission request permission", get_value(pdu, pos, 1));
-    pos += 1;
-
-    report_add("reset call time-out timer T310", get_value(pdu, pos, 1));
-    pos += 1;
-
-    uint8_t o_flag = get_value(pdu, pos, 1);                                    // option flag
-    pos += 1;
-    if (o_flag)                                                                 // there is type2 or type3/4 fields
+    if (!report_start("CMCE", "D-CALL RESTORE"))
     {
-        uint8_t p_flag;                                                         // presence flag
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("new call identifier", get_value(pdu, pos, 14));
-            pos += 14;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("call time-out", get_value(pdu, pos, 4));
-            pos += 4;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("call status", get_value(pdu, pos, 3));
-            pos += 3;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("modify", get_value(pdu, pos, 9));
-            pos += 9;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("notification indicator", get_value(pdu, pos, 6));
-            pos += 6;
-        }
-
-        // TODO handle type3/4 elements
+        return;
     }
 
+    pdu_parse<CMCE_D_CALL_RESTORE, pdu_schema_size(CMCE_D_CALL_RESTORE)>(pdu, 5, *this); // after pdu type
+
+    // TODO handle type3/4 elements
+
     report_send();
 }
 
@@ -364,90 +312,37 @@ void tetra_dl::cmce_parse_d_call_restore(std::vector<uint8_t> pdu)
  *
  */
 
+static constexpr pdu_field_t CMCE_D_CONNECT[] = {
+    pdu_value("call identifier", 14),
+    pdu_value("call timeout", 4),
+    pdu_value("hook method selection", 1),
+    pdu_value("simplex/duplex selection", 1),
+    pdu_value("transmission grant", 2),
+    pdu_value("transmission request permission", 1),
+    pdu_value("call ownership", 1),
+    pdu_option(),
+    pdu_type2("call priority", 4),
+    pdu_type2("basic service information", 8),
+    pdu_type2("temporary address", 24),
+    pdu_type2("notification indicator", 6)
+};
+
 void tetra_dl::cmce_parse_d_connect(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_connect", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_connect", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-CONNECT");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    report_add("call identifier", get_value(pdu, pos, 14));
-    pos += 14;
-
-    report_add("call timeout", get_value(pdu, pos, 4));
-    pos += 4;
-
-    report_add("hook method selection", get_value(pdu, pos, 1));
-    pos += 1;
-
-    report_add("simplex/duplex selection", get_value(pdu, pos, 1));
-    pos += 1;
-
-    report_add("transmission grant", get_value(pdu, pos, 2));
-    pos += 2;
-
-    report_add("transmission request permission", get_value(pdu, pos, 1));
-    pos += 1;
-
-    report_add("call ownership", get_value(pdu, pos, 1));
-    pos += 1;
-
-    uint8_t o_flag = get_value(pdu, pos, 1);                                    // option flag
-    pos += 1;
-    if (o_flag)                                                                 // there is type2 or type3/4 fields
+    if (!report_start("CMCE", "D-CONNECT"))
     {
-        uint8_t p_flag;                                                         // presence flag
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("call priority", get_value(pdu, pos, 4));
-            pos += 4;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("basic service information", get_value(pdu, pos, 8));
-            pos += 8;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("temporary address", get_value(pdu, pos, 24));
-            pos += 24;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("notification indicator", get_value(pdu, pos, 6));
-            pos += 6;
-        }
-
-        // TODO
-        // uint8_t m_flag;                                                         // type 3/4 elements flag
-        // m_flag = get_value(pdu, pos, 1);
-        // pos += 1;
-
-        // while (m_flag)                                                          // it there type3/4 fields
-        // {
-        //     // facility and proprietary elements
-        //     report_add("type3 element id", json_object_new_int(get_value(pdu, pos, 4)));
-        //     pos += 4;
-        // }
+        return;
     }
 
+    pdu_parse<CMCE_D_CONNECT, pdu_schema_size(CMCE_D_CONNECT)>(pdu, 5, *this);  // after pdu type
+
+    // TODO handle type3/4
+
     report_send();
 }
 
@@ -456,47 +351,30 @@ void tetra_dl::cmce_parse_d_connect(std::vector<uint8_t> pdu)
  *
  */
 
+static constexpr pdu_field_t CMCE_D_CONNECT_ACK[] = {
+    pdu_value("call identifier", 14),
+    pdu_value("call timeout", 4),
+    pdu_value("transmission grant", 2),
+    pdu_value("transmission request permission", 1),
+    pdu_option(),
+    pdu_type2("notification indicator", 6)
+};
+
 void tetra_dl::cmce_parse_d_connect_ack(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_connect_ack", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_connect_ack", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-CONNECT ACK");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    report_add("call identifier", get_value(pdu, pos, 14));
-    pos += 14;
-
-    report_add("call timeout", get_value(pdu, pos, 4));
-    pos += 4;
-
-    report_add("transmission grant", get_value(pdu, pos, 2));
-    pos += 2;
-
-    report_add("transmission request permission", get_value(pdu, pos, 1));
-    pos += 1;
-
-    uint8_t o_flag = get_value(pdu, pos, 1);                                    // option flag
-    pos += 1;
-
-    if (o_flag)                                                                 // there is type2, type3 or type4 fields
+    if (!report_start("CMCE", "D-CONNECT ACK"))
     {
-        uint8_t p_flag;                                                         // presence flag
+        return;
+    }
 
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("notification indicator", get_value(pdu, pos, 6));
-            pos += 6;
-        }
+    pdu_parse<CMCE_D_CONNECT_ACK, pdu_schema_size(CMCE_D_CONNECT_ACK)>(pdu, 5, *this); // after pdu type
 
-        // TODO handle type3/4
-    }
+    // TODO handle type3/4
 
     report_send();
 }
@@ -506,41 +384,28 @@ void tetra_dl::cmce_parse_d_connect_ack(std::vector<uint8_t> pdu)
  *
  */
 
+static constexpr pdu_field_t CMCE_D_DISCONNECT[] = {
+    pdu_value("call identifier", 14),
+    pdu_value("disconnect cause", 1),
+    pdu_option(),
+    pdu_type2("notification indicator", 6)
+};
+
 void tetra_dl::cmce_parse_d_disconnect(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_disconnect", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_disconnect", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-DISCONNECT");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    report_add("call identifier", get_value(pdu, pos, 14));
-    pos += 14;
-
-    report_add("disconnect cause", get_value(pdu, pos, 1));
-    pos += 1;
-
-    uint8_t o_flag = get_value(pdu, pos, 1);                                    // option flag
-    pos += 1;
-
-    if (o_flag)                                                                 // there is type2, type3 or type4 fields
+    if (!report_start("CMCE", "D-DISCONNECT"))
     {
-        uint8_t p_flag;                                                         // presence flag
+        return;
+    }
 
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("notification indicator", get_value(pdu, pos, 6));
-            pos += 6;
-        }
+    pdu_parse<CMCE_D_DISCONNECT, pdu_schema_size(CMCE_D_DISCONNECT)>(pdu, 5, *this); // after pdu type
 
-        // TODO handle type3/4
-    }
+    // TODO handle type3/4
 
     report_send();
 }
@@ -550,117 +415,39 @@ void tetra_dl::cmce_parse_d_disconnect(std::vector<uint8_t> pdu)
  *
  */
 
+static constexpr pdu_field_t CMCE_D_INFO[] = {
+    pdu_value("call identifier", 14),
+    pdu_value("reset call time-out timer (T310)", 1),
+    pdu_value("poll request", 1),
+    pdu_option(),
+    pdu_type2("new call identifier", 14),
+    pdu_type2("call time-out", 4),
+    pdu_type2("call time-out setup phase (T301, T302)", 3),
+    pdu_type2("call ownership", 1),
+    pdu_type2("modify", 9),
+    pdu_type2("call status", 3),
+    pdu_type2("temporary address", 24),
+    pdu_type2("notification indicator", 6),
+    pdu_type2("poll response percentage", 6),
+    pdu_type2("poll response number", 6)
+};
+
 void tetra_dl::cmce_parse_d_info(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_info", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_info", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-INFO");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    report_add("call identifier", get_value(pdu, pos, 14));
-    pos += 14;
-
-    report_add("reset call time-out timer (T310)", get_value(pdu, pos, 1));
-    pos += 1;
-
-    report_add("poll request", get_value(pdu, pos, 1));
-    pos += 1;
-
-    uint8_t o_flag = get_value(pdu, pos, 1);                                    // option flag
-    pos += 1;
-
-    if (o_flag)                                                                 // there is type2, type3 or type4 fields
+    if (!report_start("CMCE", "D-INFO"))
     {
-        uint8_t p_flag;                                                         // presence flag
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("new call identifier", get_value(pdu, pos, 14));
-            pos += 14;
-        }
-        
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("call time-out", get_value(pdu, pos, 4));
-            pos += 4;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("call time-out setup phase (T301, T302)", get_value(pdu, pos, 3));
-            pos += 3;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("call ownership", get_value(pdu, pos, 1));
-            pos += 1;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("modify", get_value(pdu, pos, 9));
-            pos += 9;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("call status", get_value(pdu, pos, 3));
-            pos += 3;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("temporary address", get_value(pdu, pos, 24));
-            pos += 24;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("notification indicator", get_value(pdu, pos, 6));
-            pos += 6;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("poll response percentage", get_value(pdu, pos, 6));
-            pos += 6;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("poll response number", get_value(pdu, pos, 6));
-            pos += 6;
-        }
-
-        // TODO handle type3/4
+        return;
     }
 
+    pdu_parse<CMCE_D_INFO, pdu_schema_size(CMCE_D_INFO)>(pdu, 5, *this);        // after pdu type
+
+    // TODO handle type3/4
+
     report_send();
 }
 
@@ -669,41 +456,28 @@ void tetra_dl::cmce_parse_d_info(std::vector<uint8_t> pdu)
  *
  */
 
+static constexpr pdu_field_t CMCE_D_RELEASE[] = {
+    pdu_value("call identifier", 14),
+    pdu_value("disconnect cause", 5),
+    pdu_option(),
+    pdu_type2("notification indicator", 6)
+};
+
 void tetra_dl::cmce_parse_d_release(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_release", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_release", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-RELEASE");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    report_add("call identifier", get_value(pdu, pos, 14));
-    pos += 14;
-
-    report_add("disconnect cause", get_value(pdu, pos, 5));
-    pos += 5;
-
-    uint8_t o_flag = get_value(pdu, pos, 1);                                    // option flag
-    pos += 1;
-
-    if (o_flag)                                                                 // there is type2, type3 or type4 fields
+    if (!report_start("CMCE", "D-RELEASE"))
     {
-        uint8_t p_flag;                                                         // presence flag
+        return;
+    }
 
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("notification indicator", get_value(pdu, pos, 6));
-            pos += 6;
-        }
+    pdu_parse<CMCE_D_RELEASE, pdu_schema_size(CMCE_D_RELEASE)>(pdu, 5, *this);  // after pdu type
 
-        // TODO handle type3/4
-    }
+    // TODO handle type3/4
 
     report_send();
 }
@@ -713,99 +487,37 @@ void tetra_dl::cmce_parse_d_release(std::vector<uint8_t> pdu)
  *
  */
 
+static constexpr pdu_field_t CMCE_D_SETUP[] = {
+    pdu_value("call identifier", 14),
+    pdu_value("call timeout", 4),
+    pdu_value("hook method selection", 1),
+    pdu_value("simplex/duplex selection", 1),
+    pdu_value("basic service information", 8),
+    pdu_value("transmission grant", 2),
+    pdu_value("transmission request permission", 1),
+    pdu_value("call priority", 4),
+    pdu_option(),
+    pdu_type2("notification indicator", 6),
+    pdu_type2("temporary address", 24),
+    pdu_party_type2("calling party type identifier", "calling party ssi", "calling party ext", 8)
+};
+
 void tetra_dl::cmce_parse_d_setup(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_setup", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_setup", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-SETUP");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    report_add("call identifier", get_value(pdu, pos, 14));
-    pos += 14;
-
-    report_add("call timeout", get_value(pdu, pos, 4));
-    pos += 4;
-
-    report_add("hook method selection", get_value(pdu, pos, 1));
-    pos += 1;
-
-    report_add("simplex/duplex selection", get_value(pdu, pos, 1));
-    pos += 1;
-
-    report_add("basic service information", get_value(pdu, pos, 8));
-    pos += 8;
-
-    report_add("transmission grant", get_value(pdu, pos, 2));
-    pos += 2;
-
-    report_add("transmission request permission", get_value(pdu, pos, 1));
-    pos += 1;
-
-    report_add("call priority", get_value(pdu, pos, 4));
-    pos += 4;
-
-    uint8_t o_flag = get_value(pdu, pos, 1);                                    // option flag
-    pos += 1;
-
-    if (o_flag)                                                                 // there is type2, type3 or type4 fields
+    if (!report_start("CMCE", "D-SETUP"))
     {
-        uint8_t p_flag;                                                         // presence flag
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("notification indicator", get_value(pdu, pos, 6));
-            pos += 6;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("temporary address", get_value(pdu, pos, 24));
-            pos += 24;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)                                                             // calling party type identifier
-        {
-            uint8_t cpti = get_value(pdu, pos, 2);
-            pos += 2;
-            report_add("calling party type identifier", cpti);
-
-            if (cpti == 0)                                                      // SNA ? not documented
-            {
-                report_add("calling party ssi", get_value(pdu, pos, 8));
-                pos += 8;
-            }
-            else if (cpti == 1)
-            {
-                report_add("calling party ssi", get_value(pdu, pos, 24));
-                pos += 24;
-            }
-            else if (cpti == 2)
-            {
-                report_add("calling party ssi", get_value(pdu, pos, 24));
-                pos += 24;
-
-                report_add("calling party ext", get_value(pdu, pos, 24));
-                pos += 24;
-            }
-        }
-
-        // TODO handle type 3/4
-        // uint8_t m_flag;
-        // m_flag = get_value(pdu, pos, 1);
-        // pos += 1;
+        return;
     }
 
+    pdu_parse<CMCE_D_SETUP, pdu_schema_size(CMCE_D_SETUP)>(pdu, 5, *this);      // after pdu type
+
+    // TODO handle type 3/4
+
     report_send();
 }
 
@@ -814,41 +526,28 @@ void tetra_dl::cmce_parse_d_setup(std::vector<uint8_t> pdu)
  *
  */
 
+static constexpr pdu_field_t CMCE_D_TX_CEASED[] = {
+    pdu_value("call identifier", 14),
+    pdu_value("transmission request permission", 1),
+    pdu_option(),
+    pdu_type2("notification indicator", 6)
+};
+
 void tetra_dl::cmce_parse_d_tx_ceased(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_tx_ceased", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_tx_ceased", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-TX CEASED");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    report_add("call identifier", get_value(pdu, pos, 14));
-    pos += 14;
-
-    report_add("transmission request permission", get_value(pdu, pos, 1));
-    pos += 1;
-
-    uint8_t o_flag = get_value(pdu, pos, 1);                                    // option flag
-    pos += 1;
-
-    if (o_flag)                                                                 // there is type2, type3 or type4 fields
+    if (!report_start("CMCE", "D-TX CEASED"))
     {
-        uint8_t p_flag;                                                         // presence flag
+        return;
+    }
 
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("notification indicator", get_value(pdu, pos, 6));
-            pos += 6;
-        }
+    pdu_parse<CMCE_D_TX_CEASED, pdu_schema_size(CMCE_D_TX_CEASED)>(pdu, 5, *this); // after pdu type
 
-        // TODO handle type3/4
-    }
+    // TODO handle type3/4
 
     report_send();
 }
@@ -858,44 +557,29 @@ void tetra_dl::cmce_parse_d_tx_ceased(std::vector<uint8_t> pdu)
  *
  */
 
+static constexpr pdu_field_t CMCE_D_TX_CONTINUE[] = {
+    pdu_value("call identifier", 14),
+    pdu_value("continue", 1),
+    pdu_value("transmission request permission", 1),
+    pdu_option(),
+    pdu_type2("notification indicator", 6)
+};
+
 void tetra_dl::cmce_parse_d_tx_continue(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_tx_continue", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_tx_continue", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-TX CONTINUE");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    report_add("call identifier", get_value(pdu, pos, 14));
-    pos += 14;
-
-    report_add("continue", get_value(pdu, pos, 1));
-    pos += 1;
-
-    report_add("transmission request permission", get_value(pdu, pos, 1));
-    pos += 1;
-
-    uint8_t o_flag = get_value(pdu, pos, 1);                                    // option flag
-    pos += 1;
-
-    if (o_flag)                                                                 // there is type2, type3 or type4 fields
+    if (!report_start("CMCE", "D-TX CONTINUE"))
     {
-        uint8_t p_flag;                                                         // presence flag
+        return;
+    }
 
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("notification indicator", get_value(pdu, pos, 6));
-            pos += 6;
-        }
+    pdu_parse<CMCE_D_TX_CONTINUE, pdu_schema_size(CMCE_D_TX_CONTINUE)>(pdu, 5, *this); // after pdu type
 
-        // TODO handle type3/4
-    }
+    // TODO handle type3/4
 
     report_send();
 }
@@ -905,78 +589,33 @@ void tetra_dl::cmce_parse_d_tx_continue(std::vector<uint8_t> pdu)
  *
  */
 
+static constexpr pdu_field_t CMCE_D_TX_GRANTED[] = {
+    pdu_value("call identifier", 14),
+    pdu_value("transmission grant", 2),
+    pdu_value("transmission request permission", 1),
+    pdu_value("encryption control", 1),
+    pdu_reserved(1),
+    pdu_option(),
+    pdu_type2("notification indicator", 6),
+    pdu_party_type2("transmission party type identifier", "transmitting party ssi", "transmitting party ext", 8)
+};
+
 void tetra_dl::cmce_parse_d_tx_granted(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_tx_granted", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_tx_granted", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-TX GRANTED");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    report_add("call identifier", get_value(pdu, pos, 14));
-    pos += 14;
-
-    report_add("transmission grant", get_value(pdu, pos, 2));
-    pos += 2;
-
-    report_add("transmission request permission", get_value(pdu, pos, 1));
-    pos += 1;
-
-    report_add("encryption control", get_value(pdu, pos, 1));
-    pos += 1;
-
-    pos += 1;                                                                   // reserved and must be set to 0
-
-    uint8_t o_flag = get_value(pdu, pos, 1);                                    // option flag
-    pos += 1;
-
-    if (o_flag)                                                                 // there is type2, type3 or type4 fields
+    if (!report_start("CMCE", "D-TX GRANTED"))
     {
-        uint8_t p_flag;                                                         // presence flag
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("notification indicator", get_value(pdu, pos, 6));
-            pos += 6;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            uint8_t tpti = get_value(pdu, pos, 2);
-            pos += 2;
-            report_add("transmission party type identifier", tpti);
-
-            if (tpti == 0)                                                      // SNA ? not documented
-            {
-                report_add("transmitting party ssi", get_value(pdu, pos, 8));
-                pos += 8;
-            }
-            else if (tpti == 1)
-            {
-                report_add("transmitting party ssi", get_value(pdu, pos, 24));
-                pos += 24;
-            }
-            else if (tpti == 2)
-            {
-                report_add("transmitting party ssi", get_value(pdu, pos, 24));
-                pos += 24;
-
-                report_add("transmitting party ext", get_value(pdu, pos, 24));
-                pos += 24;
-            }
-        }
-
-        // TODO handle type3/4
+        return;
     }
 
+    pdu_parse<CMCE_D_TX_GRANTED, pdu_schema_size(CMCE_D_TX_GRANTED)>(pdu, 5, *this); // after pdu type
+
+    // TODO handle type3/4
+
     report_send();
 }
 
@@ -985,78 +624,33 @@ void tetra_dl::cmce_parse_d_tx_granted(std::vector<uint8_t> pdu)
  *
  */
 
+static constexpr pdu_field_t CMCE_D_TX_INTERRUPT[] = {
+    pdu_value("call identifier", 14),
+    pdu_value("transmission grant", 2),
+    pdu_value("transmission request permission", 1),
+    pdu_value("encryption control", 1),
+    pdu_reserved(1),
+    pdu_option(),
+    pdu_type2("notification indicator", 6),
+    pdu_party_type2("transmission party type identifier", "transmitting party ssi", "transmitting party ext", 8)
+};
+
 void tetra_dl::cmce_parse_d_tx_interrupt(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_tx_interrupt", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_tx_interrupt", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-TX INTERRUPT");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    report_add("call identifier", get_value(pdu, pos, 14));
-    pos += 14;
-
-    report_add("transmission grant", get_value(pdu, pos, 2));
-    pos += 2;
-
-    report_add("transmission request permission", get_value(pdu, pos, 1));
-    pos += 1;
-
-    report_add("encryption control", get_value(pdu, pos, 1));
-    pos += 1;
-
-    pos += 1;                                                                   // reserved and must be set to 0
-
-    uint8_t o_flag = get_value(pdu, pos, 1);                                    // option flag
-    pos += 1;
-
-    if (o_flag)                                                                 // there is type2, type3 or type4 fields
+    if (!report_start("CMCE", "D-TX INTERRUPT"))
     {
-        uint8_t p_flag;                                                         // presence flag
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("notification indicator", get_value(pdu, pos, 6));
-            pos += 6;
-        }
-
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            uint8_t tpti = get_value(pdu, pos, 2);
-            pos += 2;
-            report_add("transmission party type identifier", tpti);
-
-            if (tpti == 0)                                                      // SNA ? not documented
-            {
-                report_add("transmitting party ssi", get_value(pdu, pos, 8));
-                pos += 8;
-            }
-            else if (tpti == 1)
-            {
-                report_add("transmitting party ssi", get_value(pdu, pos, 24));
-                pos += 24;
-            }
-            else if (tpti == 2)
-            {
-                report_add("transmitting party ssi", get_value(pdu, pos, 24));
-                pos += 24;
-
-                report_add("transmitting party ext", get_value(pdu, pos, 24));
-                pos += 24;
-            }
-        }
-
-        // TODO handle type3/4
+        return;
     }
 
+    pdu_parse<CMCE_D_TX_INTERRUPT, pdu_schema_size(CMCE_D_TX_INTERRUPT)>(pdu, 5, *this); // after pdu type
+
+    // TODO handle type3/4
+
     report_send();
 }
 
@@ -1065,41 +659,28 @@ void tetra_dl::cmce_parse_d_tx_interrupt(std::vector<uint8_t> pdu)
  *
  */
 
+static constexpr pdu_field_t CMCE_D_TX_WAIT[] = {
+    pdu_value("call identifier", 14),
+    pdu_value("transmission request permission", 1),
+    pdu_option(),
+    pdu_type2("notification indicator", 6)
+};
+
 void tetra_dl::cmce_parse_d_tx_wait(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_tx_wait", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_parse_d_tx_wait", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-TX WAIT");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    report_add("call identifier", get_value(pdu, pos, 14));
-    pos += 14;
-
-    report_add("transmission request permission", get_value(pdu, pos, 1));
-    pos += 1;
-
-    uint8_t o_flag = get_value(pdu, pos, 1);                                    // option flag
-    pos += 1;
-
-    if (o_flag)                                                                 // there is type2, type3 or type4 fields
+    if (!report_start("CMCE", "D-TX WAIT"))
     {
-        uint8_t p_flag;                                                         // presence flag
+        return;
+    }
 
-        p_flag = get_value(pdu, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            report_add("notification indicator", get_value(pdu, pos, 6));
-            pos += 6;
-        }
+    pdu_parse<CMCE_D_TX_WAIT, pdu_schema_size(CMCE_D_TX_WAIT)>(pdu, 5, *this);  // after pdu type
 
-        // TODO handle type3/4
-    }
+    // TODO handle type3/4
 
     report_send();
 }
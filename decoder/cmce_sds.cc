@@ -34,13 +34,15 @@
 
 void tetra_dl::cmce_sds_parse_d_sds_data(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_parse_d_sds_data", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_parse_d_sds_data", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-SDS-DATA");
+    if (!report_start("CMCE", "D-SDS-DATA"))
+    {
+        return;
+    }
 
     uint32_t pos = 5;                                                           // pdu type
 
@@ -131,38 +133,24 @@ void tetra_dl::cmce_sds_parse_d_sds_data(std::vector<uint8_t> pdu)
  *
  */
 
+static constexpr pdu_field_t CMCE_D_STATUS[] = {
+    pdu_party("calling party type identifier", "calling party ssi", "calling party ext", 0),
+    pdu_value("pre-coded status", 16)
+};
+
 void tetra_dl::cmce_sds_parse_d_status(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_parse_d_status", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_parse_d_status", vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("CMCE", "D-STATUS");
-
-    uint32_t pos = 5;                                                           // pdu type
-
-    uint8_t cpti = get_value(pdu, pos, 2);
-    pos += 2;
-    report_add("calling party type identifier", cpti);
-
-    if (cpti == 1)                                                              // SSI
+    if (!report_start("CMCE", "D-STATUS"))
     {
-        report_add("calling party ssi", get_value(pdu, pos, 24));
-        pos += 24;
-    }
-    else if (cpti == 2)                                                         // SSI + EXT
-    {
-        report_add("calling party ssi", get_value(pdu, pos, 24));
-        pos += 24;
-
-        report_add("calling party ext", get_value(pdu, pos, 24));
-        pos += 24;
+        return;
     }
 
-    report_add("pre-coded status", get_value(pdu, pos, 16));
-    pos += 16;
+    uint32_t pos = pdu_parse<CMCE_D_STATUS, pdu_schema_size(CMCE_D_STATUS)>(pdu, 5, *this); // after pdu type
 
     uint8_t o_flag = get_value(pdu, pos, 1);                                    // type 3 flag
     pos += 1;
@@ -203,10 +191,9 @@ void tetra_dl::cmce_sds_parse_d_status(std::vector<uint8_t> pdu)
 
 void tetra_dl::cmce_sds_parse_type4_data(std::vector<uint8_t> pdu, const uint16_t len)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - len = %u pdu = %s\n", "cmce_sds_parse_type4_data", len, vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - len = %u pdu = %s\n", "cmce_sds_parse_type4_data", len, vector_to_string(pdu, pdu.size()).c_str());
     }
 
     if ((pdu.size() < len) || (len > 2047))
@@ -357,10 +344,9 @@ void tetra_dl::cmce_sds_parse_type4_data(std::vector<uint8_t> pdu, const uint16_
 
 void tetra_dl::cmce_sds_parse_sub_d_transfer(std::vector<uint8_t> pdu, const uint16_t len)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - len = %u pdu = %s\n", "cmce_sds_parse_sub_d_transfer", len, vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - len = %u pdu = %s\n", "cmce_sds_parse_sub_d_transfer", len, vector_to_string(pdu, pdu.size()).c_str());
     }
 
     uint32_t pos = 0;
@@ -503,10 +489,9 @@ void tetra_dl::cmce_sds_parse_sub_d_transfer(std::vector<uint8_t> pdu, const uin
 
 void tetra_dl::cmce_sds_parse_simple_text_messaging(std::vector<uint8_t> pdu, const uint16_t len)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - len = %u pdu = %s\n", "cmce_sds_parse_simple_text_messaging", len, vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - len = %u pdu = %s\n", "cmce_sds_parse_simple_text_messaging", len, vector_to_string(pdu, pdu.size()).c_str());
     }
 
     uint32_t pos = 8;                                                           // protocol id
@@ -543,10 +528,9 @@ void tetra_dl::cmce_sds_parse_simple_text_messaging(std::vector<uint8_t> pdu, co
 
 void tetra_dl::cmce_sds_parse_text_messaging_with_sds_tl(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_parse_text_messaging_with_sds_tl", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_parse_text_messaging_with_sds_tl", vector_to_string(pdu, pdu.size()).c_str());
     }
 
     // Table 28.29 - 29.5.3.3
@@ -594,10 +578,9 @@ void tetra_dl::cmce_sds_parse_text_messaging_with_sds_tl(std::vector<uint8_t> pd
 
 void tetra_dl::cmce_sds_parse_simple_location_system(std::vector<uint8_t> pdu, const uint16_t len)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_parse_simple_location_system", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_parse_simple_location_system", vector_to_string(pdu, pdu.size()).c_str());
     }
 
     uint32_t pos = 8;                                                           // protocol id
@@ -639,10 +622,9 @@ void tetra_dl::cmce_sds_parse_simple_location_system(std::vector<uint8_t> pdu, c
 
 void tetra_dl::cmce_sds_parse_location_system_with_sds_tl(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_parse_location_system_with_sds_tl", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_parse_location_system_with_sds_tl", vector_to_string(pdu, pdu.size()).c_str());
     }
 
     uint16_t len = pdu.size();
@@ -10,10 +10,9 @@
 
 void tetra_dl::cmce_sds_service_location_information_protocol(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_service_location_information_protocol", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_service_location_information_protocol", vector_to_string(pdu, pdu.size()).c_str());
     }
 
     uint32_t pos = 0;                                                           // protocol ID from SDS has been removed since LIP is a service with SDU
@@ -46,10 +45,9 @@ void tetra_dl::cmce_sds_service_location_information_protocol(std::vector<uint8_
 
 void tetra_dl::cmce_sds_lip_parse_extended_message(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_lip_parse_extended_message", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_lip_parse_extended_message", vector_to_string(pdu, pdu.size()).c_str());
     }
 
     uint32_t pos = 2;                                                           // pdu type
@@ -204,10 +202,9 @@ static std::string utils_decode_lip_position_error(uint8_t val)
 
 void tetra_dl::cmce_sds_lip_parse_short_location_report(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_lip_parse_short_location_report", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_CMCE, "DEBUG ::%-44s - pdu = %s\n", "cmce_sds_lip_parse_short_location_report", vector_to_string(pdu, pdu.size()).c_str());
     }
 
     static const std::size_t MIN_SIZE = 68;
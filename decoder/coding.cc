@@ -26,6 +26,8 @@
 
 std::vector<uint8_t> tetra_dl::dec_descramble(std::vector<uint8_t> data, int len, uint32_t scrambling_code) // OK
 {
+    uint64_t start_ns = g_profile_flag ? utils_now_ns() : 0;
+
     const uint8_t poly[14] = {32, 26, 23, 22, 16, 12, 11, 10, 8, 7, 5, 4, 2, 1}; // Feedback polynomial - see 8.2.5.2 (8.39)
 
     std::vector<uint8_t> res;
@@ -44,6 +46,8 @@ std::vector<uint8_t> tetra_dl::dec_descramble(std::vector<uint8_t> data, int len
         res.push_back(data[i] ^ (bit & 0xff));
     }
 
+    if (g_profile_flag) g_profile_ns[PROFILE_DESCRAMBLE] += utils_now_ns() - start_ns;
+
     return res;
 }
 
@@ -54,6 +58,8 @@ std::vector<uint8_t> tetra_dl::dec_descramble(std::vector<uint8_t> data, int len
 
 std::vector<uint8_t> tetra_dl::dec_deinterleave(std::vector<uint8_t> data, uint32_t K, uint32_t a)
 {
+    uint64_t start_ns = g_profile_flag ? utils_now_ns() : 0;
+
     std::vector<uint8_t> res(K, 0);                                             // output vector is size K
 
     for (unsigned int idx = 1; idx <= K; idx++)
@@ -62,6 +68,8 @@ std::vector<uint8_t> tetra_dl::dec_deinterleave(std::vector<uint8_t> data, uint3
         res[idx - 1] = data[k - 1];                                             // to interleave: DataOut[i-1] = DataIn[k-1]
     }
 
+    if (g_profile_flag) g_profile_ns[PROFILE_DEINTERLEAVE] += utils_now_ns() - start_ns;
+
     return res;
 }
 
@@ -72,6 +80,8 @@ std::vector<uint8_t> tetra_dl::dec_deinterleave(std::vector<uint8_t> data, uint3
 
 std::vector<uint8_t> tetra_dl::dec_depuncture23(std::vector<uint8_t> data, uint32_t len)
 {
+    uint64_t start_ns = g_profile_flag ? utils_now_ns() : 0;
+
     const uint8_t P[] = {0, 1, 2, 5};                                           // 8.2.3.1.3 - P[1..t]
     std::vector<uint8_t> res(4 * len * 2 / 3, 2);                               // 8.2.3.1.2 with flag 2 for erase bit in Viterbi routine
 
@@ -85,6 +95,8 @@ std::vector<uint8_t> tetra_dl::dec_depuncture23(std::vector<uint8_t> data, uint3
         res[k - 1] = data[j - 1];
     }
 
+    if (g_profile_flag) g_profile_ns[PROFILE_VITERBI] += utils_now_ns() - start_ns;
+
     return res;
 }
 
@@ -95,6 +107,8 @@ std::vector<uint8_t> tetra_dl::dec_depuncture23(std::vector<uint8_t> data, uint3
 
 std::vector<uint8_t> tetra_dl::dec_viterbi_decode16_14(std::vector<uint8_t> data)
 {
+    uint64_t start_ns = g_profile_flag ? utils_now_ns() : 0;
+
     std::string s_in = "";
     for (unsigned int i = 0; i < data.size(); i++)
     {
@@ -110,6 +124,13 @@ std::vector<uint8_t> tetra_dl::dec_viterbi_decode16_14(std::vector<uint8_t> data
         res.push_back((uint8_t)(s_out[i] - '0'));
     }
 
+    if (g_profile_flag)
+    {
+        uint64_t elapsed_ns = utils_now_ns() - start_ns;
+        g_profile_ns[PROFILE_VITERBI] += elapsed_ns;
+        metrics->viterbi.add(elapsed_ns);
+    }
+
     return res;
 }
 
@@ -122,6 +143,8 @@ std::vector<uint8_t> tetra_dl::dec_viterbi_decode16_14(std::vector<uint8_t> data
 
 std::vector<uint8_t> tetra_dl::dec_reed_muller_3014_decode(std::vector<uint8_t> data)
 {
+    uint64_t start_ns = g_profile_flag ? utils_now_ns() : 0;
+
     uint8_t q[5];
     std::vector<uint8_t> res(14);
 
@@ -235,6 +258,8 @@ std::vector<uint8_t> tetra_dl::dec_reed_muller_3014_decode(std::vector<uint8_t>
 
     //return vector_extract(data, 0, 14);
     
+    if (g_profile_flag) g_profile_ns[PROFILE_VITERBI] += utils_now_ns() - start_ns;
+
     return res;
 }
 
@@ -245,6 +270,8 @@ std::vector<uint8_t> tetra_dl::dec_reed_muller_3014_decode(std::vector<uint8_t>
 
 int tetra_dl::check_crc16ccitt(std::vector<uint8_t> data, int len)
 {
+    uint64_t start_ns = g_profile_flag ? utils_now_ns() : 0;
+
     uint16_t crc = 0xFFFF;                                                      // CRC16-CCITT initial value
 
     for (int i = 0; i < len; i++)
@@ -263,5 +290,85 @@ int tetra_dl::check_crc16ccitt(std::vector<uint8_t> data, int len)
         }
     }
 
-    return crc == 0x1D0F;                                                       // CRC16-CCITT reminder value
+    int res = (crc == 0x1D0F);                                                  // CRC16-CCITT reminder value
+
+    if (g_profile_flag) g_profile_ns[PROFILE_CRC] += utils_now_ns() - start_ns;
+
+    return res;
+}
+
+/**
+ * @brief CRC-32 lookup table, one entry per byte value (MSB first)
+ *
+ */
+
+struct crc32_table_t {
+    uint32_t val[256];
+
+    crc32_table_t()
+    {
+        for (uint32_t idx = 0; idx < 256; idx++)
+        {
+            uint32_t crc = idx << 24;
+
+            for (int bit = 0; bit < 8; bit++)
+            {
+                crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : (crc << 1); // CRC-32 polynomial
+            }
+            val[idx] = crc;
+        }
+    }
+};
+
+static const crc32_table_t CRC32_TABLE;
+
+/**
+ * @brief Check LLC frame check sequence (FCS)
+ *
+ * FCS is the 32 bits CRC of the TL-SDU (len bits from start) and
+ * immediately follows it. Bits are packed by 8 and processed with the
+ * lookup table, the remaining bits one by one.
+ *
+ * @return true if FCS is valid
+ *
+ */
+
+bool tetra_dl::check_llc_fcs(const std::vector<uint8_t> & pdu, uint32_t start, uint32_t len)
+{
+    if ((uint64_t)start + len + 32 > pdu.size())                                // too short to contain the FCS
+    {
+        return false;
+    }
+
+    uint64_t start_ns = g_profile_flag ? utils_now_ns() : 0;
+
+    const uint8_t * bits = pdu.data() + start;
+    uint32_t crc = 0xFFFFFFFF;                                                  // CRC-32 initial value
+    uint32_t pos = 0;
+
+    for (; pos + 8 <= len; pos += 8)
+    {
+        uint8_t val = (uint8_t)((bits[pos] << 7) | (bits[pos + 1] << 6) | (bits[pos + 2] << 5) | (bits[pos + 3] << 4) |
+                                (bits[pos + 4] << 3) | (bits[pos + 5] << 2) | (bits[pos + 6] << 1) | bits[pos + 7]);
+
+        crc = (crc << 8) ^ CRC32_TABLE.val[(crc >> 24) ^ val];
+    }
+
+    for (; pos < len; pos++)
+    {
+        crc = ((crc >> 31) ^ bits[pos]) ? (crc << 1) ^ 0x04C11DB7 : (crc << 1);
+    }
+
+    uint32_t fcs = 0;
+
+    for (int idx = 0; idx < 32; idx++)
+    {
+        fcs = (fcs << 1) | bits[len + idx];
+    }
+
+    bool res = (fcs == ~crc);                                                   // FCS is the ones complement of the CRC
+
+    if (g_profile_flag) g_profile_ns[PROFILE_CRC] += utils_now_ns() - start_ns;
+
+    return res;
 }
@@ -0,0 +1,411 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "tetra_dl.h"
+#include "utils.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Stage names for report, same order as profile_stage_t
+ *
+ */
+
+static const char * stage_names[PROFILE_STAGE_COUNT] = {
+    "sync search",
+    "descramble",
+    "deinterleave",
+    "viterbi",
+    "crc",
+    "mac parse",
+    "report"
+};
+
+/**
+ * @brief Result of one decoding run
+ *
+ */
+
+struct bench_result_t {
+    uint64_t wall_ns;                                                           ///< Total run time [ns]
+    uint64_t bursts;                                                            ///< Bursts sent to lower MAC
+    uint64_t reports;                                                           ///< Json reports sent
+    uint64_t checksum;                                                          ///< Json reports checksum
+    uint64_t stage_ns[PROFILE_STAGE_COUNT];                                     ///< Time per stage [ns]
+};
+
+/**
+ * @brief Append value to bits vector, MSB first
+ *
+ */
+
+static void put_bits(std::vector<uint8_t> & bits, uint64_t val, int len)
+{
+    for (int idx = len - 1; idx >= 0; idx--)
+    {
+        bits.push_back((val >> idx) & 1);
+    }
+}
+
+/**
+ * @brief Check LLC FCS before measuring anything
+ *
+ * The known answer is the CRC-32/BZIP2 check value of "123456789". Then
+ * a MAC-RESOURCE shorter than its SCH/F block, with fill bits and a
+ * NULL PDU behind it, carries a BL-UDATA + FCS: its FCS must pass, so
+ * fill bits must be removed at the end of the MAC PDU, not of the block.
+ *
+ * @return true if both checks pass
+ *
+ */
+
+static bool check_llc_fcs_vectors(int null_fd)
+{
+    tetra_dl * decoder = new tetra_dl(0, true);
+    decoder->socketfd = null_fd;
+
+    std::vector<uint8_t> vec;
+    const char * txt = "123456789";
+    for (std::size_t idx = 0; idx < strlen(txt); idx++)
+    {
+        put_bits(vec, (uint8_t)txt[idx], 8);
+    }
+    put_bits(vec, 0xFC891918, 32);
+
+    bool b_known_answer = decoder->check_llc_fcs(vec, 0, 72);
+    vec[3] ^= 1;
+    b_known_answer = b_known_answer && !decoder->check_llc_fcs(vec, 0, 72);
+
+    std::vector<uint8_t> tl_sdu;
+    put_bits(tl_sdu, 0b010, 3);                                                 // MLE protocol discriminator CMCE
+    put_bits(tl_sdu, 0b01000, 5);                                               // D-STATUS
+    put_bits(tl_sdu, 1, 2);                                                     // calling party SSI
+    put_bits(tl_sdu, 4001, 24);
+    put_bits(tl_sdu, 0x8001, 16);                                               // pre-coded status
+
+    uint32_t crc = 0xFFFFFFFF;                                                  // FCS is the complemented CRC-32 of the TL-SDU
+    for (std::size_t idx = 0; idx < tl_sdu.size(); idx++)
+    {
+        crc = ((crc >> 31) ^ tl_sdu[idx]) ? (crc << 1) ^ 0x04C11DB7 : (crc << 1);
+    }
+    uint32_t fcs = ~crc;
+
+    std::vector<uint8_t> block;
+    put_bits(block, 0b00, 2);                                                   // MAC-RESOURCE
+    put_bits(block, 1, 1);                                                      // fill bits
+    put_bits(block, 0, 4);                                                      // grant, encryption, random access
+    std::size_t length_pos = block.size();
+    put_bits(block, 0, 6);                                                      // length indication, set below
+    put_bits(block, 0b001, 3);                                                  // SSI
+    put_bits(block, 1001, 24);
+    put_bits(block, 0, 3);                                                      // power control, slot granting, channel allocation
+    put_bits(block, 0b0110, 4);                                                 // BL-UDATA + FCS
+    block.insert(block.end(), tl_sdu.begin(), tl_sdu.end());
+    put_bits(block, fcs, 32);
+
+    put_bits(block, 1, 1);                                                      // 23.4.3.2 fill bits up to octet boundary
+    while (block.size() % 8)
+    {
+        block.push_back(0);
+    }
+    for (int idx = 0; idx < 6; idx++)
+    {
+        block[length_pos + idx] = ((block.size() / 8) >> (5 - idx)) & 1;
+    }
+
+    put_bits(block, 0, 7);                                                      // NULL PDU
+    put_bits(block, 0b000010, 6);
+    put_bits(block, 0b000, 3);
+    block.resize(268, 0);
+
+    fflush(stdout);
+    int stdout_fd = dup(STDOUT_FILENO);                                         // silence decoder screen output
+    dup2(null_fd, STDOUT_FILENO);
+
+    decoder->service_upper_mac(block, SCH_F);
+
+    fflush(stdout);
+    dup2(stdout_fd, STDOUT_FILENO);
+    close(stdout_fd);
+
+    bool b_fill_bits = (decoder->metrics->llc_fcs_pass == 1) && (decoder->metrics->llc_fcs_fail == 0);
+
+    delete decoder;
+
+    return b_known_answer && b_fill_bits;
+}
+
+/**
+ * @brief Decode the whole capture with a fresh decoder
+ *
+ * Json reports are written to the null sink, screen output is
+ * redirected to it as well for the run duration.
+ *
+ */
+
+static bench_result_t run_capture(const uint8_t * bits, std::size_t len, int null_fd, int debug_level, bool metrics_flag, bool decode_policy_flag, const char * filter_filename, int broadcast_keepalive, int flywheel_window)
+{
+    bench_result_t res;
+
+    tetra_dl * decoder = new tetra_dl(debug_level, true);
+    decoder->socketfd             = null_fd;
+    decoder->g_profile_flag       = true;
+    decoder->g_decode_policy_flag = decode_policy_flag;
+    decoder->g_broadcast_keepalive_frames = broadcast_keepalive * 300 / 17;     // TDMA frame is 56.67 ms
+    decoder->g_flywheel_window    = flywheel_window;
+
+    if (filter_filename != NULL)                                                // already checked by main
+    {
+        decoder->filter = new report_filter_t();
+        decoder->filter->load(filter_filename);
+    }
+
+    fflush(stdout);
+    int stdout_fd = dup(STDOUT_FILENO);                                         // silence decoder screen output
+    dup2(null_fd, STDOUT_FILENO);
+    log_start(true, 0);                                                         // same output path as decoder, nothing dropped
+
+    uint64_t start_ns = utils_now_ns();
+
+    for (std::size_t idx = 0; idx < len; idx++)
+    {
+        decoder->rx_symbol(bits[idx]);
+    }
+
+    res.wall_ns = utils_now_ns() - start_ns;
+
+    log_stop();                                                                 // queued lines go to /dev/null too
+    dup2(stdout_fd, STDOUT_FILENO);                                             // restore screen output
+    close(stdout_fd);
+
+    res.bursts   = decoder->g_profile_bursts;
+    res.reports  = decoder->g_report_count;
+    res.checksum = decoder->g_report_checksum;
+
+    uint64_t timed_ns = 0;
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++)
+    {
+        res.stage_ns[stage] = decoder->g_profile_ns[stage];
+        timed_ns += res.stage_ns[stage];
+    }
+    res.stage_ns[PROFILE_SYNC] = (res.wall_ns > timed_ns) ? res.wall_ns - timed_ns : 0; // what is left is sync search
+
+    if (metrics_flag)
+    {
+        printf("%s\n", decoder->metrics->snapshot(decoder->g_cell_infos, decoder->g_is_synchronized).c_str());
+    }
+
+    delete decoder;
+
+    return res;
+}
+
+/**
+ * @brief Decoder benchmark entry point
+ *
+ * Replays a capture recorded with "decoder -o" through the decoder
+ * with output sent to /dev/null, and prints throughput, time per stage
+ * and a checksum of all Json reports (system time excluded) which must
+ * not change when optimizing the decoder.
+ *
+ */
+
+int main(int argc, char * argv[])
+{
+    int repeat = 3;
+    int debug_level = 0;
+    bool metrics_flag = false;
+    bool decode_policy_flag = true;
+    const char * filter_filename = NULL;
+    int broadcast_keepalive = 10;
+    int flywheel_window = 2;
+
+    int option;
+    while ((option = getopt(argc, argv, "hn:d:maF:K:W:")) != -1)
+    {
+        switch (option)
+        {
+        case 'n':
+            repeat = atoi(optarg);
+            break;
+
+        case 'd':
+            debug_level = atoi(optarg);
+            break;
+
+        case 'm':
+            metrics_flag = true;
+            break;
+
+        case 'a':
+            decode_policy_flag = false;
+            break;
+
+        case 'F':
+            filter_filename = optarg;
+            break;
+
+        case 'K':
+            broadcast_keepalive = atoi(optarg);
+            break;
+
+        case 'W':
+            flywheel_window = atoi(optarg);
+            break;
+
+        default:
+            printf("\nUsage: ./decoder_bench [OPTIONS] capture.bin\n\n"
+                   "Options:\n"
+                   "  -n <count> number of runs, best one is reported [default 3]\n"
+                   "  -d <level> decoder debug level (output is discarded)\n"
+                   "  -m print metrics snapshot after each run\n"
+                   "  -a decode all blocks (no AACH decode policy)\n"
+                   "  -F <file> subscription filter\n"
+                   "  -K <seconds> unchanged broadcast PDUs report period, 0 to report all [default 10 s]\n"
+                   "  -W <bits> burst search window while synchronized, 0 to disable [default 2]\n"
+                   "  -h print this help\n\n");
+            exit(EXIT_FAILURE);
+            break;
+        }
+    }
+
+    if ((optind >= argc) || (repeat < 1))
+    {
+        fprintf(stderr, "missing capture file, run ./decoder_bench -h\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if ((flywheel_window < 0) || (flywheel_window > 16))                        // training sequences must stay in buffer
+    {
+        fprintf(stderr, "invalid burst search window %d, 0 to 16 bits\n", flywheel_window);
+        exit(EXIT_FAILURE);
+    }
+
+    if (filter_filename != NULL)
+    {
+        report_filter_t filter;
+        if (!filter.load(filter_filename))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // map capture file
+
+    int fd = open(argv[optind], O_RDONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Couldn't open capture file '%s'\n", argv[optind]);
+        exit(EXIT_FAILURE);
+    }
+
+    struct stat st;
+    if ((fstat(fd, &st) < 0) || (st.st_size == 0))
+    {
+        fprintf(stderr, "Empty capture file '%s'\n", argv[optind]);
+        exit(EXIT_FAILURE);
+    }
+
+    std::size_t len = (std::size_t)st.st_size;
+    const uint8_t * bits = (const uint8_t *)mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (bits == MAP_FAILED)
+    {
+        fprintf(stderr, "Couldn't map capture file '%s'\n", argv[optind]);
+        exit(EXIT_FAILURE);
+    }
+    madvise((void *)bits, len, MADV_SEQUENTIAL);
+
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd < 0)
+    {
+        fprintf(stderr, "Couldn't open /dev/null\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (!check_llc_fcs_vectors(null_fd))
+    {
+        fprintf(stderr, "LLC FCS check failed\n");
+        exit(EXIT_FAILURE);
+    }
+    printf("llc fcs      : ok\n");
+
+    // decode, keep the fastest run
+
+    bench_result_t best;
+    bool stable_flag = true;
+
+    for (int run = 0; run < repeat; run++)
+    {
+        bench_result_t res = run_capture(bits, len, null_fd, debug_level, metrics_flag, decode_policy_flag, filter_filename, broadcast_keepalive, flywheel_window);
+
+        printf("run %2d : %8.1f ms  %8lu bursts  %8lu reports  checksum %016lx\n",
+               run + 1,
+               res.wall_ns / 1.0e6,
+               (unsigned long)res.bursts,
+               (unsigned long)res.reports,
+               (unsigned long)res.checksum);
+
+        if (run == 0)
+        {
+            best = res;
+            continue;
+        }
+
+        if ((res.checksum != best.checksum) || (res.reports != best.reports))
+        {
+            stable_flag = false;
+        }
+
+        if (res.wall_ns < best.wall_ns)
+        {
+            best = res;
+        }
+    }
+
+    munmap((void *)bits, len);
+    close(fd);
+    close(null_fd);
+
+    // report
+
+    double wall_s = best.wall_ns / 1.0e9;
+
+    printf("\ncapture      : %s (%lu bits, %.1f s of air time)\n", argv[optind], (unsigned long)len, len / 36000.0);
+    printf("bursts       : %lu\n", (unsigned long)best.bursts);
+    printf("reports      : %lu\n", (unsigned long)best.reports);
+    printf("time         : %.1f ms\n", wall_s * 1.0e3);
+    printf("throughput   : %.0f bursts/s  %.0f bits/s  (x%.1f real time)\n",
+           best.bursts / wall_s,
+           len / wall_s,
+           len / wall_s / 36000.0);                                             // downlink is 36 kbit/s
+
+    printf("\n%-14s %10s %7s %12s\n", "stage", "time [ms]", "[%]", "[ns/burst]");
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++)
+    {
+        printf("%-14s %10.2f %7.2f %12.0f\n",
+               stage_names[stage],
+               best.stage_ns[stage] / 1.0e6,
+               100.0 * best.stage_ns[stage] / best.wall_ns,
+               best.bursts ? (double)best.stage_ns[stage] / best.bursts : 0.0);
+    }
+
+    printf("\nchecksum     : %016lx%s\n", (unsigned long)best.checksum, stable_flag ? "" : " (UNSTABLE between runs)");
+
+    return stable_flag ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -17,6 +17,7 @@
  *
  */
 #include "tetra_dl.h"
+#include "utils.h"
 #include <signal.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -43,6 +44,27 @@ static void sigint_handler(int val)
     sigint_flag = 1;
 }
 
+/** @brief Burst trace ring to dump on SIGUSR1 */
+
+static trace_ring_t * sigusr1_trace = NULL;
+
+/**
+ * @brief Handle SIGUSR1 to dump the burst trace ring
+ *
+ */
+
+static void sigusr1_handler(int)
+{
+    int saved_errno = errno;                                                    // main loop checks errno
+
+    if (sigusr1_trace != NULL)
+    {
+        sigusr1_trace->dump(TRACE_REASON_SIGNAL);                               // async-signal-safe
+    }
+
+    errno = saved_errno;
+}
+
 /**
  * @brief Decoder program entry point
  *
@@ -65,13 +87,23 @@ int main(int argc, char * argv[])
     const int FILENAME_LEN = 256;
     char opt_filename_in[FILENAME_LEN]  = "";                                   // input bits filename
     char opt_filename_out[FILENAME_LEN] = "";                                   // output bits filename
+    char opt_filename_metrics[FILENAME_LEN] = "";                               // metrics snapshot filename
+    char opt_filename_trace[FILENAME_LEN] = "";                                 // burst trace dump filename
+    char opt_filename_filter[FILENAME_LEN] = "";                                // subscription filter filename
+    char opt_filename_cell[FILENAME_LEN] = "";                                  // cell state snapshot filename
+    int trace_records = 4096;                                                   // burst trace ring size (about 1 minute)
+    int metrics_period = 10;                                                    // metrics snapshot period [s]
+    int broadcast_keepalive = 10;                                               // unchanged broadcast PDUs report period [s]
+    int flywheel_window = 2;                                                    // tolerated bit slip while synchronized [bits]
+    int log_rate_limit = 0;                                                     // screen lines per second per category, 0 = no limit
 
     int program_mode = STANDARD_MODE;
     int debug_level = 0;
     bool fill_bit_flag = true;
+    bool decode_policy_flag = true;
 
     int option;
-    while ((option = getopt(argc, argv, "hr:t:i:o:d:f")) != -1)
+    while ((option = getopt(argc, argv, "hr:t:i:o:d:fam:M:T:N:F:K:S:W:R:")) != -1)
     {
         switch (option)
         {
@@ -101,6 +133,46 @@ int main(int argc, char * argv[])
             fill_bit_flag = false;
             break;
 
+        case 'a':
+            decode_policy_flag = false;
+            break;
+
+        case 'm':
+            strncpy(opt_filename_metrics, optarg, FILENAME_LEN - 1);
+            break;
+
+        case 'M':
+            metrics_period = atoi(optarg);
+            break;
+
+        case 'T':
+            strncpy(opt_filename_trace, optarg, FILENAME_LEN - 1);
+            break;
+
+        case 'N':
+            trace_records = atoi(optarg);
+            break;
+
+        case 'F':
+            strncpy(opt_filename_filter, optarg, FILENAME_LEN - 1);
+            break;
+
+        case 'K':
+            broadcast_keepalive = atoi(optarg);
+            break;
+
+        case 'S':
+            strncpy(opt_filename_cell, optarg, FILENAME_LEN - 1);
+            break;
+
+        case 'W':
+            flywheel_window = atoi(optarg);
+            break;
+
+        case 'R':
+            log_rate_limit = atoi(optarg);
+            break;
+
         case 'h':
             printf("\nUsage: ./decoder [OPTIONS]\n\n"
                    "Options:\n"
@@ -110,6 +182,16 @@ int main(int argc, char * argv[])
                    "  -o <file> record data to binary file (can be replayed with -i option)\n"
                    "  -d <level> print debug information\n"
                    "  -f keep fill bits\n"
+                   "  -a decode all blocks, including unallocated and encrypted traffic slots\n"
+                   "  -m <file> write metrics snapshot to file (counters and latency histograms)\n"
+                   "  -M <seconds> metrics snapshot period [default 10 s]\n"
+                   "  -T <file> keep a trace of last bursts, dumped to <file>.<reason>.<n> on SIGUSR1, synchronization loss and exit\n"
+                   "  -N <count> number of bursts in trace [default 4096]\n"
+                   "  -F <file> subscription filter, only decode and report selected services, PDUs, SSI and encryption modes\n"
+                   "  -K <seconds> report unchanged broadcast PDUs (SYNC) again after this period, 0 to report all [default 10 s]\n"
+                   "  -S <file> save cell state to file every 10 s and on exit, reload it on start (warm start)\n"
+                   "  -W <bits> search bursts up to this number of bits around their expected position while synchronized, 0 to disable [default 2]\n"
+                   "  -R <lines> print at most this number of lines per second for each output category (TCH, DEFRAG...), 0 for no limit [default 0]\n"
                    "  -h print this help\n\n");
             exit(EXIT_FAILURE);
             break;
@@ -124,6 +206,39 @@ int main(int argc, char * argv[])
     // create decoder
 
     tetra_dl * decoder = new tetra_dl(debug_level, fill_bit_flag);
+    decoder->g_decode_policy_flag = decode_policy_flag;
+    decoder->g_broadcast_keepalive_frames = broadcast_keepalive * 300 / 17;     // TDMA frame is 56.67 ms
+    decoder->g_flywheel_window = flywheel_window < 0 ? 0 : (flywheel_window > 16 ? 16 : flywheel_window); // training sequences must stay in buffer
+
+    bool metrics_flag = (opt_filename_metrics[0] != '\0');
+    decoder->g_profile_flag = metrics_flag;                                     // latency histograms require stages timing
+
+    if (opt_filename_filter[0] != '\0')
+    {
+        decoder->filter = new report_filter_t();
+        if (!decoder->filter->load(opt_filename_filter))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    bool cell_state_flag = (opt_filename_cell[0] != '\0');
+    if (cell_state_flag)                                                        // missing file is not an error, it is written later
+    {
+        decoder->cell_state_load(opt_filename_cell);
+    }
+
+    if (opt_filename_trace[0] != '\0')                                          // read with ./trace_print <file>
+    {
+        decoder->trace = new trace_ring_t(trace_records, opt_filename_trace);
+        sigusr1_trace  = decoder->trace;
+
+        struct sigaction sa_usr1;
+        memset(&sa_usr1, 0, sizeof(struct sigaction));
+        sa_usr1.sa_handler = sigusr1_handler;
+        sa_usr1.sa_flags   = SA_RESTART;                                        // don't break reads
+        sigaction(SIGUSR1, &sa_usr1, 0);
+    }
 
     // output destination socket
 
@@ -194,9 +309,16 @@ int main(int argc, char * argv[])
         }
     }
 
+    const uint64_t CELL_STATE_PERIOD_NS = 10000000000ULL;                       // cell state snapshot period [ns]
     const int RXBUF_LEN = 1024;
     uint8_t rx_buf[RXBUF_LEN];                                                  // receive buffer
 
+    uint64_t metrics_next_ns = utils_now_ns() + (uint64_t)metrics_period * 1000000000ULL;
+    uint64_t cell_state_next_ns = utils_now_ns() + CELL_STATE_PERIOD_NS;
+
+    bool log_blocking_flag = (program_mode & READ_FROM_BINARY_FILE) != 0;      // replayed file output must be complete, live decoding goes first
+    log_start(log_blocking_flag, log_rate_limit < 0 ? 0 : (uint32_t)log_rate_limit);
+
     while (!sigint_flag)
     {
         int bytes_read = read(fd_input, rx_buf, sizeof(rx_buf));
@@ -225,6 +347,39 @@ int main(int argc, char * argv[])
         {
             decoder->rx_symbol(rx_buf[cnt]);                                    // bytes must be pushed one at a time into decoder
         }
+
+        if (metrics_flag && (utils_now_ns() >= metrics_next_ns))                // snapshot is taken by the decoding thread, counters need no locking
+        {
+            decoder->metrics->write_snapshot(opt_filename_metrics, decoder->g_cell_infos, decoder->g_is_synchronized);
+            metrics_next_ns += (uint64_t)metrics_period * 1000000000ULL;
+        }
+
+        if (cell_state_flag && (utils_now_ns() >= cell_state_next_ns))
+        {
+            decoder->cell_state_save(opt_filename_cell);
+            cell_state_next_ns += CELL_STATE_PERIOD_NS;
+        }
+    }
+
+    log_stop();                                                                 // write lines still queued
+
+    if (metrics_flag)                                                           // last snapshot on exit
+    {
+        if (!decoder->metrics->write_snapshot(opt_filename_metrics, decoder->g_cell_infos, decoder->g_is_synchronized))
+        {
+            fprintf(stderr, "Couldn't write metrics file '%s'\n", opt_filename_metrics);
+        }
+    }
+
+    if (cell_state_flag)                                                        // last cell state on exit
+    {
+        decoder->cell_state_save(opt_filename_cell);
+    }
+
+    if (decoder->trace != NULL)                                                 // last bursts on exit
+    {
+        sigusr1_trace = NULL;
+        decoder->trace->dump(TRACE_REASON_EXIT);
     }
 
     close(decoder->socketfd);
@@ -0,0 +1,288 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "filter.h"
+#include "log.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @brief Remove leading and trailing blanks
+ *
+ */
+
+static std::string trim(const std::string & txt)
+{
+    std::size_t start = txt.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos)
+    {
+        return "";
+    }
+
+    std::size_t end = txt.find_last_not_of(" \t\r\n");
+
+    return txt.substr(start, end - start + 1);
+}
+
+/**
+ * @brief Constructor, the default filter keeps everything
+ *
+ */
+
+report_filter_t::report_filter_t()
+{
+    for (int idx = 0; idx < 4; idx++)
+    {
+        encryption_modes[idx] = true;
+    }
+}
+
+/**
+ * @brief Destructor
+ *
+ */
+
+report_filter_t::~report_filter_t()
+{
+
+}
+
+/**
+ * @brief Load rules from file
+ *
+ * @return false if file can't be read or contains an invalid rule
+ *
+ */
+
+bool report_filter_t::load(const char * filename)
+{
+    FILE * file = fopen(filename, "r");
+    if (file == NULL)
+    {
+        log_printf(LOG_ERROR, "Couldn't open filter file '%s'\n", filename);
+        return false;
+    }
+
+    bool b_encryption_rule = false;                                             // first encryption rule replaces default (all modes)
+    bool b_valid           = true;
+    int  line_number       = 0;
+    char buf[512];
+
+    while (b_valid && (fgets(buf, sizeof(buf), file) != NULL))
+    {
+        line_number++;
+
+        std::string line = buf;
+        std::size_t comment = line.find('#');
+        if (comment != std::string::npos)
+        {
+            line.erase(comment);
+        }
+        line = trim(line);
+
+        if (line.empty())
+        {
+            continue;
+        }
+
+        std::size_t sep = line.find_first_of(" \t");
+        std::string keyword = line.substr(0, sep);
+        std::string args    = (sep == std::string::npos) ? "" : trim(line.substr(sep));
+
+        if (keyword == "drop")
+        {
+            sep = args.find_first_of(" \t");
+            std::string kind = args.substr(0, sep);
+            std::string name = (sep == std::string::npos) ? "" : trim(args.substr(sep)); // PDU names may contain spaces
+
+            if (name.empty())
+            {
+                b_valid = false;
+            }
+            else if (kind == "service")
+            {
+                drop_services.push_back(name);
+            }
+            else if (kind == "pdu")
+            {
+                drop_pdus.push_back(name);
+            }
+            else
+            {
+                b_valid = false;
+            }
+        }
+        else if ((keyword == "ssi") || (keyword == "gssi"))                     // same address space for MAC
+        {
+            char * ptr = (char *)args.c_str();
+            char * end = ptr;
+
+            while (*ptr != '\0')
+            {
+                unsigned long val = strtoul(ptr, &end, 10);
+                if ((end == ptr) || (val > 0xffffff))                           // not a number or not a 24 bits address
+                {
+                    b_valid = false;
+                    break;
+                }
+
+                ssi_list.push_back((uint32_t)val);
+                ptr = end + strspn(end, " \t");
+            }
+
+            b_valid = b_valid && !args.empty();
+        }
+        else if (keyword == "encryption")
+        {
+            if (!b_encryption_rule)
+            {
+                for (int idx = 0; idx < 4; idx++)
+                {
+                    encryption_modes[idx] = false;
+                }
+                b_encryption_rule = true;
+            }
+
+            char * ptr = (char *)args.c_str();
+            char * end = ptr;
+
+            while (*ptr != '\0')
+            {
+                unsigned long val = strtoul(ptr, &end, 10);
+                if ((end == ptr) || (val > 3))                                  // encryption mode is 2 bits
+                {
+                    b_valid = false;
+                    break;
+                }
+
+                encryption_modes[val] = true;
+                ptr = end + strspn(end, " \t");
+            }
+
+            b_valid = b_valid && !args.empty();
+        }
+        else
+        {
+            b_valid = false;
+        }
+    }
+
+    fclose(file);
+
+    if (!b_valid)
+    {
+        log_printf(LOG_ERROR, "Invalid rule in filter file '%s' line %d\n", filename, line_number);
+        return false;
+    }
+
+    std::sort(ssi_list.begin(), ssi_list.end());                                // for binary search
+
+    return true;
+}
+
+/**
+ * @brief Check encryption mode
+ *
+ * @return true if the encryption mode is kept
+ *
+ */
+
+bool report_filter_t::accept_encryption(uint8_t encryption_mode) const
+{
+    return encryption_modes[encryption_mode & 0x03];
+}
+
+/**
+ * @brief Check MAC address decoded from MAC-RESOURCE (or assigned to the
+ *        traffic time slot)
+ *
+ * Addresses without SSI (event label only) can't be checked against the
+ * SSI list and are kept.
+ *
+ * @return true if PDUs of this address must be decoded
+ *
+ */
+
+bool report_filter_t::accept_address(const mac_address_t & address) const
+{
+    if (!accept_encryption(address.encryption_mode))
+    {
+        return false;
+    }
+
+    if (ssi_list.empty())
+    {
+        return true;
+    }
+
+    uint32_t ssi;
+
+    switch (address.address_type)
+    {
+    case 0b000:                                                                 // NULL pdu received since, slot keeps last SSI (as defragmenter does)
+    case 0b001:                                                                 // SSI
+    case 0b101:                                                                 // SSI + event label
+    case 0b110:                                                                 // SSI + usage marker
+        ssi = address.ssi;
+        break;
+
+    case 0b011:                                                                 // USSI
+        ssi = address.ussi;
+        break;
+
+    case 0b100:                                                                 // SMI
+    case 0b111:                                                                 // SMI + event label
+        ssi = address.smi;
+        break;
+
+    default:                                                                    // event label or unknown
+        return true;
+    }
+
+    return std::binary_search(ssi_list.begin(), ssi_list.end(), ssi);
+}
+
+/**
+ * @brief Check report service and PDU type
+ *
+ * @return true if the report must be built and sent
+ *
+ */
+
+bool report_filter_t::accept_report(const std::string & service, const std::string & pdu) const
+{
+    for (std::size_t idx = 0; idx < drop_services.size(); idx++)
+    {
+        if (drop_services[idx] == service)
+        {
+            return false;
+        }
+    }
+
+    for (std::size_t idx = 0; idx < drop_pdus.size(); idx++)
+    {
+        if (drop_pdus[idx] == pdu)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
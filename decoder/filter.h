@@ -0,0 +1,60 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef FILTER_H
+#define FILTER_H
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "tetra_common.h"
+
+/**
+ * @brief Subscription filter, selects the PDUs to decode and report
+ *
+ * Loaded from a text file, one rule per line, '#' starts a comment:
+ *
+ *   drop service <service>      ie. "drop service MAC"
+ *   drop pdu <pdu>              ie. "drop pdu D-STATUS"
+ *   ssi <ssi> [<ssi>...]        keep only these SSI/GSSI (may be repeated)
+ *   encryption <mode> [<mode>]  keep only these encryption modes 0..3
+ *
+ * The address rules are checked by MAC as soon as the address is
+ * decoded so upper layers are not parsed at all, the service and pdu
+ * rules are checked by report_start before the report is built.
+ *
+ */
+
+class report_filter_t {
+public:
+    report_filter_t();
+    ~report_filter_t();
+
+    bool load(const char * filename);
+
+    bool accept_address(const mac_address_t & address) const;
+    bool accept_encryption(uint8_t encryption_mode) const;
+    bool accept_report(const std::string & service, const std::string & pdu) const;
+
+private:
+    std::vector<std::string> drop_services;                                     ///< Services not reported
+    std::vector<std::string> drop_pdus;                                         ///< PDU types not reported
+    std::vector<uint32_t> ssi_list;                                             ///< Sorted SSI/GSSI to keep, empty to keep all
+    bool encryption_modes[4];                                                   ///< Encryption modes to keep
+};
+
+#endif /* FILTER_H */
@@ -28,10 +28,9 @@
 
 void tetra_dl::service_llc(std::vector<uint8_t> pdu, mac_logical_channel_t mac_logical_channel)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - mac_channel = %s pdu = %s\n", "service_llc", mac_logical_channel_name(mac_logical_channel).c_str(), vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_LLC, "DEBUG ::%-44s - mac_channel = %s pdu = %s\n", "service_llc", mac_logical_channel_name(mac_logical_channel).c_str(), vector_to_string(pdu, pdu.size()).c_str());
     }
 
     if (mac_logical_channel == BSCH)                                           // TM-SDU is directly sent to MLE
@@ -44,6 +43,7 @@ void tetra_dl::service_llc(std::vector<uint8_t> pdu, mac_logical_channel_t mac_l
     uint8_t advanced_link;
     uint8_t dfinal = -1;
     uint8_t ack_length = 0;
+    bool b_fcs = false;                                                         // TL-SDU is followed by a 32 bits FCS
 
     std::vector<uint8_t> tl_sdu;
 
@@ -79,25 +79,26 @@ void tetra_dl::service_llc(std::vector<uint8_t> pdu, mac_logical_channel_t mac_l
 
     case 0b0100:                                                                // BL-ADATA + FCS
         txt = "BL-ADATA + FCS";
-        pos += 1;                                                                 // nr
-        pos += 1;                                                                 // ns
-        tl_sdu = vector_extract(pdu, pos, utils_substract(pdu.size(), pos) - 32); // TODO removed FCS for now
+        pos += 1;                                                               // nr
+        pos += 1;                                                               // ns
+        b_fcs = true;
         break;
 
     case 0b0101:                                                                // BL-DATA + FCS
         txt = "BL-DATA + FCS";
-        tl_sdu = vector_extract(pdu, pos, utils_substract(pdu.size(), pos) - 32); // TODO removed FCS for now
+        pos += 1;                                                               // ns
+        b_fcs = true;
         break;
 
     case 0b0110:                                                                // BL-UDATA + FCS
         txt = "BL-UDATA + FCS";
-        tl_sdu = vector_extract(pdu, pos, utils_substract(pdu.size(), pos) - 32); // TODO removed FCS for now
+        b_fcs = true;
         break;
 
     case 0b0111:                                                                // BL-ACK + FCS
         txt = "BL-ACK + FCS";
         pos += 1;                                                               // nr
-        tl_sdu = vector_extract(pdu, pos, utils_substract(pdu.size(), pos) - 32); // TODO removed FCS for now
+        b_fcs = true;
         break;
 
     case 0b1000:                                                                // AL-SETUP
@@ -185,9 +186,34 @@ void tetra_dl::service_llc(std::vector<uint8_t> pdu, mac_logical_channel_t mac_l
         break;
     }
 
-    if (g_debug_level > 1)
+    if (b_fcs)                                                                  // corrupted TL-SDU must not reach upper layers
+    {
+        int32_t len = utils_substract(pdu.size(), pos) - 32;
+
+        if (!g_remove_fill_bit_flag)                                            // FCS position is only known once fill bits are removed
+        {
+            tl_sdu = vector_extract(pdu, pos, len);
+        }
+        else if ((len < 0) || !check_llc_fcs(pdu, pos, (uint32_t)len))
+        {
+            metrics->llc_fcs_fail++;
+
+            if (LOG_ENABLED(g_debug_level, 2))
+            {
+                log_printf(LOG_LLC, "service_llc : TN/FN/MN = %2d/%2d/%2d  %-20s FCS FAILED\n", g_time.tn, g_time.fn, g_time.mn, txt.c_str());
+            }
+            return;
+        }
+        else
+        {
+            metrics->llc_fcs_pass++;
+            tl_sdu = vector_extract(pdu, pos, len);
+        }
+    }
+
+    if (LOG_ENABLED(g_debug_level, 2))
     {
-        printf("service_llc : TN/FN/MN = %2d/%2d/%2d  %-20s\n", g_time.tn, g_time.fn, g_time.mn, txt.c_str());
+        log_printf(LOG_LLC, "service_llc : TN/FN/MN = %2d/%2d/%2d  %-20s\n", g_time.tn, g_time.fn, g_time.mn, txt.c_str());
     }
 
     if (tl_sdu.size() > 0)                                                      // service MLE
@@ -0,0 +1,423 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "log.h"
+#include "utils.h"
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const uint64_t RING_SIZE = 1 << 20;                                      // bytes, power of 2
+static const uint32_t LINE_MAX  = RING_SIZE / 4;                                // longer lines are truncated
+
+static const char * category_names[LOG_CATEGORY_COUNT] = {"sync", "mac", "defrag", "llc", "mle", "cmce", "sndcp", "uplane", "report", "error"};
+
+/**
+ * @brief Line header in ring, followed by len bytes of text
+ *
+ */
+
+struct log_header_t {
+    uint32_t len;
+    uint32_t category;
+};
+
+/**
+ * @brief Output state
+ *
+ * The ring has a single writer (the decoding thread, which owns head)
+ * and a single reader (the output thread, which owns tail), so it needs
+ * no lock. Everything else is only used by the decoding thread.
+ *
+ */
+
+struct log_state_t {
+    std::vector<char> ring;                                                     ///< Ring storage
+    std::atomic<uint64_t> head;                                                 ///< Bytes queued since start
+    std::atomic<uint64_t> tail;                                                 ///< Bytes written to screen since start
+    std::atomic<bool> running;                                                  ///< Output thread must keep running
+    std::thread * writer;                                                       ///< Output thread, NULL while output is direct
+
+    bool b_blocking;                                                            ///< Wait for free space instead of dropping lines
+    uint32_t rate_limit;                                                        ///< Lines per second per category, 0 = no limit
+    uint64_t window_start_ns;                                                   ///< Rate limit window start
+    uint32_t window_count[LOG_CATEGORY_COUNT];                                  ///< Lines per category in current window
+    uint64_t window_dropped[LOG_CATEGORY_COUNT];                                ///< Lines dropped per category in current window
+    uint64_t overflow_pending;                                                  ///< Lines dropped since last successful push
+
+    log_stats_t stats;
+};
+
+static log_state_t log_state;
+
+/**
+ * @brief Copy to ring at position pos, wrapping around the end
+ *
+ */
+
+static void ring_copy_in(uint64_t pos, const char * data, uint32_t len)
+{
+    uint64_t offset = pos & (RING_SIZE - 1);
+    uint64_t first  = (len < RING_SIZE - offset) ? len : RING_SIZE - offset;
+
+    memcpy(&log_state.ring[offset], data, first);
+    memcpy(&log_state.ring[0], data + first, len - first);
+}
+
+/**
+ * @brief Copy from ring at position pos, wrapping around the end
+ *
+ */
+
+static void ring_copy_out(uint64_t pos, char * data, uint32_t len)
+{
+    uint64_t offset = pos & (RING_SIZE - 1);
+    uint64_t first  = (len < RING_SIZE - offset) ? len : RING_SIZE - offset;
+
+    memcpy(data, &log_state.ring[offset], first);
+    memcpy(data + first, &log_state.ring[0], len - first);
+}
+
+/**
+ * @brief Write text from ring at position pos to stream
+ *
+ */
+
+static void ring_write(uint64_t pos, uint32_t len, FILE * stream)
+{
+    uint64_t offset = pos & (RING_SIZE - 1);
+    uint64_t first  = (len < RING_SIZE - offset) ? len : RING_SIZE - offset;
+
+    fwrite(&log_state.ring[offset], 1, first, stream);
+    fwrite(&log_state.ring[0], 1, len - first, stream);
+}
+
+/**
+ * @brief Output thread, write queued lines then flush once per batch
+ *
+ */
+
+static void log_writer()
+{
+    while (true)
+    {
+        bool b_running = log_state.running.load(std::memory_order_acquire);    // read before head so the last lines are not missed
+        uint64_t tail  = log_state.tail.load(std::memory_order_relaxed);
+        uint64_t head  = log_state.head.load(std::memory_order_acquire);
+
+        if (tail == head)
+        {
+            if (!b_running)
+            {
+                break;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        while (tail != head)
+        {
+            log_header_t header;
+            ring_copy_out(tail, (char *)&header, sizeof(log_header_t));
+            ring_write(tail + sizeof(log_header_t), header.len, (header.category == LOG_ERROR) ? stderr : stdout);
+
+            tail += sizeof(log_header_t) + header.len;
+            log_state.tail.store(tail, std::memory_order_release);              // space is free as soon as copied to stdio buffer
+        }
+
+        fflush(stdout);
+    }
+}
+
+/**
+ * @brief Queue line in ring
+ *
+ * @return false if there is not enough space and output is not blocking
+ *
+ */
+
+static bool ring_push(uint32_t category, const char * text, uint32_t len)
+{
+    uint64_t size = sizeof(log_header_t) + len;
+    uint64_t head = log_state.head.load(std::memory_order_relaxed);
+
+    while (RING_SIZE - (head - log_state.tail.load(std::memory_order_acquire)) < size)
+    {
+        if (!log_state.b_blocking)
+        {
+            return false;
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    log_header_t header = {len, category};
+    ring_copy_in(head, (const char *)&header, sizeof(log_header_t));
+    ring_copy_in(head + sizeof(log_header_t), text, len);
+
+    log_state.head.store(head + size, std::memory_order_release);
+
+    return true;
+}
+
+/**
+ * @brief Write line directly or queue it for the output thread
+ *
+ */
+
+static void log_write(uint32_t category, const char * text, uint32_t len)
+{
+    if (len > LINE_MAX)
+    {
+        len = LINE_MAX;
+    }
+
+    if (log_state.writer == NULL)
+    {
+        fwrite(text, 1, len, (category == LOG_ERROR) ? stderr : stdout);
+        log_state.stats.lines++;
+        return;
+    }
+
+    if (log_state.overflow_pending > 0)                                         // tell how much is missing before going on
+    {
+        char buf[128];
+        int notice_len = snprintf(buf, sizeof(buf), "* log         : %llu lines dropped, output too slow\n", (unsigned long long)log_state.overflow_pending);
+
+        if (ring_push(LOG_ERROR, buf, (uint32_t)notice_len))
+        {
+            log_state.overflow_pending = 0;
+        }
+    }
+
+    if ((log_state.overflow_pending == 0) && ring_push(category, text, len))
+    {
+        log_state.stats.lines++;
+    }
+    else
+    {
+        log_state.stats.overflow++;
+        log_state.overflow_pending++;
+    }
+}
+
+/**
+ * @brief Check category rate limit, one second fixed window
+ *
+ * @return true if the line can be written
+ *
+ */
+
+static bool log_rate_check(uint32_t category)
+{
+    uint64_t now_ns = utils_now_ns();
+
+    if (now_ns - log_state.window_start_ns >= 1000000000ULL)                    // new window, report what was dropped in the last one
+    {
+        log_state.window_start_ns = now_ns;
+
+        for (uint32_t idx = 0; idx < LOG_CATEGORY_COUNT; idx++)
+        {
+            log_state.window_count[idx] = 0;
+
+            if (log_state.window_dropped[idx] > 0)
+            {
+                char buf[128];
+                int len = snprintf(buf, sizeof(buf), "* log         : %llu %s lines dropped, rate limit %u/s\n",
+                                   (unsigned long long)log_state.window_dropped[idx],
+                                   category_names[idx],
+                                   log_state.rate_limit);
+                log_write(idx, buf, (uint32_t)len);
+                log_state.window_dropped[idx] = 0;
+            }
+        }
+    }
+
+    if (log_state.window_count[category] >= log_state.rate_limit)
+    {
+        log_state.window_dropped[category]++;
+        return false;
+    }
+
+    log_state.window_count[category]++;
+
+    return true;
+}
+
+/**
+ * @brief Start output thread
+ *
+ * With b_blocking, the decoding thread waits when the ring is full so
+ * no line is lost (reading from file). Otherwise lines are dropped and
+ * counted, real time decoding goes first (reading from UDP).
+ *
+ * rate_limit is the maximum lines per second of each category, 0 means
+ * no limit. Errors are never limited.
+ *
+ */
+
+void log_start(bool b_blocking, uint32_t rate_limit)
+{
+    static bool b_atexit = false;
+
+    if (log_state.writer != NULL)
+    {
+        return;
+    }
+
+    if (!b_atexit)                                                              // queued lines are written on exit() too
+    {
+        atexit(log_stop);
+        b_atexit = true;
+    }
+
+    fflush(stdout);                                                             // keep lines printed before in order
+
+    log_state.ring.resize(RING_SIZE);
+    log_state.head.store(0);
+    log_state.tail.store(0);
+    log_state.b_blocking       = b_blocking;
+    log_state.rate_limit       = rate_limit;
+    log_state.window_start_ns  = utils_now_ns();
+    log_state.overflow_pending = 0;
+
+    for (uint32_t idx = 0; idx < LOG_CATEGORY_COUNT; idx++)
+    {
+        log_state.window_count[idx]   = 0;
+        log_state.window_dropped[idx] = 0;
+    }
+
+    log_state.running.store(true);
+    log_state.writer = new std::thread(log_writer);
+}
+
+/**
+ * @brief Write all queued lines and stop output thread, next lines are
+ *        written directly
+ *
+ */
+
+void log_stop()
+{
+    if (log_state.writer == NULL)
+    {
+        return;
+    }
+
+    log_state.running.store(false, std::memory_order_release);
+    log_state.writer->join();
+
+    delete log_state.writer;
+    log_state.writer = NULL;
+
+    if (log_state.overflow_pending > 0)
+    {
+        fprintf(stderr, "* log         : %llu lines dropped, output too slow\n", (unsigned long long)log_state.overflow_pending);
+        log_state.overflow_pending = 0;
+    }
+
+    for (uint32_t idx = 0; idx < LOG_CATEGORY_COUNT; idx++)                     // rate limit window not closed yet
+    {
+        if (log_state.window_dropped[idx] > 0)
+        {
+            fprintf(stderr, "* log         : %llu %s lines dropped, rate limit %u/s\n", (unsigned long long)log_state.window_dropped[idx], category_names[idx], log_state.rate_limit);
+            log_state.window_dropped[idx] = 0;
+        }
+    }
+
+    fflush(stdout);
+}
+
+/**
+ * @brief Wait until all queued lines are written
+ *
+ */
+
+void log_flush()
+{
+    if (log_state.writer != NULL)
+    {
+        while (log_state.tail.load(std::memory_order_acquire) != log_state.head.load(std::memory_order_relaxed))
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    fflush(stdout);                                                             // stdio is locked, safe with output thread
+}
+
+/**
+ * @brief Print formatted line like printf
+ *
+ * Must only be called from the decoding thread. The cost is the
+ * formatting and a copy to the ring, it never waits for the screen
+ * unless output is blocking and the ring is full.
+ *
+ */
+
+void log_printf(log_category_t category, const char * fmt, ...)
+{
+    if ((log_state.rate_limit > 0) && (log_state.writer != NULL) && (category != LOG_ERROR) && !log_rate_check(category))
+    {
+        log_state.stats.rate_limited++;                                         // not even formatted
+        return;
+    }
+
+    char buf[1024];
+
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    if (len < 0)
+    {
+        return;
+    }
+
+    if ((std::size_t)len < sizeof(buf))
+    {
+        log_write(category, buf, (uint32_t)len);
+    }
+    else                                                                        // long line (Json report, PDU dump...)
+    {
+        std::string txt((std::size_t)len + 1, '\0');
+
+        va_start(args, fmt);
+        vsnprintf(&txt[0], txt.size(), fmt, args);
+        va_end(args);
+
+        log_write(category, txt.c_str(), (uint32_t)len);
+    }
+}
+
+/**
+ * @brief Output counters
+ *
+ */
+
+log_stats_t log_stats()
+{
+    return log_state.stats;
+}
@@ -0,0 +1,84 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef LOG_H
+#define LOG_H
+#include <cstdint>
+
+/**
+ * @defgroup log Screen output
+ *
+ * All decoder screen output goes through log_printf(). Once log_start()
+ * is called, lines are copied into a lock-free ring and written to
+ * stdout by a background thread, so a slow terminal or a pipe never
+ * blocks the decoding thread. Before log_start() (and after log_stop())
+ * lines are written directly, as printf() would.
+ *
+ * Debug messages are guarded by LOG_ENABLED(g_debug_level, level): levels
+ * above LOG_MAX_LEVEL are removed at compile time, eg. build with
+ * -DLOG_MAX_LEVEL=1 to remove all PDU dumps.
+ *
+ * @{
+ *
+ */
+
+#ifndef LOG_MAX_LEVEL
+#define LOG_MAX_LEVEL 9                                                         // highest debug level compiled in
+#endif
+
+#define LOG_ENABLED(debug_level, level) (((level) <= LOG_MAX_LEVEL) && ((debug_level) >= (level)))
+
+/**
+ * @brief Output category, rate limit applies to each one separately
+ *
+ */
+
+enum log_category_t {
+    LOG_SYNC     = 0,                                                           // synchronization and warm start
+    LOG_MAC      = 1,                                                           // BSCH, traffic slots and MAC errors
+    LOG_DEFRAG   = 2,                                                           // MAC defragmentation
+    LOG_LLC      = 3,
+    LOG_MLE      = 4,
+    LOG_CMCE     = 5,                                                           // CMCE, SDS and LIP
+    LOG_SNDCP    = 6,
+    LOG_UPLANE   = 7,
+    LOG_REPORT   = 8,                                                           // Json reports
+    LOG_ERROR    = 9,                                                           // written to stderr, never rate limited
+    LOG_CATEGORY_COUNT
+};
+
+/**
+ * @brief Output counters, only read from the decoding thread
+ *
+ */
+
+struct log_stats_t {
+    uint64_t lines;                                                             ///< Lines written or queued
+    uint64_t rate_limited;                                                      ///< Lines dropped by category rate limit
+    uint64_t overflow;                                                          ///< Lines dropped because the ring was full
+};
+
+void log_start(bool b_blocking, uint32_t rate_limit);
+void log_stop();
+void log_flush();
+void log_printf(log_category_t category, const char * fmt, ...) __attribute__((format(printf, 2, 3)));
+log_stats_t log_stats();
+
+/** @} */
+
+#endif /* LOG_H */
@@ -130,10 +130,9 @@ std::string tetra_dl::burst_name(int val)
 
 void tetra_dl::service_lower_mac(std::vector<uint8_t> data, int burst_type)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - burst = %s data = %s\n", "service_lower_mac", burst_name(burst_type).c_str(), vector_to_string(data, data.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_MAC, "DEBUG ::%-44s - burst = %s data = %s\n", "service_lower_mac", burst_name(burst_type).c_str(), vector_to_string(data, data.size()).c_str());
     }
 
     bool bnch_flag = false;
@@ -154,12 +153,30 @@ void tetra_dl::service_lower_mac(std::vector<uint8_t> data, int burst_type)
     }
 
     //printf("BURST %d\n", burst_type);
+    mac_state   = mac_timeslot[g_time.tn - 1].state;                            // restore MAC state and address of the burst time slot
+    mac_address = mac_timeslot[g_time.tn - 1].address;
+
     second_slot_stolen_flag = 0;                                                // stolen flag lifetime is NDB_SF burst life only
+    first_slot_stolen_flag  = 0;
 
     std::vector<uint8_t> bkn1;                                                  // busrt block BKN1
     std::vector<uint8_t> bkn2;                                                  // burst block BKN2
     std::vector<uint8_t> bbk;                                                   // burst block BBK
 
+    decode_policy_t policy = DECODE_FULL;
+
+    if ((burst_type == NDB) || (burst_type == NDB_SF))                          // AACH first, it gives the slot usage and so the blocks to decode
+    {
+        // BBK block - AACH
+        bbk = vector_append(vector_extract(data, 230, 14), vector_extract(data, 266, 16)); // BBK is in two parts
+        bbk = dec_descramble(bbk, 30, g_cell_infos.scrambling_code);                       // descramble
+        bbk = dec_reed_muller_3014_decode(bbk);                                            // Reed-Muller correction
+        service_upper_mac(bbk, AACH);
+
+        policy = mac_decode_policy(burst_type);
+        metrics->decode_policy[policy]++;
+    }
+
     if (burst_type == SB)                                                       // synchronisation burst
     {
         // BKN1 block - BSCH - SB seems to be sent only on FN=18 thus BKN1 contains only BSCH
@@ -168,7 +185,10 @@ void tetra_dl::service_lower_mac(std::vector<uint8_t> data, int burst_type)
         bkn1 = dec_deinterleave(bkn1, 120, 11);                                 // deinterleave 120, 11
         bkn1 = dec_depuncture23(bkn1, 120);                                     // depuncture with 2/3 rate 120 bits -> 4 * 80 bits before Viterbi decoding
         bkn1 = dec_viterbi_decode16_14(bkn1);                                   // Viterbi decode - see 8.3.1.2  (K1 + 16, K1) block code with K1 = 60
-        if (check_crc16ccitt(bkn1, 76))                                         // BSCH found process immediately to calculate scrambling code
+        int crc_ok = check_crc16ccitt(bkn1, 76);
+        metrics->count_crc(BSCH, crc_ok);
+        trace_outcome(TRACE_BKN1_CHECKED | (crc_ok ? TRACE_BKN1_CRC_OK : 0));
+        if (crc_ok)                                                             // BSCH found process immediately to calculate scrambling code
         {
             service_upper_mac(bkn1, BSCH);                                      // only 60 bits are meaningful
         }
@@ -185,34 +205,45 @@ void tetra_dl::service_lower_mac(std::vector<uint8_t> data, int burst_type)
         bkn2 = dec_deinterleave(bkn2, 216, 101);                                // deinterleave
         bkn2 = dec_depuncture23(bkn2, 216);                                     // depuncture with 2/3 rate 144 bits -> 4 * 144 bits before Viterbi decoding
         bkn2 = dec_viterbi_decode16_14(bkn2);                                   // Viterbi decode
-        if (check_crc16ccitt(bkn2, 140))                                        // check CRC
+        crc_ok = check_crc16ccitt(bkn2, 140);                                   // check CRC
+        metrics->count_crc(SCH_HD, crc_ok);
+        trace_outcome(TRACE_BKN2_CHECKED | (crc_ok ? TRACE_BKN2_CRC_OK : 0));
+        if (crc_ok)
         {
             bkn2 = vector_extract(bkn2, 0, 124);
             service_upper_mac(bkn2, SCH_HD);
         }
     }
+    else if (policy == DECODE_AACH_ONLY)                                        // nothing to decode in slot
+    {
+        metrics->blocks_skipped += (burst_type == NDB_SF) ? 2 : 1;
+    }
     else if (burst_type == NDB)                                                 // 1 logical channel in time slot
     {
-        // BBK block
-        bbk = vector_append(vector_extract(data, 230, 14), vector_extract(data, 266, 16)); // BBK is in two parts
-        bbk = dec_descramble(bbk, 30, g_cell_infos.scrambling_code);                       // descramble
-        bbk = dec_reed_muller_3014_decode(bbk);                                            // Reed-Muller correction
-        service_upper_mac(bbk, AACH);
-
-        // BKN1 + BKN2
-        bkn1 = vector_append(vector_extract(data, 14, 216), vector_extract(data, 282, 216)); // reconstruct block to BKN1
-        bkn1 = dec_descramble(bkn1, 432, g_cell_infos.scrambling_code);                      // descramble
+        bool traffic_flag = (mac_state.downlink_usage == TRAFFIC) && (g_time.fn <= 17);
 
-        if ((mac_state.downlink_usage == TRAFFIC) && (g_time.fn <= 17))         // traffic mode
+        if (traffic_flag && (policy == DECODE_SIGNALLING))                      // encrypted speech, nothing stolen
         {
+            metrics->speech_skipped++;
+        }
+        else if (traffic_flag)                                                  // traffic mode
+        {
+            bkn1 = vector_append(vector_extract(data, 14, 216), vector_extract(data, 282, 216)); // reconstruct block to BKN1
+            bkn1 = dec_descramble(bkn1, 432, g_cell_infos.scrambling_code);                      // descramble
+            trace_outcome(TRACE_TRAFFIC);
             service_upper_mac(bkn1, TCH_S);                                     // frame is sent directly to User plane
         }
         else                                                                    // signalling mode
         {
+            bkn1 = vector_append(vector_extract(data, 14, 216), vector_extract(data, 282, 216)); // reconstruct block to BKN1
+            bkn1 = dec_descramble(bkn1, 432, g_cell_infos.scrambling_code);                      // descramble
             bkn1 = dec_deinterleave(bkn1, 432, 103);                            // deinterleave
             bkn1 = dec_depuncture23(bkn1, 432);                                 // depuncture with 2/3 rate 288 bits -> 4 * 288 bits before Viterbi decoding
             bkn1 = dec_viterbi_decode16_14(bkn1);                               // Viterbi decode
-            if (check_crc16ccitt(bkn1, 284))                                    // check CRC
+            int crc_ok = check_crc16ccitt(bkn1, 284);                           // check CRC
+            metrics->count_crc(SCH_F, crc_ok);
+            trace_outcome(TRACE_BKN1_CHECKED | (crc_ok ? TRACE_BKN1_CRC_OK : 0));
+            if (crc_ok)
             {
                 bkn1 = vector_extract(bkn1, 0, 268);
                 service_upper_mac(bkn1, SCH_F);
@@ -224,15 +255,10 @@ void tetra_dl::service_lower_mac(std::vector<uint8_t> data, int burst_type)
         bool bkn1_valid = false;
         bool bkn2_valid = false;
 
-        // BBK block - AACH
-        bbk = vector_append(vector_extract(data, 230, 14), vector_extract(data, 266, 16)); // BBK is in two parts
-        bbk = dec_descramble(bbk, 30, g_cell_infos.scrambling_code);                       // descramble
-        bbk = dec_reed_muller_3014_decode(bbk);                                            // Reed-Muller correction
-        service_upper_mac(bbk, AACH);
-
         // BKN1 block - always SCH/HD (CP channel)
         bkn1 = vector_extract  (data, 14, 216);
         bkn1 = dec_descramble  (bkn1, 216, g_cell_infos.scrambling_code);       // descramble
+        std::vector<uint8_t> tch = bkn1;                                        // descrambled half slots, BKN2 may still be a speech half frame
         bkn1 = dec_deinterleave(bkn1, 216, 101);                                // deinterleave
         bkn1 = dec_depuncture23(bkn1, 216);                                     // depuncture with 2/3 rate 144 bits -> 4 * 144 bits before Viterbi decoding
         bkn1 = dec_viterbi_decode16_14(bkn1);                                   // Viterbi decode
@@ -241,40 +267,64 @@ void tetra_dl::service_lower_mac(std::vector<uint8_t> data, int burst_type)
             bkn1 = vector_extract(bkn1, 0, 124);
             bkn1_valid = true;
         }
+        bool traffic_flag = (mac_state.downlink_usage == TRAFFIC) && (g_time.fn <= 17);
+        metrics->count_crc(traffic_flag ? STCH : SCH_HD, bkn1_valid);
+        trace_outcome(TRACE_BKN1_CHECKED | (bkn1_valid ? TRACE_BKN1_CRC_OK : 0));
 
-        // BKN2 block - SCH/HD or BNCH
+        // BKN2 block - SCH/HD, BNCH, STCH or speech half frame
         bkn2 = vector_extract  (data, 282, 216);
         bkn2 = dec_descramble  (bkn2, 216, g_cell_infos.scrambling_code);       // descramble
-        bkn2 = dec_deinterleave(bkn2, 216, 101);                                // deinterleave
-        bkn2 = dec_depuncture23(bkn2, 216);                                     // depuncture with 2/3 rate 144 bits -> 4 * 144 bits before Viterbi decoding
-        bkn2 = dec_viterbi_decode16_14(bkn2);                                   // Viterbi decode
-        if (check_crc16ccitt(bkn2, 140))                                        // check CRC
-        {
-            bkn2 = vector_extract(bkn2, 0, 124);
-            bkn2_valid = true;
-        }
 
-        if ((mac_state.downlink_usage == TRAFFIC) && (g_time.fn <= 17))         // traffic mode
+        if (traffic_flag)                                                       // traffic mode
         {
             if (bkn1_valid)
             {
                 service_upper_mac(bkn1, STCH);                                  // first block is stolen for C or U signalling
             }
 
-            if (second_slot_stolen_flag)                                        // if second slot is also stolen
+            if (second_slot_stolen_flag)                                        // if second slot is also stolen (known from BKN1 MAC-RESOURCE)
             {
+                bkn2 = dec_deinterleave(bkn2, 216, 101);                        // deinterleave
+                bkn2 = dec_depuncture23(bkn2, 216);                             // depuncture with 2/3 rate 144 bits -> 4 * 144 bits before Viterbi decoding
+                bkn2 = dec_viterbi_decode16_14(bkn2);                           // Viterbi decode
+                if (check_crc16ccitt(bkn2, 140))                                // check CRC
+                {
+                    bkn2 = vector_extract(bkn2, 0, 124);
+                    bkn2_valid = true;
+                }
+                metrics->count_crc(STCH, bkn2_valid);
+                trace_outcome(TRACE_BKN2_CHECKED | (bkn2_valid ? TRACE_BKN2_CRC_OK : 0));
                 if (bkn2_valid)
                 {
                     service_upper_mac(bkn2, STCH);                              // second block also stolen, reset flag
                 }
             }
-            else                                                                // second slot not stolen, so it is still traffic mode
+            else if (policy == DECODE_SIGNALLING)                               // second slot not stolen, encrypted speech is not used
             {
-                // do nothing, TCH/4.2 and 2.8 not taken into account
+                metrics->speech_skipped++;
+            }
+            else                                                                // second slot not stolen, so it is still traffic mode and BKN2 is not decoded
+            {
+                trace_outcome(TRACE_TRAFFIC);
+                tch = vector_append(tch, bkn2);
+                first_slot_stolen_flag = 1;                                     // BKN2 holds the second speech frame, the codec decodes it alone
+                service_upper_mac(tch, TCH_S);                                  // TCH/4.2 and 2.8 not taken into account
+                first_slot_stolen_flag = 0;
             }
         }
         else                                                                    // otherwise signalling mode (see 19.4.4)
         {
+            bkn2 = dec_deinterleave(bkn2, 216, 101);                            // deinterleave
+            bkn2 = dec_depuncture23(bkn2, 216);                                 // depuncture with 2/3 rate 144 bits -> 4 * 144 bits before Viterbi decoding
+            bkn2 = dec_viterbi_decode16_14(bkn2);                               // Viterbi decode
+            if (check_crc16ccitt(bkn2, 140))                                    // check CRC
+            {
+                bkn2 = vector_extract(bkn2, 0, 124);
+                bkn2_valid = true;
+            }
+            metrics->count_crc(bnch_flag ? BNCH : SCH_HD, bkn2_valid);
+            trace_outcome(TRACE_BKN2_CHECKED | (bkn2_valid ? TRACE_BKN2_CRC_OK : 0));
+
             if (bkn1_valid)
             {
                 service_upper_mac(bkn1, SCH_HD);
@@ -298,6 +348,41 @@ void tetra_dl::service_lower_mac(std::vector<uint8_t> data, int burst_type)
         // unkown burst type
         return;
     }
+
+    mac_timeslot[g_time.tn - 1].state   = mac_state;                            // keep MAC state and address of the time slot for its next burst
+    mac_timeslot[g_time.tn - 1].address = mac_address;                          // note: time slot may have been corrected by SYNC PDU
+}
+
+/**
+ * @brief Decide which blocks of a burst must be decoded - called after AACH
+ *
+ *   - unallocated slot: nothing is sent, AACH only
+ *   - traffic slot with encrypted usage marker: speech can't be used,
+ *     only stolen signalling blocks (STCH) are decoded
+ *   - otherwise everything is decoded
+ *
+ * Frame 18 is always decoded since it is reserved for control signalling.
+ *
+ */
+
+decode_policy_t tetra_dl::mac_decode_policy(int burst_type)
+{
+    if (!g_decode_policy_flag || (burst_type == SB) || (g_time.fn == 18))
+    {
+        return DECODE_FULL;
+    }
+
+    if (mac_state.downlink_usage == UNALLOCATED)
+    {
+        return DECODE_AACH_ONLY;
+    }
+
+    if ((mac_state.downlink_usage == TRAFFIC) && (usage_marker_encryption_mode[mac_state.downlink_usage_marker] != 0))
+    {
+        return DECODE_SIGNALLING;
+    }
+
+    return DECODE_FULL;
 }
 
 /**
@@ -329,10 +414,9 @@ void tetra_dl::service_lower_mac(std::vector<uint8_t> data, int burst_type)
 
 void tetra_dl::service_upper_mac(std::vector<uint8_t> data, mac_logical_channel_t mac_logical_channel)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - mac_channel = %s data = %s\n", "service_upper_mac", mac_logical_channel_name(mac_logical_channel).c_str(), vector_to_string(data, data.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_MAC, "DEBUG ::%-44s - mac_channel = %s data = %s\n", "service_upper_mac", mac_logical_channel_name(mac_logical_channel).c_str(), vector_to_string(data, data.size()).c_str());
     }
 
     std::string txt = "?";
@@ -358,13 +442,13 @@ void tetra_dl::service_upper_mac(std::vector<uint8_t> data, mac_logical_channel_
         break;
 
     case TCH_S:                                                                 // (TMD) MAC-TRAFFIC PDU full slot
-        printf("TCH_S       : TN/FN/MN = %2d/%2d/%2d    dl_usage_marker=%d, encr=%u\n", g_time.tn, g_time.fn, g_time.mn, mac_state.downlink_usage_marker, usage_marker_encryption_mode[mac_state.downlink_usage_marker]);
+        log_printf(LOG_MAC, "TCH_S       : TN/FN/MN = %2d/%2d/%2d    dl_usage_marker=%d, encr=%u\n", g_time.tn, g_time.fn, g_time.mn, mac_state.downlink_usage_marker, usage_marker_encryption_mode[mac_state.downlink_usage_marker]);
         txt = "  tch_s";
         service_u_plane(data, TCH_S);
         break;
 
     case TCH:                                                                   // TCH half-slot TODO not taken into account for now
-        printf("TCH         : TN/FN/MN = %2d/%2d/%2d    dl_usage_marker=%d, encr=%u\n", g_time.tn, g_time.fn, g_time.mn, mac_state.downlink_usage_marker, usage_marker_encryption_mode[mac_state.downlink_usage_marker]);
+        log_printf(LOG_MAC, "TCH         : TN/FN/MN = %2d/%2d/%2d    dl_usage_marker=%d, encr=%u\n", g_time.tn, g_time.fn, g_time.mn, mac_state.downlink_usage_marker, usage_marker_encryption_mode[mac_state.downlink_usage_marker]);
         txt = "  tch";
         service_u_plane(data, TCH);
         break;
@@ -434,7 +518,7 @@ void tetra_dl::service_upper_mac(std::vector<uint8_t> data, mac_logical_channel_
             else
             {
                 txt = "MAC-ERROR";
-                printf("MAC error   : TN/FN/MN = %2d/%2d/%2d    supplementary block on channel %d\n", g_time.tn, g_time.fn, g_time.mn, mac_logical_channel);
+                log_printf(LOG_MAC, "MAC error   : TN/FN/MN = %2d/%2d/%2d    supplementary block on channel %d\n", g_time.tn, g_time.fn, g_time.mn, mac_logical_channel);
             }
             break;
 
@@ -509,10 +593,14 @@ static uint32_t decode_length(uint32_t val)
 
 void tetra_dl::mac_pdu_process_aach(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
+    {
+        log_printf(LOG_MAC, "DEBUG ::%-44s - pdu = %s\n", "mac_pdu_process_aach", vector_to_string(pdu, pdu.size()).c_str());
+    }
+
+    if (trace != NULL)
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "mac_pdu_process_aach", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        trace->current()->aach = get_value(pdu, 0, 14);
     }
 
     uint8_t pos = 0;
@@ -558,6 +646,13 @@ void tetra_dl::mac_pdu_process_aach(std::vector<uint8_t> pdu)
             default:
                 mac_state.downlink_usage = TRAFFIC;
                 mac_state.downlink_usage_marker = field1;                       // note: 3 < field1 <= 63
+
+                if (mac_address.usage_marker != field1)                         // slot address belongs to a previous call, owner is unknown
+                {
+                    memset(&mac_address, 0, sizeof(mac_address));
+                    mac_address.usage_marker    = field1;
+                    mac_address.encryption_mode = usage_marker_encryption_mode[field1];
+                }
                 break;
             }
         }
@@ -574,6 +669,31 @@ void tetra_dl::mac_pdu_process_aach(std::vector<uint8_t> pdu)
            field2);*/
 }
 
+/**
+ * @brief Assign the current MAC address (usage marker assignment) to the
+ *        traffic time slots of a channel allocation - see 21.5.2
+ *
+ * Timeslot assigned is a bit map, MSB is TN 1. The carrier number is not
+ * checked since the decoder doesn't know which carrier it is listening
+ * to, a wrong assignment is corrected by the ACCESS-ASSIGN usage marker.
+ *
+ */
+
+void tetra_dl::mac_assign_traffic_timeslots(uint8_t timeslot_assigned)
+{
+    for (int idx = 0; idx < 4; idx++)
+    {
+        if ((timeslot_assigned >> (3 - idx)) & 1)
+        {
+            if (idx == g_time.tn - 1)
+            {
+                continue;                                                       // current slot address is already up to date
+            }
+            mac_timeslot[idx].address = mac_address;
+        }
+    }
+}
+
 /**
  * @brief Remove fill bits - see 23.4.3.2
  *
@@ -586,29 +706,26 @@ std::vector<uint8_t> tetra_dl::mac_remove_fill_bits(const std::vector<uint8_t> p
 
     if (g_remove_fill_bit_flag)
     {
-        if (g_debug_level > 6)
+        if (LOG_ENABLED(g_debug_level, 7))
         {
-            printf(" ------- mac_remove_fill_bits BEFORE -- %u bits\n", (uint32_t)ret.size());
-            print_vector(ret, ret.size());
+            log_printf(LOG_MAC, " ------- mac_remove_fill_bits BEFORE -- %u bits\n", (uint32_t)ret.size());
+            log_printf(LOG_MAC, "%s\n", vector_to_string(ret, ret.size()).c_str());
         }
 
-        if (ret[ret.size() - 1] == 1)
+        while ((ret.size() > 0) && (ret[ret.size() - 1] == 0))
         {
-            ret.resize(ret.size() - 1);                                         // 23.4.3.2 remove last 1
+            ret.resize(ret.size() - 1);                                         // 23.4.3.2 remove all 0
         }
-        else
+
+        if (ret.size() > 0)
         {
-            while (ret[ret.size() - 1] == 0)
-            {
-                ret.resize(ret.size() - 1);                                     // 23.4.3.2 remove all 0
-            }
             ret.resize(ret.size() - 1);                                         // 23.4.3.2 then remove last 1
         }
 
-        if (g_debug_level > 6)
+        if (LOG_ENABLED(g_debug_level, 7))
         {
-            printf(" ------- mac_remove_fill_bits AFTER --- %u bits\n", (uint32_t)ret.size());
-            print_vector(ret, ret.size());
+            log_printf(LOG_MAC, " ------- mac_remove_fill_bits AFTER --- %u bits\n", (uint32_t)ret.size());
+            log_printf(LOG_MAC, "%s\n", vector_to_string(ret, ret.size()).c_str());
         }
 
     }
@@ -636,10 +753,9 @@ std::vector<uint8_t> tetra_dl::mac_remove_fill_bits(const std::vector<uint8_t> p
 
 std::vector<uint8_t> tetra_dl::mac_pdu_process_ressource(std::vector<uint8_t> mac_pdu, mac_logical_channel_t mac_logical_channel, bool * b_fragmented_packet)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "mac_pdu_process_ressource", vector_to_string(mac_pdu, mac_pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_MAC, "DEBUG ::%-44s - pdu = %s\n", "mac_pdu_process_ressource", vector_to_string(mac_pdu, mac_pdu.size()).c_str());
     }
 
     std::vector<uint8_t> pdu = mac_pdu;
@@ -648,14 +764,9 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_ressource(std::vector<uint8_t> ma
 
     uint32_t pos = 2;                                                           // MAC pdu type
 
-    uint8_t fill_bit_flag = get_value(pdu, pos, 1);                             // fill bit indication
+    uint8_t fill_bit_flag = get_value(pdu, pos, 1);                             // fill bit indication, removed with the TM-SDU
     pos += 1;
 
-    if (fill_bit_flag)
-    {
-        pdu = mac_remove_fill_bits(pdu);
-    }
-
     pos += 1;                                                                   // position of grant
     mac_address.encryption_mode = get_value(pdu, pos, 2);                       // encryption mode see EN 300 392-7
     pos += 2;
@@ -677,6 +788,8 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_ressource(std::vector<uint8_t> ma
     mac_address.address_type = get_value(pdu, pos, 3);
     pos += 3;
 
+    bool b_filtered = false;
+
     // Note that address type may be encrypted, anyway event label and usage marker
     // should not (see EN 300 392-7 clause 4.2.6)
     
@@ -733,6 +846,8 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_ressource(std::vector<uint8_t> ma
             break;
         }
 
+        b_filtered = report_address_filtered();                                 // the header is still parsed to follow traffic assignments
+
         if (get_value(pdu, pos, 1))                                             // power control flag
         {
             pos += 1 + 4;
@@ -759,10 +874,12 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_ressource(std::vector<uint8_t> ma
 
             // 21.5.2 channel allocation elements table 21.82 (may be encrypted)
             pos += 2;                                                           // channel allocation type
+            uint8_t timeslot_assigned = get_value(pdu, pos, 4);
             pos += 4;                                                           // timeslot assigned
             uint8_t ul_dl = get_value(pdu, pos, 2);
             pos += 2;                                                           // up/downlink assigned
             pos += 1;                                                           // CLCH permission
+            uint8_t cell_change_flag = get_value(pdu, pos, 1);
             pos += 1;                                                           // cell change flag
             pos += 12;                                                          // carrier number
             flag = get_value(pdu, pos, 1);                                      // extended carrier numbering flag
@@ -781,6 +898,11 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_ressource(std::vector<uint8_t> ma
                 pos += 2;
             }
 
+            if ((mac_address.address_type == 0b110) && (ul_dl != 0b10) && !cell_change_flag) // downlink traffic assigned to usage marker in this cell
+            {
+                mac_assign_traffic_timeslots(timeslot_assigned);
+            }
+
             if (ul_dl == 0)                                                     // augmented channel allocation
             {
                 pos += 2;
@@ -823,6 +945,11 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_ressource(std::vector<uint8_t> ma
     // in case of NULL pdu, the length shall be 16 bits
     int32_t sdu_length = (int32_t)decode_length(length) * 8 - (int32_t)pos;
 
+    if (b_filtered)                                                             // neither reassembled nor sent to LLC
+    {
+        return sdu;
+    }
+
     if (sdu_length > 0)
     {
         // longest recommended size for TM_SDU 1106 bits = 133 bytes (with FCS) or 137 bytes (without FCS)
@@ -830,12 +957,22 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_ressource(std::vector<uint8_t> ma
 
         if (*b_fragmented_packet)
         {
+            if (fill_bit_flag)                                                  // first fragment fills the block
+            {
+                pdu = mac_remove_fill_bits(pdu);
+            }
+
             mac_defrag->start(mac_address, g_time);
-            mac_defrag->append(vector_extract(pdu, pos, utils_substract(pdu.size(), pos)), mac_address); // length is the whole packet size - pos
+            mac_defrag->append(vector_extract(pdu, pos, utils_substract(pdu.size(), pos)), mac_address, g_time); // length is the whole packet size - pos
         }
         else
         {
             sdu = vector_extract(pdu, pos, sdu_length);
+
+            if (fill_bit_flag && (sdu.size() > 0))                              // 23.4.3.2 fill bits are at the end of the MAC PDU, not of the block
+            {
+                sdu = mac_remove_fill_bits(sdu);
+            }
         }
     }
 
@@ -855,10 +992,14 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_ressource(std::vector<uint8_t> ma
 
 void tetra_dl::mac_pdu_process_mac_frag(std::vector<uint8_t> mac_pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
+    {
+        log_printf(LOG_MAC, "DEBUG ::%-44s - pdu = %s\n", "mac_pdu_process_mac_frag", vector_to_string(mac_pdu, mac_pdu.size()).c_str());
+    }
+
+    if (report_address_filtered())                                              // first fragment was filtered
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "mac_pdu_process_mac_frag", vector_to_string(mac_pdu, mac_pdu.size()).c_str());
-        fflush(stdout);
+        return;
     }
 
     std::vector<uint8_t> pdu = mac_pdu;
@@ -875,7 +1016,7 @@ void tetra_dl::mac_pdu_process_mac_frag(std::vector<uint8_t> mac_pdu)
 
     std::vector<uint8_t> sdu = vector_extract(pdu, pos, utils_substract(pdu.size(), pos));
 
-    mac_defrag->append(sdu, mac_address);
+    mac_defrag->append(sdu, mac_address, g_time);
 }
 
 /**
@@ -890,10 +1031,15 @@ void tetra_dl::mac_pdu_process_mac_frag(std::vector<uint8_t> mac_pdu)
 
 std::vector<uint8_t> tetra_dl::mac_pdu_process_mac_end(std::vector<uint8_t> mac_pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "mac_pdu_process_mac_end", vector_to_string(mac_pdu, mac_pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_MAC, "DEBUG ::%-44s - pdu = %s\n", "mac_pdu_process_mac_end", vector_to_string(mac_pdu, mac_pdu.size()).c_str());
+    }
+
+    if (report_address_filtered())                                              // first fragment was filtered
+    {
+        std::vector<uint8_t> null_pdu;
+        return null_pdu;
     }
 
     std::vector<uint8_t> pdu = mac_pdu;
@@ -903,11 +1049,6 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_mac_end(std::vector<uint8_t> mac_
     uint8_t fill_bit_flag = get_value(pdu, pos, 1);                             // fill bits
     pos += 1;
 
-    if (fill_bit_flag)
-    {
-        pdu = mac_remove_fill_bits(pdu);
-    }
-
     pos += 1;                                                                   // position of grant
 
     uint32_t val = get_value(pdu, pos, 6);                                      // length of MAC pdu
@@ -919,7 +1060,17 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_mac_end(std::vector<uint8_t> mac_
         return null_pdu;
     }
 
-    //uint32_t length = decode_length(val);                                       // convert length in bytes (includes MAC PDU header + TM_SDU length)
+    uint32_t length = decode_length(val) * 8;                                   // length in bits (includes MAC PDU header, TM_SDU and fill bits)
+
+    if (length < pdu.size())                                                    // MAC PDU ends before the block, so do its fill bits
+    {
+        pdu.resize(length);
+    }
+
+    if (fill_bit_flag)
+    {
+        pdu = mac_remove_fill_bits(pdu);
+    }
 
     uint8_t flag = get_value(pdu, pos, 1);                                      // slot granting flag
     pos += 1;
@@ -958,18 +1109,16 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_mac_end(std::vector<uint8_t> mac_
 
     std::vector<uint8_t> sdu;
 
-    mac_defrag->append(vector_extract(pdu, pos, utils_substract(pdu.size(), pos)), mac_address);
+    mac_defrag->append(vector_extract(pdu, pos, utils_substract(pdu.size(), pos)), mac_address, g_time);
 
     uint8_t encryption_mode;
     uint8_t usage_marker;
-    sdu = mac_defrag->get_sdu(&encryption_mode, &usage_marker);
+    sdu = mac_defrag->get_sdu(mac_address, g_time, &encryption_mode, &usage_marker); // reassembly is ended and counted
     if (sdu.size() > 0)
     {
         usage_marker_encryption_mode[usage_marker] = encryption_mode;
         mac_address.encryption_mode                = encryption_mode;           // FIXME it may be required to overwrite the last mac_address encryption state with last fragment encryption state of MAC
     }
-    
-    mac_defrag->stop();
 
     return sdu;
 }
@@ -981,10 +1130,9 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_mac_end(std::vector<uint8_t> mac_
 
 std::vector<uint8_t> tetra_dl::mac_pdu_process_sysinfo(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "mac_pdu_process_sysinfo", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_MAC, "DEBUG ::%-44s - pdu = %s\n", "mac_pdu_process_sysinfo", vector_to_string(pdu, pdu.size()).c_str());
     }
 
     std::vector<uint8_t> sdu;
@@ -993,6 +1141,11 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_sysinfo(std::vector<uint8_t> pdu)
 
     if (pdu.size() >= MIN_SIZE)
     {
+        if (!broadcast_changed(BROADCAST_SYSINFO, pdu, pdu.size(), 44, get_value(pdu, 43, 1) ? 16 : 0)) // hyperframe count changes, frequency and MLE data don't
+        {
+            return sdu;
+        }
+
         uint32_t pos = 4;
         uint16_t main_carrier = get_value(pdu, pos, 12);                        // main carrier frequency (1 / 25 kHz)
         pos += 12;
@@ -1052,10 +1205,9 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_sysinfo(std::vector<uint8_t> pdu)
 
 std::vector<uint8_t> tetra_dl::mac_pdu_process_d_block(std::vector<uint8_t> mac_pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "mac_pdu_process_d_block", vector_to_string(mac_pdu, mac_pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_MAC, "DEBUG ::%-44s - pdu = %s\n", "mac_pdu_process_d_block", vector_to_string(mac_pdu, mac_pdu.size()).c_str());
     }
 
     std::vector<uint8_t> pdu = mac_pdu;
@@ -1105,10 +1257,9 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_d_block(std::vector<uint8_t> mac_
 
 std::vector<uint8_t> tetra_dl::mac_pdu_process_sync(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "mac_pdu_process_sync", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_MAC, "DEBUG ::%-44s - pdu = %s\n", "mac_pdu_process_sync", vector_to_string(pdu, pdu.size()).c_str());
     }
 
     std::vector<uint8_t> sdu;
@@ -1117,8 +1268,14 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_sync(std::vector<uint8_t> pdu)
 
     if (pdu.size() >= MIN_SIZE)
     {
+        bool b_changed = broadcast_changed(BROADCAST_SYNC, pdu, MIN_SIZE, 10, 13); // TN/FN/MN change on each SYNC
+        tetra_time_t estimate = g_time;                                         // before it is overwritten
+
         uint32_t pos = 4;                                                       // system code
-        g_cell_infos.color_code = get_value(pdu, pos, 6);
+        if (b_changed)
+        {
+            g_cell_infos.color_code = get_value(pdu, pos, 6);
+        }
         pos += 6;
         g_time.tn = get_value(pdu, pos, 2) + 1;
         pos += 2;
@@ -1132,26 +1289,36 @@ std::vector<uint8_t> tetra_dl::mac_pdu_process_sync(std::vector<uint8_t> pdu)
         pos += 1;                                                               // frame 18 extension
         pos += 1;                                                               // reserved
 
-        g_cell_infos.mcc = get_value(pdu, 31, 10);                              // should be done in MLE but we need it here to calculate scrambling code
-        g_cell_infos.mnc = get_value(pdu, 41, 14);
+        if (b_changed)                                                          // otherwise cell informations are still valid
+        {
+            g_cell_infos.mcc = get_value(pdu, 31, 10);                          // should be done in MLE but we need it here to calculate scrambling code
+            g_cell_infos.mnc = get_value(pdu, 41, 14);
 
-        calculate_scrambling_code();
+            calculate_scrambling_code();
+        }
         g_cell_informations_acquired = true;
 
-        report_start("MAC", "SYNC");
-        report_send();
+        if (g_cell_state_pending)                                               // first SYNC after warm start
+        {
+            cell_state_validate(estimate);
+        }
+
+        if (broadcast_report_due(BROADCAST_SYNC, b_changed) && report_start("MAC", "SYNC")) // scrambling code is required even if report is filtered
+        {
+            report_send();
+        }
 
         if ((g_time.fn == 18) && ((g_time.mn + g_time.tn) % 4 == 3))
         {
-            printf("BSCH        : TN/FN/MN = %2u/%2u/%2u  MAC-SYNC              ColorCode=%3d  MCC/MNC = %3u/ %3u  Freq= %10.6f MHz  burst=%u\n",
-                   g_time.tn,
-                   g_time.fn,
-                   g_time.mn,
-                   g_cell_infos.color_code,
-                   g_cell_infos.mcc,
-                   g_cell_infos.mnc,
-                   g_cell_infos.downlink_frequency / 1.0e6,
-                   cur_burst_type);
+            log_printf(LOG_MAC, "BSCH        : TN/FN/MN = %2u/%2u/%2u  MAC-SYNC              ColorCode=%3d  MCC/MNC = %3u/ %3u  Freq= %10.6f MHz  burst=%u\n",
+                       g_time.tn,
+                       g_time.fn,
+                       g_time.mn,
+                       g_cell_infos.color_code,
+                       g_cell_infos.mcc,
+                       g_cell_infos.mnc,
+                       g_cell_infos.downlink_frequency / 1.0e6,
+                       cur_burst_type);
         }
 
         sdu = vector_extract(pdu, pos, 29);
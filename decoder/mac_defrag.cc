@@ -1,20 +1,84 @@
 #include "mac_defrag.h"
 #include "utils.h"
+#include "log.h"
 
 static const int DEBUG_VAL = 1;                                                 // start debug informations at level 1
 
+/**
+ * @brief Number of TDMA frames from time "from" to time "to", the
+ *        multiframe number wraps every 60 multiframes
+ *
+ */
+
+static int frame_age(const tetra_time_t from, const tetra_time_t to)
+{
+    const int HYPERFRAME_FRAMES = 18 * 60;
+
+    int from_idx = (from.mn - 1) * 18 + (from.fn - 1);
+    int to_idx   = (to.mn - 1) * 18 + (to.fn - 1);
+
+    return (to_idx - from_idx + HYPERFRAME_FRAMES) % HYPERFRAME_FRAMES;
+}
+
+/**
+ * @brief Check if fragment address is the one of the context, only the
+ *        field used by the address type is compared (the other ones may
+ *        be stale)
+ *
+ * A NULL PDU received in the time slot since the MAC-RESOURCE only
+ * clears the address type, the address fields are kept.
+ *
+ */
+
+static bool same_address(const mac_address_t & ctx_address, const mac_address_t & address)
+{
+    uint8_t address_type = (address.address_type == 0b000) ? ctx_address.address_type : address.address_type;
+
+    if (ctx_address.address_type != address_type)
+    {
+        return false;
+    }
+
+    switch (address_type)
+    {
+    case 0b001:                                                                 // SSI
+    case 0b101:                                                                 // SSI + event label
+    case 0b110:                                                                 // SSI + usage marker
+        return ctx_address.ssi == address.ssi;
+
+    case 0b011:                                                                 // USSI
+        return ctx_address.ussi == address.ussi;
+
+    case 0b100:                                                                 // SMI
+    case 0b111:                                                                 // SMI + event label
+        return ctx_address.smi == address.smi;
+
+    case 0b010:                                                                 // event label
+        return ctx_address.event_label == address.event_label;
+
+    default:                                                                    // NULL PDU, never fragmented
+        return false;
+    }
+}
+
 /**
  * @brief Defragmenter constructor
  *
+ * TM-SDU buffers are allocated once here, reassembly appends in place.
+ *
  */
 
-mac_defrag_t::mac_defrag_t(int debug_level)
+mac_defrag_t::mac_defrag_t(int debug_level, metrics_t * decoder_metrics)
 {
     g_debug_level = debug_level;
-    tm_sdu.clear();
+    metrics       = decoder_metrics;
 
-    fragments_count = 0;
-    b_stopped       = true;
+    for (int idx = 0; idx < CONTEXTS_COUNT; idx++)
+    {
+        contexts[idx].b_active        = false;
+        contexts[idx].fragments_count = 0;
+        contexts[idx].tm_sdu.reserve(TM_SDU_MAX_BITS);
+    }
 }
 
 /**
@@ -24,12 +88,68 @@ mac_defrag_t::mac_defrag_t(int debug_level)
 
 mac_defrag_t::~mac_defrag_t()
 {
-    tm_sdu.clear();
+
+}
+
+/**
+ * @brief Find active context for time slot and address
+ *
+ * @return context or NULL if there is none
+ *
+ */
+
+mac_defrag_context_t * mac_defrag_t::find(const mac_address_t address, const tetra_time_t time_slot)
+{
+    for (int idx = 0; idx < CONTEXTS_COUNT; idx++)
+    {
+        mac_defrag_context_t * ctx = &contexts[idx];
+
+        if (ctx->b_active && (ctx->start_time.tn == time_slot.tn) && same_address(ctx->mac_address, address))
+        {
+            return ctx;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Drop contexts which didn't receive a fragment for EXPIRY_FRAMES frames
+ *
+ */
+
+void mac_defrag_t::expire(const tetra_time_t time_slot)
+{
+    for (int idx = 0; idx < CONTEXTS_COUNT; idx++)
+    {
+        mac_defrag_context_t * ctx = &contexts[idx];
+
+        if (ctx->b_active)
+        {
+            int age = frame_age(ctx->last_time, time_slot);                     // frames since last fragment
+
+            if (age > EXPIRY_FRAMES)
+            {
+                if (LOG_ENABLED(g_debug_level, DEBUG_VAL))
+                {
+                    log_printf(LOG_DEFRAG, "  * DEFRAG FAILED   : expired after %d frames, %d fragments received for SSI = %u: %u recovered\n",
+                               age,
+                               ctx->fragments_count,
+                               ctx->mac_address.ssi,
+                               (uint32_t)ctx->tm_sdu.size());
+                }
+
+                stop(ctx, false);
+            }
+        }
+    }
 }
 
 /**
- * @brief Start defragmenter, flush previous data if already in use
- *        and report informations
+ * @brief Start a reassembly and report informations
+ *
+ * A reassembly already in progress for the same time slot and address
+ * is lost. When all contexts are in use, the oldest one is lost.
  *
  * NOTE: total fragmented length is unknown
  *
@@ -37,124 +157,181 @@ mac_defrag_t::~mac_defrag_t()
 
 void mac_defrag_t::start(const mac_address_t address, const tetra_time_t time_slot)
 {
-    if (tm_sdu.size() > 0u)
+    expire(time_slot);
+
+    mac_defrag_context_t * ctx = find(address, time_slot);
+
+    if (ctx != NULL)                                                            // previous TM-SDU was not ended
     {
-        if (g_debug_level >= DEBUG_VAL)
+        if (LOG_ENABLED(g_debug_level, DEBUG_VAL))
         {
-            printf("  * DEFRAG FAILED   : invalid %d fragments received for SSI = %u: %u recovered for address %u\n",
-                   fragments_count,
-                   mac_address.ssi,
-                   (uint32_t)tm_sdu.size(),
-                   mac_address.ssi);
+            log_printf(LOG_DEFRAG, "  * DEFRAG FAILED   : invalid %d fragments received for SSI = %u: %u recovered for address %u\n",
+                       ctx->fragments_count,
+                       ctx->mac_address.ssi,
+                       (uint32_t)ctx->tm_sdu.size(),
+                       address.ssi);
         }
+        stop(ctx, false);
     }
+    else
+    {
+        int oldest_age = -1;
 
-    mac_address     = address;                                                  // at this point, the defragmenter MAC address contains encryption mode
-    start_time      = time_slot;
-    fragments_count = 0;
+        for (int idx = 0; idx < CONTEXTS_COUNT; idx++)
+        {
+            if (!contexts[idx].b_active)                                        // free context
+            {
+                ctx = &contexts[idx];
+                break;
+            }
 
-    if (g_debug_level >= DEBUG_VAL)
-    {
-        printf("  * DEFRAG START    : SSI = %u - TN/FN/MN = %02u/%02u/%02u\n",
-               mac_address.ssi,
-               start_time.tn,
-               start_time.fn,
-               start_time.mn);
+            int age = frame_age(contexts[idx].start_time, time_slot);
+            if (age > oldest_age)
+            {
+                oldest_age = age;
+                ctx        = &contexts[idx];
+            }
+        }
+
+        if (ctx->b_active)                                                      // table is full, the oldest reassembly is lost
+        {
+            if (LOG_ENABLED(g_debug_level, DEBUG_VAL))
+            {
+                log_printf(LOG_DEFRAG, "  * DEFRAG FAILED   : no free context, %d fragments received for SSI = %u dropped\n",
+                           ctx->fragments_count,
+                           ctx->mac_address.ssi);
+            }
+            stop(ctx, false);
+        }
     }
 
-    tm_sdu.clear();                                                             // clear the buffer
+    ctx->b_active        = true;
+    ctx->mac_address     = address;                                             // at this point, the defragmenter MAC address contains encryption mode
+    ctx->start_time      = time_slot;
+    ctx->last_time       = time_slot;
+    ctx->fragments_count = 0;
+    ctx->tm_sdu.clear();                                                        // clear the buffer, capacity is kept
 
-    b_stopped = false;
+    if (LOG_ENABLED(g_debug_level, DEBUG_VAL))
+    {
+        log_printf(LOG_DEFRAG, "  * DEFRAG START    : SSI = %u - TN/FN/MN = %02u/%02u/%02u\n",
+                   ctx->mac_address.ssi,
+                   ctx->start_time.tn,
+                   ctx->start_time.fn,
+                   ctx->start_time.mn);
+    }
 }
 
 /**
- * @brief Append data to defragmenter
+ * @brief Append data to the reassembly of time slot and address
  *
  */
 
-void mac_defrag_t::append(const std::vector<uint8_t> sdu, const mac_address_t address)
+void mac_defrag_t::append(const std::vector<uint8_t> & sdu, const mac_address_t address, const tetra_time_t time_slot)
 {
-    if (b_stopped)                                                              // we can't append if in stopped mode
+    expire(time_slot);
+
+    mac_defrag_context_t * ctx = find(address, time_slot);
+
+    if (ctx == NULL)                                                            // no reassembly started, first fragment was lost
     {
-        if (g_debug_level >= DEBUG_VAL)
+        if (LOG_ENABLED(g_debug_level, DEBUG_VAL))
         {
-            printf("  * DEFRAG APPEND   : FAILED SSI = %u\n", address.ssi);
+            log_printf(LOG_DEFRAG, "  * DEFRAG APPEND   : FAILED no fragment started for SSI = %u - TN/FN/MN = %02u/%02u/%02u\n",
+                       address.ssi,
+                       time_slot.tn,
+                       time_slot.fn,
+                       time_slot.mn);
         }
     }
-    else if (address.ssi != mac_address.ssi)                                    // check mac addresses
+    else if (ctx->tm_sdu.size() + sdu.size() > (std::size_t)TM_SDU_MAX_BITS)    // too long, can't be a valid TM-SDU
     {
-        stop();                                                                 // stop defragmenter
-
-        if (g_debug_level >= DEBUG_VAL)
+        if (LOG_ENABLED(g_debug_level, DEBUG_VAL))
         {
-            printf("  * DEFRAG APPEND   : FAILED appending SSI = %u while fragment SSI = %u\n", mac_address.ssi, address.ssi);
+            log_printf(LOG_DEFRAG, "  * DEFRAG APPEND   : FAILED SSI = %u - TM-SDU longer than %d bits\n", ctx->mac_address.ssi, TM_SDU_MAX_BITS);
         }
+        stop(ctx, false);
     }
     else
     {
-        tm_sdu = vector_append(tm_sdu, sdu);
-        fragments_count++;
+        ctx->tm_sdu.insert(ctx->tm_sdu.end(), sdu.begin(), sdu.end());          // in place, buffer is preallocated
+        ctx->last_time = time_slot;
+        ctx->fragments_count++;
 
-        if (g_debug_level >= DEBUG_VAL)
+        if (LOG_ENABLED(g_debug_level, DEBUG_VAL))
         {
-            printf("  * DEFRAG APPEND   : SSI = %u - TN/FN/MN = %02u/%02u/%02u - fragment %d - length = sdu %u / tm_sdu %u - encr = %u\n",
-                   mac_address.ssi,
-                   start_time.tn,
-                   start_time.fn,
-                   start_time.mn,
-                   fragments_count,
-                   (uint32_t)sdu.size(),
-                   (uint32_t)tm_sdu.size(),
-                   mac_address.encryption_mode
-                );
+            log_printf(LOG_DEFRAG, "  * DEFRAG APPEND   : SSI = %u - TN/FN/MN = %02u/%02u/%02u - fragment %d - length = sdu %u / tm_sdu %u - encr = %u\n",
+                       ctx->mac_address.ssi,
+                       ctx->start_time.tn,
+                       ctx->start_time.fn,
+                       ctx->start_time.mn,
+                       ctx->fragments_count,
+                       (uint32_t)sdu.size(),
+                       (uint32_t)ctx->tm_sdu.size(),
+                       ctx->mac_address.encryption_mode
+                    );
         }
     }
 }
 
 /**
- * @brief Check SDU validity and return it
+ * @brief Return the reassembled SDU of time slot and address and end
+ *        the reassembly (called on MAC-END)
+ *
+ * @return TM-SDU, empty if reassembly failed
  *
  */
 
-std::vector<uint8_t> mac_defrag_t::get_sdu(uint8_t * encryption_mode, uint8_t * usage_marker)
+std::vector<uint8_t> mac_defrag_t::get_sdu(const mac_address_t address, const tetra_time_t time_slot, uint8_t * encryption_mode, uint8_t * usage_marker)
 {
     std::vector<uint8_t> ret;
 
-    if (b_stopped)
+    expire(time_slot);
+
+    mac_defrag_context_t * ctx = find(address, time_slot);
+
+    if (ctx == NULL)
     {
-        if (g_debug_level >= DEBUG_VAL)
+        if (LOG_ENABLED(g_debug_level, DEBUG_VAL))
         {
-            printf("  * DEFRAG END      : FAILED SSI = %u - TN/FN/MN = %02u/%02u/%02u - fragment %d - length = %u - encr = %u\n",
-                   mac_address.ssi,
-                   start_time.tn,
-                   start_time.fn,
-                   start_time.mn,
-                   fragments_count,
-                   (uint32_t)tm_sdu.size(),
-                   mac_address.encryption_mode
-                );
+            log_printf(LOG_DEFRAG, "  * DEFRAG END      : FAILED SSI = %u - TN/FN/MN = %02u/%02u/%02u\n",
+                       address.ssi,
+                       time_slot.tn,
+                       time_slot.fn,
+                       time_slot.mn);
         }
+        metrics->defrag_failure++;
     }
     else
     {
         // FIXME add check
-        *encryption_mode = mac_address.encryption_mode;
-        *usage_marker    = mac_address.usage_marker;
-        ret = tm_sdu;
+        *encryption_mode = ctx->mac_address.encryption_mode;
+        *usage_marker    = ctx->mac_address.usage_marker;
+        ret = ctx->tm_sdu;
+        stop(ctx, true);
     }
 
     return ret;
 }
 
 /**
- * @brief Stop defragmenter
+ * @brief Stop a reassembly and count its result
  *
  */
 
-void mac_defrag_t::stop()
+void mac_defrag_t::stop(mac_defrag_context_t * ctx, bool success)
 {
+    if (success)
+    {
+        metrics->defrag_success++;
+    }
+    else
+    {
+        metrics->defrag_failure++;
+    }
+
     // clean stop
-    b_stopped       = true;
-    fragments_count = 0;
-    tm_sdu.clear();
+    ctx->b_active        = false;
+    ctx->fragments_count = 0;
+    ctx->tm_sdu.clear();
 }
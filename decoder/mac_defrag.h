@@ -22,30 +22,59 @@
 #include <vector>
 #include <string>
 #include "tetra_common.h"
+#include "metrics.h"
+
+/**
+ * @brief One TM-SDU reassembly in progress
+ *
+ * Fragments of a TM-SDU are sent in the same time slot (the MAC-FRAG and
+ * MAC-END PDUs carry no address), so a context is identified by its time
+ * slot and by the address of the MAC-RESOURCE PDU which started it
+ * (address type and the SSI, USSI, SMI or event label it carries).
+ *
+ */
+
+struct mac_defrag_context_t {
+    bool          b_active;                                                     // reassembly in progress
+    mac_address_t mac_address;                                                  // MAC address (contains encryption mode)
+    tetra_time_t  start_time;                                                   // start time of reassembly
+    tetra_time_t  last_time;                                                    // time of last fragment, used for expiry
+    uint8_t       fragments_count;                                              // number of fragments received
+    std::vector<uint8_t> tm_sdu;                                                // reconstructed TM-SDU to be transfered to LLC, preallocated
+};
 
 /**
  * @brief MAC defragmenter
  *
+ * Holds a small table of concurrent reassembly contexts so fragmented
+ * TM-SDU sent at the same time on different time slots or to different
+ * addresses don't cancel each other. A context which doesn't receive
+ * its next fragment within EXPIRY_FRAMES TDMA frames is dropped, this is
+ * checked on each fragment received.
+ *
  */
 
 class mac_defrag_t {
 public:
-    mac_defrag_t(int debug_level);
+    mac_defrag_t(int debug_level, metrics_t * metrics);
     ~mac_defrag_t();
 
-    mac_address_t mac_address;                                                  // MAC address
-    tetra_time_t  start_time;                                                   // start time of defragemnter (will be used to stop on missing/invalid end frag packet receive)
+    static const int CONTEXTS_COUNT  = 8;                                       // concurrent reassemblies (2 per time slot)
+    static const int TM_SDU_MAX_BITS = 4096;                                    // longer TM-SDU are dropped (recommended maximum is 1106 bits)
+    static const int EXPIRY_FRAMES   = 72;                                      // 4 multiframes
 
-    std::vector<uint8_t> mac_ressource;
-    std::vector<uint8_t> tm_sdu;                                                // reconstructed TM-SDU to be transfered to LLC
+    void start(const mac_address_t address, const tetra_time_t time_slot);
+    void append(const std::vector<uint8_t> & sdu, const mac_address_t address, const tetra_time_t time_slot);
+    std::vector<uint8_t> get_sdu(const mac_address_t address, const tetra_time_t time_slot, uint8_t * encryption_mode, uint8_t * usage_marker);
 
+private:
     int g_debug_level;
-    bool b_stopped;
-    uint8_t fragments_count;
-    void start(const mac_address_t address, const tetra_time_t time_slot);
-    void append(const std::vector<uint8_t> sdu, const mac_address_t address);
-    std::vector<uint8_t> get_sdu(uint8_t * encryption_mode, uint8_t * usage_marker);
-    void stop();
+    metrics_t * metrics;                                                        // decoder metrics for success/failure counters
+    mac_defrag_context_t contexts[CONTEXTS_COUNT];
+
+    mac_defrag_context_t * find(const mac_address_t address, const tetra_time_t time_slot);
+    void expire(const tetra_time_t time_slot);
+    void stop(mac_defrag_context_t * ctx, bool success);
 };
 
 #endif /* MAC_DEFRAG_H */
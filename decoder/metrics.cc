@@ -0,0 +1,287 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "metrics.h"
+#include "utils.h"
+#include "log.h"
+#include <cstdio>
+
+/**
+ * @brief Logical channel labels, same order as mac_logical_channel_t
+ *
+ */
+
+static const char * channel_names[10] = {"AACH", "BLCH", "BNCH", "BSCH", "SCH_F", "SCH_HD", "STCH", "TCH_S", "TCH", "unknown"};
+
+/**
+ * @brief Burst type labels, same order as burst_t
+ *
+ */
+
+static const char * burst_names[3] = {"SB", "NDB", "NDB_SF"};
+
+/**
+ * @brief Decode policy labels, same order as decode_policy_t
+ *
+ */
+
+static const char * policy_names[3] = {"full", "signalling", "aach_only"};
+
+/**
+ * @brief Clear histogram
+ *
+ */
+
+void histogram_t::clear()
+{
+    count  = 0;
+    sum_ns = 0;
+    max_ns = 0;
+
+    for (int idx = 0; idx < BUCKETS; idx++)
+    {
+        bucket[idx] = 0;
+    }
+}
+
+/**
+ * @brief Add a value to histogram
+ *
+ */
+
+void histogram_t::add(uint64_t val_ns)
+{
+    uint64_t val_us = (val_ns + 999) / 1000;                                    // round up so bucket upper bound is inclusive
+
+    int idx = 0;
+    while ((idx < BUCKETS - 1) && (val_us > (1ULL << idx)))
+    {
+        idx++;
+    }
+
+    bucket[idx]++;
+    count++;
+    sum_ns += val_ns;
+
+    if (val_ns > max_ns)
+    {
+        max_ns = val_ns;
+    }
+}
+
+/**
+ * @brief Constructor
+ *
+ */
+
+metrics_t::metrics_t()
+{
+    bits_received       = 0;
+    bursts_invalid      = 0;
+    sync_lost           = 0;
+    sync_slips          = 0;
+    defrag_success      = 0;
+    defrag_failure      = 0;
+    llc_fcs_pass        = 0;
+    llc_fcs_fail        = 0;
+    blocks_skipped      = 0;
+    speech_skipped      = 0;
+    reports_sent        = 0;
+    reports_dropped     = 0;
+    reports_filtered    = 0;
+    pdus_filtered       = 0;
+    reports_unchanged   = 0;
+    broadcast_unchanged = 0;
+    processing_ns       = 0;
+
+    for (int idx = 0; idx < 3; idx++)
+    {
+        bursts[idx]        = 0;
+        decode_policy[idx] = 0;
+    }
+
+    for (int idx = 0; idx < 10; idx++)
+    {
+        crc_pass[idx] = 0;
+        crc_fail[idx] = 0;
+    }
+
+    viterbi.clear();
+    parse.clear();
+    burst.clear();
+
+    start_ns = utils_now_ns();
+}
+
+/**
+ * @brief Destructor
+ *
+ */
+
+metrics_t::~metrics_t()
+{
+
+}
+
+/**
+ * @brief Count CRC result for logical channel
+ *
+ */
+
+void metrics_t::count_crc(mac_logical_channel_t channel, int crc_ok)
+{
+    if (crc_ok)
+    {
+        crc_pass[channel]++;
+    }
+    else
+    {
+        crc_fail[channel]++;
+    }
+}
+
+/**
+ * @brief Format histogram in text exposition format
+ *
+ */
+
+static std::string format_histogram(const char * name, const histogram_t & hist)
+{
+    std::string txt = format_str("# TYPE %s histogram\n", name);
+    uint64_t cumulated = 0;
+
+    for (int idx = 0; idx < histogram_t::BUCKETS; idx++)
+    {
+        cumulated += hist.bucket[idx];
+
+        if (idx < histogram_t::BUCKETS - 1)
+        {
+            txt += format_str("%s_bucket{le=\"%llu\"} %llu\n", name, 1ULL << idx, (unsigned long long)cumulated);
+        }
+        else
+        {
+            txt += format_str("%s_bucket{le=\"+Inf\"} %llu\n", name, (unsigned long long)cumulated);
+        }
+    }
+
+    txt += format_str("%s_sum %.3f\n",   name, hist.sum_ns / 1.0e3);
+    txt += format_str("%s_count %llu\n", name, (unsigned long long)hist.count);
+    txt += format_str("%s_max %.3f\n",   name, hist.max_ns / 1.0e3);
+
+    return txt;
+}
+
+/**
+ * @brief Text snapshot of all metrics
+ *
+ * Format is one "name{labels} value" per line (Prometheus text format)
+ * so it can be read by a human or scraped. Times are in seconds, except
+ * histograms which are in microseconds.
+ *
+ * Processing time compared to air time shows if the decoder is lacking
+ * CPU, CRC failures compared to received bursts show if it is lacking RF.
+ *
+ */
+
+std::string metrics_t::snapshot(const tetra_cell_infos_t & cell, bool synchronized)
+{
+    std::string txt = "";
+
+    txt += format_str("tetra_uptime_seconds %.3f\n", (utils_now_ns() - start_ns) / 1.0e9);
+    txt += format_str("tetra_cell_info{mcc=\"%u\",mnc=\"%u\",color_code=\"%u\",downlink_hz=\"%d\"} 1\n", cell.mcc, cell.mnc, cell.color_code, cell.downlink_frequency);
+    txt += format_str("tetra_synchronized %d\n", synchronized ? 1 : 0);
+    txt += format_str("tetra_sync_lost_total %llu\n", (unsigned long long)sync_lost);
+    txt += format_str("tetra_sync_slips_total %llu\n", (unsigned long long)sync_slips);
+    txt += format_str("tetra_bits_received_total %llu\n", (unsigned long long)bits_received);
+    txt += format_str("tetra_air_seconds_total %.3f\n", bits_received / 36000.0); // downlink is 36 kbit/s
+    txt += format_str("tetra_processing_seconds_total %.3f\n", processing_ns / 1.0e9);
+
+    for (int idx = 0; idx < 3; idx++)
+    {
+        txt += format_str("tetra_bursts_total{type=\"%s\"} %llu\n", burst_names[idx], (unsigned long long)bursts[idx]);
+    }
+    txt += format_str("tetra_bursts_total{type=\"invalid\"} %llu\n", (unsigned long long)bursts_invalid);
+
+    for (int idx = 0; idx < 10; idx++)
+    {
+        if (crc_pass[idx] + crc_fail[idx] > 0)                                  // only channels protected by CRC
+        {
+            txt += format_str("tetra_crc_total{channel=\"%s\",result=\"pass\"} %llu\n", channel_names[idx], (unsigned long long)crc_pass[idx]);
+            txt += format_str("tetra_crc_total{channel=\"%s\",result=\"fail\"} %llu\n", channel_names[idx], (unsigned long long)crc_fail[idx]);
+        }
+    }
+
+    for (int idx = 0; idx < 3; idx++)
+    {
+        txt += format_str("tetra_decode_policy_total{policy=\"%s\"} %llu\n", policy_names[idx], (unsigned long long)decode_policy[idx]);
+    }
+    txt += format_str("tetra_blocks_skipped_total %llu\n", (unsigned long long)blocks_skipped);
+    txt += format_str("tetra_speech_frames_skipped_total %llu\n", (unsigned long long)speech_skipped);
+
+    txt += format_str("tetra_defrag_total{result=\"success\"} %llu\n", (unsigned long long)defrag_success);
+    txt += format_str("tetra_defrag_total{result=\"failure\"} %llu\n", (unsigned long long)defrag_failure);
+    txt += format_str("tetra_llc_fcs_total{result=\"pass\"} %llu\n", (unsigned long long)llc_fcs_pass);
+    txt += format_str("tetra_llc_fcs_total{result=\"fail\"} %llu\n", (unsigned long long)llc_fcs_fail);
+    txt += format_str("tetra_reports_total{result=\"sent\"} %llu\n", (unsigned long long)reports_sent);
+    txt += format_str("tetra_reports_total{result=\"dropped\"} %llu\n", (unsigned long long)reports_dropped);
+    txt += format_str("tetra_reports_total{result=\"filtered\"} %llu\n", (unsigned long long)reports_filtered);
+    txt += format_str("tetra_reports_total{result=\"unchanged\"} %llu\n", (unsigned long long)reports_unchanged);
+    txt += format_str("tetra_pdus_filtered_total %llu\n", (unsigned long long)pdus_filtered);
+    txt += format_str("tetra_broadcast_unchanged_total %llu\n", (unsigned long long)broadcast_unchanged);
+
+    log_stats_t log_counters = log_stats();                                     // process wide, not per carrier
+    txt += format_str("tetra_log_lines_total{result=\"written\"} %llu\n", (unsigned long long)log_counters.lines);
+    txt += format_str("tetra_log_lines_total{result=\"rate_limited\"} %llu\n", (unsigned long long)log_counters.rate_limited);
+    txt += format_str("tetra_log_lines_total{result=\"overflow\"} %llu\n", (unsigned long long)log_counters.overflow);
+
+    txt += format_histogram("tetra_viterbi_microseconds", viterbi);
+    txt += format_histogram("tetra_parse_microseconds",   parse);
+    txt += format_histogram("tetra_burst_microseconds",   burst);
+
+    return txt;
+}
+
+/**
+ * @brief Write snapshot to file
+ *
+ * The file is written aside then renamed, so a reader never sees
+ * a partial snapshot.
+ *
+ */
+
+bool metrics_t::write_snapshot(const std::string filename, const tetra_cell_infos_t & cell, bool synchronized)
+{
+    std::string tmp_filename = filename + ".tmp";
+    std::string txt = snapshot(cell, synchronized);
+
+    FILE * file = fopen(tmp_filename.c_str(), "w");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    bool ok_flag = (fwrite(txt.c_str(), 1, txt.length(), file) == txt.length());
+    ok_flag = (fclose(file) == 0) && ok_flag;
+
+    if (ok_flag)
+    {
+        ok_flag = (rename(tmp_filename.c_str(), filename.c_str()) == 0);
+    }
+
+    return ok_flag;
+}
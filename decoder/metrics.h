@@ -0,0 +1,92 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef METRICS_H
+#define METRICS_H
+#include <cstdint>
+#include <string>
+#include "tetra_common.h"
+
+/**
+ * @brief Latency histogram with power of 2 buckets in microseconds
+ *
+ * Bucket idx counts values <= 2^idx us, last bucket counts larger values
+ *
+ */
+
+struct histogram_t {
+    static const int BUCKETS = 18;                                              // 1 us to 65 ms then +Inf
+
+    uint64_t count;                                                             ///< Number of values
+    uint64_t sum_ns;                                                            ///< Sum of values [ns]
+    uint64_t max_ns;                                                            ///< Largest value [ns]
+    uint64_t bucket[BUCKETS];                                                   ///< Values count per bucket (not cumulative)
+
+    void clear();
+    void add(uint64_t val_ns);
+};
+
+/**
+ * @brief Decoder metrics for one carrier
+ *
+ * One instance is owned by each decoder, so by the thread running it.
+ * Counters are only written and read by this thread, they need no
+ * locking and cost a single increment on the decoding path.
+ * Histograms are only filled when profiling is enabled.
+ *
+ */
+
+class metrics_t {
+public:
+    metrics_t();
+    ~metrics_t();
+
+    uint64_t bits_received;                                                     ///< Bits pushed to rx_symbol
+    uint64_t bursts[3];                                                         ///< Bursts per type SB, NDB and NDB_SF
+    uint64_t bursts_invalid;                                                    ///< Bursts not matching any training sequence
+    uint64_t crc_pass[10];                                                      ///< CRC passed per logical channel
+    uint64_t crc_fail[10];                                                      ///< CRC failed per logical channel
+    uint64_t sync_lost;                                                         ///< Synchronization losses
+    uint64_t sync_slips;                                                        ///< Bursts found off their expected position while synchronized
+    uint64_t defrag_success;                                                    ///< TM-SDU reassembled
+    uint64_t defrag_failure;                                                    ///< Fragmented TM-SDU lost
+    uint64_t llc_fcs_pass;                                                      ///< LLC PDUs with valid FCS
+    uint64_t llc_fcs_fail;                                                      ///< LLC PDUs dropped due to invalid FCS
+    uint64_t decode_policy[3];                                                  ///< Bursts per decode policy full, signalling only and AACH only
+    uint64_t blocks_skipped;                                                    ///< Signalling blocks not decoded due to decode policy (Viterbi saved)
+    uint64_t speech_skipped;                                                    ///< Speech frames not sent to U-plane due to decode policy
+    uint64_t reports_sent;                                                      ///< Json reports sent
+    uint64_t reports_dropped;                                                   ///< Json reports which could not be written to socket
+    uint64_t reports_filtered;                                                  ///< Json reports not built due to service or PDU filter
+    uint64_t pdus_filtered;                                                     ///< MAC PDUs not decoded due to address or encryption filter
+    uint64_t reports_unchanged;                                                 ///< Broadcast reports not sent, content unchanged since last one
+    uint64_t broadcast_unchanged;                                               ///< Broadcast PDUs not parsed again, raw bits unchanged
+
+    uint64_t processing_ns;                                                     ///< Time spent in bursts processing [ns]
+    histogram_t viterbi;                                                        ///< Viterbi decoding time per block
+    histogram_t parse;                                                          ///< MAC and upper layers parsing time per burst
+    histogram_t burst;                                                          ///< Total processing time per burst
+
+    uint64_t start_ns;                                                          ///< Metrics start time [ns]
+
+    void count_crc(mac_logical_channel_t channel, int crc_ok);
+    std::string snapshot(const tetra_cell_infos_t & cell, bool synchronized);
+    bool write_snapshot(const std::string filename, const tetra_cell_infos_t & cell, bool synchronized);
+};
+
+#endif /* METRICS_H */
@@ -26,10 +26,9 @@
 
 void tetra_dl::service_mle(std::vector<uint8_t> pdu, mac_logical_channel_t mac_logical_channel)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - mac_channel = %s pdu = %s\n", "service_mle", mac_logical_channel_name(mac_logical_channel).c_str(), vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_MLE, "DEBUG ::%-44s - mac_channel = %s pdu = %s\n", "service_mle", mac_logical_channel_name(mac_logical_channel).c_str(), vector_to_string(pdu, pdu.size()).c_str());
     }
 
     //uint8_t pdu_type;
@@ -99,12 +98,12 @@ void tetra_dl::service_mle(std::vector<uint8_t> pdu, mac_logical_channel_t mac_l
 
     if (print_infos_flag || (g_debug_level > 1))
     {
-        printf("service_mle : TN/FN/MN = %2d/%2d/%2d  %-20s  %-20s\n",
-               g_time.tn,
-               g_time.fn,
-               g_time.mn,
-               txt.c_str(),
-               infos.c_str());
+        log_printf(LOG_MLE, "service_mle : TN/FN/MN = %2d/%2d/%2d  %-20s  %-20s\n",
+                   g_time.tn,
+                   g_time.fn,
+                   g_time.mn,
+                   txt.c_str(),
+                   infos.c_str());
     }
 }
 
@@ -115,10 +114,9 @@ void tetra_dl::service_mle(std::vector<uint8_t> pdu, mac_logical_channel_t mac_l
 
 void tetra_dl::service_mle_subsystem(std::vector<uint8_t> pdu, mac_logical_channel_t mac_logical_channel)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - mac_channel = %s pdu = %s\n", "service_mle_subsystem", mac_logical_channel_name(mac_logical_channel).c_str(), vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_MLE, "DEBUG ::%-44s - mac_channel = %s pdu = %s\n", "service_mle_subsystem", mac_logical_channel_name(mac_logical_channel).c_str(), vector_to_string(pdu, pdu.size()).c_str());
     }
 
     std::string txt = "";
@@ -165,11 +163,11 @@ void tetra_dl::service_mle_subsystem(std::vector<uint8_t> pdu, mac_logical_chann
         break;
     }
 
-    printf("serv_mle_sub: TN/FN/MN = %2d/%2d/%2d  %-20s\n",                     // all MLE sub-system are printed
-           g_time.tn,
-           g_time.fn,
-           g_time.mn,
-           txt.c_str());
+    log_printf(LOG_MLE, "serv_mle_sub: TN/FN/MN = %2d/%2d/%2d  %-20s\n",        // all MLE sub-system are printed
+               g_time.tn,
+               g_time.fn,
+               g_time.mn,
+               txt.c_str());
 }
 
 /**
@@ -179,10 +177,15 @@ void tetra_dl::service_mle_subsystem(std::vector<uint8_t> pdu, mac_logical_chann
 
 void tetra_dl::mle_process_d_nwrk_broadcast(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "mle_process_d_nwrk_broadcast", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_MLE, "DEBUG ::%-44s - pdu = %s\n", "mle_process_d_nwrk_broadcast", vector_to_string(pdu, pdu.size()).c_str());
+    }
+
+    uint8_t time_flag = get_value(pdu, 21, 1) ? get_value(pdu, 22, 1) : 0;      // option flag then network time presence flag
+    if (!broadcast_changed(BROADCAST_NWRK, pdu, pdu.size(), 23, time_flag ? 48 : 0)) // network time changes, neighbour cells don't
+    {
+        return;
     }
 
     // report_start("MLE", "D-NWRK-BROADCAST");
@@ -233,116 +236,56 @@ void tetra_dl::mle_process_d_nwrk_broadcast(std::vector<uint8_t> pdu)
 }
 
 /**
- * @brief Parse neighbour cell information 18.5.17 and return actual data length read
- *        to increase flux position. This function used by mle_process_d_nwrk_broadcast
+ * @brief Neighbour cell information 18.5.17
  *
  */
 
-uint32_t tetra_dl::mle_parse_neighbour_cell_information(std::vector<uint8_t> data, uint32_t pos_start, std::vector<std::tuple<std::string, uint64_t>> & infos)
-{
-    uint32_t pos = pos_start;
-
-    infos.push_back(std::make_tuple("identifier", get_value(data, pos, 5)));
-    pos += 5;
-
-    infos.push_back(std::make_tuple("reselection types supported", get_value(data, pos, 2)));
-    pos += 2;
+static constexpr pdu_field_t MLE_NEIGHBOUR_CELL_INFORMATION[] = {
+    pdu_value("identifier", 5),
+    pdu_value("reselection types supported", 2),
+    pdu_value("neighbour cell synchronized", 1),
+    pdu_value("service level", 2),
+    pdu_value("main carrier number", 12),
+    pdu_option(),
+    pdu_type2("main carrier number extension", 10),
+    pdu_type2("MCC", 10),
+    pdu_type2("MNC", 14),
+    pdu_type2("LA", 14),
+    pdu_type2("max. MS tx power", 3),
+    pdu_type2("min. rx access level", 4),
+    pdu_type2("subscriber class", 16),
+    pdu_type2("BS service details", 12),
+    pdu_type2("timeshare or security", 5),
+    pdu_type2("TDMA frame offset", 6)
+};
 
-    infos.push_back(std::make_tuple("neighbour cell synchronized", get_value(data, pos, 1)));
-    pos += 1;
+/**
+ * @brief Schema sink collecting neighbour cell information in a list
+ *
+ */
 
-    infos.push_back(std::make_tuple("service level", get_value(data, pos, 2)));
-    pos += 2;
+struct neighbour_cell_sink_t {
+    std::vector<std::tuple<std::string, uint64_t>> & infos;
 
-    infos.push_back(std::make_tuple("main carrier number", get_value(data, pos, 12)));
-    pos += 12;
+    explicit neighbour_cell_sink_t(std::vector<std::tuple<std::string, uint64_t>> & list) : infos(list) {}
 
-    uint8_t o_flag = get_value(data, pos, 1);                                   // option flag
-    pos += 1;
-    if (o_flag)                                                                 // there is type2 fields
+    void pdu_field(const char * key, uint64_t val)
     {
-        uint8_t p_flag = get_value(data, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            infos.push_back(std::make_tuple("main carrier number extension", get_value(data, pos, 10)));
-            pos += 10;
-        }
-
-        p_flag = get_value(data, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            infos.push_back(std::make_tuple("MCC", get_value(data, pos, 10)));
-            pos += 10;
-        }
-
-        p_flag = get_value(data, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            infos.push_back(std::make_tuple("MNC", get_value(data, pos, 14)));
-            pos += 14;
-        }
-
-        p_flag = get_value(data, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            infos.push_back(std::make_tuple("LA", get_value(data, pos, 14)));
-            pos += 14;
-        }
-
-        p_flag = get_value(data, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            infos.push_back(std::make_tuple("max. MS tx power", get_value(data, pos, 3)));
-            pos += 3;
-        }
-
-        p_flag = get_value(data, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            infos.push_back(std::make_tuple("min. rx access level", get_value(data, pos, 4)));
-            pos += 4;
-        }
-
-        p_flag = get_value(data, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            infos.push_back(std::make_tuple("subscriber class", get_value(data, pos, 16)));
-            pos += 16;
-        }
+        infos.push_back(std::make_tuple(key, val));
+    }
+};
 
-        p_flag = get_value(data, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            infos.push_back(std::make_tuple("BS service details", get_value(data, pos, 12)));
-            pos += 12;
-        }
+/**
+ * @brief Parse neighbour cell information 18.5.17 and return actual data length read
+ *        to increase flux position. This function used by mle_process_d_nwrk_broadcast
+ *
+ */
 
-        p_flag = get_value(data, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            infos.push_back(std::make_tuple("timeshare or security", get_value(data, pos, 5)));
-            pos += 5;
-        }
-        
-        p_flag = get_value(data, pos, 1);
-        pos += 1;
-        if (p_flag)
-        {
-            infos.push_back(std::make_tuple("TDMA frame offset", get_value(data, pos, 6)));
-            pos += 6;
-        }
-    }
+uint32_t tetra_dl::mle_parse_neighbour_cell_information(std::vector<uint8_t> data, uint32_t pos_start, std::vector<std::tuple<std::string, uint64_t>> & infos)
+{
+    neighbour_cell_sink_t sink(infos);
 
-    return pos;
+    return pdu_parse<MLE_NEIGHBOUR_CELL_INFORMATION, pdu_schema_size(MLE_NEIGHBOUR_CELL_INFORMATION)>(data, pos_start, sink);
 }
 
 /**
@@ -352,10 +295,14 @@ uint32_t tetra_dl::mle_parse_neighbour_cell_information(std::vector<uint8_t> dat
 
 void tetra_dl::mle_process_d_nwrk_broadcast_extension(std::vector<uint8_t> pdu)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
+    {
+        log_printf(LOG_MLE, "DEBUG ::%-44s - pdu = %s\n", "mle_process_d_nwrk_broadcast_extension", vector_to_string(pdu, pdu.size()).c_str());
+    }
+
+    if (!broadcast_changed(BROADCAST_NWRK_EXT, pdu, pdu.size()))
     {
-        fprintf(stdout, "DEBUG ::%-44s - pdu = %s\n", "mle_process_d_nwrk_broadcast_extension", vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        return;
     }
 
     // report_start("MLE", "D-NWRK-BROADCAST-EXTENSION");
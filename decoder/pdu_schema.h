@@ -0,0 +1,241 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef PDU_SCHEMA_H
+#define PDU_SCHEMA_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @defgroup pdu_schema PDU schema
+ *
+ * Fixed layout PDUs are described once by a constexpr table of fields:
+ *
+ *   static constexpr pdu_field_t CMCE_D_TX_WAIT[] = {
+ *       pdu_value("call identifier", 14),
+ *       pdu_value("transmission request permission", 1),
+ *       pdu_option(),
+ *       pdu_type2("notification indicator", 6)
+ *   };
+ *
+ *   pdu_parse<CMCE_D_TX_WAIT, pdu_schema_size(CMCE_D_TX_WAIT)>(pdu, 5, sink);
+ *
+ * The table is a template argument so pdu_parse() is unrolled at compile
+ * time into the same get/advance sequence as a hand written parser. Each
+ * value is given to sink.pdu_field(key, val), keys are the table string
+ * literals and are never copied. tetra_dl is the Json report sink, any
+ * other output only needs to provide pdu_field().
+ *
+ * Elements with a layout depending on their content (type 3/4, external
+ * numbers...) remain hand written after the position returned.
+ *
+ * @{
+ *
+ */
+
+enum pdu_field_kind_t {
+    PDU_FIELD_VALUE       = 0,                                                  ///< Type 1 element, reported
+    PDU_FIELD_RESERVED    = 1,                                                  ///< Type 1 element, skipped
+    PDU_FIELD_OPTION      = 2,                                                  ///< Option flag, following type 2 elements are present only if set
+    PDU_FIELD_TYPE2       = 3,                                                  ///< Type 2 element, presence flag then value
+    PDU_FIELD_PARTY       = 4,                                                  ///< Type 1 party type identifier then SNA, SSI or SSI + extension
+    PDU_FIELD_PARTY_TYPE2 = 5                                                   ///< Same as PDU_FIELD_PARTY after a presence flag
+};
+
+struct pdu_field_t {
+    uint8_t kind;                                                               ///< pdu_field_kind_t
+    uint8_t len;                                                                ///< Length in bits (SNA length for party fields, 0 if SNA is not allowed)
+    const char * key;                                                           ///< Report key (party type identifier for party fields)
+    const char * key_ssi;                                                       ///< Party SSI report key
+    const char * key_ext;                                                       ///< Party extension report key
+};
+
+constexpr pdu_field_t pdu_value(const char * key, uint8_t len)
+{
+    return pdu_field_t{PDU_FIELD_VALUE, len, key, nullptr, nullptr};
+}
+
+constexpr pdu_field_t pdu_reserved(uint8_t len)
+{
+    return pdu_field_t{PDU_FIELD_RESERVED, len, nullptr, nullptr, nullptr};
+}
+
+constexpr pdu_field_t pdu_option()
+{
+    return pdu_field_t{PDU_FIELD_OPTION, 1, nullptr, nullptr, nullptr};
+}
+
+constexpr pdu_field_t pdu_type2(const char * key, uint8_t len)
+{
+    return pdu_field_t{PDU_FIELD_TYPE2, len, key, nullptr, nullptr};
+}
+
+constexpr pdu_field_t pdu_party(const char * key, const char * key_ssi, const char * key_ext, uint8_t sna_len)
+{
+    return pdu_field_t{PDU_FIELD_PARTY, sna_len, key, key_ssi, key_ext};
+}
+
+constexpr pdu_field_t pdu_party_type2(const char * key, const char * key_ssi, const char * key_ext, uint8_t sna_len)
+{
+    return pdu_field_t{PDU_FIELD_PARTY_TYPE2, sna_len, key, key_ssi, key_ext};
+}
+
+template <std::size_t N>
+constexpr std::size_t pdu_schema_size(const pdu_field_t (&)[N])
+{
+    return N;
+}
+
+/**
+ * @brief Read field, bits beyond the PDU end are read as 0 (like get_value)
+ *
+ */
+
+inline uint64_t pdu_bits(const std::vector<uint8_t> & pdu, uint32_t pos, uint8_t len)
+{
+    uint64_t val = 0;
+
+    for (uint8_t idx = 0; idx < len; idx++)
+    {
+        val <<= 1;
+        if (pos + idx < pdu.size())
+        {
+            val |= pdu[pos + idx];
+        }
+    }
+
+    return val;
+}
+
+/**
+ * @brief Party address, type identifier 0 = SNA, 1 = SSI, 2 = SSI + extension
+ *
+ * @return position after the address
+ *
+ */
+
+template <typename SINK>
+inline uint32_t pdu_parse_party(const std::vector<uint8_t> & pdu, uint32_t pos, const pdu_field_t & field, SINK & sink)
+{
+    uint8_t type = (uint8_t)pdu_bits(pdu, pos, 2);
+    pos += 2;
+    sink.pdu_field(field.key, type);
+
+    if ((type == 0) && (field.len > 0))                                         // SNA ? not documented
+    {
+        sink.pdu_field(field.key_ssi, pdu_bits(pdu, pos, field.len));
+        pos += field.len;
+    }
+    else if ((type == 1) || (type == 2))
+    {
+        sink.pdu_field(field.key_ssi, pdu_bits(pdu, pos, 24));
+        pos += 24;
+
+        if (type == 2)
+        {
+            sink.pdu_field(field.key_ext, pdu_bits(pdu, pos, 24));
+            pos += 24;
+        }
+    }
+
+    return pos;
+}
+
+/**
+ * @brief Parser of field IDX of SCHEMA, then of the next ones
+ *
+ */
+
+template <const pdu_field_t * SCHEMA, std::size_t IDX, std::size_t COUNT>
+struct pdu_parser_t {
+    template <typename SINK>
+    static inline uint32_t parse(const std::vector<uint8_t> & pdu, uint32_t pos, SINK & sink)
+    {
+        constexpr pdu_field_t field = SCHEMA[IDX];
+
+        switch (field.kind)                                                     // constant, only one case is compiled in
+        {
+        case PDU_FIELD_VALUE:
+            sink.pdu_field(field.key, pdu_bits(pdu, pos, field.len));
+            pos += field.len;
+            break;
+
+        case PDU_FIELD_RESERVED:
+            pos += field.len;
+            break;
+
+        case PDU_FIELD_OPTION:
+            if (!pdu_bits(pdu, pos, 1))                                         // no type 2 elements
+            {
+                return pos + 1;
+            }
+            pos += 1;
+            break;
+
+        case PDU_FIELD_TYPE2:
+            if (pdu_bits(pdu, pos, 1))                                          // presence flag
+            {
+                sink.pdu_field(field.key, pdu_bits(pdu, pos + 1, field.len));
+                pos += field.len;
+            }
+            pos += 1;
+            break;
+
+        case PDU_FIELD_PARTY:
+            pos = pdu_parse_party(pdu, pos, field, sink);
+            break;
+
+        case PDU_FIELD_PARTY_TYPE2:
+            pos += 1;
+            if (pdu_bits(pdu, pos - 1, 1))                                      // presence flag
+            {
+                pos = pdu_parse_party(pdu, pos, field, sink);
+            }
+            break;
+        }
+
+        return pdu_parser_t<SCHEMA, IDX + 1, COUNT>::parse(pdu, pos, sink);
+    }
+};
+
+template <const pdu_field_t * SCHEMA, std::size_t COUNT>
+struct pdu_parser_t<SCHEMA, COUNT, COUNT> {
+    template <typename SINK>
+    static inline uint32_t parse(const std::vector<uint8_t> &, uint32_t pos, SINK &)
+    {
+        return pos;
+    }
+};
+
+/**
+ * @brief Parse PDU described by SCHEMA from position pos
+ *
+ * @return position after the last field parsed
+ *
+ */
+
+template <const pdu_field_t * SCHEMA, std::size_t COUNT, typename SINK>
+inline uint32_t pdu_parse(const std::vector<uint8_t> & pdu, uint32_t pos, SINK & sink)
+{
+    return pdu_parser_t<SCHEMA, 0, COUNT>::parse(pdu, pos, sink);
+}
+
+/** @} */
+
+#endif /* PDU_SCHEMA_H */
@@ -21,21 +21,112 @@
 #include "base64.h"
 
 #include <zlib.h>
+#include <algorithm>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+/**
+ * @brief Check current MAC address against the subscription filter
+ *
+ * @return true if the PDUs of this address must not be decoded
+ *
+ */
+
+bool tetra_dl::report_address_filtered()
+{
+    if ((filter == NULL) || filter->accept_address(mac_address))
+    {
+        return false;
+    }
+
+    metrics->pdus_filtered++;
+
+    return true;
+}
+
+/**
+ * @brief Compare a periodic broadcast PDU with the last one of its type
+ *
+ * Only the len first bits are compared (ie. CRC excluded), bits
+ * [skip_start, skip_start + skip_len[ change on each occurrence (ie.
+ * TDMA time) and are not compared either.
+ *
+ * @return true if the PDU changed (or is the first one) and must be
+ *         parsed, false if the previous parsing results are still valid
+ *
+ */
+
+bool tetra_dl::broadcast_changed(broadcast_pdu_t type, const std::vector<uint8_t> & pdu, std::size_t len, std::size_t skip_start, std::size_t skip_len)
+{
+    const char * data = (const char *)pdu.data();
+    len = std::min(len, pdu.size());
+    skip_start = std::min(len, skip_start);
+    std::size_t skip_end = std::min(len, skip_start + skip_len);
+
+    uint64_t hash = 0xcbf29ce484222325ULL;                                      // FNV-1a offset basis
+    hash = utils_fnv1a(hash, data, skip_start);
+    hash = utils_fnv1a(hash, data + skip_end, len - skip_end);
+
+    broadcast_cache_t * cache = &broadcast_cache[type];
+
+    if (cache->b_valid && (cache->hash == hash))
+    {
+        metrics->broadcast_unchanged++;
+        return false;
+    }
+
+    cache->b_valid = true;
+    cache->hash    = hash;
+
+    return true;
+}
+
+/**
+ * @brief Check if a periodic broadcast PDU must be reported
+ *
+ * Unchanged PDUs are reported again every g_broadcast_keepalive_frames
+ * so the receiver knows the cell is still there.
+ *
+ * @return true if the report must be sent
+ *
+ */
+
+bool tetra_dl::broadcast_report_due(broadcast_pdu_t type, bool b_changed)
+{
+    broadcast_cache_t * cache = &broadcast_cache[type];
+
+    if (b_changed || (g_broadcast_keepalive_frames == 0) || (g_frames_count - cache->report_frame >= g_broadcast_keepalive_frames))
+    {
+        cache->report_frame = g_frames_count;
+        return true;
+    }
+
+    metrics->reports_unchanged++;
+
+    return false;
+}
+
 /**
  * @brief Prepare Json report
  *
  * Initialize Json object, add tetra common informations.
  * Must be ended by send
  *
+ * @return false if the report is filtered, the caller must not parse
+ *         further nor send it
+ *
  */
 
-void tetra_dl::report_start(std::string service, std::string pdu)
+bool tetra_dl::report_start(std::string service, std::string pdu)
 {
     //report_start(service.c_str(), pdu.c_str());
 
+    if ((filter != NULL) && !filter->accept_report(service, pdu))
+    {
+        metrics->reports_filtered++;
+        return false;
+    }
+
     jdoc.SetObject();                                                           // create empty Json DOM
 
     report_add("service", service);
@@ -90,6 +181,8 @@ void tetra_dl::report_start(std::string service, std::string pdu)
         report_add("event label", mac_address.event_label);
         break;
     }
+
+    return true;
 }
 
 /**
@@ -100,12 +193,20 @@ void tetra_dl::report_start(std::string service, std::string pdu)
  * Initialize Json object, add tetra common informations for U-PLANE.
  * Must be ended by send.
  *
+ * @return false if the report is filtered
+ *
  */
 
-void tetra_dl::report_start_u_plane(std::string service, std::string pdu)
+bool tetra_dl::report_start_u_plane(std::string service, std::string pdu)
 {
     //report_start(service.c_str(), pdu.c_str());
 
+    if ((filter != NULL) && !filter->accept_report(service, pdu))
+    {
+        metrics->reports_filtered++;
+        return false;
+    }
+
     jdoc.SetObject();                                                           // create empty Json DOM
 
     report_add("service", service);
@@ -160,6 +261,8 @@ void tetra_dl::report_start_u_plane(std::string service, std::string pdu)
         report_add("event label", mac_address.event_label);
         break;
     }
+
+    return true;
 }
 
 /**
@@ -227,6 +330,21 @@ void tetra_dl::report_add(std::string field, uint64_t val)
     jdoc.AddMember(key, dat, jdoc.GetAllocator());
 }
 
+/**
+ * @brief Add PDU schema field to report (pdu_schema.h sink)
+ *
+ * Key is a schema string literal, it is referenced instead of copied.
+ *
+ */
+
+void tetra_dl::pdu_field(const char * key, uint64_t val)
+{
+    rapidjson::Value name(rapidjson::StringRef(key));
+    rapidjson::Value dat(val);
+
+    jdoc.AddMember(name, dat, jdoc.GetAllocator());
+}
+
 /**
  * @brief Add double data to report
  *
@@ -334,6 +452,8 @@ void tetra_dl::report_add_compressed(std::string field, const unsigned char * bi
 
 void tetra_dl::report_send()
 {
+    uint64_t start_ns = g_profile_flag ? utils_now_ns() : 0;
+
     rapidjson::StringBuffer buffer;                                             // the size of buffer is automatically increased by the writer
     buffer.Clear();
 
@@ -343,11 +463,36 @@ void tetra_dl::report_send()
     std::string output(buffer.GetString());
 
     char eol = '\n';
-    write(socketfd, output.c_str(), output.length() * sizeof(char));            // string doesn't contain newline
+    ssize_t len = write(socketfd, output.c_str(), output.length());             // string doesn't contain newline
     write(socketfd, &eol, sizeof(char));                                        // so send it alone
 
-    if (g_debug_level > 1)
+    if (len == (ssize_t)output.length())
+    {
+        metrics->reports_sent++;
+    }
+    else                                                                        // socket full or closed, report is lost
     {
-        printf("%s\n", output.c_str());
+        metrics->reports_dropped++;
+    }
+
+    if (LOG_ENABLED(g_debug_level, 2))
+    {
+        log_printf(LOG_REPORT, "%s\n", output.c_str());
+    }
+
+    if (g_profile_flag)                                                         // checksum report without system time which changes on each run
+    {
+        g_profile_ns[PROFILE_REPORT] += utils_now_ns() - start_ns;
+
+        std::size_t pos = output.find("\"sysTime\":");
+        std::size_t end = (pos == std::string::npos) ? pos : output.find_first_of(",}", pos);
+
+        if (end != std::string::npos)
+        {
+            output.erase(pos, end - pos);
+        }
+
+        g_report_checksum = utils_fnv1a(g_report_checksum, output.c_str(), output.length());
+        g_report_count++;
     }
 }
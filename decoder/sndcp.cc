@@ -26,13 +26,15 @@
 
 void tetra_dl::service_sndcp(std::vector<uint8_t> pdu, mac_logical_channel_t mac_logical_channel)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - mac_channel = %s pdu = %s\n", "service_sndcp", mac_logical_channel_name(mac_logical_channel).c_str(), vector_to_string(pdu, pdu.size()).c_str());
-        fflush(stdout);
+        log_printf(LOG_SNDCP, "DEBUG ::%-44s - mac_channel = %s pdu = %s\n", "service_sndcp", mac_logical_channel_name(mac_logical_channel).c_str(), vector_to_string(pdu, pdu.size()).c_str());
     }
 
-    report_start("SNDCP", "RAW-DATA");
+    if (!report_start("SNDCP", "RAW-DATA"))
+    {
+        return;
+    }
     report_add("data", pdu);
     report_send();
 
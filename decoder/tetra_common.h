@@ -129,6 +129,91 @@ struct mac_state_t {
     mac_logical_channel_t logical_channel;                                      ///< Current logical channel
 };
 
+/**
+ * @brief Blocks to decode in a burst, decided from its ACCESS-ASSIGN PDU
+ *
+ */
+
+enum decode_policy_t {
+    DECODE_FULL       = 0,                                                      // all blocks
+    DECODE_SIGNALLING = 1,                                                      // stolen signalling blocks only, speech is not used (encrypted traffic)
+    DECODE_AACH_ONLY  = 2                                                       // nothing after AACH (unallocated slot)
+};
+
+/**
+ * @brief MAC informations kept independently for each time slot
+ *
+ * The usage is given by the ACCESS-ASSIGN PDU of the slot, the address
+ * by the last MAC-RESOURCE PDU received in the slot or by a traffic
+ * channel allocation (usage marker assignment) received in another slot.
+ *
+ */
+
+struct mac_timeslot_t {
+    mac_state_t   state;                                                        ///< MAC state of the slot
+    mac_address_t address;                                                      ///< MAC address of the slot
+};
+
+/**
+ * @brief Periodic broadcast PDUs, parsed and reported only when their
+ *        content changes
+ *
+ */
+
+enum broadcast_pdu_t {
+    BROADCAST_SYNC      = 0,                                                    // MAC SYNC 21.4.4.2
+    BROADCAST_SYSINFO   = 1,                                                    // MAC SYSINFO 21.4.4.1
+    BROADCAST_NWRK      = 2,                                                    // MLE D-NWRK-BROADCAST 18.4.1.4.1
+    BROADCAST_NWRK_EXT  = 3,                                                    // MLE D-NWRK-BROADCAST-EXTENSION 18.4.1.4.1a
+    BROADCAST_PDU_COUNT = 4
+};
+
+/**
+ * @brief Last content of a broadcast PDU type
+ *
+ */
+
+struct broadcast_cache_t {
+    bool     b_valid;                                                           ///< A PDU of this type was received
+    uint64_t hash;                                                              ///< FNV-1a hash of the last PDU raw bits, varying fields (time) excluded
+    uint64_t report_frame;                                                      ///< TDMA frame of the last report
+};
+
+/**
+ * @brief Cell state snapshot for warm start, fixed size binary file
+ *
+ */
+
+struct cell_state_t {
+    char               magic[8];                                                ///< "TKCELL01"
+    uint32_t           record_size;                                             ///< sizeof(cell_state_t)
+    uint32_t           reserved;
+    tetra_cell_infos_t cell;                                                    ///< MCC, MNC, color code, scrambling code and frequencies
+    tetra_time_t       time;                                                    ///< TDMA time when saved
+    uint64_t           time_ns;                                                 ///< Wall clock time when saved [ns since epoch]
+    uint8_t            usage_marker_encryption_mode[64];                        ///< Encryption mode per usage marker
+};
+
+/**
+ * @brief Decoding stages timed when profiling is enabled
+ *
+ * MAC time excludes the nested coding and report stages, sync search
+ * is not timed directly, it is the remainder of the total run time
+ * (see decoder_bench)
+ *
+ */
+
+enum profile_stage_t {
+    PROFILE_SYNC         = 0,                                                   // burst synchronization search
+    PROFILE_DESCRAMBLE   = 1,                                                   // descrambling 8.2.5
+    PROFILE_DEINTERLEAVE = 2,                                                   // deinterleaving 8.2.4
+    PROFILE_VITERBI      = 3,                                                   // depuncturing, Viterbi and Reed-Muller decoding 8.2.3
+    PROFILE_CRC          = 4,                                                   // CRC16 check 8.2.3.2
+    PROFILE_MAC          = 5,                                                   // MAC and upper layers parsing
+    PROFILE_REPORT       = 6,                                                   // Json report serialization and sending
+    PROFILE_STAGE_COUNT  = 7
+};
+
 /** @} */
 
 #endif /* TETRA_COMMON_H */
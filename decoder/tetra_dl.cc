@@ -40,6 +40,7 @@ tetra_dl::tetra_dl(int debug_level, bool remove_fill_bit_flag)
 
     g_is_synchronized  = false;
     g_sync_bit_counter = 0;
+    g_flywheel_window  = 2;                                                     // tolerated bit slip
 
     // initialize TDMA time
     g_time.tn = 1;
@@ -54,6 +55,8 @@ tetra_dl::tetra_dl(int debug_level, bool remove_fill_bit_flag)
     g_cell_infos.downlink_frequency = 0;
     g_cell_infos.uplink_frequency   = 0;
     g_cell_informations_acquired    = false;
+    g_frames_count                  = 0;
+    g_cell_state_pending            = false;                                    // until a snapshot is loaded
 
     /*
      * Initialize Viterbi coder/decoder for MAC
@@ -78,12 +81,57 @@ tetra_dl::tetra_dl(int debug_level, bool remove_fill_bit_flag)
     polynomials.push_back(0b11011);
     viterbi_codec16_14 = new ViterbiCodec(constraint, polynomials);
 
-    mac_defrag = new mac_defrag_t(g_debug_level);
+    metrics    = new metrics_t();
+    mac_defrag = new mac_defrag_t(g_debug_level, metrics);
+    trace      = NULL;                                                          // enabled by caller if required
+    filter     = NULL;
+
+    for (int idx = 0; idx < BROADCAST_PDU_COUNT; idx++)
+    {
+        broadcast_cache[idx].b_valid      = false;
+        broadcast_cache[idx].hash         = 0;
+        broadcast_cache[idx].report_frame = 0;
+    }
+    g_broadcast_keepalive_frames = 176;                                         // 10 s, TDMA frame is 56.67 ms
+
+    // initialize MAC state and address, they are reported before the first MAC-RESOURCE is received
+    mac_state.downlink_usage        = UNALLOCATED;
+    mac_state.downlink_usage_marker = 0;
+    mac_state.logical_channel       = unkown;
+
+    mac_address.address_type    = 0;
+    mac_address.event_label     = 0;
+    mac_address.encryption_mode = 0;
+    mac_address.usage_marker    = 0;
+    mac_address.stolen_flag     = 0;
+    mac_address.smi             = 0;
+    mac_address.ssi             = 0;
+    mac_address.ussi            = 0;
+
+    for (int idx = 0; idx < 4; idx++)
+    {
+        mac_timeslot[idx].state   = mac_state;
+        mac_timeslot[idx].address = mac_address;
+    }
+
+    second_slot_stolen_flag = 0;
+    first_slot_stolen_flag  = 0;
+    g_decode_policy_flag    = true;
 
     for (uint8_t idx = 0; idx < 64; idx++)
     {
         usage_marker_encryption_mode[idx] = 0;
     }
+
+    g_profile_flag    = false;                                                  // profiling is enabled by decoder_bench only
+    g_profile_bursts  = 0;
+    g_report_count    = 0;
+    g_report_checksum = 0xcbf29ce484222325ULL;                                  // FNV-1a offset basis
+
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++)
+    {
+        g_profile_ns[stage] = 0;
+    }
 }
 
 /**
@@ -94,6 +142,9 @@ tetra_dl::tetra_dl(int debug_level, bool remove_fill_bit_flag)
 tetra_dl::~tetra_dl()
 {
     delete mac_defrag;
+    delete metrics;
+    delete trace;
+    delete filter;
 }
 
 /**
@@ -124,43 +175,139 @@ void tetra_dl::reset_synchronizer()
 int tetra_dl::rx_symbol(uint8_t sym)
 {
     g_frame_data.push_back(sym);                                                // insert symbol at buffer end
-    if (g_frame_data.size() < g_frame_len) return 0;                            // not enough data to process
+    metrics->bits_received++;
 
     int frame_found = 0;
-    int score_begin = pattern_at_position_score(g_frame_data, normal_training_sequence3_begin, 0);
-    int score_end   = pattern_at_position_score(g_frame_data, normal_training_sequence3_end, 500);
 
-    if ((score_begin == 0) && (score_end < 2))                                  // frame (burst) is matched and can be processed
+    if (g_is_synchronized)                                                      // burst is expected at a known position
+    {
+        frame_found = rx_flywheel();
+    }
+    else if (g_frame_data.size() >= g_frame_len)                                // hunting, bit by bit
     {
-        frame_found = 1;
-        reset_synchronizer();                                                   // reset missing sync synchronizer
+        if (burst_at_position(0))                                               // frame (burst) is matched and can be processed
+        {
+            frame_found = 1;
+            reset_synchronizer();                                               // reset missing sync synchronizer
+
+            increment_tn();
+            process_frame();
+            g_frame_data.erase(g_frame_data.begin(), g_frame_data.end() - g_flywheel_window); // frame has been processed, keep its end in case next one comes early
+        }
+        else
+        {
+            g_frame_data.erase(g_frame_data.begin());                           // remove first symbol from buffer to make space for next one
+        }
     }
 
-    int cleared_flag = 0;
+    if (g_is_synchronized)
+    {
+        g_sync_bit_counter--;
+
+        if (g_sync_bit_counter == 0)                                            // synchronization is lost
+        {
+            log_printf(LOG_SYNC, "* synchronization lost\n");
+            metrics->sync_lost++;
+
+            if (trace != NULL)                                                  // keep the bursts which lead to the loss
+            {
+                trace_outcome(TRACE_SYNC_LOST);
+                trace->dump(TRACE_REASON_SYNC_LOST);
+            }
+            g_is_synchronized = false;
+
+            if (g_frame_data.size() >= g_frame_len)                             // back to hunting with a buffer shorter than a frame
+            {
+                g_frame_data.erase(g_frame_data.begin(), g_frame_data.end() - (g_frame_len - 1));
+            }
+        }
+    }
 
-    if (frame_found || (g_is_synchronized && (g_sync_bit_counter % 510 == 0)))  // the frame can be processed either by presence of training sequence, either by synchronised and still allowed missing frames
+    return frame_found;
+}
+
+/**
+ * @brief Check if a frame (burst) starts at position in buffer
+ *
+ */
+
+bool tetra_dl::burst_at_position(uint32_t pos)
+{
+    int score_begin = pattern_at_position_score(g_frame_data, normal_training_sequence3_begin, pos);
+    int score_end   = pattern_at_position_score(g_frame_data, normal_training_sequence3_end, pos + 500);
+
+    return (score_begin == 0) && (score_end < 2);
+}
+
+/**
+ * @brief Process the expected frame (burst) while synchronized
+ *
+ * Buffer starts with the last g_flywheel_window bits of previous frame,
+ * the next frame is expected right after them. It is searched up to
+ * g_flywheel_window bits earlier or later so small bit slips of the PHY
+ * clock recovery don't break synchronization. If it is not found, the
+ * frame at the expected position is processed anyway (flywheel) until
+ * 50 frames are missed.
+ *
+ * @return 1 if frame (burst) found, 0 otherwise
+ *
+ */
+
+int tetra_dl::rx_flywheel()
+{
+    int window = (int)g_flywheel_window;
+    int late   = (int)g_frame_data.size() - (int)g_frame_len - window;          // bits received after the expected frame end
+
+    if (late < 0)                                                               // expected frame not complete
     {
-        increment_tn();
-        process_frame();
-        g_frame_data.clear();                                                   // frame has been processed, clear it
-        cleared_flag = 1;                                                       // set flag to prevent erasing first bit in frame
+        return 0;
     }
 
-    g_sync_bit_counter--;
+    int  offset  = 0;
+    bool b_found = false;
 
-    if (g_sync_bit_counter <= 0)                                                // synchronization is lost
+    if (late == 0)                                                              // expected position first, then earlier ones
+    {
+        for (int idx = 0; (idx <= window) && !b_found; idx++)
+        {
+            if (burst_at_position(window - idx))
+            {
+                offset  = -idx;
+                b_found = true;
+            }
+        }
+    }
+    else if (burst_at_position(window + late))                                  // later
     {
-        printf("* synchronization lost\n");
-        g_is_synchronized  = false;
-        g_sync_bit_counter = 0;
+        offset  = late;
+        b_found = true;
     }
 
-    if (!cleared_flag)
+    if (!b_found && (late < window))                                            // may still come later
     {
-        g_frame_data.erase(g_frame_data.begin());                               // remove first symbol from buffer to make space for next one
+        return 0;
     }
 
-    return frame_found;
+    if (b_found)
+    {
+        reset_synchronizer();
+
+        if (offset != 0)
+        {
+            metrics->sync_slips++;
+        }
+    }
+
+    std::vector<uint8_t> window_bits;
+    window_bits.swap(g_frame_data);
+
+    g_frame_data.assign(window_bits.begin() + window + offset, window_bits.begin() + window + offset + g_frame_len);
+    increment_tn();
+    process_frame();
+
+    g_frame_data.assign(window_bits.begin() + offset + g_frame_len, window_bits.end()); // end of frame and bits already received for the next one
+
+    return b_found ? 1 : 0;
 }
 
 /**
@@ -179,7 +326,7 @@ void tetra_dl::print_data()
     txt += " ";
     for (int i = 510 - 11; i < 510; i++) txt += g_frame_data[i] == 0 ? "0" : "1";
 
-    printf("%s", txt.c_str());
+    log_printf(LOG_SYNC, "%s", txt.c_str());
 }
 
 /**
@@ -209,14 +356,68 @@ void tetra_dl::process_frame()
         burst_type = NDB_SF;
     }
 
+    if (trace != NULL)
+    {
+        trace->begin(g_frame_data, g_time, score_min > 5 ? -1 : burst_type, score_min, g_cell_infos.scrambling_code);
+    }
+
     if (score_min > 5)                                                          // invalid burst found
     {
         burst_type = -1;
+        metrics->bursts_invalid++;
+    }
+    else if (g_profile_flag)                                                    // same as below, but time MAC without nested coding and report stages
+    {
+        metrics->bursts[burst_type]++;
+
+        uint64_t nested_start_ns = 0;
+        for (int stage = PROFILE_DESCRAMBLE; stage < PROFILE_MAC; stage++)
+        {
+            nested_start_ns += g_profile_ns[stage];
+        }
+        nested_start_ns += g_profile_ns[PROFILE_REPORT];
+
+        uint64_t start_ns = utils_now_ns();
+        service_lower_mac(g_frame_data, burst_type);
+        uint64_t elapsed_ns = utils_now_ns() - start_ns;
+
+        uint64_t nested_end_ns = 0;
+        for (int stage = PROFILE_DESCRAMBLE; stage < PROFILE_MAC; stage++)
+        {
+            nested_end_ns += g_profile_ns[stage];
+        }
+        nested_end_ns += g_profile_ns[PROFILE_REPORT];
+
+        g_profile_ns[PROFILE_MAC] += elapsed_ns - (nested_end_ns - nested_start_ns);
+        g_profile_bursts++;
+
+        metrics->processing_ns += elapsed_ns;
+        metrics->burst.add(elapsed_ns);
+        metrics->parse.add(elapsed_ns - (nested_end_ns - nested_start_ns));
     }
     else                                                                        // insert it for MAC lower layer processing
     {
+        metrics->bursts[burst_type]++;
         service_lower_mac(g_frame_data, burst_type);                            // send it to MAC
     }
+
+    if (trace != NULL)
+    {
+        trace->commit();
+    }
+}
+
+/**
+ * @brief Add outcome flags to the burst being traced
+ *
+ */
+
+void tetra_dl::trace_outcome(uint8_t flags)
+{
+    if (trace != NULL)
+    {
+        trace->current()->outcome |= flags;
+    }
 }
 
 /**
@@ -250,6 +451,7 @@ void tetra_dl::increment_tn()
     {
         g_time.fn++;
         g_time.tn = 1;
+        g_frames_count++;
     }
 
     if (g_time.fn > 18)                                                         // frame number
@@ -36,6 +36,11 @@
 #include "tetra_common.h"
 #include "viterbi.h"
 #include "mac_defrag.h"
+#include "metrics.h"
+#include "trace.h"
+#include "filter.h"
+#include "pdu_schema.h"
+#include "log.h"
 
 /**
  * @defgroup tetra_dl TETRA decoder
@@ -87,15 +92,26 @@ public:
     tetra_cell_infos_t g_cell_infos;                                            ///< Cell informations
 
     bool     g_cell_informations_acquired;                                      ///< Cell informations have been acquired
+    uint64_t g_frames_count;                                                    ///< TDMA frames processed, doesn't wrap like g_time
     bool     g_is_synchronized;                                                 ///< True is program is synchronized with burst
     uint64_t g_sync_bit_counter;                                                ///< Synchronization bits counter
+    uint32_t g_flywheel_window;                                                 ///< While synchronized, burst is searched up to this number of bits before or after its expected position
 
     int rx_symbol(uint8_t sym);
+    int rx_flywheel();
+    bool burst_at_position(uint32_t pos);
     void process_frame();
     void print_data();
     void reset_synchronizer();
     void increment_tn();
 
+    // warm start
+    cell_state_t g_cell_state;                                                  ///< Cell state loaded from snapshot
+    bool         g_cell_state_pending;                                          ///< Loaded cell state not yet checked against SYNC
+    bool cell_state_save(const char * filename);
+    bool cell_state_load(const char * filename);
+    void cell_state_validate(const tetra_time_t & estimate);
+
     std::string mac_logical_channel_name(int val);
     std::string burst_name(int val);
 
@@ -111,16 +127,21 @@ public:
 
     // CRC16 check
     int check_crc16ccitt(std::vector<uint8_t> data, int len);
+    bool check_llc_fcs(const std::vector<uint8_t> & pdu, uint32_t start, uint32_t len);
 
     // MAC
-    uint8_t       usage_marker_encryption_mode[64];                             ///< usage marker encryption mode for u-plane (MAC TRAFFIC)
-    mac_defrag_t  * mac_defrag;                                                 ///< MAC defragmenter class
-    mac_state_t   mac_state;                                                    ///< Current MAC state (from ACCESS-ASSIGN PDU)
-    mac_address_t mac_address;                                                  ///< Current MAc address (from MAC-RESOURCE PDU)
-    uint8_t       second_slot_stolen_flag;                                      ///< 1 if second slot is stolen
+    uint8_t        usage_marker_encryption_mode[64];                            ///< usage marker encryption mode for u-plane (MAC TRAFFIC)
+    mac_defrag_t   * mac_defrag;                                                ///< MAC defragmenter, concurrent reassemblies per time slot and address
+    mac_timeslot_t mac_timeslot[4];                                             ///< MAC state and address per time slot, TN 1-4
+    mac_state_t    mac_state;                                                   ///< Current MAC state (from ACCESS-ASSIGN PDU), copy of the burst time slot one
+    mac_address_t  mac_address;                                                 ///< Current MAc address (from MAC-RESOURCE PDU), copy of the burst time slot one
+    uint8_t        second_slot_stolen_flag;                                     ///< 1 if second slot is stolen
+    uint8_t        first_slot_stolen_flag;                                      ///< 1 if TCH_S sent to U-plane has its first half slot stolen (speech in BKN2 only)
+    bool           g_decode_policy_flag;                                        ///< If true, blocks not required by the slot usage are not decoded
 
     void service_lower_mac(std::vector<uint8_t> data, int burst_type);
     void service_upper_mac(std::vector<uint8_t> data, mac_logical_channel_t mac_logical_channel);
+    decode_policy_t mac_decode_policy(int burst_type);
 
     std::vector<uint8_t> mac_remove_fill_bits(const std::vector<uint8_t> pdu);
     std::vector<uint8_t> mac_pdu_process_sync(std::vector<uint8_t> pdu);                                                                             // process SYNC
@@ -130,6 +151,7 @@ public:
     void                 mac_pdu_process_mac_frag(std::vector<uint8_t> pdu);                                                                         // process MAC-FRAG
     std::vector<uint8_t> mac_pdu_process_mac_end(std::vector<uint8_t> pdu);                                                                          // process MAC-END
     std::vector<uint8_t> mac_pdu_process_d_block(std::vector<uint8_t> pdu);                                                                          // process MAC-D-BLCK
+    void                 mac_assign_traffic_timeslots(uint8_t timeslot_assigned);                                                                    // assign traffic slots to current address
 
     // LLC
     void service_llc(std::vector<uint8_t> pdu, mac_logical_channel_t mac_logical_channel);
@@ -179,12 +201,36 @@ public:
     // U-plane
     void service_u_plane(std::vector<uint8_t> data, mac_logical_channel_t mac_logical_channel); // U-plane traffic
 
+    // profiling (see decoder_bench)
+    bool     g_profile_flag;                                                    ///< If true, time spent per decoding stage is accumulated and reports are checksummed
+    uint64_t g_profile_ns[PROFILE_STAGE_COUNT];                                 ///< Accumulated time per decoding stage [ns]
+    uint64_t g_profile_bursts;                                                  ///< Number of bursts sent to lower MAC
+    uint64_t g_report_count;                                                    ///< Number of Json reports sent
+    uint64_t g_report_checksum;                                                 ///< FNV-1a checksum of Json reports, without system time
+
+    // metrics
+    metrics_t * metrics;                                                        ///< Counters and latency histograms
+
+    // post-mortem trace
+    trace_ring_t * trace;                                                       ///< Ring of last bursts, NULL if disabled
+    void trace_outcome(uint8_t flags);
+
+    // subscription filter
+    report_filter_t * filter;                                                   ///< PDUs to decode and report, NULL to keep all
+    bool report_address_filtered();
+
+    // change-only reporting of periodic broadcast PDUs
+    broadcast_cache_t broadcast_cache[BROADCAST_PDU_COUNT];                     ///< Last content per broadcast PDU type
+    uint32_t          g_broadcast_keepalive_frames;                             ///< Unchanged broadcast PDUs are reported again after this number of TDMA frames, 0 to report all
+    bool broadcast_changed(broadcast_pdu_t type, const std::vector<uint8_t> & pdu, std::size_t len, std::size_t skip_start = 0, std::size_t skip_len = 0);
+    bool broadcast_report_due(broadcast_pdu_t type, bool b_changed);
+
     // for reporting informations in Json format
     rapidjson::Document jdoc;                                                   ///< rapidjson document
     int socketfd = 0;                                                           ///< UDP socket to write to
 
-    void report_start(const std::string service, const std::string pdu);
-    void report_start_u_plane(const std::string service, const std::string pdu);
+    bool report_start(const std::string service, const std::string pdu);
+    bool report_start_u_plane(const std::string service, const std::string pdu);
     void report_add(std::string field, std::string val);
     void report_add(std::string field, uint8_t val);
     void report_add(std::string field, uint16_t val);
@@ -194,6 +240,7 @@ public:
     void report_add(std::string field, std::vector<uint8_t> vec);
     void report_add_array(std::string name, std::vector<std::tuple<std::string, uint64_t>> & infos);
     void report_add_compressed(std::string field, const unsigned char * binary_data, uint16_t data_len);
+    void pdu_field(const char * key, uint64_t val);
     void report_send();
     
 private:
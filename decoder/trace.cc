@@ -0,0 +1,237 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "trace.h"
+#include "utils.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief Constructor, allocate the ring
+ *
+ */
+
+trace_ring_t::trace_ring_t(uint32_t ring_capacity, const char * dump_filename)
+{
+    capacity = (ring_capacity > 0) ? ring_capacity : 1;
+    records.resize(capacity);
+    memset(records.data(), 0, capacity * sizeof(trace_record_t));
+
+    head.store(0);
+    cur = &records[0];
+
+    strncpy(filename, dump_filename, sizeof(filename) - 1);
+    filename[sizeof(filename) - 1] = '\0';
+
+    dump_count.store(0);
+    last_sync_lost_dump_ns = 0;
+}
+
+/**
+ * @brief Destructor
+ *
+ */
+
+trace_ring_t::~trace_ring_t()
+{
+    records.clear();
+}
+
+/**
+ * @brief Start a new record for the burst
+ *
+ * The record is invalidated first, so a dump taken before commit
+ * does not mix old and new content.
+ *
+ */
+
+trace_record_t * trace_ring_t::begin(const std::vector<uint8_t> & bits, const tetra_time_t & time, int burst_type, int score, uint32_t scrambling_code)
+{
+    uint64_t seq = head.load(std::memory_order_relaxed);
+
+    cur = &records[seq % capacity];
+    cur->seq = 0;
+    std::atomic_signal_fence(std::memory_order_seq_cst);                        // invalidate before overwriting
+
+    cur->time_ns         = utils_now_ns();
+    cur->tn              = time.tn;
+    cur->fn              = time.fn;
+    cur->mn              = time.mn;
+    cur->burst_type      = (int8_t)burst_type;
+    cur->score           = (uint8_t)(score > 255 ? 255 : score);
+    cur->aach            = 0;
+    cur->outcome         = 0;
+    cur->reserved        = 0;
+    cur->scrambling_code = scrambling_code;
+
+    memset(cur->bits, 0, sizeof(cur->bits));
+    std::size_t len = bits.size() < 8 * sizeof(cur->bits) ? bits.size() : 8 * sizeof(cur->bits);
+    for (std::size_t idx = 0; idx < len; idx++)
+    {
+        cur->bits[idx >> 3] |= (bits[idx] & 1) << (7 - (idx & 7));              // pack bits MSB first
+    }
+
+    return cur;
+}
+
+/**
+ * @brief Record being written, outcome may be updated until commit
+ *
+ */
+
+trace_record_t * trace_ring_t::current()
+{
+    return cur;
+}
+
+/**
+ * @brief Publish current record
+ *
+ */
+
+void trace_ring_t::commit()
+{
+    uint64_t seq = head.load(std::memory_order_relaxed) + 1;
+
+    std::atomic_signal_fence(std::memory_order_seq_cst);                        // record content before its sequence number
+    cur->seq = seq;
+    head.store(seq, std::memory_order_release);
+}
+
+/**
+ * @brief Create a new dump file <filename>.<reason>.<n>
+ *
+ * The number is increased until the file doesn't exist yet, so dumps of
+ * a previous run are kept too. No snprintf() since it is not
+ * async-signal-safe.
+ *
+ */
+
+bool trace_ring_t::open_dump_file(trace_reason_t reason, int * fd)
+{
+    const char * reason_name = (reason == TRACE_REASON_SIGNAL) ? "signal" : (reason == TRACE_REASON_SYNC_LOST) ? "sync" : "exit";
+
+    for (int attempt = 0; attempt < 10000; attempt++)
+    {
+        uint32_t num = dump_count.fetch_add(1) + 1;
+
+        char name[sizeof(filename) + 32];
+        std::size_t len = strlen(filename);
+        memcpy(name, filename, len);
+        name[len++] = '.';
+        for (const char * ptr = reason_name; *ptr != '\0'; ptr++)
+        {
+            name[len++] = *ptr;
+        }
+        name[len++] = '.';
+
+        char digits[10];
+        int count = 0;
+        do
+        {
+            digits[count++] = (char)('0' + num % 10);
+            num /= 10;
+        } while (num > 0);
+        while (count > 0)
+        {
+            name[len++] = digits[--count];
+        }
+        name[len] = '\0';
+
+        *fd = open(name, O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (*fd >= 0)
+        {
+            return true;
+        }
+        if (errno != EEXIST)
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Write the ring to a new dump file
+ *
+ * Only async-signal-safe calls are used. Synchronization loss dumps
+ * closer than SYNC_LOST_DUMP_INTERVAL_NS to the previous one are skipped
+ * so a flapping carrier doesn't write the ring again and again from the
+ * decoding thread.
+ *
+ * @return false if the dump was skipped or failed
+ *
+ */
+
+bool trace_ring_t::dump(trace_reason_t reason)
+{
+    if (reason == TRACE_REASON_SYNC_LOST)                                       // only called from the decoding thread
+    {
+        uint64_t now_ns = utils_now_ns();
+
+        if ((last_sync_lost_dump_ns != 0) && (now_ns - last_sync_lost_dump_ns < SYNC_LOST_DUMP_INTERVAL_NS))
+        {
+            return false;
+        }
+
+        last_sync_lost_dump_ns = now_ns;
+    }
+
+    int saved_errno = errno;                                                    // may interrupt the decoding thread
+    trace_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "TKTRACE1", 8);
+    header.record_size = sizeof(trace_record_t);
+    header.capacity    = capacity;
+    header.reason      = reason;
+    header.head        = head.load(std::memory_order_acquire);
+
+    int fd;
+    if (!open_dump_file(reason, &fd))
+    {
+        errno = saved_errno;
+        return false;
+    }
+
+    bool ok_flag = (write(fd, &header, sizeof(header)) == (ssize_t)sizeof(header));
+
+    const char * data = (const char *)records.data();
+    std::size_t len   = capacity * sizeof(trace_record_t);
+    while (ok_flag && (len > 0))
+    {
+        ssize_t written = write(fd, data, len);
+        if (written <= 0)
+        {
+            ok_flag = false;
+        }
+        else
+        {
+            data += written;
+            len  -= written;
+        }
+    }
+
+    ok_flag = (close(fd) == 0) && ok_flag;
+
+    errno = saved_errno;
+
+    return ok_flag;
+}
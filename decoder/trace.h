@@ -0,0 +1,123 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef TRACE_H
+#define TRACE_H
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include "tetra_common.h"
+
+/**
+ * @brief Burst decoding outcome flags
+ *
+ */
+
+enum trace_outcome_t {
+    TRACE_BKN1_CHECKED = 0x01,                                                  // BKN1 (or full slot) CRC checked
+    TRACE_BKN1_CRC_OK  = 0x02,                                                  // BKN1 (or full slot) CRC passed
+    TRACE_BKN2_CHECKED = 0x04,                                                  // BKN2 CRC checked
+    TRACE_BKN2_CRC_OK  = 0x08,                                                  // BKN2 CRC passed
+    TRACE_TRAFFIC      = 0x10,                                                  // burst sent to U-plane as speech
+    TRACE_SYNC_LOST    = 0x20                                                   // synchronization lost after this burst
+};
+
+/**
+ * @brief Dump reason
+ *
+ */
+
+enum trace_reason_t {
+    TRACE_REASON_SIGNAL    = 1,                                                 // SIGUSR1 received
+    TRACE_REASON_SYNC_LOST = 2,                                                 // synchronization lost
+    TRACE_REASON_EXIT      = 3                                                  // program exit
+};
+
+/**
+ * @brief One burst record, fixed size binary
+ *
+ */
+
+struct trace_record_t {
+    uint64_t seq;                                                               ///< Record number starting at 1, 0 while being written
+    uint64_t time_ns;                                                           ///< Monotonic time [ns]
+    uint16_t tn;                                                                ///< TDMA time of the burst
+    uint16_t fn;
+    uint16_t mn;
+    int8_t   burst_type;                                                        ///< burst_t or -1 if invalid
+    uint8_t  score;                                                             ///< Training sequence errors (0 = perfect match)
+    uint16_t aach;                                                              ///< Decoded ACCESS-ASSIGN 14 bits
+    uint8_t  outcome;                                                           ///< trace_outcome_t flags
+    uint8_t  reserved;
+    uint32_t scrambling_code;                                                   ///< Scrambling code used
+    uint8_t  bits[64];                                                          ///< 510 burst bits, MSB first
+};
+
+/**
+ * @brief Dump file header, followed by capacity records in slot order
+ *
+ */
+
+struct trace_header_t {
+    char     magic[8];                                                          ///< "TKTRACE1"
+    uint32_t record_size;                                                       ///< sizeof(trace_record_t)
+    uint32_t capacity;                                                          ///< Number of records
+    uint32_t reason;                                                            ///< trace_reason_t
+    uint32_t reserved;
+    uint64_t head;                                                              ///< Number of records written since start
+};
+
+/**
+ * @brief Fixed size ring of the last bursts
+ *
+ * Single writer (the decoding thread), no lock and no allocation after
+ * construction. The dump only uses open/write/close so it may be called
+ * from a signal handler: a record interrupted while being written has
+ * seq = 0 and is skipped by trace_print.
+ *
+ * Each dump is written to its own file <filename>.<reason>.<n> and
+ * never replaces an earlier one. Synchronization loss dumps are rate
+ * limited since the ring already covers about one minute.
+ *
+ */
+
+class trace_ring_t {
+public:
+    trace_ring_t(uint32_t capacity, const char * filename);
+    ~trace_ring_t();
+
+    trace_record_t * begin(const std::vector<uint8_t> & bits, const tetra_time_t & time, int burst_type, int score, uint32_t scrambling_code);
+    void commit();
+    trace_record_t * current();
+
+    bool dump(trace_reason_t reason);                                           // async-signal-safe
+
+    static const uint64_t SYNC_LOST_DUMP_INTERVAL_NS = 60000000000ULL;          ///< Minimum time between two synchronization loss dumps [ns]
+
+private:
+    bool open_dump_file(trace_reason_t reason, int * fd);
+    std::vector<trace_record_t> records;                                        ///< Ring storage
+    uint32_t capacity;
+    std::atomic<uint64_t> head;                                                 ///< Records committed
+    trace_record_t * cur;                                                       ///< Record being written
+    char filename[256];                                                         ///< Dump file name prefix
+    std::atomic<uint32_t> dump_count;                                           ///< Last dump file number
+    uint64_t last_sync_lost_dump_ns;                                            ///< Time of last synchronization loss dump, 0 if none
+};
+
+#endif /* TRACE_H */
@@ -0,0 +1,170 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <algorithm>
+#include <unistd.h>
+
+/**
+ * @brief Burst type name
+ *
+ */
+
+static const char * burst_type_name(int8_t burst_type)
+{
+    switch (burst_type)
+    {
+    case SB:
+        return "SB";
+    case NDB:
+        return "NDB";
+    case NDB_SF:
+        return "NDB_SF";
+    default:
+        return "invalid";
+    }
+}
+
+/**
+ * @brief Format CRC outcome of one block: '-' not checked, 'ok' or 'KO'
+ *
+ */
+
+static const char * crc_name(uint8_t outcome, uint8_t checked_flag, uint8_t ok_flag)
+{
+    if (!(outcome & checked_flag))
+    {
+        return "--";
+    }
+
+    return (outcome & ok_flag) ? "ok" : "KO";
+}
+
+/**
+ * @brief Pretty-print a burst trace dump written by "decoder -T <file>"
+ *
+ */
+
+int main(int argc, char * argv[])
+{
+    bool bits_flag = false;
+
+    int option;
+    while ((option = getopt(argc, argv, "hb")) != -1)
+    {
+        switch (option)
+        {
+        case 'b':
+            bits_flag = true;
+            break;
+
+        default:
+            printf("\nUsage: ./trace_print [OPTIONS] trace.bin\n\n"
+                   "Options:\n"
+                   "  -b print burst bits\n"
+                   "  -h print this help\n\n");
+            exit(EXIT_FAILURE);
+            break;
+        }
+    }
+
+    if (optind >= argc)
+    {
+        fprintf(stderr, "missing trace file, run ./trace_print -h\n");
+        exit(EXIT_FAILURE);
+    }
+
+    FILE * file = fopen(argv[optind], "rb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Couldn't open trace file '%s'\n", argv[optind]);
+        exit(EXIT_FAILURE);
+    }
+
+    trace_header_t header;
+    if ((fread(&header, sizeof(header), 1, file) != 1) || (memcmp(header.magic, "TKTRACE1", 8) != 0) || (header.record_size != sizeof(trace_record_t)))
+    {
+        fprintf(stderr, "Invalid trace file '%s'\n", argv[optind]);
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<trace_record_t> records(header.capacity);
+    std::size_t count = fread(records.data(), sizeof(trace_record_t), header.capacity, file);
+    fclose(file);
+
+    records.resize(count);
+    // drop empty records and the ones interrupted while written
+    records.erase(std::remove_if(records.begin(), records.end(), [](const trace_record_t & rec) { return rec.seq == 0; }), records.end());
+    std::sort(records.begin(), records.end(), [](const trace_record_t & a, const trace_record_t & b) { return a.seq < b.seq; });
+
+    const char * reasons[] = {"?", "signal", "synchronization lost", "exit"};
+    printf("trace '%s': reason = %s, %lu bursts recorded, %lu in dump\n\n",
+           argv[optind],
+           reasons[header.reason <= TRACE_REASON_EXIT ? header.reason : 0],
+           (unsigned long)header.head,
+           (unsigned long)records.size());
+
+    if (records.empty())
+    {
+        return EXIT_SUCCESS;
+    }
+
+    uint64_t last_ns = records.back().time_ns;
+
+    printf("%10s %12s  %-8s  %-7s %5s  %-14s %4s %4s  %s\n", "seq", "time [ms]", "TN/FN/MN", "burst", "score", "AACH hdr/f1/f2", "bkn1", "bkn2", "flags");
+
+    for (std::size_t idx = 0; idx < records.size(); idx++)
+    {
+        const trace_record_t & rec = records[idx];
+
+        std::string flags = "";
+        if (rec.outcome & TRACE_TRAFFIC)   flags += " traffic";
+        if (rec.outcome & TRACE_SYNC_LOST) flags += " SYNC-LOST";
+
+        printf("%10lu %12.3f  %2u/%2u/%2u  %-7s %5u  %3u/%3u/%3u    %4s %4s %s\n",
+               (unsigned long)rec.seq,
+               -((double)(last_ns - rec.time_ns)) / 1.0e6,                      // relative to last burst
+               rec.tn,
+               rec.fn,
+               rec.mn,
+               burst_type_name(rec.burst_type),
+               rec.score,
+               (rec.aach >> 12) & 0x03,
+               (rec.aach >> 6) & 0x3f,
+               rec.aach & 0x3f,
+               crc_name(rec.outcome, TRACE_BKN1_CHECKED, TRACE_BKN1_CRC_OK),
+               crc_name(rec.outcome, TRACE_BKN2_CHECKED, TRACE_BKN2_CRC_OK),
+               flags.c_str());
+
+        if (bits_flag)
+        {
+            std::string txt = "";
+            for (int bit = 0; bit < 510; bit++)
+            {
+                txt += (rec.bits[bit >> 3] >> (7 - (bit & 7))) & 1 ? '1' : '0';
+            }
+            printf("           %s\n", txt.c_str());
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
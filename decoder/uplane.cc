@@ -26,19 +26,32 @@
 
 void tetra_dl::service_u_plane(std::vector<uint8_t> pdu, mac_logical_channel_t mac_logical_channel)
 {
-    if (g_debug_level >= 5)
+    if (LOG_ENABLED(g_debug_level, 5))
     {
-        fprintf(stdout, "DEBUG ::%-44s - mac_channel = %s pdu = %s encr = %u\n",
-                "service_u_plane",
-                mac_logical_channel_name(mac_logical_channel).c_str(),
-                vector_to_string(pdu, pdu.size()).c_str(),
-                usage_marker_encryption_mode[mac_state.downlink_usage_marker]);
-        fflush(stdout);
+        log_printf(LOG_UPLANE, "DEBUG ::%-44s - mac_channel = %s pdu = %s encr = %u\n",
+                   "service_u_plane",
+                   mac_logical_channel_name(mac_logical_channel).c_str(),
+                   vector_to_string(pdu, pdu.size()).c_str(),
+                   usage_marker_encryption_mode[mac_state.downlink_usage_marker]);
+    }
+
+    if ((filter != NULL) && !filter->accept_encryption(usage_marker_encryption_mode[mac_state.downlink_usage_marker]))
+    {
+        metrics->pdus_filtered++;
+        return;
+    }
+
+    if ((mac_address.address_type != 0) && report_address_filtered())           // slot address is unknown until a traffic assignment is received
+    {
+        return;
     }
 
     if (mac_logical_channel == TCH_S)                                           // speech frame
     {
-        report_start_u_plane("UPLANE", "TCH_S");
+        if (!report_start_u_plane("UPLANE", "TCH_S"))
+        {
+            return;
+        }
 
         static const std::size_t MIN_SIZE = 432;
 
@@ -81,6 +94,7 @@ void tetra_dl::service_u_plane(std::vector<uint8_t> pdu, mac_logical_channel_t m
 
             report_add("downlink usage marker", mac_state.downlink_usage_marker);                               // current usage marker
             report_add("encryption mode",       usage_marker_encryption_mode[mac_state.downlink_usage_marker]); // current encryption mode
+            report_add("frame stealing",        first_slot_stolen_flag);                                       // 1 if first half slot is stolen (STCH), speech is in second half slot only
             // report_add_compressed("frame", (const unsigned char *)speech_frame, 2 * 690);                       // actual binary frame 1380 bytes
         }
         else
@@ -359,3 +359,31 @@ std::string format_str(const char *fmt, ...)
 
     return std::string(buf);
 }
+
+/**
+ * @brief Monotonic clock in nanoseconds, used for profiling
+ *
+ */
+
+uint64_t utils_now_ns()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Update FNV-1a 64 bits hash with data
+ *
+ * Initial hash value is 0xcbf29ce484222325
+ *
+ */
+
+uint64_t utils_fnv1a(uint64_t hash, const char * data, std::size_t len)
+{
+    for (std::size_t idx = 0; idx < len; idx++)
+    {
+        hash ^= (uint8_t)data[idx];
+        hash *= 0x100000001b3ULL;                                               // FNV 64 bits prime
+    }
+
+    return hash;
+}
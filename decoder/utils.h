@@ -50,4 +50,7 @@ int32_t utils_substract(int32_t val1, int32_t val2);
 
 std::string format_str(const char *fmt, ...);
 
+uint64_t utils_now_ns();
+uint64_t utils_fnv1a(uint64_t hash, const char * data, std::size_t len);
+
 #endif /* UTILS_H */
@@ -51,28 +51,150 @@ void audio_decoder::init()
  *
  * NOTES:
  *  - first frame must be handled by recorder when calling function
- *  - stealing frame must be handled by recorder when calling function
+ *  - stealing frame flag is given by recorder (first half slot stolen by STCH)
  */
 
 int audio_decoder::process_frame(const int16_t * input_frame, int16_t * raw_output, const int16_t frame_stealing_flag)
 {
     // cdecoder part
-    
-    int16_t interleaved_coded_array[432];                                       // time-slot length at 7.2 kb/s
+
     int16_t coded_array[432];
     int16_t reordered_array[286];                                               // 2 frames vocoder + 8 + 4
 
-    // TODO Add Frame Stealing Flag handling, for now, frame_stealing_flag is always 0
+    // frame_stealing_flag (from "frame stealing" field of UPLANE report):
     // 0 = Inactive,
-    // !0 = First Frame in time-slot stolen
+    // !0 = First Frame in time-slot stolen, only second half slot is decoded and bfi1 is set
+
+    if (!unpack_frame(input_frame, coded_array, frame_stealing_flag))
+    {
+        return 0;                                                               // skip this frame
+    }
+
+    bfi1 = frame_stealing_flag;
+
+    // channel decoding
+    bfi2 = cdec->channel_decoding(g_first_pass_flag, frame_stealing_flag, coded_array, reordered_array);
+    g_first_pass_flag = 0;
+
+    if ((frame_stealing_flag == 0) && (bfi2 == 1))
+    {
+        bfi1 = 1;
+    }
+
+    // sdecoder part
+
+    synthesize(reordered_array, raw_output);
+
+    return 1;
+}
+
+/**
+ * @brief Process TETRA channel frames of several streams (see audio_batch_t)
+ *
+ * Stages are run for all frames in turn, and the RCPC decoding of standard mode frames
+ * is done BATCH_LANES frames at a time with one stream per SIMD lane. Results are the same
+ * as process_frame() called on each frame.
+ *
+ */
+
+void audio_decoder::process_batch(audio_batch_t * batch)
+{
+    const int MAX_FRAMES = audio_batch_t::MAX_FRAMES;
+
+    int16_t coded_array[MAX_FRAMES][432];
+    int16_t decoded_array[MAX_FRAMES][286];
+    int16_t reordered_array[286];
+
+    int16_t * lane_input[codec_cdecoder::cdecoder::BATCH_LANES];
+    int16_t * lane_output[codec_cdecoder::cdecoder::BATCH_LANES];
+    int16_t lanes = 0;
+    audio_decoder * leader = NULL;
+
+    for (int idx = 0; idx < batch->count; idx++)
+    {
+        audio_decoder * dec = batch->decoder[idx];
+        int16_t fs_flag = batch->frame_stealing_flag[idx];
+
+        batch->result[idx] = dec->unpack_frame(batch->input_frame[idx], coded_array[idx], fs_flag);
+
+        if (!batch->result[idx])
+        {
+            continue;                                                           // skip this frame
+        }
+
+        if (dec->g_first_pass_flag)                                             // init channel-decoder
+        {
+            dec->cdec->init_rcpc_decoding();
+            dec->g_first_pass_flag = 0;
+        }
+
+        if (fs_flag)                                                            // frame stealing: second half only, decoded alone
+        {
+            dec->cdec->rcpc_decoding(fs_flag, coded_array[idx] + 216, decoded_array[idx]);
+            continue;
+        }
+
+        if (lanes == 0)
+        {
+            leader = dec;                                                       // lattice tables are the same for every decoder
+        }
+
+        lane_input[lanes]  = coded_array[idx];
+        lane_output[lanes] = decoded_array[idx];
+        lanes++;
+
+        if (lanes == codec_cdecoder::cdecoder::BATCH_LANES)
+        {
+            leader->cdec->rcpc_decoding_batch(lanes, lane_input, lane_output);
+            lanes = 0;
+        }
+    }
+
+    if (lanes > 0)
+    {
+        leader->cdec->rcpc_decoding_batch(lanes, lane_input, lane_output);
+    }
+
+    for (int idx = 0; idx < batch->count; idx++)
+    {
+        if (!batch->result[idx])
+        {
+            continue;
+        }
+
+        audio_decoder * dec = batch->decoder[idx];
+        int16_t fs_flag = batch->frame_stealing_flag[idx];
+
+        dec->bfi1 = fs_flag;
+        dec->bfi2 = dec->cdec->channel_decoding_post(fs_flag, decoded_array[idx], reordered_array);
+
+        if ((fs_flag == 0) && (dec->bfi2 == 1))
+        {
+            dec->bfi1 = 1;
+        }
+
+        dec->synthesize(reordered_array, batch->raw_output[idx]);
+    }
+}
+
+/**
+ * @brief Check input frame, remove interleaving to coded_array[432]
+ *
+ * @return 0 if frame is invalid, 1 otherwise
+ *
+ */
+
+int audio_decoder::unpack_frame(const int16_t * input_frame, int16_t * coded_array, const int16_t frame_stealing_flag)
+{
+    int16_t interleaved_coded_array[432];                                       // time-slot length at 7.2 kb/s
 
     if (!cdec->process_frame(input_frame, interleaved_coded_array))
     {
         printf("invalid frame\n");
-        return 0;                                                               // skip this frame
+        return 0;
     }
- 
-    if (frame_stealing_flag)                                                    // FIXME handle frame_stealing_flag in recorder program
+
+    if (frame_stealing_flag)                                                    // second half slot is interleaved as a signalling block
     {
         cdec->desinterleaving_signalling(interleaved_coded_array + 216, coded_array + 216);
 
@@ -86,17 +208,19 @@ int audio_decoder::process_frame(const int16_t * input_frame, int16_t * raw_outp
     {
         cdec->desinterleaving_speech(interleaved_coded_array, coded_array);
     }
-    bfi1 = frame_stealing_flag;
 
-    // channel decoding
-    bfi2 = cdec->channel_decoding(g_first_pass_flag, frame_stealing_flag, coded_array, reordered_array);
-    g_first_pass_flag = 0;
-    
-    if ((frame_stealing_flag == 0) && (bfi2 == 1))
-    {
-        bfi1 = 1;
-    }
+    return 1;
+}
+
+/**
+ * @brief Synthesize the two speech frames of reordered_array with current bfi1/bfi2
+ *
+ *  - raw_output : 240 * 2 * sizeof(int16_t) = 960 bytes contains the two speech frames
+ *
+ */
 
+void audio_decoder::synthesize(const int16_t * reordered_array, int16_t * raw_output)
+{
     // prepare speech frames, length is 138 * 2 bytes
     int16_t speech_frame1[138] = {0};
     int16_t speech_frame2[138] = {0};
@@ -113,25 +237,9 @@ int audio_decoder::process_frame(const int16_t * input_frame, int16_t * raw_outp
         speech_frame2[pos - 136] = reordered_array[pos];
     }
 
-    // sdecoder part
-
-    int16_t data[240] = {0};                                                    // output speech frame length is 240 * 2 bytes
-
-    // process first speech frame
-    sdec->process_speech_frame(speech_frame1, data);
-    for (int idx = 0; idx < 240; idx++)
-    {
-        raw_output[idx] = data[idx];
-    }
-
-    // process second speech frame
-    sdec->process_speech_frame(speech_frame2, data);
-    for (int idx = 0; idx < 240; idx++)
-    {
-        raw_output[idx + 240] = data[idx];
-    }
-
-    return 1;
+    // process first and second speech frames, output speech frame length is 240 * 2 bytes
+    sdec->process_speech_frame(speech_frame1, raw_output);
+    sdec->process_speech_frame(speech_frame2, raw_output + 240);
 }
 
 /**
@@ -159,7 +267,7 @@ int audio_decoder::process_frame_debug(FILE * file_out, const int16_t * input_fr
         return 0;                                                               // skip this frame
     }
  
-    if (frame_stealing_flag)                                                    // FIXME handle frame_stealing_flag
+    if (frame_stealing_flag)                                                    // second half slot is interleaved as a signalling block
     {
         cdec->desinterleaving_signalling(interleaved_coded_array + 216, coded_array + 216);
 
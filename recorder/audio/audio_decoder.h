@@ -22,6 +22,27 @@
 #include <cdecoder.h>
 #include <sdecoder.h>
 
+class audio_decoder;
+
+/**
+ * @brief Frames of independent streams decoded together by audio_decoder::process_batch()
+ *
+ * Structure of arrays: entry i is the frame of stream decoder[i]. A decoder must appear
+ * only once in a batch since its frames depend on the previous ones.
+ *
+ */
+
+struct audio_batch_t {
+    static const int MAX_FRAMES = 16;
+
+    int count;                                                                  // number of frames in batch
+    audio_decoder * decoder[MAX_FRAMES];                                        // stream decoder
+    const int16_t * input_frame[MAX_FRAMES];                                    // input 690 * int16_t
+    int16_t * raw_output[MAX_FRAMES];                                           // raw output 480 * int16_t
+    int16_t frame_stealing_flag[MAX_FRAMES];
+    int result[MAX_FRAMES];                                                     // process_frame() return value
+};
+
 class audio_decoder {
 public:
     audio_decoder();
@@ -32,12 +53,18 @@ public:
     int process_frame(const int16_t * input_frame, int16_t * raw_output, const int16_t frame_stealing_flag);                        // input 690 * int16_t, raw output 480 * int16_t
     int process_frame_debug(FILE * file_out, const int16_t * input_frame, int16_t * raw_output, const int16_t frame_stealing_flag); // output .cod to file_out for debugging purpose
 
+    static void process_batch(audio_batch_t * batch);                          // decode frames of several streams at once
+
     short g_first_pass_flag = 1;
     int16_t bfi1 = 0;                                                           // bad frame indicator: 0 = data is correct, 1 = frame is corrupted
     int16_t bfi2 = 0;
 
     codec_cdecoder::cdecoder * cdec;                                            // cdecoder wrapper
     codec_sdecoder::sdecoder * sdec;                                            // sdecoder wrapper
+
+private:
+    int  unpack_frame(const int16_t * input_frame, int16_t * coded_array, const int16_t frame_stealing_flag);
+    void synthesize(const int16_t * reordered_array, int16_t * raw_output);
 };
 
 #endif /* AUDIO_DECODER_H */
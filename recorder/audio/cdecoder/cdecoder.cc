@@ -118,6 +118,22 @@ int16_t cdecoder::channel_decoding(short first_pass, int16_t frame_stealing, int
         cdecoder::rcpc_decoding(frame_stealing, input_frame + 216, decoded_array);
     }
 
+    return cdecoder::channel_decoding_post(frame_stealing, decoded_array, output_frame);
+}
+
+/**
+ *
+ * @brief Speech channel decoding after RCPC decoding: BFI and reordering of speech frames
+ *
+ * @param[in]  frame_stealing  0 = standard mode, 1 = frame stealing mode activated
+ * @param[in]  decoded_array   RCPC decoded frame (286 * 2 bytes), modified
+ * @param[out] output_frame    two concatenated speech frames (2 * 137 * 2 bytes), see channel_decoding()
+ * @return                     0 = frame is valid, 1 = bad frame indicator flag
+ *
+ */
+
+int16_t cdecoder::channel_decoding_post(int16_t frame_stealing, int16_t * decoded_array, int16_t * output_frame)
+{
     int16_t bad_frame_indicator = cdecoder::bfi(frame_stealing, decoded_array);
 
     cdecoder::untransform_class_0(frame_stealing, decoded_array);               // "decoding" for non-protected class (class 0)
@@ -2,11 +2,16 @@
 #define CDECODER_H
 #include <stdio.h>
 #include <stdlib.h>
+#include "etsi_operators.h"
 
 namespace codec_cdecoder {
 
+    using namespace etsi_op;
+
     class cdecoder {
     public:
+        static const int16_t BATCH_LANES = 8;                                   // frames decoded at once by rcpc_decoding_batch()
+
         cdecoder();
         ~cdecoder();
     
@@ -14,11 +19,13 @@ namespace codec_cdecoder {
      
         int16_t bfi(int16_t fs_flag, int16_t * input_frame);
         int16_t channel_decoding(short first_pass, int16_t frame_stealing, int16_t * input_frame, int16_t * output_frame);
+        int16_t channel_decoding_post(int16_t frame_stealing, int16_t * decoded_array, int16_t * output_frame);
         int16_t combination(int16_t a, int16_t b);
         int16_t desinterleaving_signalling(int16_t * input_frame, int16_t * output_frame);
         int16_t desinterleaving_speech(int16_t * input_frame, int16_t * output_frame);
         void    init_rcpc_decoding(void);
         void    rcpc_decoding(int16_t fs_flag, int16_t * input_frame, int16_t * output_frame);
+        void    rcpc_decoding_batch(int16_t count, int16_t * const input_frames[], int16_t * const output_frames[]);
         int16_t unbuild_sensitivity_classes(int16_t fs_flag, int16_t * input_frame, int16_t * output_frame);
         int16_t untransform_class_0(int16_t fs_flag, int16_t * input_frame);
 
@@ -105,81 +112,16 @@ namespace codec_cdecoder {
         static const int16_t FS_TAB_CRC3[FS_SIZE_TAB_CRC3];
         static const int16_t FS_TAB_CRC4[FS_SIZE_TAB_CRC4];
 
-        int16_t Previous[(1 << (K - 1))][2];
-        int16_t Best_previous[(1 << (K - 1))][DECODING_DELAY];
-        int16_t T1[(1 << (K - 1))][2], T2[(1 << (K - 1))][2], T3[(1 << (K - 1))][2];
-        int16_t Score[(1 << (K - 1))];
-        int16_t Ex_score[(1 << (K - 1))];
-        int16_t Received[3];
-        int16_t Msb_bit;
-        int16_t M_1;
-
-        // operators
-        
-        int g_overflow = 0;                                                     // used only in sdecoder tetra_dsp.cc and tetra_codec.cc
-        
-        static const int32_t MAX_32 = ((int32_t)0x7FFFFFFF);
-        static const int32_t MIN_32 = ((int32_t)0x80000000);
-        static const int16_t MAX_16 = ((int16_t)0x7FFF);
-        static const int16_t MIN_16 = ((int16_t)0x8000);
-        static const int BIT_0      = 0;
-        static const int BIT_1      = 1;
-        static const int MASK       = 1;
-
-        static const int16_t POW2[16];
-        int16_t op_sature(int32_t lval1);
-        
-        int16_t op_abs_s(int16_t var1);                                         // Short abs,           1
-        int16_t op_add(int16_t var1, int16_t var2);                             // Short add,           1
-        int16_t op_div_s(int16_t var1, int16_t var2);                           // Short division,     18
-        int16_t op_extract_h(int32_t L_var1);                                   // Extract high,        1
-        int16_t op_extract_l(int32_t L_var1);                                   // Extract low,         1
-        int16_t op_mult(int16_t var1, int16_t var2);                            // Short mult,          1
-        int16_t op_mult_r(int16_t var1, int16_t var2);                          // Mult with round,     2
-        int16_t op_negate(int16_t var1);                                        // Short negate,        1
-        int16_t op_norm_l(int32_t L_var1);                                      // Long norm,          30
-        int16_t op_norm_s(int16_t var1);                                        // Short norm,         15
-        int16_t op_etsi_round(int32_t L_var1);                                  // Round,               1
-        int16_t op_shl(int16_t var1, int16_t var2);                             // Short shift left,    1
-        int16_t op_shr(int16_t var1, int16_t var2);                             // Short shift right,   1
-        int16_t op_sub(int16_t var1, int16_t var2);                             // Short sub,           1
-
-        int32_t op_labs(int32_t L_var1);                                        // Long abs,            3
-        int32_t op_ladd(int32_t L_var1, int32_t L_var2);                        // Long add,            2
-        int32_t op_ldeposit_h(int16_t var1);                                    // 16 bit var1 -> MSB   2
-        int32_t op_ldeposit_l(int16_t var1);                                    // 16 bit var1 -> LSB,  2
-        int32_t op_lmac(int32_t L_var3, int16_t var1, int16_t var2);            // Mac,                 1
-        int32_t op_lmac0(int32_t L_var3, int16_t var1, int16_t var2);           // no shift             1
-        int32_t op_lmsu(int32_t L_var3, int16_t var1, int16_t var2);            // Msu,                 1
-        int32_t op_lmsu0(int32_t L_var3, int16_t var1, int16_t var2);           // no shift             1
-        int32_t op_lmult(int16_t var1, int16_t var2);                           // Long mult,           1
-        int32_t op_lmult0(int16_t var1, int16_t var2);                          // Long mult no shift,  1
-        int32_t op_lnegate(int32_t L_var1);                                     // Long negate,         2
-        int32_t op_lshl(int32_t L_var1, int16_t var2);                          // Long shift left,     2
-        int32_t op_lshr(int32_t L_var1, int16_t var2);                          // Long shift right,    2
-        int32_t op_lshr_r(int32_t L_var1, int16_t var2);                        // L_shr with round,    3
-        int32_t op_lsub(int32_t L_var1, int32_t L_var2);                        // Long sub,            2
-
-        // Extended precision functions
-
-        int32_t op_div_32(int32_t L_num, int16_t hi, int16_t lo);
-        int32_t op_lcomp(int16_t hi, int16_t lo);
-        void    op_lextract(int32_t L_32, int16_t * hi, int16_t * lo);
-        int32_t op_mpy_mix(int16_t hi1, int16_t lo1, int16_t lo2);
-        int32_t op_mpy_32(int16_t hi1, int16_t lo1, int16_t hi2, int16_t lo2);
-
-        // Basic functions
-
-        int32_t op_add_sh(int32_t L_var, int16_t var1, int16_t shift);
-        int32_t op_add_sh16(int32_t L_var, int16_t var1);
-        int16_t op_bin2int(int16_t no_of_bits, int16_t * bitstream);
-        void    op_int2bin(int16_t value, int16_t no_of_bits, int16_t * bitstream);
-        int32_t op_load_sh(int16_t var1, int16_t shift);
-        int32_t op_load_sh16(int16_t var1);
-        int32_t op_norm_v(int32_t L_var3, int16_t var1, int16_t * var2);
-        int16_t op_store_hi(int32_t L_var1, int16_t var2);
-        int32_t op_sub_sh(int32_t L_var, int16_t var1, int16_t shift);
-        int32_t op_sub_sh16(int32_t L_var, int16_t var1);
+        int16_t  Branch_mask[2][3][(1 << (K - 1))];                             // [lsb][generator][arrival state] -1 if T > 0 (received data added), 0 otherwise
+        uint16_t Decisions[DECODING_DELAY];                                     // survivor lsb of every state, one bit per state, for traceback
+        int16_t  Score[(1 << (K - 1))];
+        int16_t  Msb_bit;
+        int16_t  M_1;
+
+        int16_t rcpc_acs(const int16_t * received, int16_t step, int16_t best);
+        int16_t rcpc_traceback(int16_t best, int16_t pointer, int16_t count);
+
+        // operators are inlined from etsi_operators.h
     };
 };
 
@@ -1,5 +1,12 @@
 #include "cdecoder.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 using namespace codec_cdecoder;
 
 // ARRAYS FOR INITIALIZATION OF THE CHANNEL CODING
@@ -480,6 +487,9 @@ void cdecoder::init_rcpc_decoding()
     int16_t lsb_bits = Msb_bit - 1;
 
     // Description of the Lattice : Loop on Arrival_State
+    // the predecessors of arrival state are ((arrival_state & lsb_bits) << 1) + lsb, only the
+    // transition bits are tabulated, as masks for the add-compare-select
+
     for (int16_t arrival_state = 0; arrival_state <= M_1; arrival_state++)      // Loop on the lattice states
     {
         // Computation of the MSB for the Arrival State
@@ -496,19 +506,176 @@ void cdecoder::init_rcpc_decoding()
         {
             int16_t starting_state = op_add(op_shl(msbs_starting_state, (int16_t)1), lsb);
 
-            Previous[arrival_state][lsb] = starting_state;
-
-            // Ttransition bits T1, T2, T3
+            // Ttransition bits T1, T2, T3: mask is -1 when received data is added, 0 when it is substracted
 
             int16_t involved_bits = op_add(op_shl(msb,(int16_t)1), starting_state);
 
-            T1[arrival_state][lsb] = cdecoder::combination(involved_bits, (int16_t)G1);
-            T2[arrival_state][lsb] = cdecoder::combination(involved_bits, (int16_t)G2);
-            T3[arrival_state][lsb] = cdecoder::combination(involved_bits, (int16_t)G3);
+            Branch_mask[lsb][0][arrival_state] = (cdecoder::combination(involved_bits, (int16_t)G1) > 0) ? -1 : 0;
+            Branch_mask[lsb][1][arrival_state] = (cdecoder::combination(involved_bits, (int16_t)G2) > 0) ? -1 : 0;
+            Branch_mask[lsb][2][arrival_state] = (cdecoder::combination(involved_bits, (int16_t)G3) > 0) ? -1 : 0;
         }
     } // end Loop on arrival_state
 }
 
+/**
+ * @brief Add-compare-select of one Viterbi step
+ *
+ * Scores of the 16 states are updated with the received data, the chosen predecessor lsb of
+ * every state is stored as one bit in Decisions[step] and scores are normalized by the best one.
+ *
+ * Ties are broken as ETSI reference: lsb 0 is kept on equal scores, and the best state is the
+ * first reaching the maximum in the reference loop order 8, 0, 9, 1, ... 15, 7. If every score
+ * is -32768, best state is unchanged.
+ *
+ * @return best state of this step
+ *
+ */
+
+int16_t cdecoder::rcpc_acs(const int16_t * received, int16_t step, int16_t best)
+{
+    int16_t negated[3];
+
+    for (int16_t k = 0; k < 3; k++)
+    {
+        negated[k] = op_negate(received[k]);
+    }
+
+#ifdef __SSE2__
+    const __m128i lo = _mm_loadu_si128((const __m128i *)Score);                 // states 0 to 7
+    const __m128i hi = _mm_loadu_si128((const __m128i *)(Score + 8));           // states 8 to 15
+
+    // predecessors of arrival states a and a + 8 are 2a (lsb 0) and 2a + 1 (lsb 1)
+
+    const __m128i even = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 16), 16), _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16));
+    const __m128i odd  = _mm_packs_epi32(_mm_srai_epi32(lo, 16), _mm_srai_epi32(hi, 16));
+
+    __m128i rec[3];
+    __m128i neg[3];
+
+    for (int16_t k = 0; k < 3; k++)
+    {
+        rec[k] = _mm_set1_epi16(received[k]);
+        neg[k] = _mm_set1_epi16(negated[k]);
+    }
+
+    __m128i score[2];
+    __m128i chosen[2];
+
+    for (int16_t half = 0; half < 2; half++)
+    {
+        __m128i essai0 = even;
+        __m128i essai1 = odd;
+
+        for (int16_t k = 0; k < 3; k++)                                         // saturated accumulation, same order as op_add()
+        {
+            __m128i mask0 = _mm_loadu_si128((const __m128i *)(&Branch_mask[0][k][8 * half]));
+            __m128i mask1 = _mm_loadu_si128((const __m128i *)(&Branch_mask[1][k][8 * half]));
+
+            essai0 = _mm_adds_epi16(essai0, _mm_or_si128(_mm_and_si128(mask0, rec[k]), _mm_andnot_si128(mask0, neg[k])));
+            essai1 = _mm_adds_epi16(essai1, _mm_or_si128(_mm_and_si128(mask1, rec[k]), _mm_andnot_si128(mask1, neg[k])));
+        }
+
+        chosen[half] = _mm_cmpgt_epi16(essai1, essai0);                         // lsb 1 only if strictly better
+        score[half]  = _mm_max_epi16(essai0, essai1);
+    }
+
+    Decisions[step] = (uint16_t)_mm_movemask_epi8(_mm_packs_epi16(chosen[0], chosen[1]));
+
+    // maximum score
+
+    __m128i vmax = _mm_max_epi16(score[0], score[1]);
+    vmax = _mm_max_epi16(vmax, _mm_srli_si128(vmax, 8));
+    vmax = _mm_max_epi16(vmax, _mm_srli_si128(vmax, 4));
+    vmax = _mm_max_epi16(vmax, _mm_srli_si128(vmax, 2));
+
+    int16_t maximum = (int16_t)_mm_cvtsi128_si32(vmax);
+    vmax = _mm_set1_epi16(maximum);
+
+    if (maximum > -32768)
+    {
+        // interleave states in reference order 8, 0, 9, 1... and take the first reaching maximum
+
+        __m128i eq_lo = _mm_cmpeq_epi16(score[0], vmax);
+        __m128i eq_hi = _mm_cmpeq_epi16(score[1], vmax);
+        int mask = _mm_movemask_epi8(_mm_packs_epi16(_mm_unpacklo_epi16(eq_hi, eq_lo), _mm_unpackhi_epi16(eq_hi, eq_lo)));
+        int rank = __builtin_ctz((unsigned)mask);
+
+        best = (int16_t)((rank & 1) ? (rank >> 1) : (8 + (rank >> 1)));
+    }
+
+    // To avoid overflow, substraction of the highest score
+
+    _mm_storeu_si128((__m128i *)Score,       _mm_subs_epi16(score[0], vmax));
+    _mm_storeu_si128((__m128i *)(Score + 8), _mm_subs_epi16(score[1], vmax));
+#else
+    int16_t score[1 << (K - 1)];
+    uint16_t decisions = 0;
+    int16_t maximum = -32768;
+
+    for (int16_t state = 0; state <= M_1; state++)
+    {
+        int16_t lsb_bits = Msb_bit - 1;
+        int16_t essai0 = Score[(state & lsb_bits) << 1];
+        int16_t essai1 = Score[((state & lsb_bits) << 1) + 1];
+
+        for (int16_t k = 0; k < 3; k++)
+        {
+            essai0 = op_add(essai0, Branch_mask[0][k][state] ? received[k] : negated[k]);
+            essai1 = op_add(essai1, Branch_mask[1][k][state] ? received[k] : negated[k]);
+        }
+
+        if (essai1 > essai0)
+        {
+            decisions |= (uint16_t)(1 << state);
+        }
+        score[state] = (essai1 > essai0) ? essai1 : essai0;
+    }
+
+    Decisions[step] = decisions;
+
+    for (int16_t rank = 0; rank <= M_1; rank++)                                 // reference order 8, 0, 9, 1...
+    {
+        int16_t state = (rank & 1) ? (rank >> 1) : (Msb_bit + (rank >> 1));
+
+        if (score[state] > maximum)
+        {
+            best    = state;
+            maximum = score[state];
+        }
+    }
+
+    // To avoid overflow, substraction of the highest score
+
+    for (int16_t j = 0; j <= M_1; j++)
+        Score[j] = op_sub(score[j], maximum);
+#endif
+
+    return best;
+}
+
+/**
+ * @brief Traceback from state best at step pointer, going backward of count steps
+ *
+ * @return state reached
+ *
+ */
+
+int16_t cdecoder::rcpc_traceback(int16_t best, int16_t pointer, int16_t count)
+{
+    int16_t lsb_bits = Msb_bit - 1;
+
+    for (int16_t j = 0; j < count; j++)
+    {
+        best = (int16_t)(((best & lsb_bits) << 1) | ((Decisions[pointer] >> best) & 1));
+
+        pointer--;
+        if (pointer < 0)
+            pointer = DECODING_DELAY - 1;
+    }
+
+    return best;
+}
+
 
 /**************************************************************************
  *
@@ -549,6 +716,16 @@ void cdecoder::init_rcpc_decoding()
  *
  **************************************************************************/
 
+/**
+ * @brief Received soft bit after symetrization: -(2 * data - 1)
+ *
+ */
+
+static inline int16_t symmetrize(int16_t data)
+{
+    return op_negate(op_sub(op_shl(data, (int16_t)1), (int16_t)1));
+}
+
 void cdecoder::rcpc_decoding(int16_t stolen_frame_flag, int16_t * input_frame, int16_t * output_frame)
 {
     int16_t Size_Class0;
@@ -557,6 +734,7 @@ void cdecoder::rcpc_decoding(int16_t stolen_frame_flag, int16_t * input_frame, i
     int16_t Size_Coded_Class1;
     int16_t Size_Coded_Class2;
     int16_t Size_Error_Control;
+    const int16_t * Puncturing_Class2;
 
     if (!stolen_frame_flag)
     {
@@ -566,6 +744,7 @@ void cdecoder::rcpc_decoding(int16_t stolen_frame_flag, int16_t * input_frame, i
         Size_Coded_Class1  = N1_2_CODED;
         Size_Coded_Class2  = N2_2_CODED;
         Size_Error_Control = SIZE_CRC;
+        Puncturing_Class2  = A2;
     }
     else
     {
@@ -575,6 +754,7 @@ void cdecoder::rcpc_decoding(int16_t stolen_frame_flag, int16_t * input_frame, i
         Size_Coded_Class1  = N1_CODED;
         Size_Coded_Class2  = N2_CODED;
         Size_Error_Control = FS_SIZE_CRC;
+        Puncturing_Class2  = FS_A2;
     }
 
     // Recopy of Class 0 (unprotected)
@@ -598,10 +778,11 @@ void cdecoder::rcpc_decoding(int16_t stolen_frame_flag, int16_t * input_frame, i
 
     // Decoding of Class 1
 
+    const int16_t * coded = input_frame + Size_Class0;
+    int16_t Received[3];
+
     // Init of Index for Puncturing: 0 <= Index_puncturing < PERIOD_PCT
     int16_t Index_puncturing = 0;
-    int16_t Chosen_score;
-    int16_t Chosen_lsb;
     int16_t Best = 0;                                                           // LT fixed uninitialized state
 
     for (int16_t index = 0; index < Size_Coded_Class1;)                         // loop on coded class 1
@@ -609,346 +790,357 @@ void cdecoder::rcpc_decoding(int16_t stolen_frame_flag, int16_t * input_frame, i
         // loading of array Received with the received data after symetrization
         // if Punctured data Received[data] = 0 else Received[data] = -(2 * data - 1)
 
-        Received[0] = op_negate(op_sub(op_shl(input_frame[Size_Class0 + index], (int16_t)1), (int16_t)1));
-        index++;
+        Received[0] = symmetrize(coded[index++]);
+        Received[1] = (A1[Index_puncturing + PERIOD_PCT] != 0) ? symmetrize(coded[index++]) : (int16_t)0;
+        Received[2] = 0;
 
-        if ((A1[Index_puncturing + PERIOD_PCT]) != 0)
-        {
-            Received[1] = op_negate(op_sub(op_shl(input_frame[Size_Class0 + index], (int16_t)1), (int16_t)1));
-            index++;
-        }
-        else
+        Index_puncturing++;
+        if (Index_puncturing == PERIOD_PCT)
+            Index_puncturing = 0;
+
+        Step++;
+        Step_bis++;
+        if (Step == DECODING_DELAY) Step = 0;
+
+        // Computation of the best predecessor of each state and determination of the best state
+
+        Best = rcpc_acs(Received, Step, Best);
+
+        // Check that the decoder is ready
+        if (Step == DECODING_DELAY - 1) Decoder_ready = 1;
+
+        if (Decoder_ready)
         {
-            Received[1] = 0;
+            // Normal procedure : decoding of one bit at a time
+            Best = rcpc_traceback(Best, Step, DECODING_DELAY - 1);
+            output_frame[Size_Class0 + Nber_decoded_bits] = (int16_t)(Best >> (K - 2));  // decoded bit is the state MSB
+            Nber_decoded_bits++;
         }
+    } // End Loop on class 1
 
+    // --- end decoding class 1 ---
 
-        Received[2] = 0;
+    // --- start decoding of Class 2 ---
+
+    coded = input_frame + Size_Class0 + Size_Coded_Class1;
+
+    // Init of Index for Puncturing: 0 <= Index_puncturing < PERIOD_PCT
+    Index_puncturing = 0;
+
+    for (int16_t index = 0; index < Size_Coded_Class2;)                         // Loop on coded class 2
+    {
+        // Loading of array Received with the received data after symetrization
+        // If Punctured data Received[data] = 0 else Received[data] = -(2*data - 1)
+
+        Received[0] = symmetrize(coded[index++]);
+        Received[1] = symmetrize(coded[index++]);
+        Received[2] = (Puncturing_Class2[Index_puncturing + 2 * PERIOD_PCT] != 0) ? symmetrize(coded[index++]) : (int16_t)0;
 
         Index_puncturing++;
-        if (op_sub(Index_puncturing,(int16_t)PERIOD_PCT) == 0)
+        if (Index_puncturing == PERIOD_PCT)
             Index_puncturing = 0;
 
-        // Determination of the state of highest score in the current Step
-
         Step++;
         Step_bis++;
-
-        if (op_sub(Step,(int16_t)DECODING_DELAY) == 0) Step = 0;
+        if (Step == DECODING_DELAY) Step = 0;
 
         // Computation of the best predecessor of each state and determination of the best state
 
-        int16_t Maximum = -32768;
-        for (int16_t j = 0; j <= M_1; j++)
-            Ex_score[j] = Score[j];
+        Best = rcpc_acs(Received, Step, Best);
 
-        // Loop on the states
-        for (int16_t arrival_state_sym = ((M_1 + 1) / 2); arrival_state_sym <= M_1; arrival_state_sym++)
+        // NOTE: For the very last bits of the frame, we make a block decoding :
+        //       DECODING_DELAY bits are decoded at a time
+
+        if (Step_bis == Size_Class1 + Size_Class2 + Size_Error_Control + (K - 1) - 1)
         {
-            for (int16_t lsb = 0; lsb <= 1; lsb++)                                      // loop on LSB
+            // At the end, we use the fact that the last state of the encoder is zero
+            Best = 0;
+            int16_t Pointer_bis = Step_bis;
+            int16_t Pointer = Step;
+
+            // Block decoding
+            for (int16_t j = 1; j <= DECODING_DELAY; j++)
             {
-                // For every state : Estimation of the best predecessor between the one of LSB=0 and the one of LSB=1
+                output_frame[Size_Class0 + Pointer_bis] = (int16_t)(Best >> (K - 2));
+                Best = rcpc_traceback(Best, Pointer, 1);
+                Pointer_bis--;
+                Pointer--;
+                if (Pointer < 0)
+                    Pointer = DECODING_DELAY - 1;
+            }
 
-                int16_t Essai = Ex_score[Previous[arrival_state_sym][lsb]];
+            return;
+        } // End block decoding
+        else
+        {
+            // Normal procedure : decoding of one bit at a time
+            Best = rcpc_traceback(Best, Step, DECODING_DELAY - 1);
+            output_frame[Size_Class0 + Nber_decoded_bits] = (int16_t)(Best >> (K - 2));
+            Nber_decoded_bits++;
+        }
+    } // End Loop on class 2
 
-                // Accumulation of the transition due to the received data
-                Essai = op_add(Essai, (int16_t)((T1[arrival_state_sym][lsb] > 0) ? Received[0] : op_negate(Received[0])));
-                Essai = op_add(Essai, (int16_t)((T2[arrival_state_sym][lsb] > 0) ? Received[1] : op_negate(Received[1])));
-                Essai = op_add(Essai, (int16_t)((T3[arrival_state_sym][lsb] > 0) ? Received[2] : op_negate(Received[2])));
+    // --- End Decoding class 2 ---
+}
 
-                // Search of the best predecessor (predecessor with the highest score)
+#ifdef __SSE2__
 
-                if (lsb == 0)
-                {
-                    Chosen_score = Essai;
-                    Chosen_lsb = lsb;
-                }
-                else
-                {
-                    if (op_sub(Essai,Chosen_score) > 0)
-                    {
-                        Chosen_score = Essai;
-                        Chosen_lsb = lsb;
-                    }
-                }
-            } // Loop on lsb
+/**
+ * @brief Traceback of every lane of rcpc_decoding_batch() from state best[lane] at step pointer,
+ *        going backward of count steps. Lanes are interleaved so the independent tracebacks overlap.
+ *
+ */
 
-            // The score of the current state is the best among the two (lsb=0,1)
-            Score[arrival_state_sym] = Chosen_score;
-            Best_previous[arrival_state_sym][Step] = Previous[arrival_state_sym][Chosen_lsb];
+typedef void (*traceback_lanes_t)(const uint16_t (*decisions)[cdecoder::BATCH_LANES], int16_t * best, int16_t pointer, int16_t delay, int16_t count, int16_t lsb_bits);
 
-            // Search of the best arrival state
-            if (op_sub(Chosen_score, Maximum) > 0)
-            {
-                Best    = arrival_state_sym;
-                Maximum = Chosen_score;
-            }
+static void traceback_lanes_scalar(const uint16_t (*decisions)[cdecoder::BATCH_LANES], int16_t * best, int16_t pointer, int16_t delay, int16_t count, int16_t lsb_bits)
+{
+    for (int16_t j = 0; j < count; j++)
+    {
+        for (int16_t lane = 0; lane < cdecoder::BATCH_LANES; lane++)
+        {
+            best[lane] = (int16_t)(((best[lane] & lsb_bits) << 1) | ((decisions[pointer][lane] >> best[lane]) & 1));
+        }
 
-            int16_t Arrival_state = op_sub(arrival_state_sym, (int16_t)((M_1 + 1) / 2));
+        pointer--;
+        if (pointer < 0)
+            pointer = delay - 1;
+    }
+}
 
-            for (int16_t lsb = 0; lsb <= 1; lsb++)
-            {
-                // For every state : Estimation of the best predecessor between the one of LSB=0 and the one of LSB=1
-                int16_t Essai = Ex_score[Previous[Arrival_state][lsb]];
+#if defined(__x86_64__)
+__attribute__((target("avx2")))
+static void traceback_lanes_avx2(const uint16_t (*decisions)[cdecoder::BATCH_LANES], int16_t * best, int16_t pointer, int16_t delay, int16_t count, int16_t lsb_bits)
+{
+    // one 32 bits lane per stream, the survivor bit is read with a per lane variable shift
 
-                // Accumulation of the transition due to the received data
-                Essai = op_add(Essai,(int16_t)((T1[Arrival_state][lsb] > 0) ? Received[0] : op_negate(Received[0])));
-                Essai = op_add(Essai,(int16_t)((T2[Arrival_state][lsb] > 0) ? Received[1] : op_negate(Received[1])));
-                Essai = op_add(Essai,(int16_t)((T3[Arrival_state][lsb] > 0) ? Received[2] : op_negate(Received[2])));
+    __m256i state = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)best));
+    const __m256i mask = _mm256_set1_epi32(lsb_bits);
+    const __m256i one  = _mm256_set1_epi32(1);
 
-                // Search of the best predecessor (predecessor with the highest score)
-                if (lsb == 0)
-                {
-                    Chosen_score = Essai;
-                    Chosen_lsb = lsb;
-                }
-                else
-                {
-                    if (op_sub(Essai, Chosen_score) > 0)
-                    {
-                        Chosen_score = Essai;
-                        Chosen_lsb = lsb;
-                    }
-                }
-            }
+    for (int16_t j = 0; j < count; j++)
+    {
+        __m256i dec = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)decisions[pointer]));
+        __m256i bit = _mm256_and_si256(_mm256_srlv_epi32(dec, state), one);
 
-            // The score of the current state is the best among the two (Lsb=0,1)
-            Score[Arrival_state] = Chosen_score;
-            Best_previous[Arrival_state][Step] = Previous[Arrival_state][Chosen_lsb];
+        state = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(state, mask), 1), bit);
 
-            // Search of the best arrival state
-            if(op_sub(Chosen_score, Maximum) > 0)
-            {
-                Best = Arrival_state;
-                Maximum = Chosen_score;
-            }
-        } // Loop on the states
+        pointer--;
+        if (pointer < 0)
+            pointer = delay - 1;
+    }
 
+    __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(state), _mm256_extracti128_si256(state, 1));
+    _mm_storeu_si128((__m128i *)best, packed);
+}
+#endif
 
-        // To avoid overflow, substraction of the highest score
-        for (int16_t j = 0; j <= M_1; j++)
-            Score[j] = op_sub(Score[j],Maximum);
+static traceback_lanes_t traceback_lanes_select()
+{
+#if defined(__x86_64__)
+    __builtin_cpu_init();
 
-        // Check that the decoder is ready
-        if (op_sub(Step,(int16_t)(DECODING_DELAY - 1)) == 0) Decoder_ready = 1;
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return traceback_lanes_avx2;
+    }
+#endif
 
-        if (op_sub(Decoder_ready, (int16_t)1) == 0)
-        {
-            // Normal procedure : decoding of one bit at a time
-            int16_t Pointer = Step;                                             // rank of the bit being decoded : 0 <= Step_bis < Nber_decoded_bits
+    return traceback_lanes_scalar;
+}
 
-            for (int16_t j = 1; j <= DECODING_DELAY - 1; j++)
-            {
-                Best = Best_previous[Best][Pointer];
-                Pointer--;
-                if (Pointer < 0)
-                    Pointer = DECODING_DELAY - 1;
-            } // End Decoding of one bit
-            int32_t L_temp = op_ldeposit_l(Best);
-            L_temp = op_lshl(L_temp, (int16_t)13);
-            output_frame[Size_Class0 + Nber_decoded_bits] = op_extract_h(L_temp);
-            Nber_decoded_bits++;
+#endif /* __SSE2__ */
 
-            //End Normal Decoding procedure
+/**
+ * @brief RCPC decoding of several independent frames at once (standard mode only)
+ *
+ * Frames of up to BATCH_LANES streams are decoded together: each SIMD lane holds one stream
+ * and the add-compare-select runs on every state for all streams at once. Result is identical
+ * to calling rcpc_decoding() on each frame. The decoder must have been initialized with
+ * init_rcpc_decoding(), the lattice tables are shared by all streams.
+ *
+ * @param[in]  count          number of frames, 1 to BATCH_LANES
+ * @param[in]  input_frames   frames to be decoded (432 * 16 bit-samples each)
+ * @param[out] output_frames  decoded frames (286 * 16 bit-samples each)
+ *
+ */
 
-        } // End if Decoder_ready
-    } // End Loop on class 1
+void cdecoder::rcpc_decoding_batch(int16_t count, int16_t * const input_frames[], int16_t * const output_frames[])
+{
+#ifdef __SSE2__
+    static const traceback_lanes_t traceback_lanes = traceback_lanes_select();
 
-    // --- end decoding class 1 ---
+    const int16_t M = (int16_t)(M_1 + 1);
+    const int16_t lsb_bits = Msb_bit - 1;
 
-    // --- start decoding of Class 2 ---
+    // Recopy of Class 0 (unprotected)
+    for (int16_t lane = 0; lane < count; lane++)
+        for (int16_t j = 0; j < N0_2; j++)
+            output_frames[lane][j] = input_frames[lane][j];
 
-    // Init of Index for Puncturing: 0 <= Index_puncturing < PERIOD_PCT
-    Index_puncturing = 0;
+    // Init of the scores, starting State 0 is favoured
 
-    for (int16_t index = 0; index < Size_Coded_Class2;)                         // Loop on coded class 2
-    {
-        // Loading of array Received with the received data after symetrization
-        // If Punctured data Received[data] = 0 else Received[data] = -(2*data - 1)
+    __m128i score[1 << (K - 1)];
+    score[0] = _mm_setzero_si128();
+    for (int16_t j = 1; j < M; j++)
+        score[j] = _mm_set1_epi16(-16000);
 
-        Received[0] = op_negate(op_sub(op_shl(input_frame[Size_Class0 + Size_Coded_Class1 + index], (int16_t)1), (int16_t)1));
-        index++;
+    __m128i state_value[1 << (K - 1)];
+    for (int16_t j = 0; j < M; j++)
+        state_value[j] = _mm_set1_epi16(j);
 
-        Received[1] = op_negate(op_sub(op_shl(input_frame[Size_Class0 + Size_Coded_Class1 + index], (int16_t)1), (int16_t)1));
-        index++;
+    __m128i state_bit[1 << (K - 1)];
+    for (int16_t j = 0; j < M; j++)
+        state_bit[j] = _mm_set1_epi16((int16_t)(1 << j));
 
-        if (!stolen_frame_flag)
+    uint16_t decisions[DECODING_DELAY][BATCH_LANES];                            // survivor lsb of every state, per lane
+    int16_t  best_lane[BATCH_LANES];
+    int16_t  soft[3][BATCH_LANES] = {{0}};
+    __m128i  best = _mm_setzero_si128();                                        // LT fixed uninitialized state
+
+    int16_t Nber_decoded_bits = 0;
+    int16_t Step          = -1;
+    int16_t Step_bis      = -1;
+    int16_t Decoder_ready =  0;
+    int16_t Index_puncturing = 0;
+    int16_t index = 0;
+
+    const int16_t Last_step = N1_2 + N2_2 + SIZE_CRC + (K - 1) - 1;
+
+    for (Step_bis = 0; Step_bis <= Last_step; Step_bis++)                       // class 1 then class 2, one step per decoded bit
+    {
+        // loading of received data, puncturing pattern is the same for every lane
+
+        bool class1 = (Step_bis < N1_2);
+
+        if (Step_bis == N1_2)
         {
-            if ((A2[Index_puncturing + 2 * PERIOD_PCT]) != 0)
-            {
-                Received[2] = op_negate(op_sub(op_shl(input_frame[Size_Class0 + Size_Coded_Class1 + index], (int16_t)1), (int16_t)1));
-                index++;
-            }
-            else
-                Received[2] = 0;
+            Index_puncturing = 0;                                               // start decoding of Class 2
         }
-        else
+
+        bool present[3];
+
+        present[0] = true;
+        present[1] = class1 ? (A1[Index_puncturing + PERIOD_PCT] != 0) : true;
+        present[2] = class1 ? false : (A2[Index_puncturing + 2 * PERIOD_PCT] != 0);
+
+        Index_puncturing++;
+        if (Index_puncturing == PERIOD_PCT)
+            Index_puncturing = 0;
+
+        __m128i rec[3];
+        __m128i neg[3];
+
+        for (int16_t k = 0; k < 3; k++)
         {
-            if ((FS_A2[Index_puncturing + 2 * PERIOD_PCT]) != 0)
+            if (present[k])
             {
-                Received[2] = op_negate(op_sub(op_shl(input_frame[Size_Class0 + Size_Coded_Class1 + index], (int16_t)1), (int16_t)1));
+                for (int16_t lane = 0; lane < count; lane++)
+                    soft[k][lane] = input_frames[lane][N0_2 + index];
                 index++;
+
+                // symetrization -(2 * data - 1) with saturations of op_shl(), op_sub() and op_negate()
+
+                __m128i data = _mm_loadu_si128((const __m128i *)soft[k]);
+                data   = _mm_subs_epi16(_mm_adds_epi16(data, data), _mm_set1_epi16(1));
+                rec[k] = _mm_subs_epi16(_mm_setzero_si128(), data);
+                neg[k] = _mm_subs_epi16(_mm_setzero_si128(), rec[k]);
             }
             else
             {
-                Received[2] = 0;
+                rec[k] = _mm_setzero_si128();
+                neg[k] = _mm_setzero_si128();
             }
         }
 
-        Index_puncturing++;
-        if (op_sub(Index_puncturing, (int16_t)PERIOD_PCT) == 0)
-            Index_puncturing = 0;
-
-        // Determination of the state of highest score in the current Step
-
         Step++;
-        Step_bis++;
-        if (op_sub(Step,(int16_t)DECODING_DELAY) == 0) Step = 0;
+        if (Step == DECODING_DELAY) Step = 0;
 
-        // Computation of the best predecessor of each state and determination of the best state
+        // add-compare-select on every state for all lanes
 
-        int16_t Maximum = -32768;
-        for (int16_t j = 0; j <= M_1; j++)
-            Ex_score[j] = Score[j];
+        __m128i new_score[1 << (K - 1)];
+        __m128i decision = _mm_setzero_si128();
 
-        // Loop on the states
-        for (int16_t Arrival_state_sym = ((M_1 + 1)/2); Arrival_state_sym <= M_1; Arrival_state_sym++)
+        for (int16_t state = 0; state < M; state++)
         {
+            __m128i essai0 = score[(state & lsb_bits) << 1];
+            __m128i essai1 = score[((state & lsb_bits) << 1) + 1];
 
-            // Arrival_state_sym
-            for (int16_t Lsb = 0; Lsb <= 1; Lsb++)                              // Loop on LSB
+            for (int16_t k = 0; k < 3; k++)
             {
-                // For every state : Estimation of the best predecessor between the one of LSB=0 and the one of LSB=1
-                int16_t Essai = Ex_score[Previous[Arrival_state_sym][Lsb]];
-
-                // Accumulation of the transition due to the received data
-                Essai = op_add(Essai, (int16_t)((T1[Arrival_state_sym][Lsb] > 0) ? Received[0] : op_negate(Received[0])));
-                Essai = op_add(Essai, (int16_t)((T2[Arrival_state_sym][Lsb] > 0) ? Received[1] : op_negate(Received[1])));
-                Essai = op_add(Essai, (int16_t)((T3[Arrival_state_sym][Lsb] > 0) ? Received[2] : op_negate(Received[2])));
-
-                // Search of the best predecessor (predecessor with the highest score)
-                if (Lsb == 0)
-                {
-                    Chosen_score = Essai;
-                    Chosen_lsb = Lsb;
-                }
-                else
-                {
-                    if (op_sub(Essai, Chosen_score) > 0)
-                    {
-                        Chosen_score = Essai;
-                        Chosen_lsb = Lsb;
-                    }
-                }
-            } // Loop on Lsb
-
-            // The score of the current state is the best among the two (Lsb=0,1)
-            Score[Arrival_state_sym] = Chosen_score;
-            Best_previous[Arrival_state_sym][Step] = Previous[Arrival_state_sym][Chosen_lsb];
-
-            if (op_sub(Chosen_score, Maximum) > 0)
-            {
-                Best = Arrival_state_sym;
-                Maximum = Chosen_score;
+                essai0 = _mm_adds_epi16(essai0, Branch_mask[0][k][state] ? rec[k] : neg[k]);
+                essai1 = _mm_adds_epi16(essai1, Branch_mask[1][k][state] ? rec[k] : neg[k]);
             }
 
-            int16_t Arrival_state = op_sub(Arrival_state_sym,(int16_t)((M_1 + 1) / 2));
+            __m128i chosen = _mm_cmpgt_epi16(essai1, essai0);
+            decision = _mm_or_si128(decision, _mm_and_si128(chosen, state_bit[state]));
+            new_score[state] = _mm_max_epi16(essai0, essai1);
+        }
 
-            for (int16_t Lsb = 0; Lsb <= 1; Lsb++)
-            {
-                // For every state : Estimation of the best predecessor between the one of LSB=0 and the one of LSB=1
-                int16_t Essai = Ex_score[Previous[Arrival_state][Lsb]];
+        _mm_storeu_si128((__m128i *)decisions[Step], decision);
 
-                // Accumulation of the transition due to the received data
-                Essai = op_add(Essai, (int16_t)((T1[Arrival_state][Lsb] > 0) ? Received[0] : op_negate(Received[0])));
-                Essai = op_add(Essai, (int16_t)((T2[Arrival_state][Lsb] > 0) ? Received[1] : op_negate(Received[1])));
-                Essai = op_add(Essai, (int16_t)((T3[Arrival_state][Lsb] > 0) ? Received[2] : op_negate(Received[2])));
+        // best state in reference order 8, 0, 9, 1... strictly greater only
 
-                // Search of the best predecessor (predecessor with the highest score)
-                if (Lsb == 0)
-                {
-                    Chosen_score = Essai;
-                    Chosen_lsb = Lsb;
-                }
-                else
-                {
-                    if (op_sub(Essai, Chosen_score) > 0)
-                    {
-                        Chosen_score = Essai;
-                        Chosen_lsb = Lsb;
-                    }
-                }
-
-            }
+        __m128i maximum = _mm_set1_epi16(-32768);
 
-            // The score of the current state is the best among the two (Lsb=0,1)
-            Score[Arrival_state] = Chosen_score;
-            Best_previous[Arrival_state][Step] = Previous[Arrival_state][Chosen_lsb];
+        for (int16_t rank = 0; rank < M; rank++)
+        {
+            int16_t state = (rank & 1) ? (rank >> 1) : (Msb_bit + (rank >> 1));
+            __m128i gt = _mm_cmpgt_epi16(new_score[state], maximum);
 
-            // Search of the best arrival state
-            if (op_sub(Chosen_score, Maximum) > 0)
-            {
-                Best = Arrival_state;
-                Maximum = Chosen_score;
-            }
-        } // Loop on the states
+            best    = _mm_or_si128(_mm_and_si128(gt, state_value[state]), _mm_andnot_si128(gt, best));
+            maximum = _mm_max_epi16(maximum, new_score[state]);
+        }
 
         // To avoid overflow, substraction of the highest score
-        for (int16_t j = 0; j <= M_1; j++)
-            Score[j] = op_sub(Score[j], Maximum);
 
-        // Check that the decoder is ready
+        for (int16_t state = 0; state < M; state++)
+            score[state] = _mm_subs_epi16(new_score[state], maximum);
 
-        // NOTE: For the very last bits of the frame, we make a block decoding :
-        //       DECODING_DELAY bits are decoded at a time
+        _mm_storeu_si128((__m128i *)best_lane, best);
 
-        if (op_sub(Step_bis,(int16_t)(Size_Class1 + Size_Class2 + Size_Error_Control + (K - 1) - 1)) == 0)
-        {
+        if (Step == DECODING_DELAY - 1) Decoder_ready = 1;
 
-            // At the end, we use the fact that the last state of the encoder is zero
-            Best = 0;
-            int16_t Pointer_bis = Step_bis;
-            int16_t Pointer = Step;
+        if (Step_bis == Last_step)
+        {
+            // Block decoding, the last state of the encoder is zero
 
-            // Block decoding
-            for (int16_t j = 1; j <= DECODING_DELAY; j++)
+            for (int16_t lane = 0; lane < count; lane++)
             {
-                int32_t L_temp = op_ldeposit_l(Best);
-                L_temp = op_lshl(L_temp,(int16_t)13);
-                output_frame[Size_Class0 + Pointer_bis] = op_extract_h(L_temp);
-                Best = Best_previous[Best][Pointer];
-                Nber_decoded_bits++;
-                Pointer_bis--;
-                Pointer--;
-                if (Pointer < 0)
-                    Pointer = DECODING_DELAY - 1;
-            }
-            Nber_decoded_bits = op_sub(Nber_decoded_bits,(int16_t)(K - 1));
+                int16_t Best = 0;
+                int16_t Pointer = Step;
 
-            return;
-        } // End block decoding
-        else
+                for (int16_t j = 0; j < DECODING_DELAY; j++)
+                {
+                    output_frames[lane][N0_2 + Step_bis - j] = (int16_t)(Best >> (K - 2));
+                    Best = (int16_t)(((Best & lsb_bits) << 1) | ((decisions[Pointer][lane] >> Best) & 1));
+                    Pointer--;
+                    if (Pointer < 0)
+                        Pointer = DECODING_DELAY - 1;
+                }
+            }
+        }
+        else if (Decoder_ready)
         {
             // Normal procedure : decoding of one bit at a time
-            int16_t Pointer = Step;
 
-            for (int16_t j = 1; j <= DECODING_DELAY - 1; j++)
+            traceback_lanes(decisions, best_lane, Step, DECODING_DELAY, DECODING_DELAY - 1, lsb_bits);
+
+            for (int16_t lane = 0; lane < count; lane++)
             {
-                Best = Best_previous[Best][Pointer];
-                Pointer--;
-                if (Pointer < 0)
-                    Pointer = DECODING_DELAY - 1;
+                output_frames[lane][N0_2 + Nber_decoded_bits] = (int16_t)(best_lane[lane] >> (K - 2));
             }
-            int32_t L_temp = op_ldeposit_l(Best);
-            L_temp = op_lshl(L_temp,(int16_t)13);
-            output_frame[Size_Class0 + Nber_decoded_bits] = op_extract_h(L_temp);
+
+            best = _mm_loadu_si128((const __m128i *)best_lane);                 // traceback result is the next step initial best
             Nber_decoded_bits++;
         }
-        // End Normal Decoding procedure
-        // End if Decoder_ready
-    } // End Loop on class 2
-
-    // --- End Decoding class 2 ---
+    }
+#else
+    for (int16_t lane = 0; lane < count; lane++)
+    {
+        rcpc_decoding(0, input_frames[lane], output_frames[lane]);
+    }
+#endif
 }
 
 /**************************************************************************
@@ -0,0 +1,415 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+#include "sdecoder.h"
+#include "cdecoder.h"
+#include "audio_decoder.h"
+
+/*
+ * Micro-benchmark and regression harness of the recorder speech codec
+ *
+ * USAGE:
+ *   ./codec_bench [-n <repeat>] <capture.out> [<reference.raw>]
+ *
+ * The capture is a sequence of 690 samples TCH frames as written by the recorder in out/
+ * folder (or by codec/ccoder). Frames are replayed <repeat> times (default 10) through:
+ *
+ *   - staged    : audio_decoder members called stage by stage to time desinterleave,
+ *                 channel_decoding and process_speech_frame
+ *   - frame     : audio_decoder::process_frame(), as used by the recorder for a single stream
+ *   - batch     : audio_decoder::process_batch() with audio_batch_t::MAX_FRAMES streams
+ *                 replaying the capture at the same time
+ *
+ * Each path output must be bit-exact with the reference .raw file (codec/cdecoder then
+ * codec/sdecoder, or codec/bdecoder). Without reference, the staged output is used as
+ * reference for the other paths and a checksum is printed to compare runs.
+ *
+ */
+
+static const int FRAME_LEN = 690;                                               // input frame length in int16_t
+static const int RAW_LEN   = 480;                                               // output length in int16_t (2 speech frames)
+
+/**
+ * @brief Monotonic time [ns]
+ *
+ */
+
+static uint64_t now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Read a whole file of int16_t samples
+ *
+ */
+
+static bool read_file(const char * file_name, std::vector<int16_t> & data)
+{
+    FILE * file = fopen(file_name, "rb");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "can't open %s\n", file_name);
+        return false;
+    }
+
+    int16_t buf[4096];
+    std::size_t count;
+
+    while ((count = fread(buf, sizeof(int16_t), sizeof(buf) / sizeof(buf[0]), file)) > 0)
+    {
+        data.insert(data.end(), buf, buf + count);
+    }
+
+    fclose(file);
+
+    return true;
+}
+
+/**
+ * @brief Count output samples different from the reference, reference length must match
+ *
+ */
+
+static uint64_t compare(const std::vector<int16_t> & output, const std::vector<int16_t> & reference)
+{
+    uint64_t errors = 0;
+    std::size_t len = std::min(output.size(), reference.size());
+
+    for (std::size_t idx = 0; idx < len; idx++)
+    {
+        if (output[idx] != reference[idx]) errors++;
+    }
+
+    errors += (output.size() > len) ? output.size() - len : reference.size() - len;
+
+    return errors;
+}
+
+/**
+ * @brief FNV-1a checksum of output samples
+ *
+ */
+
+static uint32_t checksum(const std::vector<int16_t> & output)
+{
+    uint32_t hash = 2166136261u;
+
+    for (std::size_t idx = 0; idx < output.size(); idx++)
+    {
+        hash = (hash ^ (uint16_t)output[idx]) * 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Decode the capture stage by stage and accumulate each stage duration [ns]
+ *
+ */
+
+static void run_staged(const int16_t * frames, int count, std::vector<int16_t> & output, uint64_t stage_ns[3])
+{
+    audio_decoder * dec = new audio_decoder();
+    dec->init();
+
+    int16_t interleaved_coded_array[432];
+    int16_t coded_array[432];
+    int16_t reordered_array[286];
+    int16_t speech_frame[2][138];
+    int16_t raw_output[RAW_LEN];
+
+    for (int idx = 0; idx < count; idx++)
+    {
+        uint64_t t0 = now_ns();
+
+        if (!dec->cdec->process_frame(frames + idx * FRAME_LEN, interleaved_coded_array))
+        {
+            continue;                                                           // invalid frame, skipped as by the recorder
+        }
+
+        dec->cdec->desinterleaving_speech(interleaved_coded_array, coded_array);
+
+        uint64_t t1 = now_ns();
+
+        dec->bfi2 = dec->cdec->channel_decoding(dec->g_first_pass_flag, 0, coded_array, reordered_array);
+        dec->bfi1 = dec->bfi2;
+        dec->g_first_pass_flag = 0;
+
+        uint64_t t2 = now_ns();
+
+        speech_frame[0][0] = dec->bfi1;
+        speech_frame[1][0] = dec->bfi2;
+        memcpy(&speech_frame[0][1], reordered_array,       137 * sizeof(int16_t));
+        memcpy(&speech_frame[1][1], reordered_array + 137, 137 * sizeof(int16_t));
+
+        dec->sdec->process_speech_frame(speech_frame[0], raw_output);
+        dec->sdec->process_speech_frame(speech_frame[1], raw_output + 240);
+
+        uint64_t t3 = now_ns();
+
+        stage_ns[0] += t1 - t0;
+        stage_ns[1] += t2 - t1;
+        stage_ns[2] += t3 - t2;
+
+        output.insert(output.end(), raw_output, raw_output + RAW_LEN);
+    }
+
+    delete dec;
+}
+
+/**
+ * @brief Decode the capture with audio_decoder::process_frame()
+ *
+ */
+
+static void run_frame(const int16_t * frames, int count, std::vector<int16_t> & output)
+{
+    audio_decoder * dec = new audio_decoder();
+    dec->init();
+
+    int16_t raw_output[RAW_LEN];
+
+    for (int idx = 0; idx < count; idx++)
+    {
+        if (dec->process_frame(frames + idx * FRAME_LEN, raw_output, 0))
+        {
+            output.insert(output.end(), raw_output, raw_output + RAW_LEN);
+        }
+    }
+
+    delete dec;
+}
+
+/**
+ * @brief Decode the capture on audio_batch_t::MAX_FRAMES streams at once with
+ *        audio_decoder::process_batch(), outputs of every stream are returned
+ *
+ */
+
+static void run_batch(const int16_t * frames, int count, std::vector<int16_t> output[])
+{
+    const int STREAMS = audio_batch_t::MAX_FRAMES;
+
+    audio_decoder * dec[STREAMS];
+    int16_t raw_output[STREAMS][RAW_LEN];
+
+    for (int stream = 0; stream < STREAMS; stream++)
+    {
+        dec[stream] = new audio_decoder();
+        dec[stream]->init();
+    }
+
+    for (int idx = 0; idx < count; idx++)
+    {
+        audio_batch_t batch;
+        batch.count = STREAMS;
+
+        for (int stream = 0; stream < STREAMS; stream++)
+        {
+            batch.decoder[stream]             = dec[stream];
+            batch.input_frame[stream]         = frames + idx * FRAME_LEN;
+            batch.raw_output[stream]          = raw_output[stream];
+            batch.frame_stealing_flag[stream] = 0;
+        }
+
+        audio_decoder::process_batch(&batch);
+
+        for (int stream = 0; stream < STREAMS; stream++)
+        {
+            if (batch.result[stream])
+            {
+                output[stream].insert(output[stream].end(), raw_output[stream], raw_output[stream] + RAW_LEN);
+            }
+        }
+    }
+
+    for (int stream = 0; stream < STREAMS; stream++)
+    {
+        delete dec[stream];
+    }
+}
+
+/**
+ * @brief Print frames per second and real-time factor (one TCH frame = 60 ms of speech)
+ *
+ */
+
+static void print_rate(const char * name, uint64_t frames, uint64_t elapsed_ns)
+{
+    double seconds = elapsed_ns / 1e9;
+    double fps     = (seconds > 0.) ? frames / seconds : 0.;
+
+    printf("%-22s: %10.0f frames/s  %8.3f us/frame  x%.0f real-time\n", name, fps, (frames > 0) ? elapsed_ns / 1e3 / frames : 0., fps * 0.060);
+}
+
+/**
+ * @brief Program entry point
+ *
+ */
+
+int main(int argc, char * argv[])
+{
+    int repeat = 10;
+    int arg = 1;
+
+    if ((argc > 2) && (strcmp(argv[1], "-n") == 0))
+    {
+        repeat = atoi(argv[2]);
+        arg += 2;
+    }
+
+    if ((argc - arg < 1) || (argc - arg > 2) || (repeat < 1))
+    {
+        fprintf(stderr, "usage: ./codec_bench [-n <repeat>] <capture.out> [<reference.raw>]\n");
+        return EXIT_FAILURE;
+    }
+
+    std::vector<int16_t> capture;
+    std::vector<int16_t> reference;
+
+    if (!read_file(argv[arg], capture)) return EXIT_FAILURE;
+
+    if ((argc - arg == 2) && !read_file(argv[arg + 1], reference)) return EXIT_FAILURE;
+
+    std::size_t start = 0;                                                      // skip any header before first frame (see codec/sub_cd.c Read_Tetra_File)
+
+    while ((start < capture.size()) && (capture[start] != 0x6b21))
+    {
+        start++;
+    }
+
+    int count = (int)((capture.size() - start) / FRAME_LEN);
+
+    if (count == 0)
+    {
+        fprintf(stderr, "no TCH frame in %s\n", argv[arg]);
+        return EXIT_FAILURE;
+    }
+
+    const int16_t * frames = &capture[start];
+
+    printf("capture: %d frames (%.1f s of speech), %d repeat\n", count, count * 0.060, repeat);
+    printf("kernels: %s\n", codec_sdecoder::dsp_kernels_select()->name);
+
+    bool b_ok = true;
+    std::vector<int16_t> staged;
+    uint64_t stage_ns[3] = {0, 0, 0};
+
+    for (int run = 0; run < repeat; run++)
+    {
+        std::vector<int16_t> output;
+        run_staged(frames, count, output, stage_ns);
+
+        if (run == 0)
+        {
+            staged = output;
+        }
+        else if (output != staged)
+        {
+            printf("staged run %d differs from first run\n", run);
+            b_ok = false;
+        }
+    }
+
+    uint64_t total_ns = stage_ns[0] + stage_ns[1] + stage_ns[2];
+    uint64_t frames_done = (uint64_t)(staged.size() / RAW_LEN) * repeat;
+
+    print_rate("staged", frames_done, total_ns);
+
+    const char * stage_names[3] = {"  desinterleave", "  channel_decoding", "  process_speech_frame"};
+
+    for (int stage = 0; stage < 3; stage++)
+    {
+        printf("%-22s: %8.3f us/frame  %5.1f %%\n", stage_names[stage],
+               (frames_done > 0) ? stage_ns[stage] / 1e3 / frames_done : 0.,
+               (total_ns > 0) ? 100. * stage_ns[stage] / total_ns : 0.);
+    }
+
+    {
+        std::vector<int16_t> output;
+        uint64_t t0 = now_ns();
+
+        for (int run = 0; run < repeat; run++)
+        {
+            output.clear();
+            run_frame(frames, count, output);
+        }
+
+        print_rate("process_frame", (uint64_t)(output.size() / RAW_LEN) * repeat, now_ns() - t0);
+
+        if (output != staged)
+        {
+            printf("process_frame output differs from staged output\n");
+            b_ok = false;
+        }
+    }
+
+    {
+        const int STREAMS = audio_batch_t::MAX_FRAMES;
+        std::vector<int16_t> output[STREAMS];
+        uint64_t t0 = now_ns();
+
+        for (int run = 0; run < repeat; run++)
+        {
+            for (int stream = 0; stream < STREAMS; stream++)
+            {
+                output[stream].clear();
+            }
+
+            run_batch(frames, count, output);
+        }
+
+        char name[32];
+        snprintf(name, sizeof(name), "process_batch x%d", STREAMS);
+        print_rate(name, (uint64_t)(output[0].size() / RAW_LEN) * STREAMS * repeat, now_ns() - t0);
+
+        for (int stream = 0; stream < STREAMS; stream++)
+        {
+            if (output[stream] != staged)
+            {
+                printf("process_batch stream %d output differs from staged output\n", stream);
+                b_ok = false;
+                break;
+            }
+        }
+    }
+
+    printf("checksum: %08x (%u samples)\n", checksum(staged), (unsigned)staged.size());
+
+    if (!reference.empty())
+    {
+        uint64_t errors = compare(staged, reference);
+        printf("reference: %u samples, %llu mismatches\n", (unsigned)reference.size(), (unsigned long long)errors);
+        b_ok = b_ok && (errors == 0);
+    }
+
+    printf("%s\n", b_ok ? "PASS" : "FAIL");
+
+    return b_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,745 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "etsi_operators.h"
+#include "sdecoder.h"
+#include "cdecoder.h"
+#include "audio_decoder.h"
+
+/*
+ * Bit-exactness check of the inlined operators (etsi_operators.h)
+ *
+ * USAGE:
+ *   ./etsi_check                              compare every operator with ETSI reference codec/tetra_op.c
+ *   ./etsi_check <serial_file> <synth_file>   also decode ETSI serial stream test vector and compare
+ *                                             the synthesis with the reference output file
+ *
+ * The channel decoder RCPC Viterbi (cdecoder_func.cc) is compared with codec/sub_cd.c on random
+ * soft bits frames, in normal and frame stealing modes. Batched decoding of several streams
+ * (rcpc_decoding_batch() and audio_decoder::process_batch()) is compared with frame by frame
+ * decoding.
+ *
+ * The speech decoder filtering kernels (sdecoder_simd.cc) available on the running CPU are also
+ * compared with the scalar ones, which is the ETSI code.
+ *
+ * Test vector format is the ETSI one (see codec/sdecoder.c): 16 bits words, 138 (BFI + 137 bits)
+ * per frame for serial file and 240 samples per frame for synthesis file.
+ *
+ */
+
+/**
+ * @brief ETSI reference operators from codec/ folder (C linkage)
+ *
+ */
+
+namespace ref {
+    extern "C" {
+        extern __thread int Overflow;                                           // one copy per thread (see codec/channel.h)
+
+        int16_t abs_s(int16_t var1);
+        int16_t add(int16_t var1, int16_t var2);
+        int16_t div_s(int16_t var1, int16_t var2);
+        int16_t extract_h(int32_t L_var1);
+        int16_t extract_l(int32_t L_var1);
+        int16_t mult(int16_t var1, int16_t var2);
+        int16_t mult_r(int16_t var1, int16_t var2);
+        int16_t negate(int16_t var1);
+        int16_t norm_l(int32_t L_var1);
+        int16_t norm_s(int16_t var1);
+        int16_t etsi_round(int32_t L_var1);
+        int16_t shl(int16_t var1, int16_t var2);
+        int16_t shr(int16_t var1, int16_t var2);
+        int16_t sub(int16_t var1, int16_t var2);
+        int32_t L_abs(int32_t L_var1);
+        int32_t L_add(int32_t L_var1, int32_t L_var2);
+        int32_t L_deposit_h(int16_t var1);
+        int32_t L_deposit_l(int16_t var1);
+        int32_t L_mac(int32_t L_var3, int16_t var1, int16_t var2);
+        int32_t L_mac0(int32_t L_var3, int16_t var1, int16_t var2);
+        int32_t L_msu(int32_t L_var3, int16_t var1, int16_t var2);
+        int32_t L_msu0(int32_t L_var3, int16_t var1, int16_t var2);
+        int32_t L_mult(int16_t var1, int16_t var2);
+        int32_t L_mult0(int16_t var1, int16_t var2);
+        int32_t L_negate(int32_t L_var1);
+        int32_t L_shl(int32_t L_var1, int16_t var2);
+        int32_t L_shr(int32_t L_var1, int16_t var2);
+        int32_t L_shr_r(int32_t L_var1, int16_t var2);
+        int32_t L_sub(int32_t L_var1, int32_t L_var2);
+
+        int32_t add_sh(int32_t L_var2, int16_t var1, int16_t shift);
+        int32_t add_sh16(int32_t L_var2, int16_t var1);
+        int32_t Load_sh(int16_t var1, int16_t shift);
+        int32_t Load_sh16(int16_t var1);
+        int32_t norm_v(int32_t L_var3, int16_t var1, int16_t * var2);
+        int16_t store_hi(int32_t L_var1, int16_t var2);
+        int32_t sub_sh(int32_t L_var2, int16_t var1, int16_t shift);
+        int32_t sub_sh16(int32_t L_var2, int16_t var1);
+
+        int32_t L_comp(int16_t hi, int16_t lo);
+        void    L_extract(int32_t L_32, int16_t * hi, int16_t * lo);
+        int32_t mpy_mix(int16_t hi1, int16_t lo1, int16_t lo2);
+        int32_t mpy_32(int16_t hi1, int16_t lo1, int16_t hi2, int16_t lo2);
+        int32_t div_32(int32_t L_num, int16_t denom_hi, int16_t denom_lo);
+
+        // same layout as Channel_Decoder_State in codec/channel.h (K = 5, Decoding_delay = 30)
+        struct channel_decoder_state_t {
+            int16_t previous[16][2];
+            int16_t best_previous[16][30];
+            int16_t t1[16][2], t2[16][2], t3[16][2];
+            int16_t score[16];
+            int16_t ex_score[16];
+            int16_t received[3];
+            int16_t msb_bit;
+            int16_t m_1;
+        };
+
+        int16_t Bfi(int16_t FS_Flag, int16_t Input_Frame[]);
+        void    Init_Rcpc_Decoding(channel_decoder_state_t * st);
+        void    Rcpc_Decoding(channel_decoder_state_t * st, int16_t FS_Flag, int16_t Input_Frame[], int16_t Output_Frame[]);
+    }
+}
+
+static uint32_t g_errors = 0;
+static uint64_t g_checks = 0;
+
+/**
+ * @brief Xorshift pseudo-random generator, reproducible
+ *
+ */
+
+static uint32_t rnd()
+{
+    static uint32_t state = 2463534242u;
+
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    return state;
+}
+
+/**
+ * @brief Compare results and print the first mismatches
+ *
+ */
+
+static void check(const char * name, int64_t res, int64_t expected, int32_t a, int32_t b, int32_t c)
+{
+    g_checks++;
+
+    if (res != expected)
+    {
+        if (g_errors < 20)
+        {
+            printf("MISMATCH %-12s (%d, %d, %d) = %lld expected %lld\n", name, a, b, c, (long long)res, (long long)expected);
+        }
+        g_errors++;
+    }
+}
+
+/**
+ * @brief Build 16 and 32 bits test values: edge values plus random ones
+ *
+ */
+
+static void build_values(std::vector<int16_t> & val16, std::vector<int32_t> & val32, int random_count)
+{
+    static const int32_t edges32[] = {
+        0, 1, -1, 2, -2, 0x3FFFFFFF, 0x40000000, (int32_t)0xC0000000, (int32_t)0xBFFFFFFF,
+        0x7FFFFFFF, 0x7FFFFFFE, (int32_t)0x80000000, (int32_t)0x80000001, 0x00008000, 0x00007FFF,
+        (int32_t)0xFFFF8000, (int32_t)0xFFFF7FFF, 0x00010000, (int32_t)0xFFFF0000
+    };
+
+    for (int idx = 0; idx < 16; idx++)
+    {
+        val16.push_back((int16_t)(1 << idx));
+        val16.push_back((int16_t)((1 << idx) - 1));
+        val16.push_back((int16_t)-(1 << idx));
+        val16.push_back((int16_t)(-(1 << idx) + 1));
+    }
+    val16.push_back(0);
+    val16.push_back(-1);
+
+    for (uint32_t idx = 0; idx < sizeof(edges32) / sizeof(edges32[0]); idx++)
+    {
+        val32.push_back(edges32[idx]);
+    }
+
+    for (int idx = 0; idx < 31; idx++)
+    {
+        val32.push_back((int32_t)1 << idx);
+        val32.push_back(((int32_t)1 << idx) - 1);
+        val32.push_back(-((int32_t)1 << idx));
+    }
+
+    for (int idx = 0; idx < random_count; idx++)
+    {
+        val16.push_back((int16_t)rnd());
+        val32.push_back((int32_t)rnd());
+        val32.push_back((int32_t)rnd() >> (rnd() % 31));                         // various magnitudes
+    }
+}
+
+/**
+ * @brief Compare every operator with the reference
+ *
+ */
+
+static void check_operators()
+{
+    using namespace etsi_op;
+
+    std::vector<int16_t> v16;
+    std::vector<int32_t> v32;
+    build_values(v16, v32, 300);
+
+    // one operand
+
+    for (std::size_t i = 0; i < v16.size(); i++)
+    {
+        int16_t a = v16[i];
+        check("abs_s",       op_abs_s(a),      ref::abs_s(a),       a, 0, 0);
+        check("negate",      op_negate(a),     ref::negate(a),      a, 0, 0);
+        check("norm_s",      op_norm_s(a),     ref::norm_s(a),      a, 0, 0);
+        check("L_deposit_h", op_ldeposit_h(a), ref::L_deposit_h(a), a, 0, 0);
+        check("L_deposit_l", op_ldeposit_l(a), ref::L_deposit_l(a), a, 0, 0);
+        check("Load_sh16",   op_load_sh16(a),  ref::Load_sh16(a),   a, 0, 0);
+
+        for (int16_t shift = 0; shift < 16; shift++)
+        {
+            check("Load_sh", op_load_sh(a, shift), ref::Load_sh(a, shift), a, shift, 0);
+        }
+    }
+
+    for (std::size_t i = 0; i < v32.size(); i++)
+    {
+        int32_t l = v32[i];
+        check("extract_h",  op_extract_h(l),  ref::extract_h(l),  l, 0, 0);
+        check("extract_l",  op_extract_l(l),  ref::extract_l(l),  l, 0, 0);
+        check("norm_l",     op_norm_l(l),     ref::norm_l(l),     l, 0, 0);
+        check("etsi_round", op_etsi_round(l), ref::etsi_round(l), l, 0, 0);
+        check("L_abs",      op_labs(l),       ref::L_abs(l),      l, 0, 0);
+        check("L_negate",   op_lnegate(l),    ref::L_negate(l),   l, 0, 0);
+
+        int16_t hi, lo, ref_hi, ref_lo;
+        op_lextract(l, &hi, &lo);
+        ref::L_extract(l, &ref_hi, &ref_lo);
+        check("L_extract",  ((int32_t)hi << 16) | (uint16_t)lo, ((int32_t)ref_hi << 16) | (uint16_t)ref_lo, l, 0, 0);
+
+        for (int16_t var2 = 0; var2 < 8; var2++)
+        {
+            check("store_hi", op_store_hi(l, var2), ref::store_hi(l, var2), l, var2, 0);
+        }
+
+        for (int16_t var1 = 0; var1 <= 32; var1++)
+        {
+            int16_t shift, ref_shift;
+            int32_t res = op_norm_v(l, var1, &shift);
+            check("norm_v", res + shift, ref::norm_v(l, var1, &ref_shift) + ref_shift, l, var1, 0);
+        }
+
+        for (int16_t shift = -40; shift <= 40; shift++)                         // shifts in both directions, beyond word size
+        {
+            check("L_shl",   op_lshl(l, shift),   ref::L_shl(l, shift),   l, shift, 0);
+            check("L_shr",   op_lshr(l, shift),   ref::L_shr(l, shift),   l, shift, 0);
+        }
+
+        for (int16_t shift = 0; shift <= 40; shift++)
+        {
+            check("L_shr_r", op_lshr_r(l, shift), ref::L_shr_r(l, shift), l, shift, 0);
+        }
+    }
+
+    // two operands
+
+    for (std::size_t i = 0; i < v16.size(); i++)
+    {
+        int16_t a = v16[i];
+
+        for (std::size_t j = 0; j < v16.size(); j++)
+        {
+            int16_t b = v16[j];
+            check("add",     op_add(a, b),     ref::add(a, b),     a, b, 0);
+            check("sub",     op_sub(a, b),     ref::sub(a, b),     a, b, 0);
+            check("mult",    op_mult(a, b),    ref::mult(a, b),    a, b, 0);
+            check("mult_r",  op_mult_r(a, b),  ref::mult_r(a, b),  a, b, 0);
+            check("L_mult",  op_lmult(a, b),   ref::L_mult(a, b),  a, b, 0);
+            check("L_mult0", op_lmult0(a, b),  ref::L_mult0(a, b), a, b, 0);
+            check("L_comp",  op_lcomp(a, b),   ref::L_comp(a, b),  a, b, 0);
+
+            if ((a >= 0) && (b > 0) && (a <= b))                                // div_s domain
+            {
+                check("div_s", op_div_s(a, b), ref::div_s(a, b), a, b, 0);
+            }
+        }
+
+        for (int16_t shift = -20; shift <= 20; shift++)
+        {
+            check("shl", op_shl(a, shift), ref::shl(a, shift), a, shift, 0);
+            check("shr", op_shr(a, shift), ref::shr(a, shift), a, shift, 0);
+        }
+    }
+
+    for (std::size_t i = 0; i < v32.size(); i++)
+    {
+        int32_t l = v32[i];
+
+        for (std::size_t j = 0; j < v32.size(); j += 3)
+        {
+            int32_t m = v32[j];
+
+            ref::Overflow = 0;
+            int16_t overflow = 0;
+            check("L_add", op_ladd_ovf(l, m, &overflow), ref::L_add(l, m), l, m, 0);
+            check("Overflow", overflow, ref::Overflow, l, m, 0);
+            check("L_sub", op_lsub(l, m), ref::L_sub(l, m), l, m, 0);
+        }
+
+        for (std::size_t j = 0; j < v16.size(); j += 2)
+        {
+            int16_t a = v16[j];
+            int16_t b = v16[(j * 7 + i) % v16.size()];
+
+            check("L_mac",    op_lmac(l, a, b),    ref::L_mac(l, a, b),    l, a, b);
+            check("L_mac0",   op_lmac0(l, a, b),   ref::L_mac0(l, a, b),   l, a, b);
+            check("L_msu",    op_lmsu(l, a, b),    ref::L_msu(l, a, b),    l, a, b);
+            check("L_msu0",   op_lmsu0(l, a, b),   ref::L_msu0(l, a, b),   l, a, b);
+            check("add_sh16", op_add_sh16(l, a),   ref::add_sh16(l, a),    l, a, 0);
+            check("sub_sh16", op_sub_sh16(l, a),   ref::sub_sh16(l, a),    l, a, 0);
+
+            int16_t shift = (int16_t)(j % 16);
+            check("add_sh",   op_add_sh(l, a, shift), ref::add_sh(l, a, shift), l, a, shift);
+            check("sub_sh",   op_sub_sh(l, a, shift), ref::sub_sh(l, a, shift), l, a, shift);
+        }
+    }
+
+    // extended precision on their valid domain (hi/lo double precision format)
+
+    for (int idx = 0; idx < 200000; idx++)
+    {
+        int16_t hi1 = (int16_t)rnd();
+        int16_t lo1 = (int16_t)(rnd() & 0x7FFF);
+        int16_t hi2 = (int16_t)rnd();
+        int16_t lo2 = (int16_t)(rnd() & 0x7FFF);
+
+        check("mpy_mix", op_mpy_mix(hi1, lo1, lo2),     ref::mpy_mix(hi1, lo1, lo2),     hi1, lo1, lo2);
+        check("mpy_32",  op_mpy_32(hi1, lo1, hi2, lo2), ref::mpy_32(hi1, lo1, hi2, lo2), hi1, lo1, hi2);
+
+        int32_t num = (int32_t)(rnd() & 0x3FFFFFFF);                            // 0 <= L_num < L_denom, denom normalized
+        int16_t denom_hi = (int16_t)(0x4000 | (rnd() & 0x3FFF));
+        int16_t denom_lo = (int16_t)(rnd() & 0x7FFF);
+
+        if (num < (((int32_t)denom_hi << 16) | ((int32_t)denom_lo << 1)))
+        {
+            check("div_32", op_div_32(num, denom_hi, denom_lo), ref::div_32(num, denom_hi, denom_lo), num, denom_hi, denom_lo);
+        }
+    }
+}
+
+/**
+ * @brief Compare RCPC decoding and BFI with the reference channel decoder
+ *
+ */
+
+static void check_channel_decoder(int trials)
+{
+    const int16_t LENGTH_TIME_SLOT = 432;
+    const int16_t LENGTH_DECODED   = 286;
+
+    codec_cdecoder::cdecoder * cdec = new codec_cdecoder::cdecoder();
+    cdec->init_rcpc_decoding();
+    ref::channel_decoder_state_t ref_state;
+    ref::Init_Rcpc_Decoding(&ref_state);
+
+    int16_t frame[LENGTH_TIME_SLOT];
+    int16_t input[LENGTH_TIME_SLOT];
+    int16_t out_ref[LENGTH_DECODED];
+    int16_t out_res[LENGTH_DECODED];
+
+    for (int t = 0; t < trials; t++)
+    {
+        int16_t fs_flag = (int16_t)(t & 1);
+        int mode = (t >> 1) & 3;
+
+        for (int i = 0; i < LENGTH_TIME_SLOT; i++)
+        {
+            uint32_t r = rnd();
+
+            switch (mode)
+            {
+            case 0:                                                             // hard decisions
+                frame[i] = (r & 1) ? 127 : -127;
+                break;
+            case 1:                                                             // soft decisions with erasures
+                frame[i] = (r & 0x300) ? (int16_t)((int32_t)(r >> 16) % 255 - 127) : (int16_t)0;
+                break;
+            case 2:                                                             // mostly clean with few errors
+                frame[i] = (int16_t)(((r & 0xF) == 0) ? ((r & 0x10) ? 30 : -30) : ((i & 1) ? 127 : -127));
+                break;
+            default:                                                            // out of range values, saturations
+                frame[i] = (int16_t)(r >> 16);
+                break;
+            }
+        }
+
+        memset(out_ref, 0, sizeof(out_ref));
+        memset(out_res, 0, sizeof(out_res));
+
+        memcpy(input, frame, sizeof(frame));
+        ref::Rcpc_Decoding(&ref_state, fs_flag, input + (fs_flag ? 216 : 0), out_ref);
+
+        memcpy(input, frame, sizeof(frame));
+        cdec->rcpc_decoding(fs_flag, input + (fs_flag ? 216 : 0), out_res);
+
+        for (int i = 0; i < LENGTH_DECODED; i++)
+        {
+            check("rcpc", out_res[i], out_ref[i], t, i, fs_flag);
+        }
+
+        check("bfi", cdec->bfi(fs_flag, out_res), ref::Bfi(fs_flag, out_ref), t, fs_flag, 0);
+    }
+
+    delete cdec;
+}
+
+/**
+ * @brief Compare batched decoding of several streams with frame by frame decoding
+ *
+ */
+
+static void check_batch(int rounds)
+{
+    const int STREAMS = audio_batch_t::MAX_FRAMES;
+    const int LENGTH_INPUT = 690;
+
+    // RCPC batch against single frame decoding
+
+    codec_cdecoder::cdecoder * cdec = new codec_cdecoder::cdecoder();
+    cdec->init_rcpc_decoding();
+
+    static int16_t frames[codec_cdecoder::cdecoder::BATCH_LANES][432];
+    static int16_t out_ref[codec_cdecoder::cdecoder::BATCH_LANES][286];
+    static int16_t out_res[codec_cdecoder::cdecoder::BATCH_LANES][286];
+    int16_t * inputs[codec_cdecoder::cdecoder::BATCH_LANES];
+    int16_t * outputs[codec_cdecoder::cdecoder::BATCH_LANES];
+
+    for (int t = 0; t < rounds; t++)
+    {
+        int16_t count = (int16_t)(1 + t % codec_cdecoder::cdecoder::BATCH_LANES);
+
+        for (int lane = 0; lane < count; lane++)
+        {
+            for (int i = 0; i < 432; i++)
+            {
+                uint32_t r = rnd();
+                frames[lane][i] = (t & 8) ? (int16_t)(r >> 16) : (int16_t)((int32_t)(r >> 16) % 255 - 127);
+            }
+
+            cdec->rcpc_decoding(0, frames[lane], out_ref[lane]);
+            inputs[lane]  = frames[lane];
+            outputs[lane] = out_res[lane];
+        }
+
+        cdec->rcpc_decoding_batch(count, inputs, outputs);
+
+        for (int lane = 0; lane < count; lane++)
+        {
+            for (int i = 0; i < 286; i++)
+            {
+                check("rcpc_batch", out_res[lane][i], out_ref[lane][i], t, lane, i);
+            }
+        }
+    }
+
+    delete cdec;
+
+    // full decoding of streams, consecutive frames keep the codec state
+
+    audio_decoder * single[STREAMS];
+    audio_decoder * batched[STREAMS];
+    static int16_t input[STREAMS][LENGTH_INPUT];
+    static int16_t raw_ref[STREAMS][480];
+    static int16_t raw_res[STREAMS][480];
+
+    for (int idx = 0; idx < STREAMS; idx++)
+    {
+        single[idx]  = new audio_decoder();
+        batched[idx] = new audio_decoder();
+        single[idx]->init();
+        batched[idx]->init();
+    }
+
+    for (int t = 0; t < rounds / 8; t++)
+    {
+        audio_batch_t batch;
+        int expected[STREAMS];
+
+        batch.count = 1 + (int)(rnd() % STREAMS);
+
+        for (int idx = 0; idx < batch.count; idx++)
+        {
+            uint32_t noise = rnd() & 0x1F;
+
+            for (int i = 0; i < LENGTH_INPUT; i++)
+            {
+                uint32_t r = rnd();
+                input[idx][i] = ((r & 0x1F) < noise) ? (int16_t)((int32_t)(r >> 16) % 255 - 127) : (int16_t)((r & 0x20) ? 127 : -127);
+            }
+            input[idx][0] = (idx == 5) && (t % 7 == 0) ? 0 : 0x6b21;            // some invalid frames
+
+            int16_t fs_flag = ((rnd() & 0x7) == 0) ? 1 : 0;
+
+            batch.decoder[idx]             = batched[idx];
+            batch.input_frame[idx]         = input[idx];
+            batch.raw_output[idx]          = raw_res[idx];
+            batch.frame_stealing_flag[idx] = fs_flag;
+
+            expected[idx] = single[idx]->process_frame(input[idx], raw_ref[idx], fs_flag);
+        }
+
+        audio_decoder::process_batch(&batch);
+
+        for (int idx = 0; idx < batch.count; idx++)
+        {
+            check("batch_result", batch.result[idx], expected[idx], t, idx, 0);
+
+            if (expected[idx])
+            {
+                for (int i = 0; i < 480; i++)
+                {
+                    check("batch_raw", raw_res[idx][i], raw_ref[idx][i], t, idx, i);
+                }
+            }
+        }
+    }
+
+    for (int idx = 0; idx < STREAMS; idx++)
+    {
+        delete single[idx];
+        delete batched[idx];
+    }
+}
+
+/**
+ * @brief Random 16 bits sample, with a share of extreme values
+ *
+ */
+
+static int16_t rnd_sample(int16_t amplitude)
+{
+    uint32_t r = rnd();
+
+    if ((r & 0x1F) == 0)
+    {
+        return (r & 0x20) ? (int16_t)-32768 : (int16_t)32767;
+    }
+
+    return (int16_t)((int32_t)(r >> 16) % ((int32_t)amplitude + 1) * ((r & 0x40) ? -1 : 1));
+}
+
+/**
+ * @brief Compare kernels with the scalar ones on random filters and signals
+ *
+ */
+
+static void check_kernels(const codec_sdecoder::dsp_kernels_t * kernels, int trials)
+{
+    using namespace codec_sdecoder;
+
+    const dsp_kernels_t * scalar = dsp_kernels_scalar();
+    const int16_t PP   = 10;
+    const int16_t LEN  = 256;
+
+    int16_t a[PP + 1];
+    int16_t x[PP + LEN];
+    int16_t h[80];
+    int16_t y_ref[PP + LEN];
+    int16_t y_res[PP + LEN];
+
+    for (int t = 0; t < trials; t++)
+    {
+        int16_t coef_amp = (t & 1) ? (int16_t)8192 : (int16_t)32767;            // bounded and saturating filters
+        int16_t sig_amp  = (int16_t)(rnd() & 0x7FFF);
+        int16_t lg       = (int16_t)(1 + rnd() % 70);
+
+        a[0] = 4096;
+        for (int j = 1; j <= PP; j++) a[j] = rnd_sample(coef_amp);
+        for (int i = 0; i < PP + LEN; i++) x[i] = rnd_sample(sig_amp);
+        for (int i = 0; i < 80; i++) h[i] = rnd_sample((t & 2) ? (int16_t)4096 : (int16_t)32767);
+
+        // Syn_Filt, memory is in front of output
+
+        memcpy(y_ref, x, PP * sizeof(int16_t));
+        memcpy(y_res, x, PP * sizeof(int16_t));
+        scalar->syn_filt(a, x + PP, y_ref + PP, lg);
+        kernels->syn_filt(a, x + PP, y_res + PP, lg);
+        for (int i = 0; i < lg; i++) check("syn_filt", y_res[PP + i], y_ref[PP + i], t, i, lg);
+
+        // Residu
+
+        scalar->residu(a, x + PP, y_ref, lg);
+        kernels->residu(a, x + PP, y_res, lg);
+        for (int i = 0; i < lg; i++) check("residu", y_res[i], y_ref[i], t, i, lg);
+
+        // Convolve
+
+        int16_t L = (int16_t)(1 + rnd() % 80);
+        scalar->convolve(x, h, y_ref, L);
+        kernels->convolve(x, h, y_res, L);
+        for (int i = 0; i < L; i++) check("convolve", y_res[i], y_ref[i], t, i, L);
+
+        // Autocorr sums, energy overflow decision compared with ETSI L_mac0 loop
+
+        int16_t len = (int16_t)(rnd() % (LEN + 1));
+        int16_t overflow = 0;
+        int32_t sum = 1;
+        for (int i = 0; i < len; i++) sum = op_ladd_ovf(sum, op_lmult0(x[i], x[i]), &overflow);
+
+        int64_t energy = kernels->energy(x, len);
+        check("energy", energy, scalar->energy(x, len), t, len, 0);
+        check("energy_ovf", energy + 1 > (int64_t)MAX_32, overflow != 0, t, len, 0);
+        if (!overflow) check("energy_sum", (int32_t)(energy + 1), sum, t, len, 0);
+
+        check("dot", kernels->dot(x, x + PP, len), scalar->dot(x, x + PP, len), t, len, 0);
+
+        // Post processing
+
+        memcpy(y_ref, x, LEN * sizeof(int16_t));
+        memcpy(y_res, x, LEN * sizeof(int16_t));
+        scalar->post_process(y_ref, len);
+        kernels->post_process(y_res, len);
+        for (int i = 0; i < len; i++) check("post_process", y_res[i], y_ref[i], t, i, len);
+    }
+
+    // full scale dot products (-32768 * -32768 pairs)
+
+    for (int i = 0; i < LEN; i++) x[i] = -32768;
+    check("dot_full", kernels->dot(x, x, LEN), scalar->dot(x, x, LEN), 0, 0, 0);
+    check("energy_full", kernels->energy(x, LEN), scalar->energy(x, LEN), 0, 0, 0);
+}
+
+/**
+ * @brief Decode ETSI serial test vector and compare with reference synthesis
+ *
+ */
+
+static int check_vector(const char * serial_file, const char * synth_file)
+{
+    const int SERIAL_SIZE = 138;
+    const int L_FRAME     = 240;
+
+    FILE * f_serial = fopen(serial_file, "rb");
+    FILE * f_synth  = fopen(synth_file,  "rb");
+
+    if ((f_serial == NULL) || (f_synth == NULL))
+    {
+        fprintf(stderr, "Couldn't open test vector files\n");
+        return 0;
+    }
+
+    codec_sdecoder::sdecoder * sdec = new codec_sdecoder::sdecoder();
+    sdec->init_decod_tetra();
+
+    int16_t serial[SERIAL_SIZE];
+    int16_t synth[L_FRAME];
+    int16_t expected[L_FRAME];
+    int frames = 0;
+    int frames_ko = 0;
+
+    while ((fread(serial, sizeof(int16_t), SERIAL_SIZE, f_serial) == (size_t)SERIAL_SIZE) &&
+           (fread(expected, sizeof(int16_t), L_FRAME, f_synth) == (size_t)L_FRAME))
+    {
+        sdec->process_speech_frame(serial, synth);
+
+        if (memcmp(synth, expected, sizeof(synth)) != 0)
+        {
+            if (frames_ko < 10)
+            {
+                printf("MISMATCH frame %d\n", frames);
+            }
+            frames_ko++;
+        }
+        frames++;
+    }
+
+    delete sdec;
+    fclose(f_serial);
+    fclose(f_synth);
+
+    printf("test vector: %d frames, %d mismatches\n", frames, frames_ko);
+
+    return (frames > 0) && (frames_ko == 0);
+}
+
+/**
+ * @brief Program entry point
+ *
+ */
+
+int main(int argc, char * argv[])
+{
+    check_operators();
+    printf("operators: %llu checks, %u mismatches\n", (unsigned long long)g_checks, g_errors);
+
+    {
+        uint32_t errors = g_errors;
+        uint64_t checks = g_checks;
+
+        check_channel_decoder(20000);
+        printf("channel decoder: %llu checks, %u mismatches\n", (unsigned long long)(g_checks - checks), g_errors - errors);
+    }
+
+    {
+        uint32_t errors = g_errors;
+        uint64_t checks = g_checks;
+
+        check_batch(4000);
+        printf("batch decoding: %llu checks, %u mismatches\n", (unsigned long long)(g_checks - checks), g_errors - errors);
+    }
+
+    const codec_sdecoder::dsp_kernels_t * kernels[] = {codec_sdecoder::dsp_kernels_sse41(), codec_sdecoder::dsp_kernels_avx2()};
+
+    for (size_t idx = 0; idx < sizeof(kernels) / sizeof(kernels[0]); idx++)
+    {
+        if (kernels[idx] != NULL)
+        {
+            uint32_t errors = g_errors;
+            uint64_t checks = g_checks;
+
+            check_kernels(kernels[idx], 200000);
+            printf("kernels %s: %llu checks, %u mismatches\n", kernels[idx]->name, (unsigned long long)(g_checks - checks), g_errors - errors);
+        }
+    }
+
+    printf("selected kernels: %s\n", codec_sdecoder::dsp_kernels_select()->name);
+
+    bool b_ok = (g_errors == 0);
+
+    if (argc == 3)
+    {
+        b_ok = check_vector(argv[1], argv[2]) && b_ok;
+    }
+
+    printf("%s\n", b_ok ? "PASS" : "FAIL");
+
+    return b_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
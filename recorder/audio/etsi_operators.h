@@ -0,0 +1,468 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef ETSI_OPERATORS_H
+#define ETSI_OPERATORS_H
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief ETSI fixed-point basic operators, header-only and force-inlined
+ *
+ * Results are bit-exact with the ETSI reference operators (codec/tetra_op.c),
+ * check with 'make etsi_check' in recorder folder.
+ *
+ * The reference operators set a global Overflow flag on saturation. It is only
+ * read by the speech decoder autocorrelation, so it is not maintained here:
+ * the accumulation which needs it uses op_ladd_ovf() explicitly.
+ *
+ */
+
+#if defined(__GNUC__)
+#define ETSI_INLINE static inline __attribute__((always_inline))
+#else
+#define ETSI_INLINE static inline
+#endif
+
+namespace etsi_op {
+
+    static const int32_t MAX_32 = ((int32_t)0x7FFFFFFF);
+    static const int32_t MIN_32 = ((int32_t)0x80000000);
+    static const int16_t MAX_16 = ((int16_t)0x7FFF);
+    static const int16_t MIN_16 = ((int16_t)0x8000);
+
+    ETSI_INLINE int16_t op_sature(int32_t lval1)
+    {
+        if (lval1 > MAX_16) return MAX_16;
+        if (lval1 < MIN_16) return MIN_16;
+
+        return (int16_t)lval1;
+    }
+
+    ETSI_INLINE int32_t op_sature32(int64_t lval1)
+    {
+        if (lval1 > MAX_32) return MAX_32;
+        if (lval1 < MIN_32) return MIN_32;
+
+        return (int32_t)lval1;
+    }
+
+    ETSI_INLINE int16_t op_abs_s(int16_t val1)
+    {
+        return (val1 == MIN_16) ? MAX_16 : ((val1 < 0) ? (int16_t)-val1 : val1);
+    }
+
+    ETSI_INLINE int16_t op_add(int16_t val1, int16_t val2)
+    {
+        return op_sature((int32_t)val1 + val2);
+    }
+
+    ETSI_INLINE int16_t op_sub(int16_t val1, int16_t val2)
+    {
+        return op_sature((int32_t)val1 - val2);
+    }
+
+    ETSI_INLINE int16_t op_extract_h(int32_t lval1)
+    {
+        return (int16_t)(lval1 >> 16);
+    }
+
+    ETSI_INLINE int16_t op_extract_l(int32_t lval1)
+    {
+        return (int16_t)lval1;
+    }
+
+    ETSI_INLINE int16_t op_negate(int16_t val1)
+    {
+        return (val1 == MIN_16) ? MAX_16 : (int16_t)-val1;
+    }
+
+    ETSI_INLINE int16_t op_mult(int16_t val1, int16_t val2)
+    {
+        return op_sature(((int32_t)val1 * (int32_t)val2) >> 15);                // only -1 * -1 saturates
+    }
+
+    ETSI_INLINE int16_t op_mult_r(int16_t val1, int16_t val2)
+    {
+        return op_sature(((int32_t)val1 * (int32_t)val2 + 0x00004000) >> 15);
+    }
+
+    ETSI_INLINE int16_t op_norm_s(int16_t val1)
+    {
+        if (val1 == 0)  return 0;
+        if (val1 == -1) return 15;
+
+        int32_t val = (val1 < 0) ? ~val1 : val1;                                // positive 15 bits value
+
+        return (int16_t)(__builtin_clz((uint32_t)val) - 17);
+    }
+
+    ETSI_INLINE int16_t op_norm_l(int32_t lval1)
+    {
+        if (lval1 == 0)  return 0;
+        if (lval1 == -1) return 31;
+
+        int32_t val = (lval1 < 0) ? ~lval1 : lval1;                             // positive 31 bits value
+
+        return (int16_t)(__builtin_clz((uint32_t)val) - 1);
+    }
+
+    ETSI_INLINE int16_t op_shl_pos(int16_t val1, int16_t val2)                 // val2 >= 0
+    {
+        if (val2 > 15)
+        {
+            return (val1 == 0) ? 0 : ((val1 > 0) ? MAX_16 : MIN_16);
+        }
+
+        int32_t res = (int32_t)val1 * ((int32_t)1 << val2);
+
+        if (res != (int32_t)((int16_t)res))
+        {
+            return (val1 > 0) ? MAX_16 : MIN_16;
+        }
+
+        return (int16_t)res;
+    }
+
+    ETSI_INLINE int16_t op_shr_pos(int16_t val1, int16_t val2)                 // val2 >= 0
+    {
+        if (val2 >= 15)
+        {
+            return (val1 < 0) ? -1 : 0;
+        }
+
+        return (int16_t)(val1 >> val2);                                         // arithmetic shift
+    }
+
+    ETSI_INLINE int16_t op_shl(int16_t val1, int16_t val2)
+    {
+        return (val2 < 0) ? op_shr_pos(val1, (int16_t)(-val2)) : op_shl_pos(val1, val2);
+    }
+
+    ETSI_INLINE int16_t op_shr(int16_t val1, int16_t val2)
+    {
+        return (val2 < 0) ? op_shl_pos(val1, (int16_t)(-val2)) : op_shr_pos(val1, val2);
+    }
+
+    ETSI_INLINE int32_t op_labs(int32_t lval1)
+    {
+        return (lval1 == MIN_32) ? MAX_32 : ((lval1 < 0) ? -lval1 : lval1);
+    }
+
+    ETSI_INLINE int32_t op_ladd(int32_t lval1, int32_t lval2)
+    {
+        int32_t lres;
+
+        if (__builtin_add_overflow(lval1, lval2, &lres))
+        {
+            lres = (lval1 < 0) ? MIN_32 : MAX_32;
+        }
+
+        return lres;
+    }
+
+    ETSI_INLINE int32_t op_ladd_ovf(int32_t lval1, int32_t lval2, int16_t * overflow)
+    {
+        int32_t lres;
+
+        if (__builtin_add_overflow(lval1, lval2, &lres))
+        {
+            lres = (lval1 < 0) ? MIN_32 : MAX_32;
+            *overflow = 1;
+        }
+
+        return lres;
+    }
+
+    ETSI_INLINE int32_t op_lsub(int32_t lval1, int32_t lval2)
+    {
+        int32_t lres;
+
+        if (__builtin_sub_overflow(lval1, lval2, &lres))
+        {
+            lres = (lval1 < 0) ? MIN_32 : MAX_32;
+        }
+
+        return lres;
+    }
+
+    ETSI_INLINE int32_t op_ldeposit_h(int16_t val1)
+    {
+        return (int32_t)((uint32_t)(int32_t)val1 << 16);
+    }
+
+    ETSI_INLINE int32_t op_ldeposit_l(int16_t val1)
+    {
+        return (int32_t)val1;
+    }
+
+    ETSI_INLINE int32_t op_lmult(int16_t val1, int16_t val2)
+    {
+        int32_t lres = (int32_t)val1 * (int32_t)val2;
+
+        return (lres != (int32_t)0x40000000) ? lres * 2 : MAX_32;
+    }
+
+    ETSI_INLINE int32_t op_lmult0(int16_t val1, int16_t val2)
+    {
+        return (int32_t)val1 * (int32_t)val2;
+    }
+
+    ETSI_INLINE int32_t op_lmac(int32_t lval3, int16_t val1, int16_t val2)
+    {
+        return op_ladd(lval3, op_lmult(val1, val2));
+    }
+
+    ETSI_INLINE int32_t op_lmac0(int32_t lval3, int16_t val1, int16_t val2)
+    {
+        return op_ladd(lval3, op_lmult0(val1, val2));
+    }
+
+    ETSI_INLINE int32_t op_lmsu(int32_t lval3, int16_t val1, int16_t val2)
+    {
+        return op_lsub(lval3, op_lmult(val1, val2));
+    }
+
+    ETSI_INLINE int32_t op_lmsu0(int32_t lval3, int16_t val1, int16_t val2)
+    {
+        return op_lsub(lval3, op_lmult0(val1, val2));
+    }
+
+    ETSI_INLINE int32_t op_lnegate(int32_t lval1)
+    {
+        return (lval1 == MIN_32) ? MAX_32 : -lval1;
+    }
+
+    ETSI_INLINE int32_t op_lshl_pos(int32_t lval1, int16_t val2)               // val2 > 0
+    {
+        if (val2 > 32)                                                          // saturates anyway unless zero
+        {
+            val2 = 32;
+        }
+
+        return op_sature32((int64_t)lval1 * ((int64_t)1 << val2));
+    }
+
+    ETSI_INLINE int32_t op_lshr_pos(int32_t lval1, int16_t val2)               // val2 >= 0
+    {
+        if (val2 >= 31)
+        {
+            return (lval1 < 0) ? -1 : 0;
+        }
+
+        return lval1 >> val2;                                                   // arithmetic shift
+    }
+
+    ETSI_INLINE int32_t op_lshl(int32_t lval1, int16_t val2)
+    {
+        return (val2 <= 0) ? op_lshr_pos(lval1, (int16_t)(-val2)) : op_lshl_pos(lval1, val2);
+    }
+
+    ETSI_INLINE int32_t op_lshr(int32_t lval1, int16_t val2)
+    {
+        return (val2 < 0) ? op_lshl_pos(lval1, (int16_t)(-val2)) : op_lshr_pos(lval1, val2);
+    }
+
+    ETSI_INLINE int32_t op_lshr_r(int32_t lval1, int16_t val2)
+    {
+        if (val2 > 31)
+        {
+            return 0;
+        }
+
+        int32_t lres = op_lshr(lval1, val2);
+
+        if ((val2 > 0) && ((lval1 & ((int32_t)1 << (val2 - 1))) != 0))
+        {
+            lres++;
+        }
+
+        return lres;
+    }
+
+    ETSI_INLINE int16_t op_etsi_round(int32_t lval1)
+    {
+        return op_extract_h(op_ladd(lval1, (int32_t)0x00008000));
+    }
+
+    ETSI_INLINE int16_t op_div_s(int16_t val1, int16_t val2)
+    {
+        if ((val1 > val2) || (val1 < 0) || (val2 < 0))
+        {
+            printf("Division Error\n");
+            exit(0);
+        }
+
+        if (val2 == 0)
+        {
+            printf("Division by 0, Fatal error \n");
+            exit(0);
+        }
+
+        if (val1 == 0)    return 0;
+        if (val1 == val2) return MAX_16;
+
+        int32_t lnum   = val1;
+        int32_t ldenom = val2;
+        int16_t res    = 0;
+
+        for (int16_t iteration = 0; iteration < 15; iteration++)
+        {
+            res  <<= 1;
+            lnum <<= 1;
+
+            if (lnum >= ldenom)
+            {
+                lnum -= ldenom;
+                res  += 1;
+            }
+        }
+
+        return res;
+    }
+
+    // Extended precision functions (double precision format hi/lo)
+
+    static const int16_t POW2[16] = {
+        -1, -2, -4, -8, -16, -32, -64, -128, -256, -512,
+        -1024, -2048, -4096, -8192, -16384, -32768
+    };
+
+    ETSI_INLINE int32_t op_add_sh(int32_t L_var2, int16_t var1, int16_t shift)
+    {
+        return op_lmsu0(L_var2, var1, POW2[shift]);
+    }
+
+    ETSI_INLINE int32_t op_add_sh16(int32_t L_var2, int16_t var1)
+    {
+        return op_lmsu(L_var2, var1, (int16_t)-32768);
+    }
+
+    ETSI_INLINE int32_t op_sub_sh(int32_t L_var2, int16_t var1, int16_t shift)
+    {
+        return op_lmac0(L_var2, var1, POW2[shift]);
+    }
+
+    ETSI_INLINE int32_t op_sub_sh16(int32_t L_var2, int16_t var1)
+    {
+        return op_lmac(L_var2, var1, (int16_t)-32768);
+    }
+
+    ETSI_INLINE int32_t op_load_sh(int16_t var1, int16_t shift)
+    {
+        return op_lmsu0((int32_t)0, var1, POW2[shift]);
+    }
+
+    ETSI_INLINE int32_t op_load_sh16(int16_t var1)
+    {
+        return op_lmsu((int32_t)0, var1, (int16_t)-32768);
+    }
+
+    ETSI_INLINE int32_t op_lcomp(int16_t hi, int16_t lo)
+    {
+        return op_add_sh(op_load_sh(lo, (int16_t)0), hi, (int16_t)15);
+    }
+
+    ETSI_INLINE void op_lextract(int32_t L_32, int16_t * hi, int16_t * lo)
+    {
+        *hi = op_extract_h(op_lshl(L_32, (int16_t)1));
+        *lo = op_extract_l(op_sub_sh(L_32, *hi, (int16_t)15));
+    }
+
+    ETSI_INLINE int32_t op_mpy_mix(int16_t hi1, int16_t lo1, int16_t lo2)
+    {
+        int16_t p1   = op_extract_h(op_lmult0(lo1, lo2));
+        int32_t L_32 = op_lmult0(hi1, lo2);
+
+        return op_add_sh(L_32, p1, (int16_t)1);
+    }
+
+    ETSI_INLINE int32_t op_mpy_32(int16_t hi1, int16_t lo1, int16_t hi2, int16_t lo2)
+    {
+        int16_t p1   = op_extract_h(op_lmult0(hi1, lo2));
+        int16_t p2   = op_extract_h(op_lmult0(lo1, hi2));
+        int32_t L_32 = op_lmult0(hi1, hi2);
+
+        L_32 = op_add_sh(L_32, p1, (int16_t)1);
+
+        return op_add_sh(L_32, p2, (int16_t)1);
+    }
+
+    ETSI_INLINE int32_t op_div_32(int32_t L_num, int16_t denom_hi, int16_t denom_lo)
+    {
+        int16_t approx, hi, lo, n_hi, n_lo;
+        int32_t t0;
+
+        approx = op_div_s((int16_t)0x3FFF, denom_hi);                           // first approximation: 1 / L_denom = 1/denom_hi in Q15
+
+        t0 = op_mpy_mix(denom_hi, denom_lo, approx);                            // 1/L_denom = approx * (2.0 - L_denom * approx) in Q29
+        t0 = op_lsub((int32_t)0x40000000, t0);
+        op_lextract(t0, &hi, &lo);
+        t0 = op_mpy_mix(hi, lo, approx);                                        // 1/L_denom in Q28
+
+        op_lextract(t0, &hi, &lo);                                              // L_num * (1/L_denom)
+        op_lextract(L_num, &n_hi, &n_lo);
+        t0 = op_mpy_32(n_hi, n_lo, hi, lo);
+
+        return op_lshl(t0, (int16_t)2);                                         // from Q28 to Q30
+    }
+
+    ETSI_INLINE int32_t op_norm_v(int32_t L_var3, int16_t var1, int16_t * var2)
+    {
+        int16_t shift = op_norm_l(L_var3);
+
+        if (op_sub(shift, var1) > 0) shift = var1;
+        *var2 = shift;
+
+        return op_lshl(L_var3, shift);
+    }
+
+    ETSI_INLINE int16_t op_store_hi(int32_t L_var1, int16_t var2)
+    {
+        static const int16_t SHR[8] = {16, 15, 14, 13, 12, 11, 10, 9};
+
+        return op_extract_l(op_lshr(L_var1, SHR[var2]));
+    }
+
+    ETSI_INLINE int16_t op_bin2int(int16_t no_of_bits, int16_t * bitstream)
+    {
+        int16_t value = 0;
+
+        for (int16_t idx = 0; idx < no_of_bits; idx++)
+        {
+            value = op_shl(value, (int16_t)1);
+            if (*bitstream++ == 1) value += 1;
+        }
+
+        return value;
+    }
+
+    ETSI_INLINE void op_int2bin(int16_t value, int16_t no_of_bits, int16_t * bitstream)
+    {
+        int16_t * pt_bitstream = bitstream + no_of_bits;
+
+        for (int16_t idx = 0; idx < no_of_bits; idx++)
+        {
+            *--pt_bitstream = ((value & 1) == 0) ? 0 : 1;
+            value = op_shr(value, (int16_t)1);
+        }
+    }
+}
+
+#endif /* ETSI_OPERATORS_H */
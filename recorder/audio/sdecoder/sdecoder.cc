@@ -10,7 +10,7 @@ using namespace codec_sdecoder;
 
 sdecoder::sdecoder()
 {
-
+    m_dsp = dsp_kernels_select();
 }
 
 /**
@@ -387,8 +387,5 @@ void sdecoder::bits2prm_tetra(int16_t * bits, int16_t * prm)
 
 void sdecoder::post_process(int16_t * signal, int16_t lg)
 {
-    for (int16_t i = 0; i < lg; i++)
-    {
-        signal[i] = op_add(signal[i], signal[i]);
-    }
+    m_dsp->post_process(signal, lg);                                            // signal[i] = add(signal[i], signal[i])
 }
@@ -2,9 +2,13 @@
 #define SDECODER_H
 #include <stdint.h>
 #include <stdlib.h>
+#include "etsi_operators.h"
+#include "sdecoder_simd.h"
 
 namespace codec_sdecoder {
 
+    using namespace etsi_op;
+
     class sdecoder {
     public:
         sdecoder();
@@ -27,6 +31,8 @@ namespace codec_sdecoder {
         int16_t inter32_1_3(int16_t x[]);
 
     private:
+        const dsp_kernels_t * m_dsp;                                            // filtering kernels selected for the running CPU
+
         static const int PARAM_SIZE     = 24;
         int16_t synth_param[PARAM_SIZE] = {0};                                  // synthesis parameters
 
@@ -102,72 +108,7 @@ namespace codec_sdecoder {
         int16_t last_ener_cod;
         int16_t last_ener_pit;
 
-        // operators
-
-        int16_t g_overflow = 0;                                                 // used only in sdecoder tetra_dsp.cc and tetra_codec.cc
-
-        static const int32_t MAX_32 = ((int32_t)0x7FFFFFFF);
-        static const int32_t MIN_32 = ((int32_t)0x80000000);
-        static const int16_t MAX_16 = ((int16_t)0x7FFF);
-        static const int16_t MIN_16 = ((int16_t)0x8000);
-        static const int16_t BIT_0      = 0;
-        static const int16_t BIT_1      = 1;
-        static const int16_t MASK       = 1;
-
-        static const int16_t POW2[16];
-        int16_t op_sature(int32_t lval1);
-
-        int16_t op_abs_s(int16_t var1);                                         // Short abs,           1
-        int16_t op_add(int16_t var1, int16_t var2);                             // Short add,           1
-        int16_t op_div_s(int16_t var1, int16_t var2);                           // Short division,     18
-        int16_t op_extract_h(int32_t L_var1);                                   // Extract high,        1
-        int16_t op_extract_l(int32_t L_var1);                                   // Extract low,         1
-        int16_t op_mult(int16_t var1, int16_t var2);                            // Short mult,          1
-        int16_t op_mult_r(int16_t var1, int16_t var2);                          // Mult with round,     2
-        int16_t op_negate(int16_t var1);                                        // Short negate,        1
-        int16_t op_norm_l(int32_t L_var1);                                      // Long norm,          30
-        int16_t op_norm_s(int16_t var1);                                        // Short norm,         15
-        int16_t op_etsi_round(int32_t L_var1);                                  // Round,               1
-        int16_t op_shl(int16_t var1, int16_t var2);                             // Short shift left,    1
-        int16_t op_shr(int16_t var1, int16_t var2);                             // Short shift right,   1
-        int16_t op_sub(int16_t var1, int16_t var2);                             // Short sub,           1
-
-        int32_t op_labs(int32_t L_var1);                                        // Long abs,            3
-        int32_t op_ladd(int32_t L_var1, int32_t L_var2);                        // Long add,            2
-        int32_t op_ldeposit_h(int16_t var1);                                    // 16 bit var1 -> MSB   2
-        int32_t op_ldeposit_l(int16_t var1);                                    // 16 bit var1 -> LSB,  2
-        int32_t op_lmac(int32_t L_var3, int16_t var1, int16_t var2);            // Mac,                 1
-        int32_t op_lmac0(int32_t L_var3, int16_t var1, int16_t var2);           // no shift             1
-        int32_t op_lmsu(int32_t L_var3, int16_t var1, int16_t var2);            // Msu,                 1
-        int32_t op_lmsu0(int32_t L_var3, int16_t var1, int16_t var2);           // no shift             1
-        int32_t op_lmult(int16_t var1, int16_t var2);                           // Long mult,           1
-        int32_t op_lmult0(int16_t var1, int16_t var2);                          // Long mult no shift,  1
-        int32_t op_lnegate(int32_t L_var1);                                     // Long negate,         2
-        int32_t op_lshl(int32_t L_var1, int16_t var2);                          // Long shift left,     2
-        int32_t op_lshr(int32_t L_var1, int16_t var2);                          // Long shift right,    2
-        int32_t op_lshr_r(int32_t L_var1, int16_t var2);                        // L_shr with round,    3
-        int32_t op_lsub(int32_t L_var1, int32_t L_var2);                        // Long sub,            2
-
-        // Extended precision functions
-
-        int32_t op_div_32(int32_t L_num, int16_t hi, int16_t lo);
-        int32_t op_lcomp(int16_t hi, int16_t lo);
-        void    op_lextract(int32_t L_32, int16_t *hi, int16_t *lo);
-        int32_t op_mpy_mix(int16_t hi1, int16_t lo1, int16_t lo2);
-        int32_t op_mpy_32(int16_t hi1, int16_t lo1, int16_t hi2, int16_t lo2);
-
-        // Basic functions
-
-        int32_t op_add_sh(int32_t L_var, int16_t var1, int16_t shift);
-        int32_t op_add_sh16(int32_t L_var, int16_t var1);
-        int16_t op_bin2int(int16_t no_of_bits, int16_t *bitstream);
-        void    op_int2bin(int16_t value, int16_t no_of_bits, int16_t *bitstream);
-        int32_t op_load_sh(int16_t var1, int16_t shift);
-        int32_t op_load_sh16(int16_t var1);
-        int32_t op_norm_v(int32_t L_var3, int16_t var1, int16_t *var2);
-        int16_t op_store_hi(int32_t L_var1, int16_t var2);
-        int32_t op_sub_sh(int32_t L_var, int16_t var1, int16_t shift);
-        int32_t op_sub_sh16(int32_t L_var, int16_t var1);
+        // operators are inlined from etsi_operators.h
 
         // General signal processing
         static const int16_t GRID_POINTS = 60;
@@ -146,7 +146,7 @@ const int16_t sdecoder::WIND[L_WINDOW] = {
 
 void sdecoder::dsp_autocorr(int16_t * x, int16_t p, int16_t * r_h, int16_t * r_l)
 {
-    int16_t i, j, norm;
+    int16_t i, norm;
     int16_t y[L_WINDOW];
     int32_t sum;
 
@@ -157,21 +157,23 @@ void sdecoder::dsp_autocorr(int16_t * x, int16_t p, int16_t * r_h, int16_t * r_l
 
     // Compute r[0] and test for overflow
 
+    int16_t overflow;
+
     do {
-        g_overflow = 0;
-        sum = 1;                                                                // Avoid case of all zeros
-        for (i=0; i<L_WINDOW; i++)
-            sum = op_lmac0(sum, y[i], y[i]);
+        int64_t energy = m_dsp->energy(y, L_WINDOW);                            // exact, all terms are positive
+
+        overflow = (energy + 1 > (int64_t)MAX_32) ? 1 : 0;                      // L_mac0 would have saturated
+        sum      = (int32_t)(energy + 1);                                       // Avoid case of all zeros
 
         // If overflow divide y[] by 4
 
-        if (g_overflow != 0)
+        if (overflow != 0)
         {
             for (i=0; i<L_WINDOW; i++)
                 y[i] = op_shr(y[i], (int16_t)2);
         }
 
-    } while (g_overflow != 0);
+    } while (overflow != 0);
 
     // Normalization of r[0]
 
@@ -184,9 +186,7 @@ void sdecoder::dsp_autocorr(int16_t * x, int16_t p, int16_t * r_h, int16_t * r_l
 
     for (i = 1; i <= p; i++)
     {
-        sum = 0;
-        for (j=0; j<L_WINDOW-i; j++)
-            sum = op_lmac0(sum, y[j], y[j+i]);
+        sum = (int32_t)m_dsp->dot(y, y + i, L_WINDOW - i);                      // bounded by r[0], can't saturate
 
         sum = op_lshr(sum, (int16_t)1);                                         // Special double format
         sum = op_lshl(sum, norm);
@@ -548,17 +548,7 @@ int16_t sdecoder::dsp_chebps(int16_t x, int16_t * f, int16_t n)
 
 void sdecoder::dsp_convolve(int16_t * x, int16_t * h, int16_t * y, int16_t L)
 {
-    int16_t i, n;
-    int32_t s;
-
-    for (n = 0; n < L; n++)
-    {
-        s = 0;
-        for (i = 0; i <= n; i++)
-            s = op_lmac0(s, x[i], h[n-i]);
-
-        y[n] = op_store_hi(s, (int16_t)4);                                      // h is in Q12
-    }
+    m_dsp->convolve(x, h, y, L);                                                // h is in Q12
 }
 
 /**************************************************************************
@@ -1148,19 +1138,7 @@ void sdecoder::dsp_pond_ai(int16_t * a, int16_t * fac, int16_t * a_exp)
 
 void sdecoder::dsp_residu(int16_t * a, int16_t * x, int16_t * y, int16_t lg)
 {
-    int16_t i, j;
-    int32_t s;
-
-    for (i = 0; i < lg; i++)
-    {
-        s = op_load_sh(x[i], (int16_t)12);
-        for (j = 1; j <= PP; j++)
-            s = op_lmac0(s, a[j], x[i-j]);
-
-        s = op_add_sh(s, (int16_t)1, (int16_t)11);                              // Rounding
-        s = op_lshl(s, (int16_t)4);                                             // Saturation
-        y[i] = op_extract_h(s);
-    }
+    m_dsp->residu(a, x, y, lg);
 }
 
 /**************************************************************************
@@ -1205,8 +1183,7 @@ void sdecoder::dsp_residu(int16_t * a, int16_t * x, int16_t * y, int16_t lg)
 
 void sdecoder::dsp_syn_filt(int16_t * a, int16_t * x, int16_t * y, int16_t lg, int16_t * mem, int16_t update)
 {
-    int16_t i, j;
-    int32_t s;
+    int16_t i;
     int16_t tmp[80];                                                            // This is usually done by memory allocation (lg+PP)
     int16_t *yy;
 
@@ -1219,15 +1196,7 @@ void sdecoder::dsp_syn_filt(int16_t * a, int16_t * x, int16_t * y, int16_t lg, i
 
     // Do the filtering.
 
-    for (i = 0; i < lg; i++)
-    {
-        s = op_load_sh(x[i], (int16_t)12);                                      // a[] is in Q12
-        for (j = 1; j <= PP; j++)
-            s = op_lmsu0(s, a[j], yy[-j]);
-
-        s     = op_add_sh(s, (int16_t)1, (int16_t)11);                          // Rounding
-        *yy++ = op_extract_h(op_lshl(s, (int16_t)4));
-    }
+    m_dsp->syn_filt(a, x, yy, lg);                                              // a[] is in Q12
 
     for (i=0; i<lg; i++) y[i] = tmp[i+PP];
 
@@ -0,0 +1,620 @@
+#include <string.h>
+#include <stdlib.h>
+#include "sdecoder.h"
+#include "sdecoder_simd.h"
+
+#if defined(__x86_64__)
+#define DSP_HAVE_X86 1
+#include <immintrin.h>
+#define DSP_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define DSP_TARGET_AVX2  __attribute__((target("avx2")))
+#endif
+
+using namespace codec_sdecoder;
+
+/*
+ * Bit-exactness of the vector kernels
+ *
+ * Filters (Syn_Filt and Residu) start from x << 12 (|s| <= 2^27) and accumulate 10 products
+ * a[j] * y with |y| <= 32768. When sum |a[j]| <= 61439, every partial sum and the rounding
+ * stay within [-2^31 + 1, 2^31 - 1] so L_mac0/L_msu0 never saturate: the plain 32 bits sum
+ * is the ETSI result, and the final L_shl(s, 4) + extract_h() is a clamp to 2^27 then >> 12.
+ *
+ * Convolve does the same with max |x| * sum |h| <= MAX_32.
+ *
+ * Autocorr energy is computed exactly in 64 bits: the ETSI overflow flag is raised iff
+ * 1 + energy > MAX_32 since all the terms are positive. Lag products are bounded by the
+ * energy (Cauchy-Schwarz) and cannot saturate either.
+ *
+ * Filters breaking the bound (unstable filters from corrupted frames) use the scalar code.
+ *
+ */
+
+static const int16_t LPC_ORDER    = 10;
+static const int32_t FILTER_BOUND = 61439;                                      // max sum |a[1..10]| without intermediate saturation
+static const int16_t CONV_MAX_LEN = 80;                                         // max convolution length handled by vector code
+static const int32_t ROUND_MIN    = -(1 << 27);
+static const int32_t ROUND_MAX    = (1 << 27) - 1;
+
+/**
+ * @brief Check that the filter coefficients guarantee no saturation
+ *
+ */
+
+static inline bool filter_is_bounded(const int16_t * a)
+{
+    int32_t sum = 0;
+
+    for (int16_t j = 1; j <= LPC_ORDER; j++)
+    {
+        sum += abs((int32_t)a[j]);
+    }
+
+    return sum <= FILTER_BOUND;
+}
+
+/**
+ * @brief Check that the convolution can't saturate
+ *
+ */
+
+static inline bool convolve_is_bounded(const int16_t * x, const int16_t * h, int16_t L)
+{
+    int64_t max_x = 0;
+    int64_t sum_h = 0;
+
+    for (int16_t i = 0; i < L; i++)
+    {
+        int64_t val = abs((int32_t)x[i]);
+        if (val > max_x) max_x = val;
+        sum_h += abs((int32_t)h[i]);
+    }
+
+    return max_x * sum_h <= (int64_t)MAX_32;
+}
+
+/**
+ * @brief Rounding and saturation of a bounded filter accumulator
+ *        equivalent to extract_h(L_shl(add_sh(s, 1, 11), 4))
+ *
+ */
+
+static inline int16_t filter_round(int32_t s)
+{
+    s += 2048;
+
+    if (s < ROUND_MIN) s = ROUND_MIN;
+    if (s > ROUND_MAX) s = ROUND_MAX;
+
+    return (int16_t)(s >> 12);
+}
+
+/*
+ * Scalar kernels (ETSI reference loops)
+ *
+ */
+
+static void syn_filt_scalar(const int16_t * a, const int16_t * x, int16_t * yy, int16_t lg)
+{
+    for (int16_t i = 0; i < lg; i++)
+    {
+        int32_t s = op_load_sh(x[i], (int16_t)12);                              // a[] is in Q12
+        for (int16_t j = 1; j <= LPC_ORDER; j++)
+            s = op_lmsu0(s, a[j], yy[i-j]);
+
+        s     = op_add_sh(s, (int16_t)1, (int16_t)11);                          // Rounding
+        yy[i] = op_extract_h(op_lshl(s, (int16_t)4));
+    }
+}
+
+static void residu_scalar(const int16_t * a, const int16_t * x, int16_t * y, int16_t lg)
+{
+    for (int16_t i = 0; i < lg; i++)
+    {
+        int32_t s = op_load_sh(x[i], (int16_t)12);
+        for (int16_t j = 1; j <= LPC_ORDER; j++)
+            s = op_lmac0(s, a[j], x[i-j]);
+
+        s = op_add_sh(s, (int16_t)1, (int16_t)11);                              // Rounding
+        s = op_lshl(s, (int16_t)4);                                             // Saturation
+        y[i] = op_extract_h(s);
+    }
+}
+
+static void convolve_scalar(const int16_t * x, const int16_t * h, int16_t * y, int16_t L)
+{
+    for (int16_t n = 0; n < L; n++)
+    {
+        int32_t s = 0;
+        for (int16_t i = 0; i <= n; i++)
+            s = op_lmac0(s, x[i], h[n-i]);
+
+        y[n] = op_store_hi(s, (int16_t)4);                                      // h is in Q12
+    }
+}
+
+static int64_t energy_scalar(const int16_t * y, int16_t len)
+{
+    int64_t sum = 0;
+
+    for (int16_t i = 0; i < len; i++)
+        sum += (int32_t)y[i] * (int32_t)y[i];
+
+    return sum;
+}
+
+static int64_t dot_scalar(const int16_t * x, const int16_t * y, int16_t len)
+{
+    int64_t sum = 0;
+
+    for (int16_t i = 0; i < len; i++)
+        sum += (int32_t)x[i] * (int32_t)y[i];
+
+    return sum;
+}
+
+static void post_process_scalar(int16_t * signal, int16_t lg)
+{
+    for (int16_t i = 0; i < lg; i++)
+        signal[i] = op_add(signal[i], signal[i]);
+}
+
+static const dsp_kernels_t KERNELS_SCALAR = {
+    "scalar",
+    syn_filt_scalar,
+    residu_scalar,
+    convolve_scalar,
+    energy_scalar,
+    dot_scalar,
+    post_process_scalar
+};
+
+#ifdef DSP_HAVE_X86
+
+/*
+ * SSE4.1 kernels
+ *
+ */
+
+DSP_TARGET_SSE41
+static inline int32_t hsum_epi32_sse41(__m128i acc)
+{
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4E));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xB1));
+
+    return _mm_cvtsi128_si32(acc);
+}
+
+DSP_TARGET_SSE41
+static inline __m128i filter_round_sse41(__m128i acc)
+{
+    acc = _mm_add_epi32(acc, _mm_set1_epi32(2048));
+    acc = _mm_max_epi32(acc, _mm_set1_epi32(ROUND_MIN));
+    acc = _mm_min_epi32(acc, _mm_set1_epi32(ROUND_MAX));
+
+    return _mm_srai_epi32(acc, 12);
+}
+
+DSP_TARGET_SSE41
+static void syn_filt_sse41(const int16_t * a, const int16_t * x, int16_t * yy, int16_t lg)
+{
+    if (!filter_is_bounded(a))
+    {
+        syn_filt_scalar(a, x, yy, lg);
+        return;
+    }
+
+    // recursive filter: one horizontal dot product per sample with reversed coefficients
+    // rev[k] multiplies yy[i - 10 + k]
+
+    int16_t rev[LPC_ORDER];
+    for (int16_t k = 0; k < LPC_ORDER; k++)
+    {
+        rev[k] = a[LPC_ORDER - k];
+    }
+
+    int32_t tail;
+    memcpy(&tail, rev + 8, sizeof(tail));
+
+    const __m128i coef_lo = _mm_loadu_si128((const __m128i *)rev);              // taps 10 to 3
+    const __m128i coef_hi = _mm_cvtsi32_si128(tail);                            // taps 2 and 1
+
+    for (int16_t i = 0; i < lg; i++)
+    {
+        memcpy(&tail, yy + i - 2, sizeof(tail));
+
+        __m128i acc = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(yy + i - LPC_ORDER)), coef_lo);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_cvtsi32_si128(tail), coef_hi));
+
+        yy[i] = filter_round((int32_t)x[i] * 4096 - hsum_epi32_sse41(acc));
+    }
+}
+
+DSP_TARGET_SSE41
+static void residu_sse41(const int16_t * a, const int16_t * x, int16_t * y, int16_t lg)
+{
+    if (!filter_is_bounded(a))
+    {
+        residu_scalar(a, x, y, lg);
+        return;
+    }
+
+    __m128i coef[LPC_ORDER + 1];
+    for (int16_t j = 1; j <= LPC_ORDER; j++)
+    {
+        coef[j] = _mm_set1_epi32(a[j]);
+    }
+
+    int16_t i = 0;
+
+    for (; i + 4 <= lg; i += 4)                                                 // 4 outputs per iteration
+    {
+        __m128i acc = _mm_slli_epi32(_mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)(x + i))), 12);
+
+        for (int16_t j = 1; j <= LPC_ORDER; j++)
+        {
+            __m128i xv = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)(x + i - j)));
+            acc = _mm_add_epi32(acc, _mm_mullo_epi32(coef[j], xv));
+        }
+
+        acc = filter_round_sse41(acc);
+        _mm_storel_epi64((__m128i *)(y + i), _mm_packs_epi32(acc, acc));
+    }
+
+    for (; i < lg; i++)
+    {
+        int32_t s = (int32_t)x[i] * 4096;
+        for (int16_t j = 1; j <= LPC_ORDER; j++)
+            s += (int32_t)a[j] * (int32_t)x[i-j];
+
+        y[i] = filter_round(s);
+    }
+}
+
+DSP_TARGET_SSE41
+static void convolve_sse41(const int16_t * x, const int16_t * h, int16_t * y, int16_t L)
+{
+    if ((L > CONV_MAX_LEN) || !convolve_is_bounded(x, h, L))
+    {
+        convolve_scalar(x, h, y, L);
+        return;
+    }
+
+    // h is preceded by zeros so that lanes with n - i < 0 don't contribute
+
+    int16_t hpad[8 + CONV_MAX_LEN] = {0};
+    memcpy(hpad + 8, h, L * sizeof(int16_t));
+    const int16_t * hp = hpad + 8;
+
+    int16_t n = 0;
+
+    for (; n + 4 <= L; n += 4)
+    {
+        __m128i acc = _mm_setzero_si128();
+
+        for (int16_t i = 0; i < n + 4; i++)
+        {
+            __m128i hv = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)(hp + n - i)));
+            acc = _mm_add_epi32(acc, _mm_mullo_epi32(_mm_set1_epi32(x[i]), hv));
+        }
+
+        acc = _mm_srai_epi32(_mm_slli_epi32(_mm_srai_epi32(acc, 12), 16), 16);  // store_hi() keeps the low 16 bits
+        _mm_storel_epi64((__m128i *)(y + n), _mm_packs_epi32(acc, acc));
+    }
+
+    for (; n < L; n++)
+    {
+        int32_t s = 0;
+        for (int16_t i = 0; i <= n; i++)
+            s += (int32_t)x[i] * (int32_t)hp[n-i];
+
+        y[n] = (int16_t)(s >> 12);
+    }
+}
+
+DSP_TARGET_SSE41
+static int64_t energy_sse41(const int16_t * y, int16_t len)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    int16_t i = 0;
+
+    for (; i + 8 <= len; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(y + i));
+        __m128i m = _mm_madd_epi16(v, v);                                       // positive, up to 2^31: read as unsigned
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(m, zero));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(m, zero));
+    }
+
+    int64_t sum = _mm_extract_epi64(acc, 0) + _mm_extract_epi64(acc, 1);
+
+    return sum + energy_scalar(y + i, len - i);
+}
+
+DSP_TARGET_SSE41
+static int64_t dot_sse41(const int16_t * x, const int16_t * y, int16_t len)
+{
+    const __m128i wrap_val = _mm_set1_epi32(MIN_32);
+    const __m128i wrap_fix = _mm_set1_epi64x((int64_t)1 << 32);
+    __m128i acc = _mm_setzero_si128();
+    int16_t i = 0;
+
+    for (; i + 8 <= len; i += 8)
+    {
+        __m128i m = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(x + i)), _mm_loadu_si128((const __m128i *)(y + i)));
+        __m128i w = _mm_cmpeq_epi32(m, wrap_val);                               // only -32768^2 * 2 wraps, to MIN_32
+
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(m));
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(m, 8)));
+        acc = _mm_add_epi64(acc, _mm_and_si128(_mm_cvtepi32_epi64(w), wrap_fix));
+        acc = _mm_add_epi64(acc, _mm_and_si128(_mm_cvtepi32_epi64(_mm_srli_si128(w, 8)), wrap_fix));
+    }
+
+    int64_t sum = _mm_extract_epi64(acc, 0) + _mm_extract_epi64(acc, 1);
+
+    return sum + dot_scalar(x + i, y + i, len - i);
+}
+
+DSP_TARGET_SSE41
+static void post_process_sse41(int16_t * signal, int16_t lg)
+{
+    int16_t i = 0;
+
+    for (; i + 8 <= lg; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(signal + i));
+        _mm_storeu_si128((__m128i *)(signal + i), _mm_adds_epi16(v, v));
+    }
+
+    post_process_scalar(signal + i, lg - i);
+}
+
+static const dsp_kernels_t KERNELS_SSE41 = {
+    "sse4.1",
+    syn_filt_sse41,
+    residu_sse41,
+    convolve_sse41,
+    energy_sse41,
+    dot_sse41,
+    post_process_sse41
+};
+
+/*
+ * AVX2 kernels
+ *
+ * Syn_Filt is recursive with only 10 taps and keeps the SSE4.1 version
+ *
+ */
+
+DSP_TARGET_AVX2
+static inline __m128i pack_epi32_avx2(__m256i acc)
+{
+    return _mm_packs_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+}
+
+DSP_TARGET_AVX2
+static void residu_avx2(const int16_t * a, const int16_t * x, int16_t * y, int16_t lg)
+{
+    if (!filter_is_bounded(a))
+    {
+        residu_scalar(a, x, y, lg);
+        return;
+    }
+
+    __m256i coef[LPC_ORDER + 1];
+    for (int16_t j = 1; j <= LPC_ORDER; j++)
+    {
+        coef[j] = _mm256_set1_epi32(a[j]);
+    }
+
+    const __m256i round = _mm256_set1_epi32(2048);
+    const __m256i lo    = _mm256_set1_epi32(ROUND_MIN);
+    const __m256i hi    = _mm256_set1_epi32(ROUND_MAX);
+    int16_t i = 0;
+
+    for (; i + 8 <= lg; i += 8)                                                 // 8 outputs per iteration
+    {
+        __m256i acc = _mm256_slli_epi32(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(x + i))), 12);
+
+        for (int16_t j = 1; j <= LPC_ORDER; j++)
+        {
+            __m256i xv = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(x + i - j)));
+            acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(coef[j], xv));
+        }
+
+        acc = _mm256_add_epi32(acc, round);
+        acc = _mm256_min_epi32(_mm256_max_epi32(acc, lo), hi);
+        acc = _mm256_srai_epi32(acc, 12);
+        _mm_storeu_si128((__m128i *)(y + i), pack_epi32_avx2(acc));
+    }
+
+    for (; i < lg; i++)
+    {
+        int32_t s = (int32_t)x[i] * 4096;
+        for (int16_t j = 1; j <= LPC_ORDER; j++)
+            s += (int32_t)a[j] * (int32_t)x[i-j];
+
+        y[i] = filter_round(s);
+    }
+}
+
+DSP_TARGET_AVX2
+static void convolve_avx2(const int16_t * x, const int16_t * h, int16_t * y, int16_t L)
+{
+    if ((L > CONV_MAX_LEN) || !convolve_is_bounded(x, h, L))
+    {
+        convolve_scalar(x, h, y, L);
+        return;
+    }
+
+    int16_t hpad[8 + CONV_MAX_LEN] = {0};
+    memcpy(hpad + 8, h, L * sizeof(int16_t));
+    const int16_t * hp = hpad + 8;
+
+    int16_t n = 0;
+
+    for (; n + 8 <= L; n += 8)
+    {
+        __m256i acc = _mm256_setzero_si256();
+
+        for (int16_t i = 0; i < n + 8; i++)
+        {
+            __m256i hv = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(hp + n - i)));
+            acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(_mm256_set1_epi32(x[i]), hv));
+        }
+
+        acc = _mm256_srai_epi32(_mm256_slli_epi32(_mm256_srai_epi32(acc, 12), 16), 16);
+        _mm_storeu_si128((__m128i *)(y + n), pack_epi32_avx2(acc));
+    }
+
+    for (; n < L; n++)
+    {
+        int32_t s = 0;
+        for (int16_t i = 0; i <= n; i++)
+            s += (int32_t)x[i] * (int32_t)hp[n-i];
+
+        y[n] = (int16_t)(s >> 12);
+    }
+}
+
+DSP_TARGET_AVX2
+static int64_t energy_avx2(const int16_t * y, int16_t len)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc = zero;
+    int16_t i = 0;
+
+    for (; i + 16 <= len; i += 16)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(y + i));
+        __m256i m = _mm256_madd_epi16(v, v);
+        acc = _mm256_add_epi64(acc, _mm256_unpacklo_epi32(m, zero));
+        acc = _mm256_add_epi64(acc, _mm256_unpackhi_epi32(m, zero));
+    }
+
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+
+    return _mm_extract_epi64(sum, 0) + _mm_extract_epi64(sum, 1) + energy_scalar(y + i, len - i);
+}
+
+DSP_TARGET_AVX2
+static int64_t dot_avx2(const int16_t * x, const int16_t * y, int16_t len)
+{
+    const __m256i wrap_val = _mm256_set1_epi32(MIN_32);
+    const __m256i wrap_fix = _mm256_set1_epi64x((int64_t)1 << 32);
+    __m256i acc = _mm256_setzero_si256();
+    int16_t i = 0;
+
+    for (; i + 16 <= len; i += 16)
+    {
+        __m256i m = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i *)(x + i)), _mm256_loadu_si256((const __m256i *)(y + i)));
+        __m256i w = _mm256_cmpeq_epi32(m, wrap_val);
+
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(m)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(m, 1)));
+        acc = _mm256_add_epi64(acc, _mm256_and_si256(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(w)), wrap_fix));
+        acc = _mm256_add_epi64(acc, _mm256_and_si256(_mm256_cvtepi32_epi64(_mm256_extracti128_si256(w, 1)), wrap_fix));
+    }
+
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+
+    return _mm_extract_epi64(sum, 0) + _mm_extract_epi64(sum, 1) + dot_scalar(x + i, y + i, len - i);
+}
+
+DSP_TARGET_AVX2
+static void post_process_avx2(int16_t * signal, int16_t lg)
+{
+    int16_t i = 0;
+
+    for (; i + 16 <= lg; i += 16)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(signal + i));
+        _mm256_storeu_si256((__m256i *)(signal + i), _mm256_adds_epi16(v, v));
+    }
+
+    post_process_scalar(signal + i, lg - i);
+}
+
+static const dsp_kernels_t KERNELS_AVX2 = {
+    "avx2",
+    syn_filt_sse41,
+    residu_avx2,
+    convolve_avx2,
+    energy_avx2,
+    dot_avx2,
+    post_process_avx2
+};
+
+#endif /* DSP_HAVE_X86 */
+
+/**
+ * @brief Scalar kernels, always available
+ *
+ */
+
+const dsp_kernels_t * codec_sdecoder::dsp_kernels_scalar()
+{
+    return &KERNELS_SCALAR;
+}
+
+/**
+ * @brief SSE4.1 kernels if supported by the running CPU, NULL otherwise
+ *
+ */
+
+const dsp_kernels_t * codec_sdecoder::dsp_kernels_sse41()
+{
+#ifdef DSP_HAVE_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("sse4.1"))
+    {
+        return &KERNELS_SSE41;
+    }
+#endif
+
+    return NULL;
+}
+
+/**
+ * @brief AVX2 kernels if supported by the running CPU, NULL otherwise
+ *        (AVX2 kernels also use SSE4.1 for the synthesis filter)
+ *
+ */
+
+const dsp_kernels_t * codec_sdecoder::dsp_kernels_avx2()
+{
+#ifdef DSP_HAVE_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("sse4.1"))
+    {
+        return &KERNELS_AVX2;
+    }
+#endif
+
+    return NULL;
+}
+
+/**
+ * @brief Select the best kernels for the running CPU
+ *
+ */
+
+const dsp_kernels_t * codec_sdecoder::dsp_kernels_select()
+{
+    const dsp_kernels_t * kernels = dsp_kernels_avx2();
+
+    if (kernels == NULL)
+    {
+        kernels = dsp_kernels_sse41();
+    }
+
+    if (kernels == NULL)
+    {
+        kernels = dsp_kernels_scalar();
+    }
+
+    return kernels;
+}
@@ -0,0 +1,40 @@
+#ifndef SDECODER_SIMD_H
+#define SDECODER_SIMD_H
+#include <stdint.h>
+
+namespace codec_sdecoder {
+
+    /**
+     * @brief Inner loops of the speech decoder filters
+     *
+     * Every implementation is bit-exact with the scalar ETSI code: vector versions compute
+     * the accumulations exactly in 32 bits lanes when the coefficients bound proves that
+     * no intermediate saturation can occur, otherwise they fall back to the scalar loop
+     * with saturating L_mac/L_msu.
+     *
+     */
+
+    struct dsp_kernels_t {
+        const char * name;
+
+        // y[i] = 1/A(z) filtering, yy[-PP..-1] holds the filter memory, lg <= 70
+        void    (*syn_filt)(const int16_t * a, const int16_t * x, int16_t * yy, int16_t lg);
+        // y[i] = A(z) filtering, x[-PP..-1] must be valid
+        void    (*residu)(const int16_t * a, const int16_t * x, int16_t * y, int16_t lg);
+        // y[n] = sum x[i] * h[n-i] with h in Q12, L <= 80
+        void    (*convolve)(const int16_t * x, const int16_t * h, int16_t * y, int16_t L);
+        // exact sum of squares (may exceed 32 bits)
+        int64_t (*energy)(const int16_t * y, int16_t len);
+        // exact correlation sum x[j] * y[j]
+        int64_t (*dot)(const int16_t * x, const int16_t * y, int16_t len);
+        // signal[i] = add(signal[i], signal[i])
+        void    (*post_process)(int16_t * signal, int16_t lg);
+    };
+
+    const dsp_kernels_t * dsp_kernels_scalar();
+    const dsp_kernels_t * dsp_kernels_sse41();                                  // NULL if not available on this target
+    const dsp_kernels_t * dsp_kernels_avx2();                                   // NULL if not available on this target
+    const dsp_kernels_t * dsp_kernels_select();                                 // best kernels supported by running CPU
+}
+
+#endif /* SDECODER_SIMD_H */
@@ -0,0 +1,319 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "audio_output.h"
+
+/**
+ * @brief Store 16 bits value in little endian order
+ *
+ */
+
+static void put_le16(uint8_t * buf, uint16_t val)
+{
+    buf[0] = (uint8_t)(val & 0xff);
+    buf[1] = (uint8_t)(val >> 8);
+}
+
+/**
+ * @brief Store 32 bits value in little endian order
+ *
+ */
+
+static void put_le32(uint8_t * buf, uint32_t val)
+{
+    buf[0] = (uint8_t)(val & 0xff);
+    buf[1] = (uint8_t)(val >> 8);
+    buf[2] = (uint8_t)(val >> 16);
+    buf[3] = (uint8_t)(val >> 24);
+}
+
+/**
+ * @brief Write samples as signed 16 bits little endian
+ *
+ */
+
+static bool write_pcm_le16(FILE * file, const int16_t * samples, uint32_t count)
+{
+    uint8_t buf[2 * 480];                                                       // one TETRA frame is 2 * 240 samples
+    uint32_t done = 0;
+
+    while (done < count)
+    {
+        uint32_t len = count - done;
+        if (len > 480)
+        {
+            len = 480;
+        }
+
+        for (uint32_t idx = 0; idx < len; idx++)
+        {
+            put_le16(buf + 2 * idx, (uint16_t)samples[done + idx]);
+        }
+
+        if (fwrite(buf, 2, len, file) != len)
+        {
+            return false;
+        }
+
+        done += len;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Raw encoder constructor
+ *
+ */
+
+raw_encoder_t::raw_encoder_t()
+{
+    m_file = NULL;
+}
+
+/**
+ * @brief Raw encoder destructor
+ *
+ */
+
+raw_encoder_t::~raw_encoder_t()
+{
+    close();
+}
+
+/**
+ * @brief Open raw output file in append mode
+ *
+ */
+
+bool raw_encoder_t::open(const std::string file_name)
+{
+    close();
+
+    m_file = fopen(file_name.c_str(), "ab");
+
+    return m_file != NULL;
+}
+
+/**
+ * @brief Append samples to raw file
+ *
+ */
+
+bool raw_encoder_t::write(const int16_t * samples, uint32_t count)
+{
+    if (m_file == NULL) return false;
+
+    bool ret = write_pcm_le16(m_file, samples, count);
+    fflush(m_file);                                                             // keep live listening (raw2play.sh) possible
+
+    return ret;
+}
+
+/**
+ * @brief Close raw file
+ *
+ */
+
+void raw_encoder_t::close()
+{
+    if (m_file != NULL)
+    {
+        fclose(m_file);
+        m_file = NULL;
+    }
+}
+
+/**
+ * @brief Raw file extension
+ *
+ */
+
+const char * raw_encoder_t::extension()
+{
+    return "raw";
+}
+
+/**
+ * @brief WAV encoder constructor
+ *
+ */
+
+wav_encoder_t::wav_encoder_t()
+{
+    m_file        = NULL;
+    m_data_len    = 0;
+    m_write_count = 0;
+}
+
+/**
+ * @brief WAV encoder destructor
+ *
+ */
+
+wav_encoder_t::~wav_encoder_t()
+{
+    close();
+}
+
+/**
+ * @brief Create WAV file and write header with empty sizes
+ *
+ */
+
+bool wav_encoder_t::open(const std::string file_name)
+{
+    close();
+
+    m_file = fopen(file_name.c_str(), "wb");
+
+    if (m_file == NULL) return false;
+
+    m_data_len    = 0;
+    m_write_count = 0;
+    write_header();
+
+    return true;
+}
+
+/**
+ * @brief Write canonical 44 bytes PCM header - sizes are patched later
+ *
+ */
+
+void wav_encoder_t::write_header()
+{
+    const uint16_t channels        = 1;
+    const uint16_t bits_per_sample = 16;
+    const uint16_t block_align     = channels * bits_per_sample / 8;
+
+    uint8_t hdr[HEADER_LEN];
+
+    hdr[0] = 'R'; hdr[1] = 'I'; hdr[2] = 'F'; hdr[3] = 'F';
+    put_le32(hdr + 4, HEADER_LEN - 8 + m_data_len);                             // RIFF chunk size
+    hdr[8] = 'W'; hdr[9] = 'A'; hdr[10] = 'V'; hdr[11] = 'E';
+
+    hdr[12] = 'f'; hdr[13] = 'm'; hdr[14] = 't'; hdr[15] = ' ';
+    put_le32(hdr + 16, 16);                                                     // fmt chunk size
+    put_le16(hdr + 20, 1);                                                      // PCM
+    put_le16(hdr + 22, channels);
+    put_le32(hdr + 24, SAMPLE_RATE);
+    put_le32(hdr + 28, SAMPLE_RATE * block_align);                              // byte rate
+    put_le16(hdr + 32, block_align);
+    put_le16(hdr + 34, bits_per_sample);
+
+    hdr[36] = 'd'; hdr[37] = 'a'; hdr[38] = 't'; hdr[39] = 'a';
+    put_le32(hdr + 40, m_data_len);                                             // data chunk size
+
+    fwrite(hdr, 1, HEADER_LEN, m_file);
+}
+
+/**
+ * @brief Rewrite RIFF and data chunk sizes then go back to end of file
+ *
+ */
+
+void wav_encoder_t::patch_sizes()
+{
+    uint8_t buf[4];
+
+    fseek(m_file, 4, SEEK_SET);
+    put_le32(buf, HEADER_LEN - 8 + m_data_len);
+    fwrite(buf, 1, 4, m_file);
+
+    fseek(m_file, 40, SEEK_SET);
+    put_le32(buf, m_data_len);
+    fwrite(buf, 1, 4, m_file);
+
+    fseek(m_file, 0, SEEK_END);
+    fflush(m_file);
+}
+
+/**
+ * @brief Append samples to data chunk
+ *
+ */
+
+bool wav_encoder_t::write(const int16_t * samples, uint32_t count)
+{
+    if (m_file == NULL) return false;
+
+    bool ret = write_pcm_le16(m_file, samples, count);
+
+    if (ret)
+    {
+        m_data_len += 2 * count;
+    }
+
+    m_write_count++;
+    if (m_write_count % PATCH_INTERVAL == 0)
+    {
+        patch_sizes();
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Patch final sizes and close WAV file
+ *
+ */
+
+void wav_encoder_t::close()
+{
+    if (m_file != NULL)
+    {
+        patch_sizes();
+        fclose(m_file);
+        m_file = NULL;
+    }
+}
+
+/**
+ * @brief WAV file extension
+ *
+ */
+
+const char * wav_encoder_t::extension()
+{
+    return "wav";
+}
+
+/**
+ * @brief Create an encoder for the requested audio format
+ *
+ */
+
+audio_encoder_t * audio_encoder_create(int audio_format)
+{
+    audio_encoder_t * ret = NULL;
+
+    switch (audio_format)
+    {
+    case AUDIO_FORMAT_WAV:
+        ret = new wav_encoder_t();
+        break;
+
+    case AUDIO_FORMAT_RAW:
+    default:
+        ret = new raw_encoder_t();
+        break;
+    }
+
+    return ret;
+}
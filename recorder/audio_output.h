@@ -0,0 +1,106 @@
+/*
+ *  tetra-kit
+ *  Copyright (C) 2020  LarryTh <dev@logami.fr>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef AUDIO_OUTPUT_H
+#define AUDIO_OUTPUT_H
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+/**
+ * @brief Audio output formats available for decoded speech
+ *
+ */
+
+enum audio_format_t {
+    AUDIO_FORMAT_RAW = 0,                                                       // headerless signed 16 bits little endian PCM (.raw)
+    AUDIO_FORMAT_WAV = 1                                                        // RIFF/WAVE PCM (.wav)
+};
+
+/**
+ * @brief Streaming audio encoder interface
+ *
+ * The file is kept open for the whole record, samples are 8 kHz mono signed 16 bits
+ * as produced by the TETRA speech decoder. New compressed formats (ogg/opus...)
+ * have only to implement this interface and be added to audio_encoder_create().
+ *
+ */
+
+class audio_encoder_t {
+public:
+    virtual ~audio_encoder_t() {}
+
+    virtual bool open(const std::string file_name) = 0;                         ///< Create the output file (file name includes extension)
+    virtual bool write(const int16_t * samples, uint32_t count) = 0;            ///< Append samples to the output
+    virtual void close() = 0;                                                   ///< Finalize and close the output
+    virtual const char * extension() = 0;                                       ///< File extension without dot
+
+    static const uint32_t SAMPLE_RATE = 8000;                                   ///< TETRA speech codec sampling rate [Hz]
+};
+
+/**
+ * @brief Headerless PCM encoder (.raw), same output as previous recorder versions
+ *
+ */
+
+class raw_encoder_t : public audio_encoder_t {
+public:
+    raw_encoder_t();
+    ~raw_encoder_t();
+
+    bool open(const std::string file_name);
+    bool write(const int16_t * samples, uint32_t count);
+    void close();
+    const char * extension();
+
+private:
+    FILE * m_file;
+};
+
+/**
+ * @brief WAV encoder writing RIFF header at open and streaming PCM samples.
+ *        Header sizes are patched on close, and also periodically so an
+ *        interrupted record is still playable.
+ *
+ */
+
+class wav_encoder_t : public audio_encoder_t {
+public:
+    wav_encoder_t();
+    ~wav_encoder_t();
+
+    bool open(const std::string file_name);
+    bool write(const int16_t * samples, uint32_t count);
+    void close();
+    const char * extension();
+
+private:
+    static const uint32_t HEADER_LEN     = 44;                                  ///< canonical PCM WAV header length [bytes]
+    static const uint32_t PATCH_INTERVAL = 50;                                  ///< patch header sizes every N writes (50 TETRA frames = 3 s)
+
+    FILE *   m_file;
+    uint32_t m_data_len;                                                        ///< PCM data written [bytes]
+    uint32_t m_write_count;
+
+    void write_header();
+    void patch_sizes();
+};
+
+audio_encoder_t * audio_encoder_create(int audio_format);
+
+#endif /* AUDIO_OUTPUT_H */
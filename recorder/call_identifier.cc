@@ -25,11 +25,13 @@
  *
  */
 
-call_identifier_t::call_identifier_t(uint32_t cid)
+call_identifier_t::call_identifier_t(uint32_t cid, int audio_format, const std::string label)
 {
     m_cid           = cid;
+    m_label         = label;
     m_usage_marker  = 0;
     m_data_received = 0.;
+    m_audio_format  = audio_format;
 
     m_ssi.clear();
 
@@ -40,6 +42,7 @@ call_identifier_t::call_identifier_t(uint32_t cid)
     {
         m_file_name[cnt]         = "";
         m_last_traffic_time[cnt] = now;
+        m_output[cnt]            = NULL;
     }
 
     audio = new audio_decoder();
@@ -55,9 +58,41 @@ call_identifier_t::~call_identifier_t()
 {
     m_ssi.clear();
 
+    for (int cnt = 0; cnt < MAX_USAGES; cnt++)
+    {
+        release_output(cnt);                                                    // finalize files still recording
+    }
+
     if (audio) delete audio;
 }
 
+/**
+ * @brief Close the speech output of a usage marker and reset its file name
+ *        so the next traffic starts a new record
+ *
+ */
+
+void call_identifier_t::release_output(int usage_marker)
+{
+    if (m_output[usage_marker] != NULL)
+    {
+        delete m_output[usage_marker];                                          // encoder closes (and finalizes) the file
+        m_output[usage_marker] = NULL;
+    }
+
+    m_file_name[usage_marker] = "";
+}
+
+/**
+ * @brief Prefix for output file names, to keep CID of different inputs apart
+ *
+ */
+
+std::string call_identifier_t::file_prefix()
+{
+    return m_label.empty() ? "" : m_label + "_";
+}
+
 /**
  * @brief Clean up the usage marker which were recording but
  *        has not been updated for TIMEOUT_RELEASE_S. This
@@ -74,9 +109,9 @@ void call_identifier_t::clean_up()
 
     for (int cnt = 0; cnt < MAX_USAGES; cnt++)
     {
-        if (difftime(now, m_last_traffic_time[m_usage_marker]) > TIMEOUT_RELEASE_S) // check if timeout exceed predefined value
+        if ((m_file_name[cnt] != "") && (difftime(now, m_last_traffic_time[cnt]) > TIMEOUT_RELEASE_S)) // check if timeout exceed predefined value
         {
-            m_file_name[m_usage_marker] = "";                                       // reset the file name to release the marker
+            release_output(cnt);                                                // close the file and reset its name to release the marker
         }
     }
 
@@ -109,7 +144,7 @@ void call_identifier_t::push_traffic(const char * data, uint32_t len)
         char tmp[16]       = "";
 
         strftime(tmp, 16, "%Y%m%d_%H%M%S", timeinfo);                                             // get time
-        snprintf(filename, sizeof(filename), "out/%s_%06u_%02u.out", tmp, m_cid, m_usage_marker); // create file filename
+        snprintf(filename, sizeof(filename), "out/%s%s_%06u_%02u.out", file_prefix().c_str(), tmp, m_cid, m_usage_marker); // create file filename
 
         m_file_name[m_usage_marker] = filename;
         m_data_received = 0.;
@@ -124,24 +159,23 @@ void call_identifier_t::push_traffic(const char * data, uint32_t len)
 }
 
 /**
- * @brief Push traffic in raw format to this CID taking care of TIMEOUT_S
- *        If timeout exceeded, a new file is created.
- *        This function store also data received in Kb
+ * @brief Prepare the current usage marker to receive a decoded speech frame:
+ *        handle TIMEOUT_S, create the output file and reset the codec when a
+ *        new record starts. The frame is then decoded in a batch with other
+ *        CID and written with write_traffic_raw() (see cid_flush_traffic)
  *
- *        TODO add switch feedback from main class to be activated from cid,
- *        so audio raw output can be sent also to speakers
  */
 
-void call_identifier_t::push_traffic_raw(const char * data, uint32_t len)
+void call_identifier_t::prepare_traffic_raw()
 {
     time_t now;
     time(&now);
 
     // NOTE: the follwing part shouldn't be necessary anymore since cid_clean_up()
-    // is ran to handle the timeouts every PDU received
+    // is ran periodically to handle the timeouts
     if (difftime(now, m_last_traffic_time[m_usage_marker]) > TIMEOUT_S)         // check if timeout exceed predefined value
     {
-        m_file_name[m_usage_marker] = "";                                       // force to start a new record since timeout
+        release_output(m_usage_marker);                                         // force to start a new record since timeout
     }
 
     m_last_traffic_time[m_usage_marker] = now;
@@ -154,34 +188,48 @@ void call_identifier_t::push_traffic_raw(const char * data, uint32_t len)
         char filename[512] = "";
         char tmp[16]       = "";
 
-        strftime(tmp, 16, "%Y%m%d_%H%M%S", timeinfo);                                             // get time
-        snprintf(filename, sizeof(filename), "raw/%s_%06u_%02u.raw", tmp, m_cid, m_usage_marker); // create file filename
+        audio_encoder_t * output = audio_encoder_create(m_audio_format);
+        const char * ext = output->extension();                                 // output folder has the same name as the extension (raw/ or wav/)
 
+        strftime(tmp, 16, "%Y%m%d_%H%M%S", timeinfo);                                                   // get time
+        snprintf(filename, sizeof(filename), "%s/%s%s_%06u_%02u.%s", ext, file_prefix().c_str(), tmp, m_cid, m_usage_marker, ext); // create file filename
+
+        if (!output->open(filename))
+        {
+            fprintf(stderr, "Couldn't open speech output file '%s'\n", filename);
+        }
+
+        m_output[m_usage_marker]    = output;
         m_file_name[m_usage_marker] = filename;
         m_data_received = 0.;
 
         audio->init();                                                          // init Tetra audio plugins
     }
+}
+
+/**
+ * @brief Write a valid decoded speech frame to the output of the usage marker
+ *        it was received with
+ *
+ */
 
-    // DEBUG audio
-    // string filename_debug = m_file_name[m_usage_marker] + ".cod";
-    // FILE * file = fopen(filename_debug.c_str(), "ab");
-    // audio->process_frame_debug(file, (int16_t *)data, raw_output, 0);
-    // fflush(file);
-    // fclose(file);
+void call_identifier_t::write_traffic_raw(uint8_t usage_marker, const int16_t * raw_output, uint32_t len)
+{
+    if (m_output[usage_marker] == NULL) return;                                 // output released meanwhile
 
-    int16_t raw_output[480];
+    m_output[usage_marker]->write(raw_output, 480);                             // 2 speech frames of 240 elements
 
-    // TODO for now, there is no stealing frame handling (always 0)
-    if (audio->process_frame((int16_t *)data, raw_output, 0))                   // check if raw output is valid
-    {
-        FILE * file = fopen(m_file_name[m_usage_marker].c_str(), "ab");
-        fwrite(raw_output, 2, 480, file);                                       // 2 speech frames of 240 elements * sizeof(int16_t)
-        fflush(file);
-        fclose(file);
+    m_data_received += len / 1000.;
+}
 
-        m_data_received += len / 1000.;
-    }
+/**
+ * @brief Tetra voice decoder of this CID
+ *
+ */
+
+audio_decoder * call_identifier_t::decoder()
+{
+    return audio;
 }
 
 /**
@@ -19,9 +19,11 @@
 #ifndef CALLIDENTIFIER_H
 #define CALLIDENTIFIER_H
 #include <cstdint>
+#include <ctime>
 #include <string>
 #include <vector>
 #include <audio_decoder.h>
+#include "audio_output.h"
 
 /**
  * @brief Call identifier class
@@ -32,10 +34,11 @@
 
 class call_identifier_t {
 public:
-    call_identifier_t(uint32_t cid);
+    call_identifier_t(uint32_t cid, int audio_format, const std::string label);
     ~call_identifier_t();
 
     uint32_t m_cid;                                                             ///< CID value
+    std::string m_label;                                                        ///< Input label (namespace) of this CID, may be empty
     uint8_t m_usage_marker;                                                     ///< Usage marker
     double m_data_received;                                                     ///< Data received in Kb
 
@@ -47,14 +50,21 @@ public:
     time_t m_last_traffic_time[MAX_USAGES];                                     ///< Last traffic seen to know when to start new record
 
     std::vector<ssi_t> m_ssi;                                                   ///< List of SSI associated with this cid
+    audio_encoder_t * m_output[MAX_USAGES];                                     ///< Speech output per usage marker (kept open while recording)
 
     void clean_up();                                                            ///< Garbage collector release the traffic usage marker when timeout exceeds TIMEOUT_RELEASE_S
     void push_traffic(const char * data, uint32_t len);
-    void push_traffic_raw(const char * data, uint32_t len);
+    void prepare_traffic_raw();                                                 ///< Timeout, output file and codec reset before decoding a frame
+    void write_traffic_raw(uint8_t usage_marker, const int16_t * raw_output, uint32_t len);
+    audio_decoder * decoder();
     void update_usage_marker(uint8_t usage_marker);
 
 private:
     audio_decoder * audio = NULL;                                               ///< Tetra voice decoder
+    int m_audio_format;                                                         ///< Speech output format (see audio_format_t)
+
+    void release_output(int usage_marker);
+    std::string file_prefix();
 };
 
 
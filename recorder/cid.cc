@@ -1,4 +1,6 @@
 #include <cstdint>
+#include <cstring>
+#include <algorithm>
 #include <zlib.h>
 #include "base64.h"
 #include "cid.h"
@@ -8,22 +10,53 @@
 #include "utils.h"
 
 /**
- * @brief Internal call identifiers list
+ * @brief Internal call identifiers namespaces, one per input
  *
  */
 
-static std::vector<call_identifier_t *> cid_list;
+static std::vector<cid_context_t *> g_contexts;
 static int g_raw_format_flag = 0;
+static int g_audio_format    = AUDIO_FORMAT_RAW;
+static json_parser_t g_json_parser;                                             // Json parser reused for every message
+
+/**
+ * @brief Speech frames waiting to be decoded together by cid_flush_traffic().
+ *        A CID appears at most once since its frames must be decoded in order
+ *
+ */
+
+struct traffic_queue_t {
+    static const int FRAME_LEN = 690;                                           // input frame length in int16_t
+
+    int count;
+    call_identifier_t * cid[audio_batch_t::MAX_FRAMES];
+    uint8_t  usage_marker[audio_batch_t::MAX_FRAMES];                           // usage marker when the frame was received
+    uint32_t len[audio_batch_t::MAX_FRAMES];                                    // received length for statistics
+    int16_t  frame_stealing_flag[audio_batch_t::MAX_FRAMES];                    // 1 if first half slot is stolen
+    int16_t  frame[audio_batch_t::MAX_FRAMES][FRAME_LEN];
+    int16_t  raw_output[audio_batch_t::MAX_FRAMES][480];
+};
+
+static traffic_queue_t g_traffic_queue;
+static uint64_t g_traffic_batches = 0;                                          // batches decoded, for mean batch size
+static uint64_t g_traffic_frames  = 0;                                          // frames decoded in batches
 
 /**
  * @brief Initialize CID list
  *
  */
 
-void cid_init(int raw_format_flag)
+void cid_init(int raw_format_flag, int audio_format, const std::vector<std::string> & labels)
 {
     g_raw_format_flag = raw_format_flag;
-    cid_list.clear();
+    g_audio_format    = audio_format;
+
+    for (std::size_t idx = 0; idx < labels.size(); idx++)
+    {
+        cid_context_t * ctx = new cid_context_t;
+        ctx->label = labels[idx];
+        g_contexts.push_back(ctx);
+    }
 
     // if (g_raw_format_flag)
     // {
@@ -69,9 +102,18 @@ void cid_init(int raw_format_flag)
 
 void cid_clear()
 {
-    for (std::vector<call_identifier_t *>::iterator iter = cid_list.begin(); iter != cid_list.end(); ++iter)
+    cid_flush_traffic();                                                        // write pending frames before closing files
+
+    for (std::size_t idx = 0; idx < g_contexts.size(); idx++)
     {
-        delete *iter;                                                           // delete the call_identifier_t class
+        std::vector<call_identifier_t *> & cid_list = g_contexts[idx]->cid_list;
+
+        for (std::vector<call_identifier_t *>::iterator iter = cid_list.begin(); iter != cid_list.end(); ++iter)
+        {
+            delete *iter;                                                       // delete the call_identifier_t class
+        }
+
+        delete g_contexts[idx];
     }
 
     // if (g_raw_format_flag)
@@ -80,11 +122,12 @@ void cid_clear()
     //     ao_shutdown();
     // }
 
-    cid_list.clear();
+    g_contexts.clear();
 }
 
 /**
- * @brief API to access to CID list from other modules
+ * @brief API to access to CID list from other modules. The index runs over
+ *        the CID of all namespaces, in inputs order
  *
  */
 
@@ -92,17 +135,43 @@ call_identifier_t * get_cid(int index)
 {
     call_identifier_t * res = NULL;
 
-    if (cid_list.size() > 0)
+    for (std::size_t idx = 0; (idx < g_contexts.size()) && (index >= 0); idx++)
     {
-        if (index < (int)cid_list.size())
+        if (index < (int)g_contexts[idx]->cid_list.size())
         {
-            res = cid_list[index];
+            res = g_contexts[idx]->cid_list[index];
+            break;
         }
+
+        index -= (int)g_contexts[idx]->cid_list.size();
     }
 
     return res;
 }
 
+/**
+ * @brief Return the namespace of an input label, created when first seen.
+ *        Replayed logs may hold lines of several inputs
+ *
+ */
+
+static int cid_context_by_label(const std::string & label)
+{
+    for (std::size_t idx = 0; idx < g_contexts.size(); idx++)
+    {
+        if (g_contexts[idx]->label == label)
+        {
+            return (int)idx;
+        }
+    }
+
+    cid_context_t * ctx = new cid_context_t;
+    ctx->label = label;
+    g_contexts.push_back(ctx);
+
+    return (int)g_contexts.size() - 1;
+}
+
 /**
  * @brief Clean up CID/SSI with their last seen time (to be performed periodically)
  *
@@ -110,14 +179,17 @@ call_identifier_t * get_cid(int index)
  *
  */
 
-static void cid_clean_up()
+void cid_clean_up()
 {
     time_t now;
     time(&now);
 
-    for (std::size_t idx = 0; idx < cid_list.size(); idx++)
+    for (std::size_t ctx = 0; ctx < g_contexts.size(); ctx++)
     {
-        cid_list[idx]->clean_up();
+        for (std::size_t idx = 0; idx < g_contexts[ctx]->cid_list.size(); idx++)
+        {
+            g_contexts[ctx]->cid_list[idx]->clean_up();
+        }
     }
 
     // check cid last activity
@@ -132,13 +204,13 @@ static void cid_clean_up()
  *
  */
 
-static bool cid_exists(uint32_t cid)
+static bool cid_exists(cid_context_t * ctx, uint32_t cid)
 {
     bool b_exists = false;
 
-    for (std::size_t cnt = 0; cnt < cid_list.size(); cnt++)
+    for (std::size_t cnt = 0; cnt < ctx->cid_list.size(); cnt++)
     {
-        if (cid_list[cnt]->m_cid == cid)
+        if (ctx->cid_list[cnt]->m_cid == cid)
         {
             b_exists = true;
             break;
@@ -155,13 +227,13 @@ static bool cid_exists(uint32_t cid)
  *
  */
 
-static std::size_t cid_index(uint32_t cid)
+static std::size_t cid_index(cid_context_t * ctx, uint32_t cid)
 {
     std::size_t index = -1;
 
-    for (std::size_t cnt = 0; cnt < cid_list.size(); cnt++)
+    for (std::size_t cnt = 0; cnt < ctx->cid_list.size(); cnt++)
     {
-        if (cid_list[cnt]->m_cid == cid)
+        if (ctx->cid_list[cnt]->m_cid == cid)
         {
             index = cnt;
             break;
@@ -176,13 +248,13 @@ static std::size_t cid_index(uint32_t cid)
  *
  */
 
-static bool cid_index_by_usage_marker(uint8_t usage_marker, std::size_t * index)
+static bool cid_index_by_usage_marker(cid_context_t * ctx, uint8_t usage_marker, std::size_t * index)
 {
     bool ret = false;
 
-    for (std::size_t cnt = 0; cnt < cid_list.size(); cnt++)
+    for (std::size_t cnt = 0; cnt < ctx->cid_list.size(); cnt++)
     {
-        if (cid_list[cnt]->m_usage_marker == usage_marker)
+        if (ctx->cid_list[cnt]->m_usage_marker == usage_marker)
         {
             *index = cnt;
             ret = true;
@@ -198,11 +270,11 @@ static bool cid_index_by_usage_marker(uint8_t usage_marker, std::size_t * index)
  *
  */
 
-static void cid_add(uint32_t cid)
+static void cid_add(cid_context_t * ctx, uint32_t cid)
 {
-    if (!cid_exists(cid))
+    if (!cid_exists(ctx, cid))
     {
-        cid_list.push_back(new call_identifier_t(cid));
+        ctx->cid_list.push_back(new call_identifier_t(cid, g_audio_format, ctx->label));
     }
 }
 
@@ -212,25 +284,25 @@ static void cid_add(uint32_t cid)
  *
  */
 
-static void cid_add_ssi_to_cid(uint32_t cid, uint32_t ssi)
+static void cid_add_ssi_to_cid(cid_context_t * ctx, uint32_t cid, uint32_t ssi)
 {
     if (ssi <= 0) return;
 
-    if (!cid_exists(cid))
+    if (!cid_exists(ctx, cid))
     {
-        cid_add(cid);
+        cid_add(ctx, cid);
     }
 
-    std::size_t index = cid_index(cid);
+    std::size_t index = cid_index(ctx, cid);
 
     // check if ssi already exists in cid list
     bool b_exists = false;
 
-    for (std::size_t cnt = 0; cnt < cid_list[index]->m_ssi.size(); cnt++)
+    for (std::size_t cnt = 0; cnt < ctx->cid_list[index]->m_ssi.size(); cnt++)
     {
-        if (cid_list[index]->m_ssi[cnt].ssi == ssi)
+        if (ctx->cid_list[index]->m_ssi[cnt].ssi == ssi)
         {
-            time(&cid_list[index]->m_ssi[cnt].last_seen);                       // SSI exists, update its last seen time
+            time(&ctx->cid_list[index]->m_ssi[cnt].last_seen);                  // SSI exists, update its last seen time
             b_exists = true;
             break;
         }
@@ -241,7 +313,7 @@ static void cid_add_ssi_to_cid(uint32_t cid, uint32_t ssi)
         ssi_t new_ssi;
         new_ssi.ssi = ssi;
         time(&new_ssi.last_seen);
-        cid_list[index]->m_ssi.push_back(new_ssi);
+        ctx->cid_list[index]->m_ssi.push_back(new_ssi);
     }
 }
 
@@ -252,15 +324,15 @@ static void cid_add_ssi_to_cid(uint32_t cid, uint32_t ssi)
  *
  */
 
-static void cid_update_usage_marker(uint32_t cid, uint8_t usage_marker)
+static void cid_update_usage_marker(cid_context_t * ctx, uint32_t cid, uint8_t usage_marker)
 {
-    if (!cid_exists(cid))                                                       // if cid doesn't exists, create it
+    if (!cid_exists(ctx, cid))                                                  // if cid doesn't exists, create it
     {
-        cid_add(cid);
+        cid_add(ctx, cid);
     }
 
-    std::size_t index = cid_index(cid);
-    cid_list[index]->update_usage_marker(usage_marker);
+    std::size_t index = cid_index(ctx, cid);
+    ctx->cid_list[index]->update_usage_marker(usage_marker);
 }
 
 /**
@@ -268,15 +340,28 @@ static void cid_update_usage_marker(uint32_t cid, uint8_t usage_marker)
  *
  */
 
-static void cid_release(uint32_t cid)
+static void cid_release(cid_context_t * ctx, uint32_t cid)
 {
-    if (!cid_exists(cid)) return;
+    if (!cid_exists(ctx, cid)) return;
+
+    traffic_queue_t * queue = &g_traffic_queue;
+    call_identifier_t * released = ctx->cid_list[cid_index(ctx, cid)];
+
+    for (int idx = 0; idx < queue->count; idx++)
+    {
+        if (queue->cid[idx] == released)
+        {
+            cid_flush_traffic();                                                // its queued frames go to the record before it is closed
+            break;
+        }
+    }
 
-    for (std::vector<call_identifier_t *>::iterator it = cid_list.begin(); it != cid_list.end();)
+    for (std::vector<call_identifier_t *>::iterator it = ctx->cid_list.begin(); it != ctx->cid_list.end();)
     {
         if ((*it)->m_cid == cid)
         {
-            it = cid_list.erase(it);                                            // erase current id and get pointer to next one
+            delete *it;                                                         // close its speech outputs
+            it = ctx->cid_list.erase(it);                                       // erase current id and get pointer to next one
         }
         else
         {
@@ -285,26 +370,113 @@ static void cid_release(uint32_t cid)
     }
 }
 
+/**
+ * @brief Decode all queued speech frames at once and write them to their CID outputs
+ *
+ */
+
+void cid_flush_traffic()
+{
+    traffic_queue_t * queue = &g_traffic_queue;
+
+    if (queue->count == 0) return;
+
+    audio_batch_t batch;
+    batch.count = queue->count;
+
+    for (int idx = 0; idx < queue->count; idx++)
+    {
+        batch.decoder[idx]             = queue->cid[idx]->decoder();
+        batch.input_frame[idx]         = queue->frame[idx];
+        batch.raw_output[idx]          = queue->raw_output[idx];
+        batch.frame_stealing_flag[idx] = queue->frame_stealing_flag[idx];
+    }
+
+    audio_decoder::process_batch(&batch);
+
+    g_traffic_batches++;
+    g_traffic_frames += queue->count;
+
+    for (int idx = 0; idx < queue->count; idx++)
+    {
+        if (batch.result[idx])                                                  // check if raw output is valid
+        {
+            queue->cid[idx]->write_traffic_raw(queue->usage_marker[idx], queue->raw_output[idx], queue->len[idx]);
+        }
+    }
+
+    queue->count = 0;
+}
+
+/**
+ * @brief Mean count of speech frames decoded per batch, 0 if none
+ *
+ */
+
+double cid_mean_batch_size()
+{
+    return (g_traffic_batches > 0) ? (double)g_traffic_frames / (double)g_traffic_batches : 0.;
+}
+
+/**
+ * @brief Queue a speech frame to be decoded with the frames of other CID.
+ *        The queue is flushed first when it is full or already holds a frame of this CID,
+ *        otherwise it waits for the next refresh tick. Each frame keeps the usage marker
+ *        it was received with, so signalling PDU in between don't need a flush
+ *
+ */
+
+static void cid_queue_traffic(call_identifier_t * cid, const char * data, uint32_t len, int16_t frame_stealing_flag)
+{
+    traffic_queue_t * queue = &g_traffic_queue;
+
+    bool b_flush = (queue->count >= audio_batch_t::MAX_FRAMES);
+
+    for (int idx = 0; (idx < queue->count) && !b_flush; idx++)
+    {
+        b_flush = (queue->cid[idx] == cid);
+    }
+
+    if (b_flush)
+    {
+        cid_flush_traffic();
+    }
+
+    cid->prepare_traffic_raw();                                                 // may start a new record and reset the codec
+
+    int idx = queue->count;
+    std::size_t size = std::min((std::size_t)len, sizeof(queue->frame[idx]));
+
+    memset(queue->frame[idx], 0, sizeof(queue->frame[idx]));
+    memcpy(queue->frame[idx], data, size);
+
+    queue->cid[idx]          = cid;
+    queue->usage_marker[idx] = cid->m_usage_marker;
+    queue->len[idx]          = len;
+    queue->frame_stealing_flag[idx] = frame_stealing_flag;
+    queue->count++;
+}
+
 /**
  * @brief Send traffic speech frame to a CID identified by a given usage marker
  *
  */
 
-static void cid_send_traffic_to_cid_by_usage_marker(uint8_t usage_marker, const char * data, uint32_t len)
+static void cid_send_traffic_to_cid_by_usage_marker(cid_context_t * ctx, uint8_t usage_marker, const char * data, uint32_t len, int16_t frame_stealing_flag)
 {
     if (usage_marker > 63) return;                                              // only values from 0-63 are relevant for TETRA
 
     std::size_t index;
 
-    if (cid_index_by_usage_marker(usage_marker, &index))
+    if (cid_index_by_usage_marker(ctx, usage_marker, &index))
     {
         if (g_raw_format_flag)
         {
-            cid_list[index]->push_traffic_raw(data, len);                       // push traffic to this cid and generate .raw files with internal TETRA codec
+            cid_queue_traffic(ctx->cid_list[index], data, len, frame_stealing_flag); // queue traffic for this cid, decoded with internal TETRA codec to .raw/.wav files
         }
         else
         {
-            cid_list[index]->push_traffic(data, len);                           // push traffic to this cid and generate .out binary files
+            ctx->cid_list[index]->push_traffic(data, len);                      // push traffic to this cid and generate .out binary files (no stealing indication in this format)
         }
     }
 }
@@ -319,16 +491,35 @@ static void cid_send_traffic_to_cid_by_usage_marker(uint8_t usage_marker, const
  *
  */
 
-void cid_parse_pdu(std::string data, FILE * fd_log)
+void cid_parse_pdu(int context, const char * data, std::size_t len, FILE * fd_log)
 {
-    cid_clean_up();
+    if ((context != CID_CONTEXT_FROM_LOG) && ((context < 0) || (context >= (int)g_contexts.size()))) return;
+
+    while ((len > 0) && ((data[len - 1] == '\n') || (data[len - 1] == '\r') || (data[len - 1] == '\0'))) // strip end of line (text file replay)
+    {
+        len--;
+    }
 
     // parse data
-    json_parser_t * jparser = new json_parser_t(data);
+    json_parser_t * jparser = &g_json_parser;
+
+    if (!jparser->parse(data, len))                                             // invalid Json text, stop processing here
+    {
+        return;
+    }
+
+    const char * input;
+    std::size_t  input_len;
+    bool b_tagged = jparser->read(JSON_INPUT, &input, &input_len);              // line already logged by a multi-input recorder
+
+    if (context == CID_CONTEXT_FROM_LOG)
+    {
+        context = cid_context_by_label(std::string(input, input_len));          // untagged lines come from a single input
+    }
+
+    cid_context_t * ctx = g_contexts[context];
 
     // extract data common to all pdu
-    std::string   service;
-    std::string   pdu;
     uint8_t  usage_marker;
     uint8_t  downlink_usage_marker;
     uint8_t  encryption_mode;
@@ -336,34 +527,42 @@ void cid_parse_pdu(std::string data, FILE * fd_log)
 
     bool b_valid = true;                                                        // check if the pdu is valid
 
-    b_valid = b_valid && jparser->read("service",         &service);
-    b_valid = b_valid && jparser->read("pdu",             &pdu);
-    b_valid = b_valid && jparser->read("usage marker",    &usage_marker);
-    b_valid = b_valid && jparser->read("encryption mode", &encryption_mode);
-    b_valid = b_valid && jparser->read("ssi",             &ssi);
+    const char * service;
+    const char * pdu;
+    std::size_t  service_len;
+    std::size_t  pdu_len;
 
-    if (!b_valid)                                                               // invalid Json text, stop processing here
+    b_valid = b_valid && jparser->read(JSON_SERVICE,         &service, &service_len);
+    b_valid = b_valid && jparser->read(JSON_PDU,             &pdu, &pdu_len);
+    b_valid = b_valid && jparser->read(JSON_USAGE_MARKER,    &usage_marker);
+    b_valid = b_valid && jparser->read(JSON_ENCRYPTION_MODE, &encryption_mode);
+    b_valid = b_valid && jparser->read(JSON_SSI,             &ssi);
+
+    if (!b_valid)                                                               // missing fields, stop processing here
     {
-        delete jparser;
         return;
     }
 
     bool b_log = true;
 
-    if (!service.compare("MAC"))                                                // MAC service (don't print)
+    if (jparser->equals(JSON_SERVICE, "MAC"))                                   // MAC service (don't print)
     {
         b_log = false;                                                          // too much packets to log
     }
-    else if (!service.compare("UPLANE"))                                        // traffic speech frame
+    else if (jparser->equals(JSON_SERVICE, "UPLANE"))                           // traffic speech frame
     {
         uint64_t zlib_uncomp_size;
         uint64_t zlib_comp_size;
-        std::string frame;
-        b_valid = jparser->read("downlink usage marker", &downlink_usage_marker); // may differ from usage marker
-        b_valid = b_valid && jparser->read("encryption mode", &encryption_mode);
-        b_valid = b_valid && jparser->read("uzsize", &zlib_uncomp_size);          // uncompressed frame length 2 * 690 + 1 bytes
-        b_valid = b_valid && jparser->read("zsize",  &zlib_comp_size);            // compressed frame length (before B64 since B64 add overhead)
-        b_valid = b_valid && jparser->read("frame",  &frame);                     // zlib + B64 frame
+        const char * frame;
+        std::size_t  frame_len;
+        b_valid = jparser->read(JSON_DOWNLINK_USAGE_MARKER, &downlink_usage_marker); // may differ from usage marker
+        b_valid = b_valid && jparser->read(JSON_ENCRYPTION_MODE, &encryption_mode);
+        b_valid = b_valid && jparser->read(JSON_UZSIZE, &zlib_uncomp_size);        // uncompressed frame length 2 * 690 + 1 bytes
+        b_valid = b_valid && jparser->read(JSON_ZSIZE,  &zlib_comp_size);          // compressed frame length (before B64 since B64 add overhead)
+        b_valid = b_valid && jparser->read(JSON_FRAME,  &frame, &frame_len);       // zlib + B64 frame
+
+        uint8_t frame_stealing = 0;                                             // optional, first half slot stolen (speech in second half slot only)
+        jparser->read(JSON_FRAME_STEALING, &frame_stealing);
 
         if (b_valid && (encryption_mode == 0))                                  // we can process current speech frame
         {
@@ -371,7 +570,7 @@ void cid_parse_pdu(std::string data, FILE * fd_log)
 
             // base64 decode
             unsigned char buf_b64out[BUFSIZE] = {0};
-            b64_decode((const unsigned char *)frame.c_str(), frame.length(), buf_b64out);
+            b64_decode((const unsigned char *)frame, frame_len, buf_b64out);
 
             // zlib uncompress
             char buf_zlib_out[BUFSIZE] = {0};
@@ -381,49 +580,49 @@ void cid_parse_pdu(std::string data, FILE * fd_log)
 
             if (!ret)
             {
-                cid_send_traffic_to_cid_by_usage_marker(downlink_usage_marker, buf_zlib_out, zlib_uncomp_size); // process it
+                cid_send_traffic_to_cid_by_usage_marker(ctx, downlink_usage_marker, buf_zlib_out, zlib_uncomp_size, frame_stealing ? 1 : 0); // process it
             }
         }
     }
     else                                                                        // other services
     {
-        if ((!pdu.compare("D-ALERT")) ||
-            (!pdu.compare("D-CONNECT")) ||
-            (!pdu.compare("D-CONNECT ACK")) ||
-            (!pdu.compare("D-SETUP")) ||
-            (!pdu.compare("D-STATUS")) ||
-            (!pdu.compare("D-TX GRANTED")) ||
-            (!pdu.compare("D-TX CEASED")))
+        if (jparser->equals(JSON_PDU, "D-ALERT") ||
+            jparser->equals(JSON_PDU, "D-CONNECT") ||
+            jparser->equals(JSON_PDU, "D-CONNECT ACK") ||
+            jparser->equals(JSON_PDU, "D-SETUP") ||
+            jparser->equals(JSON_PDU, "D-STATUS") ||
+            jparser->equals(JSON_PDU, "D-TX GRANTED") ||
+            jparser->equals(JSON_PDU, "D-TX CEASED"))
         {
             // register new cid and attach ssi and usage marker
             uint32_t cid;
-            b_valid = jparser->read("call identifier", &cid);
+            b_valid = jparser->read(JSON_CALL_IDENTIFIER, &cid);
 
             if (b_valid)
             {
-                cid_update_usage_marker(cid, usage_marker);                     // CID will be added to list if it doesn't exists yet
-                cid_add_ssi_to_cid(cid, ssi);
-                scr_update(data);
+                cid_update_usage_marker(ctx, cid, usage_marker);                // CID will be added to list if it doesn't exists yet
+                cid_add_ssi_to_cid(ctx, cid, ssi);
+                scr_update(std::string(data, len));
             }
         }
-        else if (!pdu.compare("D-RELEASE"))                                     // || (!pdu.compare("D-TX WAIT")))
+        else if (jparser->equals(JSON_PDU, "D-RELEASE"))                        // || (jparser->equals(JSON_PDU, "D-TX WAIT")))
         {
             // release cid
             uint32_t cid;
-            b_valid = jparser->read("call identifier", &cid);
+            b_valid = jparser->read(JSON_CALL_IDENTIFIER, &cid);
 
             if (b_valid)
             {
-                cid_release(cid);
-                scr_update(data);
+                cid_release(ctx, cid);
+                scr_update(std::string(data, len));
             }
         }
         else if (
-            ((!pdu.compare("D-SDS-DATA")) || (!pdu.compare("D-STATUS")))
+            (jparser->equals(JSON_PDU, "D-SDS-DATA") || jparser->equals(JSON_PDU, "D-STATUS"))
             && (encryption_mode == 0))                                          // SDS messages
         {
             std::string sds_msg;
-            b_valid = jparser->read("infos", &sds_msg);
+            b_valid = jparser->read(JSON_INFOS, &sds_msg);
 
             if (b_valid)                                                        // text message can be printed
             {
@@ -433,12 +632,12 @@ void cid_parse_pdu(std::string data, FILE * fd_log)
 
                 //{"service":"CMCE","pdu":"D-SDS-DATA","tn":2,"fn":13,"mn":41,"ssi":299906,"usage marker":47,"calling party type identifier":1,"calling party ssi":401101,"sds type identifier":3,"protocol id":130,"message type":0,"sds-pdu":"SDS-TRANSFER","message reference":225,"protocol info":"text messaging (SDS-TL)","text coding scheme":1,"infos":"_____ _)______(______b_)______(%"}
 
-                jparser->read("message reference", &msg_ref);
-                jparser->read("calling party ssi", &party_ssi);
-                jparser->read("protocol id", &protocol_id);
+                jparser->read(JSON_MESSAGE_REFERENCE, &msg_ref);
+                jparser->read(JSON_CALLING_PARTY_SSI, &party_ssi);
+                jparser->read(JSON_PROTOCOL_ID, &protocol_id);
                 scr_print_sds(format_str("prot:%3u ssi:%6u calling:%6u ref:%3u encr:%2u msg: '%s'", protocol_id, ssi, party_ssi, msg_ref, encryption_mode, sds_msg.c_str()));
             }
-            scr_update(data);                                                   // note that there is two lines printed for every message (for analyze, we provide full hexa + attempted decoded message with 8 bits charset)
+            scr_update(std::string(data, len));                                 // note that there is two lines printed for every message (for analyze, we provide full hexa + attempted decoded message with 8 bits charset)
         }
         else
         {
@@ -446,10 +645,17 @@ void cid_parse_pdu(std::string data, FILE * fd_log)
         }
     }
 
-    if (b_log)                                                                  // append to log file
+    if (b_log)                                                                  // append original Json text to log file
     {
-        jparser->write_report(fd_log);
-    }
+        if (!ctx->label.empty() && !b_tagged && (data[0] == '{'))               // tag the input so replay keeps namespaces apart
+        {
+            fprintf(fd_log, "{\"input\":\"%s\",", ctx->label.c_str());
+            data++;
+            len--;
+        }
 
-    delete jparser;
+        fwrite(data, 1, len, fd_log);
+        fputc('\n', fd_log);
+        fflush(fd_log);
+    }
 }
@@ -20,6 +20,7 @@
 #define CID_H
 #include <cstdint>
 #include <string>
+#include <vector>
 
 /**
  * @brief Short Subscriber Identity structure with last seen time for clean up
@@ -33,9 +34,25 @@ struct ssi_t {
 
 class call_identifier_t;                                                        // forward declaration
 
-void cid_init(int raw_format_flag);
+/**
+ * @brief Call identifiers namespace of one input (ie. one decoder/carrier).
+ *        CID and usage markers are only meaningful inside the cell they come from.
+ *
+ */
+
+struct cid_context_t {
+    std::string label;                                                          ///< Input label used in file names, empty for single input
+    std::vector<call_identifier_t *> cid_list;                                  ///< CID of this input
+};
+
+static const int CID_CONTEXT_FROM_LOG = -1;                                     ///< Take namespace from the "input" field of a logged line (replay)
+
+void cid_init(int raw_format_flag, int audio_format, const std::vector<std::string> & labels);
 call_identifier_t * get_cid(int index);
 void cid_clear();
-void cid_parse_pdu(std::string data, FILE * fd_log);
+void cid_clean_up();
+void cid_parse_pdu(int context, const char * data, std::size_t len, FILE * fd_log);
+void cid_flush_traffic();                                                       // decode queued speech frames
+double cid_mean_batch_size();
 
 #endif /* CID_H */
@@ -1,23 +1,38 @@
+#include <cstring>
 #include "json_parser.h"
 
-
-json_parser_t::json_parser_t(std::string data)
+/**
+ * @brief Json keys of wanted fields, in json_field_t order
+ *
+ */
+
+static const char * const FIELD_KEYS[JSON_FIELDS_COUNT] = {
+    "service",
+    "pdu",
+    "ssi",
+    "usage marker",
+    "downlink usage marker",
+    "encryption mode",
+    "call identifier",
+    "uzsize",
+    "zsize",
+    "frame",
+    "infos",
+    "message reference",
+    "calling party ssi",
+    "protocol id",
+    "frame stealing",
+    "input"
+};
+
+
+json_parser_t::json_parser_t()
 {
     // constructor
-    b_valid = true;
+    b_valid = false;
+    m_buffer.reserve(65536);
 
-    if (data == "")
-    {
-        b_valid = false;
-    }
-    else if (jdoc.Parse(data.c_str()).HasParseError())                          // parse and check parsing result for errors
-    {
-        b_valid = false;
-        fprintf(stderr, "\nError(offset %u): %s\n'%s'\n",
-                (unsigned)jdoc.GetErrorOffset(),
-                rapidjson::GetParseError_En(jdoc.GetParseError()),
-                data.c_str());
-    }
+    memset(m_values, 0, sizeof(m_values));
 }
 
 
@@ -27,37 +42,88 @@ json_parser_t::~json_parser_t()
 }
 
 
+bool json_parser_t::parse(const char * data, std::size_t len)
+{
+    // parse data in-situ in the reused buffer (the original data is left untouched for logging)
+    memset(m_values, 0, sizeof(m_values));
+
+    b_valid = false;
+
+    if (len == 0)
+    {
+        return b_valid;
+    }
+
+    m_buffer.resize(len + 1);
+    memcpy(m_buffer.data(), data, len);
+    m_buffer[len] = '\0';
+
+    handler_t handler;
+    handler.values    = m_values;
+    handler.depth     = 0;
+    handler.cur_field = -1;
+
+    rapidjson::InsituStringStream stream(m_buffer.data());
+    rapidjson::Reader reader;
+    rapidjson::ParseResult res = reader.Parse<rapidjson::kParseInsituFlag | rapidjson::kParseStopWhenDoneFlag>(stream, handler);
+
+    if (res.IsError())                                                          // check parsing result for errors
+    {
+        fprintf(stderr, "\nError(offset %u): %s\n'%.*s'\n",
+                (unsigned)res.Offset(),
+                rapidjson::GetParseError_En(res.Code()),
+                (int)len,
+                data);
+    }
+    else
+    {
+        b_valid = true;
+    }
+
+    return b_valid;
+}
+
+
 bool json_parser_t::is_valid()
 {
     return b_valid;
 }
 
 
-bool json_parser_t::read(const std::string field, std::string * result)
+bool json_parser_t::read(json_field_t field, const char ** result, std::size_t * len)
 {
-    // read field with error check
+    // read string field without copy, valid until next parse
     bool ret = false;
 
     *result = "";                                                               // for sanity
+    *len    = 0;
 
-    if (b_valid)                                                                // check if document is valid
+    if (b_valid && m_values[field].b_present && m_values[field].b_string)       // check if field exists and its type
     {
-        if (jdoc.HasMember(field.c_str()))                                      // check if document has member field
-        {
-            if (jdoc[field.c_str()].IsString())                                 // check member field type
-            {
-                std::string txt(jdoc[field.c_str()].GetString());
-                *result = txt;
-                ret = true;
-            }
-        }
+        *result = m_values[field].str;
+        *len    = m_values[field].len;
+        ret = true;
     }
 
     return ret;
 }
 
 
-bool json_parser_t::read(const std::string field, uint8_t * result)
+bool json_parser_t::read(json_field_t field, std::string * result)
+{
+    // read field with error check
+    const char * str;
+    std::size_t len;
+
+    bool ret = read(field, &str, &len);
+
+    result->assign(str, len);
+
+    return ret;
+}
+
+
+bool json_parser_t::read(json_field_t field, uint8_t * result)
 {
     // read field with error check
     uint64_t val;
@@ -70,7 +136,7 @@ bool json_parser_t::read(const std::string field, uint8_t * result)
 }
 
 
-bool json_parser_t::read(const std::string field, uint16_t * result)
+bool json_parser_t::read(json_field_t field, uint16_t * result)
 {
     // read field with error check
     uint64_t val;
@@ -83,7 +149,7 @@ bool json_parser_t::read(const std::string field, uint16_t * result)
 }
 
 
-bool json_parser_t::read(const std::string field, uint32_t * result)
+bool json_parser_t::read(json_field_t field, uint32_t * result)
 {
     // read field with error check
     uint64_t val;
@@ -96,60 +162,150 @@ bool json_parser_t::read(const std::string field, uint32_t * result)
 }
 
 
-bool json_parser_t::read(const std::string field, uint64_t * result)
+bool json_parser_t::read(json_field_t field, uint64_t * result)
 {
     // read field with error check
     bool ret = false;
 
     *result = 0;                                                                // for sanity
 
-    if (b_valid)                                                                // check if document is valid
+    if (b_valid && m_values[field].b_present && !m_values[field].b_string)      // check if field exists and its type
     {
-        if (jdoc.HasMember(field.c_str()))                                      // check if document has member field
-        {
-            if (jdoc[field.c_str()].IsNumber())                                 // check member field type
-            {
-                uint64_t val = jdoc[field.c_str()].GetUint64();
-                *result = val;
-                ret = true;
-            }
-        }
+        *result = m_values[field].num;
+        ret = true;
     }
 
     return ret;
 }
 
 
-void json_parser_t::write_report(FILE * fd)
+bool json_parser_t::equals(json_field_t field, const char * val)
 {
-    if (b_valid)
+    // compare string field to val
+    const char * str;
+    std::size_t len;
+
+    if (!read(field, &str, &len))
     {
-        rapidjson::StringBuffer buffer(0, 8192);                                // size of buffer is automatically increased
-        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-        jdoc.Accept(writer);
+        return false;
+    }
+
+    return (strlen(val) == len) && (memcmp(str, val, len) == 0);
+}
+
+/*
+ * SAX handler
+ *
+ * Only top-level (depth 1) keys are taken into account, nested arrays and objects
+ * (ie. neighbour cells) are skipped.
+ *
+ */
 
-        const char * buf = buffer.GetString();
-        std::string txt = buf;
+bool json_parser_t::handler_t::Default()
+{
+    cur_field = -1;                                                             // unused value type (bool, null, double)
+    return true;
+}
+
+
+bool json_parser_t::handler_t::Uint(unsigned val)
+{
+    return Uint64(val);
+}
 
-        fprintf(fd, "%s\n", txt.c_str());
-        fflush(fd);
+
+bool json_parser_t::handler_t::Int(int val)
+{
+    return Int64(val);
+}
+
+
+bool json_parser_t::handler_t::Uint64(uint64_t val)
+{
+    if (cur_field >= 0)
+    {
+        values[cur_field].b_present = true;
+        values[cur_field].b_string  = false;
+        values[cur_field].num       = val;
+        cur_field = -1;
     }
+
+    return true;
+}
+
+
+bool json_parser_t::handler_t::Int64(int64_t val)
+{
+    return Uint64((uint64_t)val);                                               // same conversion as previous GetUint64()
 }
 
 
-std::string json_parser_t::to_string()
+bool json_parser_t::handler_t::String(const char * str, rapidjson::SizeType len, bool copy)
 {
-    std::string txt = "";
+    (void)copy;                                                                 // in-situ: str points into the parsing buffer
 
-    if (b_valid)
+    if (cur_field >= 0)
     {
-        rapidjson::StringBuffer buffer(0, 8192);                                // size of buffer is automatically increased
-        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-        jdoc.Accept(writer);
+        values[cur_field].b_present = true;
+        values[cur_field].b_string  = true;
+        values[cur_field].str       = str;
+        values[cur_field].len       = len;
+        cur_field = -1;
+    }
+
+    return true;
+}
+
+
+bool json_parser_t::handler_t::Key(const char * str, rapidjson::SizeType len, bool copy)
+{
+    (void)copy;
+
+    cur_field = -1;
 
-        const char * buf = buffer.GetString();
-        txt = buf;
+    if (depth == 1)
+    {
+        for (int idx = 0; idx < JSON_FIELDS_COUNT; idx++)
+        {
+            if ((strncmp(FIELD_KEYS[idx], str, len) == 0) && (FIELD_KEYS[idx][len] == '\0'))
+            {
+                cur_field = idx;
+                break;
+            }
+        }
     }
 
-    return txt;
+    return true;
+}
+
+
+bool json_parser_t::handler_t::StartObject()
+{
+    depth++;
+    cur_field = -1;
+    return true;
+}
+
+
+bool json_parser_t::handler_t::EndObject(rapidjson::SizeType count)
+{
+    (void)count;
+    depth--;
+    return true;
+}
+
+
+bool json_parser_t::handler_t::StartArray()
+{
+    depth++;
+    cur_field = -1;
+    return true;
+}
+
+
+bool json_parser_t::handler_t::EndArray(rapidjson::SizeType count)
+{
+    (void)count;
+    depth--;
+    return true;
 }
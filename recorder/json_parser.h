@@ -19,33 +19,103 @@
 #ifndef JSON_PARSER_H
 #define JSON_PARSER_H
 #include <cstdint>
+#include <cstdio>
 #include <string>
-#include <rapidjson/document.h>
-#include <rapidjson/stringbuffer.h>
-#include <rapidjson/writer.h>
+#include <vector>
+#include <rapidjson/reader.h>
 #include <rapidjson/error/en.h>
 
 /**
- * @brief Json object parser with error handling
+ * @brief Json fields used by the recorder. Other fields are skipped while parsing
+ *
+ */
+
+enum json_field_t {
+    JSON_SERVICE = 0,
+    JSON_PDU,
+    JSON_SSI,
+    JSON_USAGE_MARKER,
+    JSON_DOWNLINK_USAGE_MARKER,
+    JSON_ENCRYPTION_MODE,
+    JSON_CALL_IDENTIFIER,
+    JSON_UZSIZE,
+    JSON_ZSIZE,
+    JSON_FRAME,
+    JSON_INFOS,
+    JSON_MESSAGE_REFERENCE,
+    JSON_CALLING_PARTY_SSI,
+    JSON_PROTOCOL_ID,
+    JSON_FRAME_STEALING,
+    JSON_INPUT,
+    JSON_FIELDS_COUNT
+};
+
+/**
+ * @brief Json report parser with error handling
+ *
+ * Json text is parsed in-situ with rapidjson SAX reader in a buffer reused between
+ * messages: only the top-level fields listed in json_field_t are extracted in a single
+ * pass, no DOM is built. String values point into the parsing buffer and remain valid
+ * until next call to parse().
  *
  */
 
 class json_parser_t {
 public:
-    json_parser_t(std::string data);
+    json_parser_t();
     ~json_parser_t();
 
+    bool parse(const char * data, std::size_t len);
     bool is_valid();
-    bool read(const std::string field, std::string   * result);
-    bool read(const std::string field, uint8_t  * result);
-    bool read(const std::string field, uint16_t * result);
-    bool read(const std::string field, uint32_t * result);
-    bool read(const std::string field, uint64_t * result);
-
-    void write_report(FILE * fd_file);
-    std::string to_string();
+
+    bool read(json_field_t field, std::string * result);
+    bool read(json_field_t field, const char ** result, std::size_t * len);     // zero-copy access to string value
+    bool read(json_field_t field, uint8_t  * result);
+    bool read(json_field_t field, uint16_t * result);
+    bool read(json_field_t field, uint32_t * result);
+    bool read(json_field_t field, uint64_t * result);
+
+    bool equals(json_field_t field, const char * val);                          // string value comparison without copy
+
+    /**
+     * @brief Field value found while parsing
+     *
+     */
+
+    struct value_t {
+        bool        b_present;
+        bool        b_string;
+        const char * str;
+        std::size_t len;
+        uint64_t    num;
+    };
+
+    /**
+     * @brief SAX handler storing the fields values
+     *
+     */
+
+    struct handler_t : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, handler_t> {
+        value_t * values;
+        int depth;
+        int cur_field;                                                          // current key, -1 when not a wanted field
+
+        bool Default();
+        bool Uint(unsigned val);
+        bool Int(int val);
+        bool Uint64(uint64_t val);
+        bool Int64(int64_t val);
+        bool String(const char * str, rapidjson::SizeType len, bool copy);
+        bool Key(const char * str, rapidjson::SizeType len, bool copy);
+        bool StartObject();
+        bool EndObject(rapidjson::SizeType count);
+        bool StartArray();
+        bool EndArray(rapidjson::SizeType count);
+    };
+
 private:
-    rapidjson::Document jdoc;
+    std::vector<char> m_buffer;                                                 // in-situ parsing buffer, reused between messages
+    value_t m_values[JSON_FIELDS_COUNT];
     bool b_valid;
 };
 
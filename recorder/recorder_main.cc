@@ -17,15 +17,19 @@
  *
  */
 #include <cstring>
+#include <ctime>
 #include <vector>
 #include <arpa/inet.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/timerfd.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <signal.h>
 #include "cid.h"
 #include "window.h"
+#include "audio_output.h"
 
 /*
  * Simple Tetra recorder with ncurses ui
@@ -55,36 +59,93 @@
  */
 
 /**
- * @brief Receive from UDP socket with time-out
+ * @brief Open non-blocking UDP socket bound to localhost:port
  *
  */
 
-int timed_recv(int fd_sock_rx, char * msg, std::size_t max_size, int max_wait_ms)
+static int udp_open(int port)
 {
-    struct sockaddr_in saddr_in;
-    socklen_t socket_len = sizeof(saddr_in);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(struct sockaddr_in));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_aton("127.0.0.1", &addr.sin_addr);
 
-    fd_set fdset;
-    FD_ZERO(&fdset);                                                            // clear fd set
-    FD_SET(fd_sock_rx, &fdset);                                                 // add socket fd to set
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
 
-    struct timeval timeout;
-    timeout.tv_sec  =  max_wait_ms / 1000;
-    timeout.tv_usec = (max_wait_ms % 1000) * 1000;
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(struct sockaddr)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/**
+ * @brief Create periodic timer for housekeeping
+ *
+ */
 
-    int ret = select(fd_sock_rx + 1, &fdset, &fdset, &fdset, &timeout);         // monitor socket for max_wait_ms
-    int val = -1;
+static int timer_open(int period_ms)
+{
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
 
-    if (ret > 0)                                                                // socket has data, then receive it
+    if (fd < 0)
     {
-        val = recvfrom(fd_sock_rx, msg, max_size, 0, (struct sockaddr *)&saddr_in, &socket_len);
+        return -1;
     }
-    else                                                                        // invalid or no data
+
+    struct itimerspec spec;
+    spec.it_interval.tv_sec  =  period_ms / 1000;
+    spec.it_interval.tv_nsec = (period_ms % 1000) * 1000000L;
+    spec.it_value            = spec.it_interval;
+
+    timerfd_settime(fd, 0, &spec, NULL);
+
+    return fd;
+}
+
+/**
+ * @brief Monotonic time [ms]
+ *
+ */
+
+static uint64_t now_ms()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static const int REFRESH_PERIOD_MS       = 200;                                 // screen refresh period [ms] (5 Hz)
+static const uint64_t HOUSEKEEPING_TICKS = 1000 / REFRESH_PERIOD_MS;            // CID/SSI clean up every second
+
+/**
+ * @brief Refresh tick: decode queued speech frames, clean up CID/SSI
+ *        every HOUSEKEEPING_TICKS and draw the screen
+ *
+ */
+
+static void refresh_tick(uint64_t expirations, uint64_t * ticks)
+{
+    cid_flush_traffic();                                                        // speech frames of all CID received since last tick
+
+    *ticks += expirations;
+
+    if (*ticks >= HOUSEKEEPING_TICKS)
     {
-        val = -1;
+        cid_clean_up();
+        *ticks = 0;
     }
 
-    return val;
+    scr_refresh();                                                              // screen is only drawn here, never while processing messages
 }
 
 /** @brief Program working mode enumeration */
@@ -116,10 +177,12 @@ static void sigint_handler(int val)
 int main(int argc, char * argv[])
 {
     struct sigaction sa;
-    sa.sa_handler = sigint_handler;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = sigint_handler;                                             // no SA_RESTART: SIGINT interrupts epoll_wait()
+    sigemptyset(&sa.sa_mask);
     sigaction(SIGINT, &sa, 0);
 
-    int udp_port_rx = 42100;                                                    // UDP RX port (ie. where to receive Json text from decoder)
+    std::vector<int> udp_ports_rx;                                              // UDP RX ports (ie. where to receive Json text from decoders)
 
     const int FILENAME_LEN = 256;
     char opt_filename_in[FILENAME_LEN]  = "";                                   // input Json text filename
@@ -129,18 +192,28 @@ int main(int argc, char * argv[])
     int line_length      = 256;                                                 // default line length
     int max_bottom_lines = 20;                                                  // default bottom lines count
     int raw_format_flag  = 1;
+    int audio_format     = AUDIO_FORMAT_RAW;
+    int headless_flag    = 0;
 
     int option;
-    while ((option = getopt(argc, argv, "xr:i:o:l:n:h")) != -1)
+    while ((option = getopt(argc, argv, "xwqr:i:o:l:n:h")) != -1)
     {
         switch (option)
         {
+        case 'q':
+            headless_flag = 1;
+            break;
+
         case 'x':
             raw_format_flag = 0;
             break;
 
+        case 'w':
+            audio_format = AUDIO_FORMAT_WAV;
+            break;
+
         case 'r':
-            udp_port_rx = atoi(optarg);
+            udp_ports_rx.push_back(atoi(optarg));                               // may be repeated to listen to several decoders
             break;
 
         case 'i':
@@ -164,7 +237,9 @@ int main(int argc, char * argv[])
             printf("\nUsage: ./recorder [OPTIONS]\n\n"
                    "Options:\n"
                    "  -x don't process raw speech output with internal codec\n"
-                   "  -r <UDP socket> receiving Json data from decoder [default port is 42100]\n"
+                   "  -w write speech as .wav files in wav/ folder instead of .raw (internal codec only)\n"
+                   "  -q headless mode, no screen output (recording and log file only)\n"
+                   "  -r <UDP socket> receiving Json data from decoder [default port is 42100] (can be repeated, each port has its own CID namespace)\n"
                    "  -i <file> replay data from Json text file instead of UDP\n"
                    "  -o <file> to record Json data in different text file [default file name is 'log.txt'] (can be replayed with -i option)\n"
                    "  -l <ncurses line length> maximum characters printed on a report line\n"
@@ -182,9 +257,10 @@ int main(int argc, char * argv[])
 
     mkdir("out", S_IRWXU | S_IRGRP | S_IXGRP);                                  // create out/ directory
     mkdir("raw", S_IRWXU | S_IRGRP | S_IXGRP);                                  // create raw/ directory
+    mkdir("wav", S_IRWXU | S_IRGRP | S_IXGRP);                                  // create wav/ directory
 
     FILE * file_in = NULL;                                                      // for Json text read
-    int fd_input = 0;                                                           // for UDP read
+    std::vector<int> fd_inputs;                                                 // for UDP read
 
     if (program_mode & READ_FROM_JSON_TEXT_FILE)                                // read input text from file
     {
@@ -196,22 +272,24 @@ int main(int argc, char * argv[])
             exit(EXIT_FAILURE);
         }
     }
-    else                                                                        // read input bits from UDP socket
+    else                                                                        // read input bits from UDP sockets
     {
-        struct sockaddr_in addr;
-        memset(&addr, 0, sizeof(struct sockaddr_in));
-        addr.sin_family = AF_INET;
-        addr.sin_port = htons(udp_port_rx);
-        inet_aton("127.0.0.1", &addr.sin_addr);
-
-        fd_input = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-        bind(fd_input, (struct sockaddr *)&addr, sizeof(struct sockaddr));
+        if (udp_ports_rx.empty())
+        {
+            udp_ports_rx.push_back(42100);                                      // default port
+        }
 
-        if (fd_input < 0)
+        for (std::size_t idx = 0; idx < udp_ports_rx.size(); idx++)
         {
-            fprintf(stderr, "Input socket 0x%04x on port %d\n", fd_input, udp_port_rx);
-            fprintf(stderr, "Couldn't create input socket");
-            exit(EXIT_FAILURE);
+            int fd = udp_open(udp_ports_rx[idx]);
+
+            if (fd < 0)
+            {
+                fprintf(stderr, "Couldn't create input socket on port %d\n", udp_ports_rx[idx]);
+                exit(EXIT_FAILURE);
+            }
+
+            fd_inputs.push_back(fd);
         }
     }
 
@@ -225,43 +303,115 @@ int main(int argc, char * argv[])
     }
 
     // initialize display and CID list
-    scr_init(line_length, max_bottom_lines);
-    cid_init(raw_format_flag);
+    scr_init(line_length, max_bottom_lines, headless_flag);
+    std::vector<std::string> labels;                                            // one CID namespace per input, replay creates them from logged lines
+
+    if (!(program_mode & READ_FROM_JSON_TEXT_FILE))
+    {
+        for (std::size_t idx = 0; idx < udp_ports_rx.size(); idx++)
+        {
+            labels.push_back((udp_ports_rx.size() == 1) ? "" : std::to_string(udp_ports_rx[idx])); // single input, keep file names unchanged
+        }
+    }
+
+    cid_init(raw_format_flag, audio_format, labels);
 
     const int RX_BUFLEN = 65535;
     char rx_buf[RX_BUFLEN];
 
+    uint64_t ticks = 0;
+
     if (program_mode & READ_FROM_JSON_TEXT_FILE)                                // read from Json text file file_in
     {
+        uint64_t last_refresh = now_ms();
+
         while (!sigint_flag)
         {
-            memset(rx_buf, 0, sizeof(rx_buf));
             while (fgets(rx_buf, sizeof(rx_buf), file_in))
             {
-                std::string data(rx_buf);
-                cid_parse_pdu(data, file_out);
+                cid_parse_pdu(CID_CONTEXT_FROM_LOG, rx_buf, strlen(rx_buf), file_out);
+
+                if (now_ms() - last_refresh >= REFRESH_PERIOD_MS)
+                {
+                    refresh_tick(1, &ticks);
+                    last_refresh = now_ms();
+                }
             }
+
+            refresh_tick(1, &ticks);                                            // end of file reached, wait for more data
+            last_refresh = now_ms();
+            usleep(REFRESH_PERIOD_MS * 1000);
+            clearerr(file_in);
         }
 
         fclose(file_in);
     }
-    else                                                                        // read from UDP socket fd_input
+    else                                                                        // read from UDP sockets fd_inputs
     {
-        const int TIME_WAIT_MS = 50;                                            // udp port maximum waiting time [ms]
+        const int MAX_EVENTS = 16;
+        const uint64_t TIMER_EVENT = (uint64_t)-1;                              // event data for timer, inputs use their index
+
+        int fd_epoll = epoll_create1(0);
+        int fd_timer = timer_open(REFRESH_PERIOD_MS);
+
+        if ((fd_epoll < 0) || (fd_timer < 0))
+        {
+            fprintf(stderr, "Couldn't create event loop\n");
+            exit(EXIT_FAILURE);
+        }
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+
+        ev.data.u64 = TIMER_EVENT;
+        epoll_ctl(fd_epoll, EPOLL_CTL_ADD, fd_timer, &ev);
+
+        for (std::size_t idx = 0; idx < fd_inputs.size(); idx++)
+        {
+            ev.data.u64 = idx;                                                  // input index is the CID namespace
+            epoll_ctl(fd_epoll, EPOLL_CTL_ADD, fd_inputs[idx], &ev);
+        }
+
+        struct epoll_event events[MAX_EVENTS];
 
         while (!sigint_flag)
         {
-            memset(rx_buf, 0, sizeof(rx_buf));
-            int len = timed_recv(fd_input, rx_buf, RX_BUFLEN, TIME_WAIT_MS);
+            int count = epoll_wait(fd_epoll, events, MAX_EVENTS, -1);           // sleep until data, timer or signal
 
-            if (len > 32)                                                        // skip small packets
+            for (int cnt = 0; cnt < count; cnt++)
             {
-                std::string data(rx_buf);
-                cid_parse_pdu(data, file_out);
+                uint64_t input = events[cnt].data.u64;
+
+                if (input == TIMER_EVENT)                                       // speech decoding, screen refresh and housekeeping
+                {
+                    uint64_t expirations;
+                    if (read(fd_timer, &expirations, sizeof(expirations)) > 0)
+                    {
+                        refresh_tick(expirations, &ticks);
+                    }
+                }
+                else                                                            // drain all pending datagrams of this socket
+                {
+                    int len;
+                    while ((len = recv(fd_inputs[input], rx_buf, RX_BUFLEN, 0)) >= 0)
+                    {
+                        if (len > 32)                                           // skip small packets
+                        {
+                            cid_parse_pdu((int)input, rx_buf, len, file_out);
+                        }
+                    }
+                }
             }
         }
 
-        close(fd_input);
+        close(fd_timer);
+        close(fd_epoll);
+
+        for (std::size_t idx = 0; idx < fd_inputs.size(); idx++)
+        {
+            close(fd_inputs[idx]);
+        }
     }
 
     fclose(file_out);
@@ -269,6 +419,11 @@ int main(int argc, char * argv[])
     scr_clear();
     cid_clear();
 
+    if (raw_format_flag)
+    {
+        printf("Speech frames decoded per batch: %.2f (mean)\n", cid_mean_batch_size());
+    }
+
     printf("Clean exit\n");
 
     return EXIT_SUCCESS;
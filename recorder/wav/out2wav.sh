@@ -1,18 +1,24 @@
 #!/bin/bash
 #
 # 2016-07-21  LT  0.0  first release
+# usage: ./out2wav.sh [threads]  (default: all online processors)
 #
 
 cp -f ../out/*.out .
 
-for FILE in *.out; do
-    BASE=${FILE%.out};
+# channel + speech decoding of all .out files on all cores
+if [ -n "$1" ]; then
+    ./bdecoder -j "$1" .
+else
+    ./bdecoder .
+fi
+
+for FILE in *.raw; do
+    BASE=${FILE%.raw};
     echo "* $FILE -> $BASE.wav";
 
-    ./cdecoder "$FILE" "$BASE.cod";
-    ./sdecoder "$BASE.cod" "$BASE.raw";
     sox -r 8k -e signed -b 16 "$BASE.raw" "$BASE.wav"
     #oggenc "$BASE.wav"
 done
 
-rm  *.out *.cod *.raw 
+rm  *.out *.raw
@@ -19,11 +19,128 @@
 #include <cstdint>
 #include <cstdarg>
 #include <string>
+#include <vector>
 #include "window.h"
 #include "utils.h"
 #include "cid.h"
 #include "call_identifier.h"
 
+/**
+ * @brief Input label printed before CID when several inputs are used
+ *
+ */
+
+static std::string label_str(call_identifier_t * cid)
+{
+    return cid->m_label.empty() ? "" : "[" + cid->m_label + "] ";
+}
+
+/**
+ * @brief Display state shared by ncurses and text output
+ *
+ * Message processing only queues text and flags, screen is redrawn by
+ * scr_refresh() at fixed rate from a snapshot of the CID list
+ *
+ */
+
+static bool b_headless = false;                                                 // no output at all
+static int  window_line_length;
+static int  window_max_bottom_lines;
+
+static std::vector<std::string> pending_infos;                                  // lines waiting for next refresh
+static std::vector<std::string> pending_sds;
+static std::vector<std::string> displayed_rows;                                 // CID rows currently on screen
+
+/**
+ * @brief Format one CID row
+ *
+ */
+
+static std::string cid_row(call_identifier_t * cid)
+{
+    std::string data = "";
+
+    if (cid->m_data_received > 0.)
+    {
+        data = format_str("%sCID [Usage] = %06u [%02u] (%.0f kB) file %s, SSI =",
+                          label_str(cid).c_str(),
+                          cid->m_cid,
+                          cid->m_usage_marker,
+                          cid->m_data_received,
+                          cid->m_file_name[cid->m_usage_marker].c_str());
+    }
+    else
+    {
+        data = format_str("%sCID [Usage] = %06u [%02u], SSI =",
+                          label_str(cid).c_str(),
+                          cid->m_cid,
+                          cid->m_usage_marker);
+    }
+
+    for (std::size_t idx = 0; idx < cid->m_ssi.size(); idx++)                   // print cid ssi
+    {
+        data = data + format_str(" %08u", cid->m_ssi[idx].ssi);
+    }
+
+    return data;
+}
+
+/**
+ * @brief Take a snapshot of the CID list as text rows
+ *
+ */
+
+static void cid_snapshot(std::vector<std::string> & rows)
+{
+    rows.clear();
+
+    int cnt = 0;
+    while (true)
+    {
+        call_identifier_t * cid = get_cid(cnt);
+        cnt++;
+
+        if (cid == NULL) break;
+
+        rows.push_back(cid_row(cid));
+    }
+}
+
+/*
+ * Queuing functions, called from message processing
+ *
+ */
+
+void scr_update(std::string info)
+{
+    if (b_headless) return;
+
+#ifdef WITH_NCURSES
+    if ((int)info.size() > window_line_length)
+    {
+        info = info.substr(0, window_line_length);
+    }
+#endif
+
+    pending_infos.push_back(info);
+}
+
+
+void scr_print_sds(std::string msg)
+{
+    if (b_headless) return;
+
+    pending_sds.push_back(msg);
+}
+
+
+void scr_print_infos(std::string msg)
+{
+    if (b_headless) return;
+
+    pending_infos.push_back(msg);
+}
+
 #ifdef WITH_NCURSES
 
 #include <ncurses.h>
@@ -33,21 +150,21 @@ static WINDOW * wn_infos;
 static WINDOW * wn_sds;                                                         // window for SDS messages
 static WINDOW * wn_bottom;
 
-static int window_line_length;
-static int window_max_bottom_lines;
-
 /*
  * screen functions
  *
  */
 
-void scr_init(int line_length, int max_bottom_lines)
+void scr_init(int line_length, int max_bottom_lines, int headless_flag)
 {
-    // ncurses screen
-    initscr();
-
     window_line_length      = line_length;                                      // maximum characters printed on a line
     window_max_bottom_lines = max_bottom_lines;                                 // maximum lines printed in bottom window before wrapping
+    b_headless              = headless_flag != 0;
+
+    if (b_headless) return;                                                     // curses is not initialized at all
+
+    // ncurses screen
+    initscr();
 
     wn_top    = subwin(stdscr, 3,             COLS, 0,             0);          // define windows dimensions
     wn_infos  = subwin(stdscr, LINES / 4 - 3, COLS, 3,             0);
@@ -60,6 +177,8 @@ void scr_init(int line_length, int max_bottom_lines)
 
     box(wn_bottom, ACS_VLINE, ACS_HLINE);                                       // draw outline
 
+    displayed_rows.assign(window_max_bottom_lines, "");
+
     wrefresh(wn_top);
     wrefresh(wn_infos);
     wrefresh(wn_sds);
@@ -67,56 +186,47 @@ void scr_init(int line_length, int max_bottom_lines)
 }
 
 
-void scr_update(std::string info)
+void scr_refresh()
 {
-    // update middle and bottom window
-    wclear(wn_bottom);
-    box(wn_bottom, ACS_VLINE, ACS_HLINE);
+    if (b_headless) return;
 
-    std::string txt = info;
-    if ((int)txt.size() > window_line_length)
+    // flush queued lines to middle windows
+    for (std::size_t idx = 0; idx < pending_infos.size(); idx++)
     {
-        txt = txt.substr(0, window_line_length);
+        wprintw(wn_infos, "%s\n", pending_infos[idx].c_str());
     }
-    wprintw(wn_infos, "%s\n", txt.c_str());
 
-    int cnt = 0;
-    int cur_line = 0;
-    while (true)
+    for (std::size_t idx = 0; idx < pending_sds.size(); idx++)
     {
-        call_identifier_t * cid = get_cid(cnt);
-        cnt++;
+        wprintw(wn_sds, "%s\n", pending_sds[idx].c_str());
+    }
 
-        if (cid == NULL) break;
+    if (!pending_infos.empty()) wnoutrefresh(wn_infos);
+    if (!pending_sds.empty())   wnoutrefresh(wn_sds);
 
-        cur_line++;
-        if (cur_line > window_max_bottom_lines)                                 // wrap to top of bottom window when maximum lines printed
-        {
-            cur_line = 1;
-        }
+    pending_infos.clear();
+    pending_sds.clear();
 
-        std::string data = "";
+    // bottom window, rows wrap to top when maximum lines printed
+    std::vector<std::string> rows;
+    cid_snapshot(rows);
 
-        if (cid->m_data_received > 0.)
-        {
-            data = format_str("CID [Usage] = %06u [%02u] (%.0f kB) file %s, SSI =",
-                              cid->m_cid,
-                              cid->m_usage_marker,
-                              cid->m_data_received,
-                              cid->m_file_name[cid->m_usage_marker].c_str());
-        }
-        else
-        {
-            data = format_str("CID [Usage] = %06u [%02u], SSI =",
-                              cid->m_cid,
-                              cid->m_usage_marker);
-        }
+    std::vector<std::string> lines(window_max_bottom_lines, "");
 
-        for (std::size_t idx = 0; idx < cid->m_ssi.size(); idx++)               // print cid ssi
-        {
-            data = data + format_str(" %08u", cid->m_ssi[idx].ssi);
-        }
+    for (std::size_t idx = 0; idx < rows.size(); idx++)
+    {
+        lines[idx % window_max_bottom_lines] = rows[idx];
+    }
 
+    bool b_changed = false;
+
+    for (int line = 0; line < window_max_bottom_lines; line++)                  // redraw changed rows only
+    {
+        if (lines[line] == displayed_rows[line]) continue;
+
+        displayed_rows[line] = lines[line];
+
+        std::string data = lines[line];
 
         if ((int)data.size() > window_line_length - 3)                          // limit line length including square box
         {
@@ -124,23 +234,23 @@ void scr_update(std::string info)
         }
         else
         {
-            while ((int)data.size() < window_line_length - 3)                   // pad text right including square box
-            {
-                data = data + " ";
-            }
+            data.resize(window_line_length - 3, ' ');                           // pad text right including square box
         }
-        mvwprintw(wn_bottom, cur_line + 2, 2, "%s", data.c_str());
+
+        mvwprintw(wn_bottom, line + 3, 2, "%s", data.c_str());
+        b_changed = true;
     }
 
-    wrefresh(wn_top);
-    wrefresh(wn_infos);
-    wrefresh(wn_sds);
-    wrefresh(wn_bottom);
+    if (b_changed) wnoutrefresh(wn_bottom);
+
+    doupdate();                                                                 // single terminal write for all windows
 }
 
 
 void scr_clear()
 {
+    if (b_headless) return;
+
     // clean data
     delwin(wn_top);
     delwin(wn_infos);
@@ -149,85 +259,56 @@ void scr_clear()
     endwin();
 }
 
-
-void scr_print_sds(std::string msg)
-{
-    wprintw(wn_sds, "%s\n", msg.c_str());
-    wrefresh(wn_sds);
-}
-
-
-void scr_print_infos(std::string msg)
-{
-    // print informations to middle window
-    wprintw(wn_infos, "%s\n", msg.c_str());
-    wrefresh(wn_infos);
-}
-
 #else
 
 /*
  * Functions with no ncurses, print to screen only
  */
 
-void scr_init(int line_length, int max_bottom_line)
+void scr_init(int line_length, int max_bottom_lines, int headless_flag)
 {
-
+    window_line_length      = line_length;
+    window_max_bottom_lines = max_bottom_lines;
+    b_headless              = headless_flag != 0;
 }
 
 
-void scr_update(std::string info)
+void scr_refresh()
 {
-    printf("%s\n", info.c_str());
+    if (b_headless) return;
 
-    int cnt = 0;
-    while (true)
+    for (std::size_t idx = 0; idx < pending_infos.size(); idx++)
     {
-        call_identifier_t * cid = get_cid(cnt);
-        cnt++;
+        printf("%s\n", pending_infos[idx].c_str());
+    }
 
-        if (cid == NULL) break;
+    for (std::size_t idx = 0; idx < pending_sds.size(); idx++)
+    {
+        printf("%s\n", pending_sds[idx].c_str());
+    }
 
-        if (cid->m_data_received > 0.)
-        {
-            printf("CID [Usage] = %06u [%02u] (%.0f kB) file %s, SSI =",
-                      cid->m_cid,
-                      cid->m_usage_marker,
-                      cid->m_data_received,
-                      cid->m_file_name[cid->m_usage_marker].c_str());
-        }
-        else
-        {
-            printf("CID [Usage] = %06u [%02u], SSI =",
-                      cid->m_cid,
-                      cid->m_usage_marker);
-        }
+    pending_infos.clear();
+    pending_sds.clear();
 
-        for (std::size_t idx = 0; idx < cid->m_ssi.size(); idx++)               // print cid ssi
-        {
-            printf(" %08u", cid->m_ssi[idx].ssi);
-        }
+    std::vector<std::string> rows;
+    cid_snapshot(rows);
 
-        printf("\n");
-    }
-}
+    for (std::size_t idx = 0; idx < rows.size(); idx++)                         // print changed CID only
+    {
+        if ((idx < displayed_rows.size()) && (rows[idx] == displayed_rows[idx])) continue;
 
+        printf("%s\n", rows[idx].c_str());
+    }
 
-void scr_clear()
-{
+    displayed_rows.swap(rows);
 
+    fflush(stdout);
 }
 
 
-void scr_print_sds(std::string msg)
+void scr_clear()
 {
-    printf("%s\n", msg.c_str());
-}
-
 
-void scr_print_infos(std::string msg)
-{
-    printf("%s\n", msg.c_str());
 }
 
 #endif
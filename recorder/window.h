@@ -21,8 +21,9 @@
 #include <cstdarg>
 #include <string>
 
-void scr_init(int line_length, int max_bottom_lines);
+void scr_init(int line_length, int max_bottom_lines, int headless_flag);
 void scr_update(std::string info);
+void scr_refresh();
 void scr_clear();
 void scr_print_infos(std::string msg);
 void scr_print_sds(std::string msg);